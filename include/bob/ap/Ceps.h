@@ -27,6 +27,7 @@
 
 #include <blitz/array.h>
 #include <vector>
+#include <algorithm>
 #include <bob/sp/FFT1D.h>
 #include <bob/core/Exception.h>
 
@@ -42,6 +43,7 @@ namespace bob {
 namespace ap {
 
 class CepsTest;
+class CepsStream;
 
 /**
  * @ingroup AP
@@ -73,10 +75,36 @@ class Ceps
     blitz::TinyVector<int,2> getCepsShape(const blitz::Array<double,1>& input) const;
 
     /**
-     * @brief Computes Cepstral features
+     * @brief Computes Cepstral features. The frames are processed in 
+     * blocks: the spectra of all the frames of a block are computed before
+     * the filter bank and the DCT are applied to the block. If several 
+     * threads are enabled (see setNThreads()), they process separate 
+     * blocks of frames. The results do not depend on the number of threads,
+     * and are the same as the ones CepsStream computes frame by frame.
      */
     void operator()(const blitz::Array<double,1>& input, blitz::Array<double,2>& output);
 
+    /**
+     * @brief Computes the Cepstral features of the frames selected by the
+     * mask (e.g. the speech frames found by VAD), which has one element per
+     * frame of the input. The output has one row per selected frame, with
+     * the features that operator()(input, output) computes for that frame.
+     * Only the cepstral coefficients of the selected frames, and of the 
+     * neighbours their derivatives depend on, are computed.
+     */
+    void operator()(const blitz::Array<double,1>& input, 
+      const blitz::Array<bool,1>& mask, blitz::Array<double,2>& output);
+
+    /**
+     * @brief Computes the log-energy (as with_energy) and the zero-crossing
+     * rate (the fraction of consecutive samples with opposite signs) of
+     * each frame of the input, after the removal of its mean value. These
+     * are the measures VAD uses. The outputs have one element per frame.
+     * Frames are split between the same threads as for the extraction.
+     */
+    void frameActivity(const blitz::Array<double,1>& input,
+      blitz::Array<double,1>& energies, blitz::Array<double,1>& zcr) const;
+
     /**
      * @brief Destructor
      */
@@ -183,6 +211,12 @@ class Ceps
      */
     bool getWithDeltaDelta() const
     { return m_with_delta_delta; }
+    /**
+     * @brief Returns the number of threads extracting the features of
+     * separate blocks of frames
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
 
     /**
      * @brief Sets the sampling frequency/frequency rate
@@ -259,6 +293,12 @@ class Ceps
     void setWithDeltaDelta(bool with_delta_delta)
     { if(with_delta_delta) m_with_delta = true;
       m_with_delta_delta = with_delta_delta; }
+    /**
+     * @brief Sets the number of threads extracting the features of separate
+     * blocks of frames. The results do not depend on the number of threads.
+     */
+    void setNThreads(size_t n_threads)
+    { m_n_threads = std::max(n_threads, (size_t)1); }
 
   private:
     /**
@@ -284,16 +324,78 @@ class Ceps
      */
     void hammingWindow(blitz::Array<double,1> &data) const;
 
+    /**
+     * @brief Computes the static features (cepstral coefficients, and
+     * energy if enabled) of a single frame of m_win_length samples
+     */
+    void extractFrame(const blitz::Array<double,1>& frame, blitz::Array<double,1>& ceps_row);
+    /**
+     * @brief Computes the static features of the given frames of the input,
+     * splitting them between m_n_threads threads. The features of frame i
+     * are written in row i of the output.
+     */
+    void extractFrames(const blitz::Array<double,1>& input,
+      const std::vector<int>& frames, blitz::Array<double,2>& ceps_matrix) const;
+    /**
+     * @brief Computes the static features of the frames [first,last) of the
+     * given list, block by block, with working arrays of its own
+     */
+    void extractFrames(const blitz::Array<double,1>& input,
+      const std::vector<int>& frames, blitz::Array<double,2>& ceps_matrix, 
+      int first, int last) const;
+    /**
+     * @brief Computes the activity measures of the frames [first,last),
+     * straight from the input samples
+     */
+    void frameActivity(const blitz::Array<double,1>& input,
+      blitz::Array<double,1>& energies, blitz::Array<double,1>& zcr,
+      int first, int last) const;
+    /**
+     * @brief Computes the first and second order derivatives (if enabled)
+     * of the static features of all the frames
+     */
+    void addDerivatives(blitz::Array<double,2>& ceps_matrix) const;
+    /**
+     * @brief Prepares a frame for the FFT: removes the mean, computes the
+     * energy (if required) and applies the pre-emphasis and the Hamming
+     * window. The frame has m_win_size samples, zero-padded.
+     */
+    void prepareFrame(blitz::Array<double,1>& frame, double& energy) const;
     /**
      * @brief Computes the power-spectrum of the FFT of the input frame and
      * applies the triangular filter bank
      */
     void logFilterBank(blitz::Array<double,1>& x);
+    /**
+     * @brief Replaces the m_win_size/2+1 first elements of the real input 
+     * frame by the magnitude of its Fourier transform. The real frame is 
+     * packed into a complex sequence of half its length, transformed, and
+     * the spectrum is recovered using the symmetries of the transform.
+     */
+    void spectrumMagnitude(blitz::Array<double,1>& x) const;
+    /**
+     * @brief Packs the even samples of the real frame x into the real parts
+     * and the odd ones into the imaginary parts of z (of half the length)
+     */
+    void packFrame(const blitz::Array<double,1>& x, 
+      blitz::Array<std::complex<double>,1>& z) const;
+    /**
+     * @brief Computes the magnitude of the m_win_size/2+1 first elements
+     * of the spectrum of a real frame, from the FFT of its packed samples
+     */
+    void combineSpectrum(const blitz::Array<std::complex<double>,1>& z, 
+      blitz::Array<double,1>& x) const;
     /**
      * @brief Applies the triangular filter bank to the input array and 
      * returns the logarithm of the energy in each band.
      */
     void logTriangularFilterBank(blitz::Array<double,1>& data) const;
+    /**
+     * @brief Applies the triangular filter bank to the spectrum. Only the 
+     * non-zero band of each filter is multiplied.
+     */
+    void logTriangularFilterBank(const blitz::Array<double,1>& spectrum, 
+      blitz::Array<double,1>& log_energies) const;
     /**
      * @brief Computes the logarithm of the energy
      */
@@ -303,6 +405,11 @@ class Ceps
      * \f$out[i]=sqrt(2/N)*sum_{j=1}^{N} (in[j]cos(M_PI*i*(j-0.5)/N)\f$
      */
     void applyDct(blitz::Array<double,1>& ceps_row) const;
+    /**
+     * @brief Applies the DCT to the given filter bank outputs
+     */
+    void applyDct(const blitz::Array<double,1>& log_energies, 
+      blitz::Array<double,1>& ceps_row) const;
 
     void initWinSize();
     void initWinLength();
@@ -351,12 +458,14 @@ class Ceps
     double m_fb_out_floor;
     double m_log_energy_floor;
     double m_log_fb_out_floor;
+    size_t m_n_threads;
 
     blitz::Array<double,2> m_dct_kernel;
     blitz::Array<double,1> m_hamming_kernel;
     blitz::Array<int,1>  m_p_index;
     std::vector<blitz::Array<double,1> > m_filter_bank;
-    bob::sp::FFT1D m_fft;
+    bob::sp::FFT1D m_fft; ///< complex FFT of length m_win_size/2
+    blitz::Array<std::complex<double>,1> m_twiddles; ///< \f$e^{-2i\pi k/N}\f$
 
     mutable blitz::Array<double,1> m_cache_frame_d;
     mutable blitz::Array<std::complex<double>,1>  m_cache_frame_c1;
@@ -364,6 +473,7 @@ class Ceps
     mutable blitz::Array<double,1> m_cache_filters;
 
     friend class TestCeps;
+    friend class CepsStream;
 };
 
 /**
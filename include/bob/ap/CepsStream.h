@@ -0,0 +1,158 @@
+/**
+ * @file bob/ap/CepsStream.h
+ * @date Sun Oct 18 21:06:42 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Extracts cepstral features from audio streams, chunk by chunk
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_AP_CEPSSTREAM_H
+#define BOB_AP_CEPSSTREAM_H
+
+#include <vector>
+#include <deque>
+#include <blitz/array.h>
+#include <bob/ap/Ceps.h>
+
+namespace bob { namespace ap {
+
+/**
+ * @ingroup AP
+ * @brief This class extracts cepstral features from an audio stream, as
+ * the signal arrives. Samples are pushed in chunks of any size, and the
+ * features of each frame are made available as soon as they can be
+ * computed:
+ *  - the cepstral coefficients (and energy) once all the samples of the
+ *    frame were pushed;
+ *  - the first order derivatives once the delta_win following frames are
+ *    available as well;
+ *  - the second order derivatives once the 2*delta_win following frames
+ *    are available.
+ *
+ * The samples overlapping the next frame are kept between chunks. At the
+ * end of the stream, finish() releases the last frames, whose derivatives
+ * are computed by replicating the last frame. The extracted features are
+ * the ones Ceps extracts from the whole signal at once.
+ */
+class CepsStream
+{
+  public:
+    /**
+     * @brief Constructor. The stream extracts features with a copy of the
+     * given configuration (later changes to it are not taken into account).
+     */
+    CepsStream(const Ceps& ceps);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CepsStream();
+
+    /**
+     * @brief Returns the configuration of the feature extraction
+     */
+    const Ceps& getCeps() const
+    { return m_ceps; }
+    /**
+     * @brief Returns the dimension of the feature vectors
+     */
+    size_t getFeatureDim() const
+    { return m_dim; }
+    /**
+     * @brief Returns the number of frames the features are delayed by, to
+     * compute the derivatives (0, delta_win or 2*delta_win)
+     */
+    size_t getLatency() const;
+    /**
+     * @brief Returns the number of frames read so far
+     */
+    size_t getNFrames() const
+    { return m_n_read; }
+    /**
+     * @brief Returns the number of frames ready to be read
+     */
+    size_t getNReady() const;
+    /**
+     * @brief Tells whether the end of the stream was signaled by finish()
+     */
+    bool getFinished() const
+    { return m_finished; }
+
+    /**
+     * @brief Appends samples to the stream, and computes the features of
+     * the frames this completes
+     */
+    void push(const blitz::Array<double,1>& chunk);
+
+    /**
+     * @brief Signals the end of the stream. The features of the last
+     * frames become ready. Samples that do not fill a complete frame are
+     * discarded, as Ceps does.
+     */
+    void finish();
+
+    /**
+     * @brief Reads the next output.extent(0) frames, which must be ready
+     */
+    void read(blitz::Array<double,2>& output);
+
+    /**
+     * @brief Discards all samples and features, to start a new stream
+     */
+    void reset();
+
+  private:
+    /**
+     * @brief Computes the derivatives of the frames for which enough
+     * following frames are available, and drops the frames not needed
+     * anymore
+     */
+    void update();
+    /**
+     * @brief Computes the derivative of the features of frame i, in the
+     * columns starting at dst, from the features in the columns starting
+     * at src, as Ceps does, given that n frames are available.
+     */
+    void derivative(size_t i, size_t n, int src, int dst);
+    /**
+     * @brief Returns the features of frame i
+     */
+    blitz::Array<double,1>& frame(size_t i)
+    { return m_frames[i - m_base]; }
+
+    CepsStream(const CepsStream&);
+    CepsStream& operator=(const CepsStream&);
+
+    Ceps m_ceps;
+    size_t m_n_coefs; ///< the number of cepstral coefficients and energy
+    size_t m_dim; ///< the dimension of the feature vectors
+
+    std::vector<double> m_samples; ///< samples of the next frames
+    size_t m_skip; ///< samples to drop before the next frame
+    bool m_finished;
+
+    std::deque<blitz::Array<double,1> > m_frames; ///< features of the frames kept
+    size_t m_base; ///< index of the first frame kept
+    size_t m_n_static; ///< frames with cepstral coefficients
+    size_t m_n_delta; ///< frames with first order derivatives
+    size_t m_n_delta_delta; ///< frames with second order derivatives
+    size_t m_n_read; ///< frames read
+};
+
+}}
+
+#endif /* BOB_AP_CEPSSTREAM_H */
@@ -0,0 +1,134 @@
+/**
+ * @file bob/ap/VAD.h
+ * @date Sun Oct 18 22:17:26 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Energy and zero-crossing rate based voice activity detection
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_AP_VAD_H
+#define BOB_AP_VAD_H
+
+#include <blitz/array.h>
+
+namespace bob { namespace ap {
+
+/**
+ * @ingroup AP
+ * @brief This class selects the speech frames of an utterance, from the
+ * log-energy and zero-crossing rate of its frames, as computed by
+ * Ceps::frameActivity(). The resulting mask can be given to Ceps to
+ * extract the features of the speech frames only.
+ *
+ * A frame is marked as speech if:
+ *  - its energy is at most threshold_db decibels below the energy of the
+ *    loudest frame of the utterance, and
+ *  - its zero-crossing rate is at most max_zcr (noise-like frames have
+ *    high rates: about 0.5 for white noise).
+ * Runs of less than min_speech_frames speech frames are then discarded,
+ * and the hangover frames before and after each remaining run are marked
+ * as speech as well, not to cut the (weaker) onsets and endings of words.
+ *
+ * Note that Ceps floors frame energies below 1 (i.e., log-energies are 
+ * never negative), so signals should not be normalized to [-1,1].
+ */
+class VAD
+{
+  public:
+    /**
+     * @brief Constructor
+     */
+    VAD(double threshold_db=30., double max_zcr=1., 
+      size_t min_speech_frames=1, size_t hangover=0);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~VAD();
+
+    /**
+      * @brief Equal to
+      */
+    bool operator==(const VAD& b) const;
+    /**
+      * @brief Not equal to
+      */
+    bool operator!=(const VAD& b) const; 
+
+    /**
+     * @brief Marks the speech frames, given the log-energy and zero-crossing
+     * rate of each frame. All arrays should have the same length.
+     */
+    void operator()(const blitz::Array<double,1>& energies,
+      const blitz::Array<double,1>& zcr, blitz::Array<bool,1>& mask) const;
+
+    /**
+     * @brief Returns the maximum energy difference with the loudest frame,
+     * in decibels
+     */
+    double getThresholdDb() const
+    { return m_threshold_db; }
+    /**
+     * @brief Returns the maximum zero-crossing rate of speech frames
+     */
+    double getMaxZcr() const
+    { return m_max_zcr; }
+    /**
+     * @brief Returns the minimum number of consecutive speech frames
+     */
+    size_t getMinSpeechFrames() const
+    { return m_min_speech_frames; }
+    /**
+     * @brief Returns the number of frames kept before and after each run of
+     * speech frames
+     */
+    size_t getHangover() const
+    { return m_hangover; }
+
+    /**
+     * @brief Sets the maximum energy difference with the loudest frame, in
+     * decibels
+     */
+    void setThresholdDb(double threshold_db)
+    { m_threshold_db = threshold_db; }
+    /**
+     * @brief Sets the maximum zero-crossing rate of speech frames
+     */
+    void setMaxZcr(double max_zcr)
+    { m_max_zcr = max_zcr; }
+    /**
+     * @brief Sets the minimum number of consecutive speech frames
+     */
+    void setMinSpeechFrames(size_t min_speech_frames)
+    { m_min_speech_frames = min_speech_frames; }
+    /**
+     * @brief Sets the number of frames kept before and after each run of
+     * speech frames
+     */
+    void setHangover(size_t hangover)
+    { m_hangover = hangover; }
+
+  private:
+    double m_threshold_db;
+    double m_max_zcr;
+    size_t m_min_speech_frames;
+    size_t m_hangover;
+};
+
+}}
+
+#endif /* BOB_AP_VAD_H */
@@ -0,0 +1,289 @@
+/**
+ * @file bob/core/ordered_ring.h
+ * @date Sun Oct 18 21:05:12 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief A bounded ring handing items over between threads, in sequence
+ * order
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_ORDERED_RING_H
+#define BOB_CORE_ORDERED_RING_H
+
+#include <vector>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+namespace bob { namespace core {
+  /**
+   * @ingroup CORE
+   * @{
+   */
+
+  /**
+   * @brief A bounded ring of Q slots through which producers hand items
+   * over to a single consumer, in sequence order. Item 'seq' always goes
+   * through slot 'seq % Q': producers may fill slots in any order, but the
+   * consumer gets items 0, 1, 2, ... in turn. A producer may only fill item
+   * 'seq' once items up to 'seq - Q' were consumed.
+   *
+   * Producers report failures against the item they could not produce (see
+   * fail()). The consumer still gets all items before it, and the failure
+   * is raised when it reaches the failed item. Producers stop getting new
+   * items past a failure.
+   *
+   * The ring optionally runs the threads producing (or consuming) items.
+   * The slots themselves can be accessed directly (e.g. to pre-allocate
+   * them) while no thread is running.
+   */
+  template <typename T> class OrderedRing {
+
+    public: //api
+
+      /**
+       * @brief Creates a ring with 'size' slots
+       */
+      explicit OrderedRing(size_t size):
+        m_slots(size),
+        m_consumed(0),
+        m_end(npos()),
+        m_failed(npos()),
+        m_error(),
+        m_stop(false)
+      {
+        if (size == 0) throw std::runtime_error("OrderedRing: the number of slots should be greater than zero");
+      }
+
+      /**
+       * @brief D'tor: stops all threads
+       */
+      virtual ~OrderedRing() { stop(); }
+
+      /**
+       * @brief The number of slots
+       */
+      inline size_t size() const { return m_slots.size(); }
+
+      /**
+       * @brief The k-th slot. Only use this while no thread is running.
+       */
+      inline T& operator[](size_t k) { return m_slots[k].item; }
+
+      /**
+       * @brief The number of items consumed so far, which is also the
+       * sequence number of the next item to be consumed
+       */
+      inline size_t position() const {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return m_consumed;
+      }
+
+      /**
+       * @brief The first failure reported so far (empty if none)
+       */
+      inline std::string error() const {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return m_error;
+      }
+
+      /**
+       * @brief If threads were started and not stopped since
+       */
+      inline bool running() const { return !m_threads.empty(); }
+
+      /**
+       * @brief Runs 'function(id)' on 'n' threads, with 'id' in [0, n), if
+       * the ring is not running already
+       */
+      void start(size_t n, const boost::function<void (size_t)>& function) {
+        if (running()) return;
+        for (size_t id=0; id<n; ++id)
+          m_threads.push_back(boost::make_shared<boost::thread>(function, id));
+      }
+
+      /**
+       * @brief Waits for the threads to return, without signaling them
+       */
+      void join() {
+        for (size_t k=0; k<m_threads.size(); ++k) m_threads[k]->join();
+        m_threads.clear();
+      }
+
+      /**
+       * @brief Signals the threads to stop, waits for them and resets the
+       * sequence: the next item is item 0 again, all slots are empty and
+       * failures are forgotten.
+       */
+      void stop() {
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          m_stop = true;
+        }
+        m_freed.notify_all();
+        m_filled.notify_all();
+
+        join();
+
+        m_stop = false;
+        m_consumed = 0;
+        m_end = npos();
+        m_failed = npos();
+        m_error.clear();
+        for (size_t k=0; k<m_slots.size(); ++k) m_slots[k].ready = false;
+      }
+
+      /**
+       * @brief Waits until item 'seq' can be produced and returns its slot.
+       * Nobody else touches the slot until publish(seq) is called. Returns
+       * 0 if the ring is stopping, if an item before 'seq' failed or if
+       * 'seq' is past the end of the sequence (see finish()).
+       */
+      T* acquire(size_t seq) {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        Slot& slot = m_slots[seq % m_slots.size()];
+        while (true) {
+          if (m_stop || m_failed <= seq || seq >= m_end) return 0;
+          if (seq < m_consumed + m_slots.size() && !slot.ready)
+            return &slot.item;
+          m_freed.wait(lock);
+        }
+      }
+
+      /**
+       * @brief Hands item 'seq', filled after acquire(seq), to the consumer
+       */
+      void publish(size_t seq) {
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          Slot& slot = m_slots[seq % m_slots.size()];
+          slot.sequence = seq;
+          slot.ready = true;
+        }
+        m_filled.notify_all();
+      }
+
+      /**
+       * @brief Reports that item 'seq' could not be produced (or consumed).
+       * Only the earliest failure is kept.
+       */
+      void fail(size_t seq, const std::string& error) {
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          if (seq < m_failed) {
+            m_failed = seq;
+            m_error = error;
+          }
+        }
+        m_freed.notify_all();
+        m_filled.notify_all();
+      }
+
+      /**
+       * @brief Tells the sequence has (at most) 'count' items: the consumer
+       * gets no item past them
+       */
+      void finish(size_t count) {
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          if (count < m_end) m_end = count;
+        }
+        m_freed.notify_all();
+        m_filled.notify_all();
+      }
+
+      /**
+       * @brief Waits for the next item and returns its slot. The slot is
+       * not refilled before release() is called. Returns 0 at the end of
+       * the sequence or if the ring is stopping. Raises std::runtime_error,
+       * with the reported message, if the next item failed.
+       */
+      T* wait() {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        while (true) {
+          Slot& slot = m_slots[m_consumed % m_slots.size()];
+          if (slot.ready && slot.sequence == m_consumed) return &slot.item;
+          if (m_failed == m_consumed) throw std::runtime_error(m_error);
+          if (m_stop || m_consumed >= m_end) return 0;
+          m_filled.wait(lock);
+        }
+      }
+
+      /**
+       * @brief Releases the slot returned by wait(), moving on to the next
+       * item
+       */
+      void release() {
+        {
+          boost::lock_guard<boost::mutex> lock(m_mutex);
+          m_slots[m_consumed % m_slots.size()].ready = false;
+          ++m_consumed;
+        }
+        m_freed.notify_all();
+      }
+
+      /**
+       * @brief Waits until 'count' items were consumed. Raises
+       * std::runtime_error, with the reported message, if one of them
+       * failed.
+       */
+      void flush(size_t count) {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        while (m_consumed < count && m_failed >= count && !m_stop)
+          m_freed.wait(lock);
+        if (m_failed < count) throw std::runtime_error(m_error);
+      }
+
+    private: //helpers
+
+      struct Slot {
+        Slot(): item(), sequence(0), ready(false) {}
+        T item;
+        size_t sequence; ///< the item number this slot holds
+        bool ready; ///< if the slot is filled
+      };
+
+      static size_t npos() { return std::numeric_limits<size_t>::max(); }
+
+      OrderedRing(const OrderedRing&);
+      OrderedRing& operator= (const OrderedRing&);
+
+    private: //representation
+
+      std::vector<Slot> m_slots;
+      size_t m_consumed; ///< the next item to be consumed
+      size_t m_end; ///< the number of items in the sequence
+      size_t m_failed; ///< the earliest item that failed
+      std::string m_error; ///< the failure of item m_failed
+      bool m_stop; ///< signals the threads to stop
+      mutable boost::mutex m_mutex; ///< protects the flags above
+      boost::condition_variable m_filled; ///< a slot was filled
+      boost::condition_variable m_freed; ///< a slot was freed
+      std::vector<boost::shared_ptr<boost::thread> > m_threads;
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_CORE_ORDERED_RING_H */
@@ -27,6 +27,7 @@
 #include <bob/core/array.h>
 #include <bob/io/BinFileHeader.h>
 #include <bob/io/Exception.h>
+#include <bob/io/MappedFile.h>
 
 namespace bob { namespace io {
   /**
@@ -99,6 +100,21 @@ namespace bob { namespace io {
       void read(bob::core::array::interface& a);
       void read(size_t index, bob::core::array::interface& a);
 
+      /**
+       * Returns the array at the given index. Files opened read-only are
+       * mapped in memory and the returned array points directly into the
+       * mapping. Otherwise, the array is read into a new buffer.
+       */
+      boost::shared_ptr<bob::core::array::interface> view(size_t index);
+
+      /**
+       * Tells the operating system how the arrays of a file opened read-only
+       * are going to be read
+       */
+      inline void advise(bob::io::File::access_t pattern) const {
+        if (m_mapping) m_mapping->advise(pattern);
+      }
+
       /**
        * Gets the Element type
        *
@@ -209,6 +225,7 @@ namespace bob { namespace io {
       std::fstream m_stream;
       detail::BinFileHeader m_header;
       openmode m_openmode;
+      boost::shared_ptr<MappedFile> m_mapping; ///< set if read-only
   };
 
   inline _BinFileFlag operator&(_BinFileFlag a, _BinFileFlag b) { 
@@ -94,12 +94,14 @@ namespace bob { namespace io {
 
   class FileNotReadable: public Exception {
     public:
-      FileNotReadable(const std::string& filename) throw();
+      FileNotReadable(const std::string& filename,
+          const std::string& reason="") throw();
       virtual ~FileNotReadable() throw();
       virtual const char* what() const throw();
 
     private:
       std::string m_name;
+      std::string m_reason;
       mutable std::string m_message;
   };
 
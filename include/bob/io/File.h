@@ -52,6 +52,17 @@ namespace io {
    */
   class File {
 
+    public: //types
+
+      /**
+       * Access patterns that can be announced with advise()
+       */
+      typedef enum access_t {
+        normal = 0, ///< no particular pattern
+        sequential = 1, ///< arrays are read in order
+        random = 2 ///< arrays are read in random order
+      } access_t;
+
     public: //abstract API
 
       virtual ~File();
@@ -123,6 +134,28 @@ namespace io {
        */
       virtual void write (const bob::core::array::interface& buffer) =0;
 
+    public: //optional API
+
+      /**
+       * Returns the array at the given index. Files opened read-only that
+       * support memory mapping return a read-only interface pointing
+       * directly into the mapped file, whose owner() keeps the mapping
+       * alive. Otherwise, the array is read into a new buffer.
+       */
+      virtual boost::shared_ptr<bob::core::array::interface> view(size_t index);
+
+      /**
+       * Returns all the data available at the file as a single array, like
+       * view(index) does for read(buffer, index).
+       */
+      virtual boost::shared_ptr<bob::core::array::interface> view_all();
+
+      /**
+       * Announces how the arrays are going to be read, so that memory
+       * mapped files can tune read-ahead. Other files ignore the hint.
+       */
+      virtual void advise(access_t pattern) { }
+
     public: //blitz::Array specific API
 
       /**
@@ -76,13 +76,14 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * b) Will contain the exact number of dimensions of the input type.
        *
        * When you set "list" to true (the default), datasets are created with
-       * chunking automatically enabled (the chunk size is set to the size of
-       * the given variable) and an extra dimension is inserted to accommodate
-       * list operations.
+       * chunking automatically enabled and an extra dimension is inserted to
+       * accommodate list operations. Each chunk holds "chunk_rows" variables
+       * of the list. If "chunk_rows" is zero (the default), it is chosen so
+       * that chunks hold about 64 KiB of data (and at least one variable).
        */
       Dataset(boost::shared_ptr<Group> parent, const std::string& name,
           const bob::io::HDF5Type& type, bool list=true,
-          size_t compression=0);
+          size_t compression=0, size_t chunk_rows=0);
 
     public: //api
 
@@ -263,6 +264,25 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           return readArray<T,N>(0);
         }
 
+      /**
+       * Reads value.extent(0) consecutive objects (or rows), starting at the
+       * given index, in a single operation. The first dimension of the given
+       * array indexes the objects read, the remaining ones should match the
+       * shape of the objects stored in this dataset, as for
+       * readArray(index, value). A 1D array reads a range of scalars.
+       *
+       * @param index The first object to read
+       * @param value The output array data will be stored inside this
+       * variable. This variable has to be a zero-based C-style contiguous
+       * storage array. If that is not the case, we will raise an exception.
+       */
+      template <typename T, int N>
+        void readRows(size_t index, blitz::Array<T,N>& value) {
+          bob::core::array::assertCZeroBaseContiguous(value);
+          bob::io::HDF5Type dest_type(value);
+          read_rows_buffer(index, dest_type, reinterpret_cast<void*>(value.data()));
+        }
+
       /**
        * DATA WRITING FUNCTIONALITY
        */
@@ -381,6 +401,56 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           }
       }
 
+      /**
+       * Replaces value.extent(0) consecutive objects (or rows), starting at
+       * the given index, in a single operation. The conditions for
+       * readRows(index, value) apply.
+       */
+      template <typename T, int N>
+        void replaceRows(size_t index, const blitz::Array<T,N>& value) {
+          bob::io::HDF5Type dest_type(value);
+          if(!bob::core::array::isCZeroBaseContiguous(value)) {
+            blitz::Array<T,N> tmp = bob::core::array::ccopy(value);
+            write_rows_buffer(index, dest_type, reinterpret_cast<const void*>(tmp.data()));
+          }
+          else {
+            write_rows_buffer(index, dest_type,
+                reinterpret_cast<const void*>(value.data()));
+          }
+        }
+
+      /**
+       * Appends value.extent(0) objects (or rows) to this dataset, extending
+       * it only once. The first dimension of the given array indexes the
+       * objects appended, the remaining ones should match the shape of the
+       * objects stored in this (expandable) dataset.
+       */
+      template <typename T, int N>
+        void addRows(const blitz::Array<T,N>& value) {
+          bob::io::HDF5Type dest_type(value);
+          if(!bob::core::array::isCZeroBaseContiguous(value)) {
+            blitz::Array<T,N> tmp = bob::core::array::ccopy(value);
+            extend_rows_buffer(dest_type, reinterpret_cast<const void*>(tmp.data()));
+          }
+          else {
+            extend_rows_buffer(dest_type, reinterpret_cast<const void*>(value.data()));
+          }
+        }
+
+      /**
+       * Sets the chunk cache used to read and write this dataset (see
+       * H5Pset_chunk_cache()). The dataset is re-opened with the new
+       * settings.
+       *
+       * @param nslots The number of chunk slots in the cache (should be a
+       * prime number, about 100 times the number of chunks that fit in the
+       * cache)
+       * @param nbytes The total size of the cache, in bytes
+       * @param w0 The preemption policy, between 0 and 1. Set it to 1 if the
+       * chunks are read or written only once.
+       */
+      void setChunkCache(size_t nslots, size_t nbytes, double w0);
+
     private: //apis
 
       /**
@@ -393,6 +463,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       std::vector<bob::io::HDF5Descriptor>::iterator select (size_t index,
           const bob::io::HDF5Type& dest);
 
+      /**
+       * Selects "count" consecutive objects of the type "row", starting at
+       * the given index, for the next read or write operation.
+       */
+      std::vector<bob::io::HDF5Descriptor>::iterator select (size_t index,
+          size_t count, const bob::io::HDF5Type& row);
+
     public: //direct access for other bindings -- don't use these!
 
       /**
@@ -412,6 +489,28 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       void extend_buffer (const bob::io::HDF5Type& dest, const void* buffer);
 
+      /**
+       * Reads consecutive objects into the given (user) buffer. The first
+       * dimension of "dest" is the number of objects to read, the remaining
+       * ones describe each of the objects.
+       */
+      void read_rows_buffer (size_t index, const bob::io::HDF5Type& dest,
+          void* buffer);
+
+      /**
+       * Writes consecutive objects from the given buffer, described as for
+       * read_rows_buffer().
+       */
+      void write_rows_buffer (size_t index, const bob::io::HDF5Type& dest,
+          const void* buffer);
+
+      /**
+       * Extend the dataset with all the objects in the given buffer,
+       * described as for read_rows_buffer().
+       */
+      void extend_rows_buffer (const bob::io::HDF5Type& dest,
+          const void* buffer);
+
     public: //attribute support
 
       /**
@@ -0,0 +1,154 @@
+/**
+ * @file bob/io/HDF5FeatureLoader.h
+ * @date Sun Oct 18 16:02:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Loads feature matrices from a list of HDF5 files on background
+ * threads, delivering them in order through a bounded queue.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_HDF5FEATURELOADER_H
+#define BOB_IO_HDF5FEATURELOADER_H
+
+#include <vector>
+#include <string>
+#include <blitz/array.h>
+#include <bob/core/ordered_ring.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * Reads one 2D array of doubles (e.g. one feature vector per row) from
+   * each file of a list of HDF5 files, on a pool of background workers. The
+   * loaded matrices are kept in a bounded ring and handed to the consumer in
+   * file order, so that reading the next files overlaps with the
+   * processing of the current one.
+   *
+   * Worker 'w' loads files 'w', 'w + W', 'w + 2W', ... (where W is the
+   * number of workers), each through its own bob::io::HDF5File handle.
+   * Calls into libhdf5 are serialized by the process-wide lock of
+   * HDF5File (see HDF5File::mutex()), so the workers mostly overlap the
+   * reads with the consumer, rather than with each other.
+   */
+  class HDF5FeatureLoader {
+
+    public: //api
+
+      /**
+       * Initializes the loader. Background workers are only started on the
+       * first call to next() or after start().
+       *
+       * @param filenames The HDF5 files to read, in delivery order
+       * @param paths The path of the dataset to read in each file. Either
+       * one path per file or a single path for all files
+       * @param n_workers The number of background threads loading files
+       * @param queue_size The maximum number of loaded files kept ready
+       */
+      HDF5FeatureLoader(const std::vector<std::string>& filenames,
+          const std::vector<std::string>& paths, size_t n_workers=1,
+          size_t queue_size=4);
+
+      /**
+       * D'tor: stops all workers
+       */
+      virtual ~HDF5FeatureLoader();
+
+      /**
+       * The number of files to be loaded
+       */
+      inline size_t size() const { return m_filenames.size(); }
+
+      /**
+       * The name of the i-th file
+       */
+      inline const std::string& getFilename(size_t i) const
+      { return m_filenames[i]; }
+
+      /**
+       * The dataset path read from the i-th file
+       */
+      inline const std::string& getPath(size_t i) const
+      { return m_paths.size() == 1 ? m_paths[0] : m_paths[i]; }
+
+      /**
+       * The number of files delivered by next() so far. This is also the
+       * index of the file next() will deliver.
+       */
+      inline size_t getPosition() const { return m_ring.position(); }
+
+      /**
+       * The number of background workers
+       */
+      inline size_t getNumberOfWorkers() const { return m_n_workers; }
+
+      /**
+       * The maximum number of loaded files kept ready
+       */
+      inline size_t getQueueSize() const { return m_ring.size(); }
+
+      /**
+       * Starts the background workers, if they are not running already
+       */
+      void start();
+
+      /**
+       * Stops the background workers and discards loaded files. The next
+       * call to next() or start() restarts from the first file.
+       */
+      void stop();
+
+      /**
+       * Makes 'data' refer to the contents of the next file, waiting for it
+       * if necessary. The data is not copied and the array is not shared
+       * with the loader anymore. Returns false if all files were already
+       * delivered, leaving 'data' untouched.
+       *
+       * Exceptions raised by the workers (e.g. while reading files) are
+       * re-thrown here when the file that failed is reached: all files
+       * before it are delivered first. Later calls raise the same error,
+       * until stop() is called.
+       */
+      bool next(blitz::Array<double,2>& data);
+
+    private: //helpers
+
+      void worker(size_t id);
+      void load(size_t i, blitz::Array<double,2>& data) const;
+
+      HDF5FeatureLoader(const HDF5FeatureLoader&);
+      HDF5FeatureLoader& operator= (const HDF5FeatureLoader&);
+
+    private: //representation
+
+      std::vector<std::string> m_filenames;
+      std::vector<std::string> m_paths;
+      size_t m_n_workers; ///< the number of background threads
+
+      bob::core::OrderedRing<blitz::Array<double,2> > m_ring; ///< loaded files
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_HDF5FEATURELOADER_H */
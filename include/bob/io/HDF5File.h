@@ -26,6 +26,8 @@
 #define BOB_IO_HDF5FILE_H
 
 #include <boost/format.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <bob/io/HDF5Utils.h>
 
 namespace bob { namespace io {
@@ -36,6 +38,11 @@ namespace bob { namespace io {
    * total functionality provided by this API is, of course, much smaller than
    * what is provided if you use the HDF5 C-APIs directly, but is much simpler
    * as well.
+   *
+   * libhdf5 is not thread-safe in the builds we use. All methods of this
+   * class hold the process-wide lock returned by mutex() while they call
+   * the library, so that files can be used from several threads (distinct
+   * objects or not).
    */
   class HDF5File {
 
@@ -65,6 +72,13 @@ namespace bob { namespace io {
        */
       virtual ~HDF5File();
 
+      /**
+       * The (recursive) lock held by all methods of this class while they
+       * call libhdf5. Code calling libhdf5 directly, while HDF5 files may be
+       * used on other threads, should hold it as well.
+       */
+      static boost::recursive_mutex& mutex();
+
       /**
        * Changes the current prefix path. When this object is started, it
        * points to the root of the file. If you set this to a different
@@ -136,6 +150,7 @@ namespace bob { namespace io {
        * container with T = std::string and accepting push_back()
        */
       template <typename T> void paths (T& container, const bool relative = false) const {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         m_cwd->dataset_paths(container);
         if (relative){
           const std::string d = cwd();
@@ -154,6 +169,7 @@ namespace bob { namespace io {
        * container with T = std::string and accepting push_back()
        */
       template <typename T> void sub_groups (T& container, bool relative = false, bool recursive = true) const {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         m_cwd->subgroup_paths(container, recursive);
         if (!relative){
           const std::string d = cwd() + "/";
@@ -182,6 +198,7 @@ namespace bob { namespace io {
        */
       template <typename T>
         void read(const std::string& path, size_t pos, T& value) {
+          boost::lock_guard<boost::recursive_mutex> lock(mutex());
           (*m_cwd)[path]->read(pos, value);
         }
 
@@ -190,6 +207,7 @@ namespace bob { namespace io {
        * type T is incompatible. Relative paths are accepted.
        */
       template <typename T> T read(const std::string& path, size_t pos) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         return (*m_cwd)[path]->read<T>(pos);
       }
 
@@ -208,6 +226,7 @@ namespace bob { namespace io {
        */
       template <typename T, int N> void readArray(const std::string& path,
           size_t pos, blitz::Array<T,N>& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         (*m_cwd)[path]->readArray(pos, value);
       }
 
@@ -218,6 +237,7 @@ namespace bob { namespace io {
        */
       template <typename T, int N> blitz::Array<T,N> readArray
         (const std::string& path, size_t pos) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         return (*m_cwd)[path]->readArray<T,N>(pos);
       }
 
@@ -242,12 +262,48 @@ namespace bob { namespace io {
           return readArray<T,N>(path, 0);
       }
 
+      /**
+       * Reads value.extent(0) consecutive objects (or rows) of a dataset,
+       * starting at position pos, with a single read operation. The first
+       * dimension of the array indexes the objects, the remaining ones should
+       * match the shape of each object in the dataset (a 1D array reads
+       * scalars). Relative paths are accepted.
+       */
+      template <typename T, int N> void readRows(const std::string& path,
+          size_t pos, blitz::Array<T,N>& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
+        (*m_cwd)[path]->readRows(pos, value);
+      }
+
+      /**
+       * Reads count consecutive objects (or rows) of a dataset, starting at
+       * position pos. The destination array is allocated internally and
+       * returned by value. Its first dimension indexes the objects read.
+       */
+      template <typename T, int N> blitz::Array<T,N> readRows
+        (const std::string& path, size_t pos, size_t count) {
+          const bob::io::HDF5Shape& S = describe(path)[0].type.shape();
+          blitz::TinyVector<int,N> shape;
+          shape = 1;
+          shape(0) = count;
+          if (N > 1) {
+            if (S.n() != N-1) 
+              throw bob::io::HDF5IncompatibleIO(filename(), 
+                  describe(path)[0].type.str(), "rows of another rank");
+            for (int k=1; k<N; ++k) shape(k) = S[k-1];
+          }
+          blitz::Array<T,N> retval(shape);
+          readRows(path, pos, retval);
+          return retval;
+        }
+
       /**
        * Modifies the value of a scalar inside the file. Relative paths are
        * accepted.
        */
       template <typename T> void replace(const std::string& path, size_t pos,
           const T& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot replace value at dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -272,6 +328,7 @@ namespace bob { namespace io {
        */
       template <typename T> void replaceArray(const std::string& path,
           size_t pos, const T& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot replace array at dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -296,6 +353,7 @@ namespace bob { namespace io {
        */
       template <typename T> void append(const std::string& path,
           const T& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot append value to dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -317,6 +375,7 @@ namespace bob { namespace io {
        */
       template <typename T> void appendArray(const std::string& path,
           const T& value, size_t compression=0) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot append array to dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -326,12 +385,73 @@ namespace bob { namespace io {
         (*m_cwd)[path]->addArray(value);
       }
 
+      /**
+       * Modifies value.extent(0) consecutive objects (or rows) of a dataset,
+       * starting at position pos, with a single write operation. The
+       * conditions for readRows(path, pos, value) apply.
+       */
+      template <typename T, int N> void replaceRows(const std::string& path,
+          size_t pos, const blitz::Array<T,N>& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
+        if (!m_file->writeable()) {
+          boost::format m("cannot replace rows at dataset '%s' at path '%s' of file '%s' because it is not writeable");
+          m % path % m_cwd->path() % m_file->filename();
+          throw std::runtime_error(m.str());
+        }
+        (*m_cwd)[path]->replaceRows(pos, value);
+      }
+
+      /**
+       * Appends all the objects (or rows) indexed by the first dimension of
+       * the given array to a dataset, extending it only once. If the dataset
+       * does not yet exist, one is created with the type characteristics of
+       * a single row. Relative paths are accepted.
+       *
+       * If a new Dataset is to be created, you can also set the compression
+       * level and the number of rows per chunk (zero lets the chunks hold
+       * about 64 KiB). These settings have no effect if the Dataset already
+       * exists on file.
+       */
+      template <typename T, int N> void appendRows(const std::string& path,
+          const blitz::Array<T,N>& value, size_t compression=0,
+          size_t chunk_rows=0) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
+        if (!m_file->writeable()) {
+          boost::format m("cannot append rows to dataset '%s' at path '%s' of file '%s' because it is not writeable");
+          m % path % m_cwd->path() % m_file->filename();
+          throw std::runtime_error(m.str());
+        }
+        if (!contains(path)) {
+          //the dataset is created for the objects (rows) of the block
+          const bob::io::HDF5Type block(value);
+          bob::io::HDF5Shape row(block.shape());
+          row <<= 1;
+          m_cwd->create_dataset(path, (N == 1) ? 
+              bob::io::HDF5Type(block.type()) : 
+              bob::io::HDF5Type(block.type(), row), true, compression, 
+              chunk_rows);
+        }
+        (*m_cwd)[path]->addRows(value);
+      }
+
+      /**
+       * Sets the chunk cache of an existing dataset (see
+       * H5Pset_chunk_cache()): the number of chunk slots (a prime number,
+       * about 100 times the number of chunks fitting in the cache), the
+       * total size in bytes and the preemption policy w0 (between 0 and 1,
+       * use 1 if chunks are accessed only once). This setting is not stored
+       * in the file.
+       */
+      void setChunkCache(const std::string& path, size_t nslots,
+          size_t nbytes, double w0=0.75);
+
       /**
        * Sets the scalar at position 0 to the given value. This method is
        * equivalent to checking if the scalar at position 0 exists and then
        * replacing it. If the path does not exist, we append the new scalar.
        */
       template <typename T> void set(const std::string& path, const T& value) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot set value at dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -354,6 +474,7 @@ namespace bob { namespace io {
        */
       template <typename T> void setArray(const std::string& path,
           const T& value, size_t compression=0) {
+        boost::lock_guard<boost::recursive_mutex> lock(mutex());
         if (!m_file->writeable()) {
           boost::format m("cannot set array at dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
@@ -370,7 +491,7 @@ namespace bob { namespace io {
        * existing data is compatible with the required type.
        */
       void create (const std::string& path, const HDF5Type& dest, bool list,
-          size_t compression);
+          size_t compression, size_t chunk_rows=0);
 
       /**
        * Reads data from the file into a buffer. The given buffer contains
@@ -394,6 +515,28 @@ namespace bob { namespace io {
       void extend_buffer (const std::string& path,
           const HDF5Type& type, const void* buffer);
 
+      /**
+       * Reads consecutive objects of the file into a buffer. The first
+       * dimension of "type" is the number of objects to read, the remaining
+       * ones describe each object.
+       */
+      void read_rows_buffer (const std::string& path, size_t pos,
+          const HDF5Type& type, void* buffer) const;
+
+      /**
+       * Writes consecutive objects into the file, described as for
+       * read_rows_buffer().
+       */
+      void write_rows_buffer (const std::string& path, size_t pos,
+          const HDF5Type& type, const void* buffer);
+
+      /**
+       * Extend the dataset with all objects of the buffer, described as for
+       * read_rows_buffer().
+       */
+      void extend_rows_buffer (const std::string& path,
+          const HDF5Type& type, const void* buffer);
+
       /**
        * Copy construct an already opened HDF5File; just creates a shallow copy
        * of the file
@@ -421,6 +564,7 @@ namespace bob { namespace io {
       template <typename T>
         void getAttribute(const std::string& path, const std::string& name, 
             T& value) const {
+          boost::lock_guard<boost::recursive_mutex> lock(mutex());
           if (m_cwd->has_dataset(path)) {
             value = (*m_cwd)[path]->get_attribute<T>(name);
           }
@@ -442,6 +586,7 @@ namespace bob { namespace io {
       template <typename T, int N>
         void getArrayAttribute(const std::string& path, 
             const std::string& name, blitz::Array<T,N>& value) const {
+          boost::lock_guard<boost::recursive_mutex> lock(mutex());
           if (m_cwd->has_dataset(path)) {
             value = (*m_cwd)[path]->get_array_attribute<T,N>(name);
           }
@@ -461,6 +606,7 @@ namespace bob { namespace io {
       template <typename T>
         void setAttribute(const std::string& path, const std::string& name, 
             const T value) {
+          boost::lock_guard<boost::recursive_mutex> lock(mutex());
           if (m_cwd->has_dataset(path)) {
             (*m_cwd)[path]->set_attribute(name, value);
           }
@@ -480,6 +626,7 @@ namespace bob { namespace io {
       template <typename T, int N>
         void setArrayAttribute(const std::string& path,
             const std::string& name, const blitz::Array<T,N>& value) {
+          boost::lock_guard<boost::recursive_mutex> lock(mutex());
           if (m_cwd->has_dataset(path)) {
             (*m_cwd)[path]->set_array_attribute(name, value);
           }
@@ -201,13 +201,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * of dimensions of the input type.
        *
        * When you set "list" to true (the default), datasets are created with
-       * chunking automatically enabled (the chunk size is set to the size of
-       * the given variable) and an extra dimension is inserted to accomodate
-       * list operations.
+       * chunking automatically enabled ("chunk_rows" variables per chunk, or
+       * about 64 KiB if zero) and an extra dimension is inserted to
+       * accomodate list operations.
        */
       virtual boost::shared_ptr<Dataset> create_dataset
         (const std::string& path, const bob::io::HDF5Type& type, bool list=true,
-         size_t compression=0);
+         size_t compression=0, size_t chunk_rows=0);
 
       /**
        * Deletes a dataset in this group
@@ -0,0 +1,219 @@
+/**
+ * @file bob/io/ImageLoader.h
+ * @date Sun Oct 18 20:14:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Decodes lists of image files on a pool of background threads
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_IMAGELOADER_H
+#define BOB_IO_IMAGELOADER_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+#include <blitz/array.h>
+#include <bob/core/ordered_ring.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * Decodes a list of 8-bit image files on a pool of background workers.
+   * Decoded images are kept in a bounded ring and handed to the consumer
+   * in file order, so that decoding the next files overlaps with the
+   * processing of the current one. Worker 'w' decodes files 'w', 'w + W',
+   * 'w + 2W', ... (where W is the number of workers).
+   *
+   * All images are delivered in the same layout, whatever the colorspace
+   * of the files:
+   *
+   * - planar: (color-bands, height, width) RGB arrays, as bob::io::load()
+   *   returns for color images. Gray-scale images are replicated on the
+   *   three bands.
+   * - interleaved: (height, width, color-bands) RGB arrays, in the order
+   *   decoders produce pixels
+   * - gray: (height, width) arrays. Color images are converted with the
+   *   weights of libjpeg (0.299 R + 0.587 G + 0.114 B).
+   *
+   * JPEG and PNG files are decoded with dedicated routines, which write
+   * the decoded rows straight into the delivered arrays (except for the
+   * planar layout, which needs re-ordering), and let the decoders do the
+   * color conversions: JPEG images delivered in gray are decoded from the
+   * luminance channel only. If a maximum size is given, JPEG images are
+   * also scaled down in the DCT domain, by the largest factor (2, 4 or 8)
+   * that keeps them at least that large: callers resizing images further
+   * get the same result for a fraction of the decoding time. Other formats
+   * are read through their regular codecs (see bob::io::open()) and
+   * converted afterwards, at full size. Some of these codecs keep global
+   * state (e.g. the error handling of netpbm and giflib), so the workers
+   * take turns on them.
+   */
+  class ImageLoader {
+
+    public: //api
+
+      /**
+       * Layouts of the delivered images
+       */
+      typedef enum layout_t {
+        planar = 0,
+        interleaved = 1,
+        gray = 2
+      } layout_t;
+
+      /**
+       * Initializes the loader. Background workers are only started on the
+       * first call to next() or after start().
+       *
+       * @param filenames The image files to decode, in delivery order
+       * @param layout The layout of the delivered images
+       * @param n_workers The number of background threads decoding files.
+       * If zero, uses as many threads as the machine has cores.
+       * @param queue_size The maximum number of decoded files kept ready
+       * @param max_height The height the caller needs at most, or zero
+       * @param max_width The width the caller needs at most, or zero
+       */
+      ImageLoader(const std::vector<std::string>& filenames,
+          layout_t layout=planar, size_t n_workers=0, size_t queue_size=8,
+          size_t max_height=0, size_t max_width=0);
+
+      /**
+       * D'tor: stops all workers
+       */
+      virtual ~ImageLoader();
+
+      /**
+       * The number of files to be decoded
+       */
+      inline size_t size() const { return m_filenames.size(); }
+
+      /**
+       * The name of the i-th file
+       */
+      inline const std::string& getFilename(size_t i) const
+      { return m_filenames[i]; }
+
+      /**
+       * The layout of the delivered images
+       */
+      inline layout_t layout() const { return m_layout; }
+
+      /**
+       * The maximum size requested for JPEG images (zero if not limited)
+       */
+      inline size_t getMaxHeight() const { return m_max_height; }
+      inline size_t getMaxWidth() const { return m_max_width; }
+
+      /**
+       * The number of files delivered by next() so far. This is also the
+       * index of the file next() will deliver.
+       */
+      inline size_t getPosition() const { return m_ring.position(); }
+
+      /**
+       * The number of background workers
+       */
+      inline size_t getNumberOfWorkers() const { return m_n_workers; }
+
+      /**
+       * The maximum number of decoded files kept ready
+       */
+      inline size_t getQueueSize() const { return m_ring.size(); }
+
+      /**
+       * Starts the background workers, if they are not running already
+       */
+      void start();
+
+      /**
+       * Stops the background workers and discards decoded files. The next
+       * call to next() or start() restarts from the first file.
+       */
+      void stop();
+
+      /**
+       * Makes 'data' refer to the next image, waiting for it if necessary.
+       * The image is not copied. This is only available for the planar and
+       * interleaved layouts. Returns false if all files were already
+       * delivered, leaving 'data' untouched.
+       *
+       * Exceptions raised by the workers (e.g. while reading files) are
+       * re-thrown here when the file that failed is reached: all files
+       * before it are delivered first. Later calls raise the same error,
+       * until stop() is called.
+       */
+      bool next(blitz::Array<uint8_t,3>& data);
+
+      /**
+       * Makes 'data' refer to the next image, for the gray layout. See the
+       * other overload for details.
+       */
+      bool next(blitz::Array<uint8_t,2>& data);
+
+      /**
+       * Decodes a single file on the calling thread, with the layout and
+       * maximum size of this loader. The output array is resized.
+       */
+      void load(const std::string& filename,
+          blitz::Array<uint8_t,3>& data) const;
+
+      /**
+       * Decodes a single file for the gray layout. See the other overload.
+       */
+      void load(const std::string& filename,
+          blitz::Array<uint8_t,2>& data) const;
+
+    private: //helpers
+
+      /**
+       * A slot in the ring of decoded files
+       */
+      struct Slot {
+        blitz::Array<uint8_t,3> color;
+        blitz::Array<uint8_t,2> gray;
+      };
+
+      void worker(size_t id);
+      void decode(const std::string& filename, blitz::Array<uint8_t,3>& color,
+          blitz::Array<uint8_t,2>& gray) const;
+      Slot* wait();
+
+      ImageLoader(const ImageLoader&);
+      ImageLoader& operator= (const ImageLoader&);
+
+    private: //representation
+
+      std::vector<std::string> m_filenames;
+      layout_t m_layout;
+      size_t m_n_workers; ///< the number of background threads
+      size_t m_max_height;
+      size_t m_max_width;
+
+      bob::core::OrderedRing<Slot> m_ring; ///< decoded files
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_IMAGELOADER_H */
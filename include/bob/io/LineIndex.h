@@ -0,0 +1,129 @@
+/**
+ * @file bob/io/LineIndex.h
+ * @date Sun Oct 18 17:35:21 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Fast access to the lines of (large) text files and fast parsing of
+ * the numbers they contain.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_LINEINDEX_H
+#define BOB_IO_LINEINDEX_H
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <bob/io/MappedFile.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * Maps a text file read-only in memory and locates the start of all its
+   * lines. Large files are split in as many blocks as threads, which are
+   * scanned concurrently. Lines are accessed as [begin, end) character
+   * ranges inside the mapping, without the line terminator ("\n" or
+   * "\r\n"). A terminator at the very end of the file does not start an
+   * extra (empty) line.
+   *
+   * Callers parsing the lines on several threads may access distinct lines
+   * concurrently, as this object is never modified after construction.
+   */
+  class LineIndex {
+
+    public: //api
+
+      /**
+       * Maps and indexes the given file
+       *
+       * @param filename The text file to read
+       * @param n_threads The number of threads scanning the file. If zero,
+       * uses as many threads as the machine has cores.
+       */
+      LineIndex(const std::string& filename, size_t n_threads=0);
+
+      virtual ~LineIndex();
+
+      /**
+       * The name of the indexed file
+       */
+      inline const std::string& filename() const
+      { return m_file->filename(); }
+
+      /**
+       * The number of lines in the file
+       */
+      inline size_t size() const { return m_start.size() - 1; }
+
+      /**
+       * The number of threads that should be used to process the lines of
+       * this file, which is at most the one given at construction. Small
+       * files are processed by a single thread.
+       */
+      inline size_t getNThreads() const { return m_n_threads; }
+
+      /**
+       * The first character of the i-th line
+       */
+      inline const char* begin(size_t i) const {
+        return static_cast<const char*>(m_file->data()) + m_start[i];
+      }
+
+      /**
+       * One past the last character of the i-th line, excluding the line
+       * terminator
+       */
+      inline const char* end(size_t i) const {
+        const char* e = static_cast<const char*>(m_file->data()) +
+          m_start[i+1] - 1;
+        if (e > begin(i) && *(e-1) == '\r') --e;
+        return e;
+      }
+
+    private: //helpers
+
+      void scan(size_t begin, size_t end, std::vector<size_t>& start) const;
+
+    private: //representation
+
+      boost::shared_ptr<MappedFile> m_file;
+      std::vector<size_t> m_start; ///< line starts, plus the end of file + 1
+      size_t m_n_threads;
+
+  };
+
+  /**
+   * Parses a floating-point number in [begin, end), with the same syntax
+   * and the same (correctly rounded) results as std::strtod() in the "C"
+   * locale. Leading and trailing spaces are not accepted. Returns false if
+   * the characters do not form a single number.
+   *
+   * Decimal numbers with up to 15 significant digits and small exponents,
+   * which cover most numbers written by programs, are converted exactly
+   * without calling std::strtod().
+   */
+  bool parse_double(const char* begin, const char* end, double& value);
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_LINEINDEX_H */
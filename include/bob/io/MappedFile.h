@@ -0,0 +1,149 @@
+/**
+ * @file bob/io/MappedFile.h
+ * @date Sun Oct 18 16:48:09 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Read-only memory mapping of raw array files and array interfaces
+ * pointing into such mappings.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_MAPPEDFILE_H
+#define BOB_IO_MAPPEDFILE_H
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <bob/core/array.h>
+#include <bob/io/File.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * A whole file mapped in memory. Pages are loaded on demand by the
+   * operating system and shared with all other processes mapping or
+   * reading the same file. The mapping is copy-on-write: pages written to
+   * are copied privately, and the file itself is never modified.
+   */
+  class MappedFile {
+
+    public: //api
+
+      /**
+       * Maps the given file
+       */
+      MappedFile(const std::string& filename);
+
+      /**
+       * Unmaps the file
+       */
+      virtual ~MappedFile();
+
+      /**
+       * The name of the mapped file
+       */
+      inline const std::string& filename() const { return m_filename; }
+
+      /**
+       * The size of the file, in bytes
+       */
+      inline size_t size() const { return m_size; }
+
+      /**
+       * The address at which the file starts
+       */
+      inline const void* data() const { return m_data; }
+
+      /**
+       * Checks that 'length' bytes starting at 'offset' are inside the file
+       * and returns their address
+       */
+      const void* data(size_t offset, size_t length) const;
+
+      /**
+       * Tells the operating system how the mapping is going to be read
+       */
+      void advise(bob::io::File::access_t pattern) const;
+
+    private: //not implemented
+
+      MappedFile(const MappedFile&);
+      MappedFile& operator= (const MappedFile&);
+
+    private: //representation
+
+      std::string m_filename;
+      size_t m_size;
+      void* m_data;
+
+  };
+
+  /**
+   * An array interface pointing into a MappedFile, which cannot be reset
+   * to other data (see set()). The mapping is kept alive for as long as
+   * this object or its owner() is. The elements may be laid out with any
+   * strides, as described by type().
+   *
+   * @warning Elements written through ptr() are only changed in this
+   * process (and for all arrays mapped from the same MappedFile): they are
+   * never written back to the file. Calling any of the set() methods
+   * raises.
+   */
+  class MappedArray: public bob::core::array::interface {
+
+    public: //api
+
+      /**
+       * Refers to the array described by 'info', starting 'offset' bytes
+       * from the beginning of the mapped file.
+       */
+      MappedArray(boost::shared_ptr<MappedFile> file, size_t offset,
+          const bob::core::array::typeinfo& info);
+
+      virtual ~MappedArray();
+
+      /**
+       * Read-only interface: these raise a std::runtime_error
+       */
+      virtual void set(const bob::core::array::interface& other);
+      virtual void set(boost::shared_ptr<bob::core::array::interface> other);
+      virtual void set(const bob::core::array::typeinfo& req);
+
+      virtual const bob::core::array::typeinfo& type() const { return m_type; }
+
+      virtual void* ptr() { return m_ptr; }
+      virtual const void* ptr() const { return m_ptr; }
+
+      virtual boost::shared_ptr<void> owner() { return m_file; }
+      virtual boost::shared_ptr<const void> owner() const { return m_file; }
+
+    private: //representation
+
+      boost::shared_ptr<MappedFile> m_file;
+      bob::core::array::typeinfo m_type;
+      void* m_ptr;
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_MAPPEDFILE_H */
@@ -0,0 +1,223 @@
+/**
+ * @file bob/io/PrefetchingVideoReader.h
+ * @date Sun Oct 18 18:32:10 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Reads videos decoding frames ahead on a background thread
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_PREFETCHINGVIDEOREADER_H
+#define BOB_IO_PREFETCHINGVIDEOREADER_H
+
+#include <string>
+#include <vector>
+#include <blitz/array.h>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+
+#include <bob/core/array.h>
+#include <bob/core/ordered_ring.h>
+#include <bob/io/VideoReader.h>
+
+namespace bob { namespace io {
+  /**
+   * @ingroup IO
+   * @{
+   */
+
+  /**
+   * Reads a video sequentially, from the first to the last frame, decoding
+   * frames ahead on a background thread. Decoded frames are kept in a
+   * bounded ring, so that decoding the next frames overlaps with the
+   * processing of the current one. The codec itself may also use several
+   * threads, if it supports frame or slice threading.
+   *
+   * Frames can be delivered in one of these layouts:
+   *
+   * - planar: (color-bands, height, width) RGB arrays, as VideoReader does
+   * - interleaved: (height, width, color-bands) RGB arrays, as converted by
+   *   the scaler, which saves the re-ordering of planar frames
+   * - gray: (height, width) arrays with the luminance (Y) plane of the
+   *   decoded pictures. For the usual YUV pixel formats, the plane is
+   *   copied as decoded, without any color conversion. Note this means
+   *   values are in the range the codec uses, mostly [16, 235].
+   *
+   * The color conversion is done on the background thread, with the
+   * interpolation method selected by the scaler setting. As frames have
+   * the size of the video, the interpolation only affects the chroma
+   * planes, which are sub-sampled by most codecs: cheaper methods than the
+   * default (bicubic, as for VideoReader) give slightly different colors.
+   */
+  class PrefetchingVideoReader {
+
+    public: //api
+
+      /**
+       * Layouts of the delivered frames
+       */
+      typedef enum layout_t {
+        planar = 0,
+        interleaved = 1,
+        gray = 2
+      } layout_t;
+
+      /**
+       * Interpolation methods for the color conversion, from the most
+       * precise to the fastest
+       */
+      typedef enum scaler_t {
+        bicubic = 0,
+        bilinear = 1,
+        fast_bilinear = 2,
+        area = 3,
+        point = 4
+      } scaler_t;
+
+      /**
+       * Opens a video file. The background thread is only started on the
+       * first read or after start().
+       *
+       * @param filename The video file to read
+       * @param layout The layout of the delivered frames
+       * @param queue_size The maximum number of decoded frames kept ready
+       * @param n_threads The number of threads the codec may use. If zero,
+       * uses as many threads as the machine has cores.
+       * @param scaler The interpolation method for the color conversion
+       * @param check Checks if the format and codec of the file are
+       * supported, see VideoReader
+       */
+      PrefetchingVideoReader(const std::string& filename,
+          layout_t layout=planar, size_t queue_size=8, size_t n_threads=0,
+          scaler_t scaler=bicubic, bool check=true);
+
+      /**
+       * D'tor: stops the background thread
+       */
+      virtual ~PrefetchingVideoReader();
+
+      /**
+       * Information about the video being read
+       */
+      inline const VideoReader& video() const { return m_video; }
+
+      /**
+       * Returns the number of frames available in this video stream
+       */
+      inline size_t numberOfFrames() const
+      { return m_video.numberOfFrames(); }
+
+      /**
+       * The layout of the delivered frames
+       */
+      inline layout_t layout() const { return m_layout; }
+
+      /**
+       * The interpolation method of the color conversion
+       */
+      inline scaler_t scaler() const { return m_scaler; }
+
+      /**
+       * Returns the typing information of the delivered frames
+       */
+      inline const bob::core::array::typeinfo& frame_type() const
+      { return m_typeinfo_frame; }
+
+      /**
+       * The number of threads the codec may use
+       */
+      inline size_t getNumberOfThreads() const { return m_n_threads; }
+
+      /**
+       * The maximum number of decoded frames kept ready
+       */
+      inline size_t getQueueSize() const { return m_ring.size(); }
+
+      /**
+       * The number of frames delivered so far, which is also the number of
+       * the next frame to be delivered
+       */
+      inline size_t getPosition() const { return m_ring.position(); }
+
+      /**
+       * Starts the background thread, if it is not running already
+       */
+      void start();
+
+      /**
+       * Stops the background thread and discards decoded frames. The next
+       * read restarts from the first frame.
+       */
+      void stop();
+
+      /**
+       * Makes 'data' refer to the next frame, waiting for it if necessary.
+       * The frame is not copied. This is only available for the planar and
+       * interleaved layouts. Returns false at the end of the video.
+       *
+       * The flag 'throw_on_error' controls the error reporting behavior, as
+       * in VideoReader: by default, decoding errors silently truncate the
+       * video. If you set it to 'true', they are raised here.
+       */
+      bool next(blitz::Array<uint8_t,3>& data, bool throw_on_error=false);
+
+      /**
+       * Makes 'data' refer to the next frame, for the gray layout. See the
+       * other overload for details.
+       */
+      bool next(blitz::Array<uint8_t,2>& data, bool throw_on_error=false);
+
+      /**
+       * Copies the next frame into a buffer, resizing it if its type does
+       * not match frame_type(). See next() for details.
+       */
+      bool read(bob::core::array::interface& data,
+          bool throw_on_error=false);
+
+    private: //helpers
+
+      /**
+       * A slot in the ring of decoded frames
+       */
+      struct Slot {
+        blitz::Array<uint8_t,3> color;
+        blitz::Array<uint8_t,2> gray;
+      };
+
+      void decoder();
+      Slot* wait(bool throw_on_error);
+
+      PrefetchingVideoReader(const PrefetchingVideoReader&);
+      PrefetchingVideoReader& operator= (const PrefetchingVideoReader&);
+
+    private: //representation
+
+      VideoReader m_video;
+      layout_t m_layout;
+      scaler_t m_scaler;
+      size_t m_n_threads;
+      bob::core::array::typeinfo m_typeinfo_frame;
+
+      bob::core::OrderedRing<Slot> m_ring; ///< decoded frames
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_IO_PREFETCHINGVIDEOREADER_H */
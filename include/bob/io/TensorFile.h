@@ -26,6 +26,7 @@
 #include <bob/core/blitz_array.h>
 #include <bob/io/TensorFileHeader.h>
 #include <bob/io/Exception.h>
+#include <bob/io/MappedFile.h>
 
 namespace bob { namespace io {
 
@@ -103,6 +104,24 @@ namespace bob { namespace io {
        */
       void read (size_t index, bob::core::array::interface& data);
 
+      /**
+       * Returns the array at the given index. Files opened read-only are
+       * mapped in memory and, if the mapped elements are suitably aligned,
+       * the returned array points directly into the mapping. As tensors are
+       * stored in column-major order, such arrays are not C-contiguous:
+       * their strides are the ones of a Fortran array. Otherwise, the array
+       * is read into a new (C-contiguous) buffer.
+       */
+      boost::shared_ptr<bob::core::array::interface> view(size_t index);
+
+      /**
+       * Tells the operating system how the arrays of a file opened read-only
+       * are going to be read
+       */
+      inline void advise(bob::io::File::access_t pattern) const {
+        if (m_mapping) m_mapping->advise(pattern);
+      }
+
       /**
        * Peeks the file and returns the currently set typeinfo
        */
@@ -216,6 +235,7 @@ namespace bob { namespace io {
       detail::TensorFileHeader m_header;
       openmode m_openmode;
       boost::shared_ptr<void> m_buffer; 
+      boost::shared_ptr<MappedFile> m_mapping; ///< set if read-only
   };
 
   inline _TensorFileFlag operator&(_TensorFileFlag a, _TensorFileFlag b) { 
@@ -25,6 +25,7 @@
 #define BOB_IO_VIDEOREADER_H
 
 #include <string>
+#include <vector>
 #include <blitz/array.h>
 #include <stdint.h>
 
@@ -56,8 +57,14 @@ namespace bob { namespace io {
        * combination of format and codec are known to work and have been
        * tested, otherwise an exception is raised. If you set 'check' to
        * 'false', though, we will ignore this check.
+       *
+       * If 'cache_index' is set, the keyframe index (see keyframes()) is
+       * saved next to the video file, in a file with the same name and the
+       * extension ".keyframes" appended, and read from there the next time
+       * the video is opened, if the video was not modified meanwhile.
        */
-      VideoReader(const std::string& filename, bool check=true);
+      VideoReader(const std::string& filename, bool check=true,
+          bool cache_index=false);
 
       /**
        * Opens a new Video stream copying information from another VideoStream
@@ -145,6 +152,19 @@ namespace bob { namespace io {
       inline const bob::core::array::typeinfo& frame_type() const 
       { return m_typeinfo_frame; }
 
+      /**
+       * Returns the numbers of the keyframes of the video stream: frames
+       * that can be decoded without any other, and from which decoding can
+       * start after a seek. The index is built by scanning (but not
+       * decoding) the whole file on the first call, unless it is cached.
+       */
+      const std::vector<size_t>& keyframes() const;
+
+      /**
+       * Tells if the keyframe index is cached next to the video file
+       */
+      inline bool cacheIndex() const { return m_cache_index; }
+
       /**
        * Loads all of the video stream in a blitz array organized in this way:
        * (frames, color-bands, height, width). The 'data' parameter will be
@@ -186,6 +206,16 @@ namespace bob { namespace io {
        */
       void open(const std::string& filename, bool check);
 
+      /**
+       * Builds the keyframe index or loads it from the cache
+       */
+      void index() const;
+
+      /**
+       * The decoding timestamps of the keyframes
+       */
+      const std::vector<int64_t>& keyframeTimestamps() const;
+
     public: //iterators
 
       /**
@@ -234,13 +264,23 @@ namespace bob { namespace io {
           //const_iterator operator++ (int); //too inefficient!
 
           /**
-           * Fast-forward the video readout by N frames, return self. This
-           * implementation is slow because of ffmpeg limitations. It has no
-           * precise frame lookup function. What we have to do is to read
-           * frame-by-frame and stop when you want to.
+           * Fast-forward the video readout by N frames, return self. If a
+           * keyframe lies on the way, this seeks to the last one before the
+           * target frame (see seek()), otherwise frames are decoded one by
+           * one.
            */
           const_iterator& operator+= (size_t frames);
 
+          /**
+           * Moves to the given frame, forwards or backwards, return self.
+           * The stream is positioned on the closest keyframe before the
+           * frame, using the keyframe index of the parent (see
+           * VideoReader::keyframes()), and only the frames between this
+           * keyframe and the target are decoded. Seeking past the end
+           * points to "end".
+           */
+          const_iterator& seek(size_t frame);
+
           /**
            * Compares two iterators for equality
            */
@@ -380,6 +420,10 @@ namespace bob { namespace io {
       std::string m_formatted_info; ///< printable information about the video
       bob::core::array::typeinfo m_typeinfo_video; ///< read whole video type
       bob::core::array::typeinfo m_typeinfo_frame; ///< read single frame type
+      bool m_cache_index; ///< shall I cache the keyframe index?
+      mutable bool m_indexed; ///< was the keyframe index built?
+      mutable std::vector<size_t> m_keyframes; ///< keyframe numbers
+      mutable std::vector<int64_t> m_keyframe_ts; ///< keyframe timestamps
   };
 
 }}
@@ -113,7 +113,9 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
    ************************************************************************/
 
   /**
-   * Creates a new codec context and verify all is good.
+   * Creates a new codec context and verify all is good. If 'n_threads' is
+   * greater than 1, the codec is allowed to use as many threads, working on
+   * several frames (or on slices of the same frame) at once, if it can.
    *
    * @note The returned object knows how to correctly delete itself, freeing
    * all acquired resources. Nonetheless, when this object is used in
@@ -121,11 +123,13 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
    * respected.
    */
   boost::shared_ptr<AVCodecContext> make_codec_context(
-      const std::string& filename, AVStream* stream, AVCodec* codec);
+      const std::string& filename, AVStream* stream, AVCodec* codec,
+      size_t n_threads=1);
 
   /**
    * Allocates the software scaler that handles size and pixel format
-   * conversion.
+   * conversion. 'flags' selects the interpolation method (one of the SWS_*
+   * constants of libswscale).
    *
    * @note The returned object knows how to correctly delete itself, freeing
    * all acquired resources. Nonetheless, when this object is used in
@@ -134,7 +138,8 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
    */
   boost::shared_ptr<SwsContext> make_scaler(const std::string& filename,
       boost::shared_ptr<AVCodecContext> stream, 
-      PixelFormat source_pixel_format, PixelFormat dest_pixel_format);
+      PixelFormat source_pixel_format, PixelFormat dest_pixel_format,
+      int flags=SWS_BICUBIC);
 
   /**
    * Allocates a frame for a particular context. The frame space will be
@@ -214,6 +219,32 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
       boost::shared_ptr<AVCodecContext> codec_context,
       boost::shared_ptr<AVFrame> context_frame, bool throw_on_error);
 
+  /**
+   * Scans all packets of the video stream, without decoding them, and lists
+   * the keyframes (pictures that can be decoded without any other). For
+   * each keyframe, 'frames' receives its frame number and 'timestamps' its
+   * decoding timestamp, in units of the stream time base, as required by
+   * seek_keyframe(). Returns the number of frames in the stream.
+   *
+   * Frame numbers are counted in decoding order, which is also the display
+   * order of keyframes in streams made of closed groups of pictures (the
+   * ones written by usual encoders).
+   */
+  size_t index_keyframes(const std::string& filename,
+      boost::shared_ptr<AVFormatContext> format_context, int stream_index,
+      std::vector<size_t>& frames, std::vector<int64_t>& timestamps);
+
+  /**
+   * Positions the stream on the keyframe with the given timestamp (see
+   * index_keyframes()) and drops all pictures buffered in the decoder, so
+   * that the next frame read is that keyframe.
+   *
+   * @return true if the seek succeeded or false otherwise.
+   */
+  bool seek_keyframe(const std::string& filename, int64_t timestamp,
+      int stream_index, boost::shared_ptr<AVFormatContext> format_context,
+      boost::shared_ptr<AVCodecContext> codec_context, bool throw_on_error);
+
   /************************************************************************
    * Video writing specific utilities
    ************************************************************************/
@@ -273,7 +304,8 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
 
   /**
    * Flushes frames which are buffered on the given encoder stream. This only
-   * happens if (codec->capabilities & CODEC_CAP_DELAY) is true.
+   * happens if (codec->capabilities & CODEC_CAP_DELAY) is true, or if the
+   * encoder works on several frames at once (frame threading).
    */
   void flush_encoder(const std::string& filename,
       boost::shared_ptr<AVFormatContext> format_context,
@@ -298,6 +330,24 @@ namespace bob { namespace io { namespace detail { namespace ffmpeg {
     boost::shared_array<uint8_t> buffer,
     size_t buffer_size);
 
+  /**
+   * Writes a data frame given as image planes into the encoder stream. The
+   * planes are in the source pixel format of the scaler (e.g. a single
+   * plane for packed RGB24 or GRAY8 data) and are converted without any
+   * intermediate copy.
+   *
+   * @note See the other overload about encoders with delay.
+   */
+  void write_video_frame (const uint8_t* const planes[],
+    const int linesize[],
+    const std::string& filename,
+    boost::shared_ptr<AVFormatContext> format_context,
+    boost::shared_ptr<AVStream> stream,
+    boost::shared_ptr<AVFrame> context_frame,
+    boost::shared_ptr<SwsContext> swscaler,
+    boost::shared_array<uint8_t> buffer,
+    size_t buffer_size);
+
 
 }}}}
 
@@ -24,18 +24,50 @@
 #ifndef BOB_IO_VIDEOWRITER_H
 #define BOB_IO_VIDEOWRITER_H
 
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
 #include <bob/core/array.h>
+#include <bob/core/ordered_ring.h>
 #include <bob/io/VideoUtilities.h>
 
 namespace bob { namespace io {
 
   /**
    * Use objects of this class to create and write video files.
+   *
+   * Frames can be given in one of these layouts, which are told apart by
+   * their extents (video sizes are always even):
+   *
+   * - planar: (RGB color-bands, height, width) arrays
+   * - interleaved: (height, width, RGB color-bands) arrays, which are
+   *   converted to the encoder pixel format without re-ordering
+   * - gray: (height, width) arrays, encoded as a gray-scale video
+   *
+   * By default, frames are converted and encoded as they are appended. If
+   * a queue size is given, append() only copies the frame into a bounded
+   * queue and a dedicated thread encodes the queued frames, so that
+   * producers only wait for the encoder if the queue is full. Errors
+   * raised by the encoder are then reported by the next call to append(),
+   * flush() or close().
    */
   class VideoWriter {
 
     public:
 
+      /**
+       * Statistics about the frames encoded so far
+       */
+      struct Statistics {
+        size_t frames; ///< number of frames encoded
+        double encoding_time; ///< seconds spent converting and encoding
+        double mean_latency; ///< mean seconds from append() to encoded
+        double max_latency; ///< maximum seconds from append() to encoded
+        double blocked_time; ///< seconds append() waited for the queue
+      };
+
       /**
        * Default constructor, creates a new output file given the input
        * parameters. The codec to be used will be derived from the filename
@@ -58,11 +90,16 @@ namespace bob { namespace io {
        * and codec are known to work and have been tested, otherwise an
        * exception is raised. If you set 'check' to 'false', though, we will
        * ignore this check.
+       * @param queue_size The maximum number of frames waiting to be
+       * encoded by the background thread. If zero, frames are encoded as
+       * they are appended, without any background thread.
+       * @param n_threads The number of threads the codec may use, if it
+       * supports it. If zero, uses as many threads as the machine has cores.
        */
       VideoWriter(const std::string& filename, size_t height, size_t width,
           double framerate=25., double bitrate=1500000., size_t gop=12,
           const std::string& codec="", const std::string& format="",
-          bool check=true);
+          bool check=true, size_t queue_size=0, size_t n_threads=1);
 
       /**
        * Destructor virtualization
@@ -71,10 +108,17 @@ namespace bob { namespace io {
 
       /**
        * Closes the current video stream and forces writing the trailer. After
-       * this point the video becomes invalid.
+       * this point the video becomes invalid. Frames still queued are
+       * encoded first.
        */
       void close();
 
+      /**
+       * Waits until all queued frames are encoded. Raises if the encoder
+       * failed.
+       */
+      void flush();
+
       /**
        * Access to the filename
        */
@@ -113,10 +157,27 @@ namespace bob { namespace io {
       }
 
       /**
-       * Returns the current number of frames written
+       * Returns the current number of frames written (including frames
+       * still queued for encoding)
        */
       inline size_t numberOfFrames() const { return m_current_frame; }
 
+      /**
+       * The maximum number of frames waiting to be encoded (zero if frames
+       * are encoded as they are appended)
+       */
+      inline size_t getQueueSize() const { return m_ring ? m_ring->size() : 0; }
+
+      /**
+       * The number of threads the codec may use
+       */
+      inline size_t getNumberOfThreads() const { return m_n_threads; }
+
+      /**
+       * Statistics about the frames encoded so far
+       */
+      Statistics statistics() const;
+
       /**
        * Returns if the video is currently opened for writing
        */
@@ -160,27 +221,41 @@ namespace bob { namespace io {
        * blitz::Array<> with 4 dimensions organized in this way:
        * (frame-number, RGB color-bands, height, width).
        *
-       * \warning At present time we only support arrays that have C-style
-       * storages (if you pass reversed arrays or arrays with Fortran-style
-       * storage, the result is undefined).
+       * Arrays that are not C-style contiguous (slices, transposed views or
+       * arrays with Fortran-style storage) are copied to a C-style array
+       * first.
        */
       void append(const blitz::Array<uint8_t,4>& data);
     
       /**
        * Writes a new frame to the file. The frame should be setup as a
        * blitz::Array<> with 3 dimensions organized in this way (RGB
-       * color-bands, height, width).
+       * color-bands, height, width) or, interleaved, (height, width, RGB
+       * color-bands).
        *
-       * \warning At present time we only support arrays that have C-style
-       * storages (if you pass reversed arrays or arrays with Fortran-style
-       * storage, the result is undefined). 
+       * Arrays that are not C-style contiguous (slices, transposed views or
+       * arrays with Fortran-style storage) are copied to a C-style array
+       * first.
        */
       void append(const blitz::Array<uint8_t,3>& data);
 
+      /**
+       * Writes a new gray-scale frame to the file. The frame should be
+       * setup as a blitz::Array<> with 2 dimensions (height, width).
+       *
+       * Arrays that are not C-style contiguous (slices, transposed views or
+       * arrays with Fortran-style storage) are copied to a C-style array
+       * first.
+       */
+      void append(const blitz::Array<uint8_t,2>& data);
+
       /**
        * Writes a set of frames to the file. The frame set should be setup as a
        * bob::core::array::interface organized this way: (frame-number, 
        * RGB color-bands, height, width) or (RGB color-bands, height, width).
+       * Interleaved (height, width, RGB color-bands) frames, or sets of them,
+       * and single gray-scale (height, width) frames are also accepted. Sets
+       * of gray-scale frames are not: 3D arrays are always color frames.
        */
       void append(const bob::core::array::interface& data);
 
@@ -190,6 +265,34 @@ namespace bob { namespace io {
 
       VideoWriter& operator= (const VideoWriter& other);
 
+    private: //helpers
+
+      /**
+       * Layouts of the frames given by the user
+       */
+      typedef enum layout_t {
+        planar = 0,
+        interleaved = 1,
+        gray = 2
+      } layout_t;
+
+      /**
+       * A slot in the queue of frames to be encoded
+       */
+      struct Slot {
+        std::vector<uint8_t> data; ///< copy of the frame
+        layout_t layout;
+        boost::posix_time::ptime queued; ///< when the frame was appended
+      };
+
+      void check_opened() const;
+      layout_t frame_layout(size_t nd, const size_t* shape) const;
+      size_t frame_size(layout_t layout) const;
+      void push(const uint8_t* data, layout_t layout);
+      void write(const uint8_t* data, layout_t layout,
+          const boost::posix_time::ptime& queued);
+      void encoder();
+
     private: //representation
       
       std::string m_filename; ///< file being written
@@ -212,6 +315,15 @@ namespace bob { namespace io {
       bob::core::array::typeinfo m_typeinfo_video;
       bob::core::array::typeinfo m_typeinfo_frame;
       size_t m_current_frame;
+      size_t m_n_threads;
+      boost::shared_ptr<SwsContext> m_interleaved_scaler; ///< from RGB24
+      boost::shared_ptr<SwsContext> m_gray_scaler; ///< from GRAY8
+
+      boost::shared_ptr<bob::core::OrderedRing<Slot> > m_ring; ///< frames to be encoded (if queued)
+      size_t m_queued; ///< number of frames put in the queue
+      Statistics m_stats;
+      double m_total_latency; ///< sum of the latencies, in seconds
+      mutable boost::mutex m_mutex; ///< protects the statistics
 
   };
 
@@ -0,0 +1,513 @@
+/**
+ * @file bob/ip/DenseHOG.h
+ * @date Sun Oct 18 15:32:47 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Computes Histogram of Oriented Gradients (HOG) descriptors densely,
+ * for many windows of the same image, using integral histograms
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IP_DENSE_HOG_H
+#define BOB_IP_DENSE_HOG_H
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <blitz/array.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "bob/core/assert.h"
+#include "bob/core/array_copy.h"
+#include "bob/core/Exception.h"
+#include "bob/math/Exception.h"
+#include "bob/ip/block.h"
+#include "bob/ip/HOG.h"
+
+namespace bob {
+/**
+ * \ingroup libip_api
+ * @{
+ */
+  namespace ip {
+
+    /**
+      * @brief Class to extract Histogram of Gradients (HOG) descriptors
+      *   for many windows of the same image, for instance in a sliding
+      *   window detector.
+      *
+      * The gradients of the whole image are computed once by setImage(),
+      * and accumulated into one integral image per orientation bin (an
+      * integral histogram). The histogram of any rectangular cell is then
+      * obtained with four lookups per bin, independently of the size of the
+      * cell, and the cells shared by overlapping windows are never
+      * recomputed.
+      *
+      * The descriptors are the ones of the HOG extractor given at
+      * construction time (window size, cells, blocks and their
+      * normalization), up to two differences:
+      *  1) the gradients are the ones of the whole image, hence they are
+      *     centered at the boundaries of the windows which do not lie on
+      *     the boundaries of the image. A window covering the whole image
+      *     gets the descriptors of HOG::forward().
+      *  2) the sums of the integral histograms are not performed in the
+      *     same order as the ones of hogComputeHistogram_(), and the
+      *     results may differ from it by a few ULPs.
+      * Since HOG descriptors may be configured as dense-SIFT descriptors
+      * (full orientation, 4x4 cells of 8 bins, one L2Hys block), this also
+      * extracts dense-SIFT like descriptors on arbitrary grids.
+      */
+    template <typename T>
+    class DenseHOG
+    {
+      public:
+        /**
+          * @brief Constructor, which uses the configuration of the given
+          *   HOG extractor. The height and the width of this extractor are
+          *   the ones of the windows.
+          */
+        DenseHOG(const HOG<T>& hog);
+
+        /**
+          * @brief Copy constructor
+          */
+        DenseHOG(const DenseHOG& other);
+
+        /**
+          * @brief Destructor
+          */
+        virtual ~DenseHOG() {}
+
+        /**
+          * @brief Assignment operator
+          */
+        DenseHOG& operator=(const DenseHOG& other);
+
+        /**
+          * Getters
+          */
+        const HOG<T>& getHOG() const { return m_hog; }
+        size_t getHeight() const { return m_height; }
+        size_t getWidth() const { return m_width; }
+        size_t getNThreads() const { return m_n_threads; }
+        /**
+          * Setters
+          */
+        void setNThreads(const size_t n_threads)
+        { m_n_threads = std::max(n_threads, (size_t)1); }
+
+        /**
+          * @brief Computes the gradients of the image, and the integral
+          *   histograms of their orientations. The rows of the image are
+          *   distributed over getNThreads() threads.
+          */
+        void setImage(const blitz::Array<T,2>& image);
+
+        /**
+          * @brief Computes the histogram of the gradients of the cell of the
+          *   current image, whose top left corner is (y,x), as
+          *   hogComputeHistogram_() would do.
+          */
+        void cellHistogram(const int y, const int x, const size_t height,
+          const size_t width, blitz::Array<double,1>& hist) const;
+
+        /**
+          * @brief Extracts the HOG descriptors of the window of the current
+          *   image whose top left corner is (y,x). The output has the shape
+          *   given by getHOG().getOutputShape().
+          */
+        void forwardWindow(const int y, const int x,
+          blitz::Array<double,3>& output) const;
+
+        /**
+          * @brief Gets the shape of the output of all the windows, which are
+          *   sampled every step_y rows and step_x columns of the current
+          *   image
+          */
+        const blitz::TinyVector<int,3> getOutputShape(const size_t step_y,
+          const size_t step_x) const;
+
+        /**
+          * @brief Extracts the HOG descriptors of all the windows of the
+          *   current image, which are sampled every step_y rows and step_x
+          *   columns. output(i,j,:) is the descriptor of the window whose top
+          *   left corner is (i*step_y,j*step_x), that is the output of
+          *   forwardWindow(), flattened. The rows of windows are distributed over
+          *   getNThreads() threads.
+          */
+        void forwardDense(const size_t step_y, const size_t step_x,
+          blitz::Array<double,3>& output) const;
+
+      private:
+        /**
+          * @brief Computes the gradients of the rows (thread,
+          *   thread+n_threads, ...) of the image, and integrates their
+          *   histograms along the x-axis
+          */
+        void integrateRows(const blitz::Array<T,2>& image,
+          const size_t thread, const size_t n_threads);
+
+        /**
+          * @brief Integrates the histograms along the y-axis, for the
+          *   thread-th of n_threads consecutive shares of the columns
+          */
+        void integrateColumns(const size_t thread, const size_t n_threads);
+
+        /**
+          * @brief Computes the (non normalized) cell histograms of the
+          *   window whose top left corner is (y,x)
+          */
+        void computeCells(const int y, const int x,
+          blitz::Array<double,3>& cells) const;
+
+        /**
+          * @brief Computes the windows of the rows (thread,
+          *   thread+n_threads, ...) of windows
+          */
+        void forwardRows(const size_t step_y, const size_t step_x,
+          blitz::Array<double,3>& output, const size_t thread,
+          const size_t n_threads) const;
+
+        /**
+          * @brief Checks that the window at (y,x) is inside the image
+          */
+        void checkWindow(const int y, const int x) const;
+
+        HOG<T> m_hog;
+        size_t m_n_threads;
+
+        // Size of the current image
+        size_t m_height;
+        size_t m_width;
+
+        // Integral histograms: m_integral(y,x,b) is the sum of the
+        // contributions to the bin b of the pixels above and left of (y,x)
+        blitz::Array<double,3> m_integral;
+    };
+
+    template <typename T>
+    DenseHOG<T>::DenseHOG(const HOG<T>& hog):
+      m_hog(hog), m_n_threads(1), m_height(0), m_width(0)
+    {
+    }
+
+    template <typename T>
+    DenseHOG<T>::DenseHOG(const DenseHOG<T>& other):
+      m_hog(other.m_hog), m_n_threads(other.m_n_threads),
+      m_height(other.m_height), m_width(other.m_width),
+      m_integral(bob::core::array::ccopy(other.m_integral))
+    {
+    }
+
+    template <typename T>
+    DenseHOG<T>& DenseHOG<T>::operator=(const DenseHOG<T>& other)
+    {
+      if (this != &other)
+      {
+        m_hog = other.m_hog;
+        m_n_threads = other.m_n_threads;
+        m_height = other.m_height;
+        m_width = other.m_width;
+        m_integral.reference(bob::core::array::ccopy(other.m_integral));
+      }
+      return *this;
+    }
+
+    template <typename T>
+    void DenseHOG<T>::setImage(const blitz::Array<T,2>& image)
+    {
+      bob::core::array::assertZeroBase(image);
+      if (image.extent(0) < 2)
+        throw bob::math::GradientDimTooSmall(0, image.extent(0));
+      if (image.extent(1) < 2)
+        throw bob::math::GradientDimTooSmall(1, image.extent(1));
+
+      m_height = image.extent(0);
+      m_width = image.extent(1);
+      m_integral.resize(m_height+1, m_width+1, m_hog.getCellDim());
+      // the first row is the only one which is not computed
+      m_integral(0, blitz::Range::all(), blitz::Range::all()) = 0.;
+
+      const size_t n_threads = std::min(m_n_threads, m_height);
+      if (n_threads <= 1) {
+        integrateRows(image, 0, 1);
+        integrateColumns(0, 1);
+        return;
+      }
+
+      // the threads only access the (distinct) elements of the arrays, and
+      // never create views of them
+      boost::thread_group rows;
+      for (size_t t = 1; t < n_threads; ++t)
+        rows.create_thread(boost::bind(&DenseHOG<T>::integrateRows, this,
+          boost::cref(image), t, n_threads));
+      integrateRows(image, 0, n_threads);
+      rows.join_all();
+
+      boost::thread_group columns;
+      for (size_t t = 1; t < n_threads; ++t)
+        columns.create_thread(boost::bind(&DenseHOG<T>::integrateColumns,
+          this, t, n_threads));
+      integrateColumns(0, n_threads);
+      columns.join_all();
+    }
+
+    template <typename T>
+    void DenseHOG<T>::integrateRows(const blitz::Array<T,2>& image,
+      const size_t thread, const size_t n_threads)
+    {
+      const int height = m_height;
+      const int width = m_width;
+      const int nb_bins = m_hog.getCellDim();
+      const double range_orientation =
+        (m_hog.getFullOrientation() ? 2*M_PI : M_PI);
+      const GradientMagnitudeType mag_type = m_hog.getGradientMagnitudeType();
+
+      for (int y = thread; y < height; y += n_threads)
+      {
+        // the rows of m_integral are contiguous
+        double* row = &m_integral(y+1, 0, 0);
+        std::fill(row, row + nb_bins, 0.);
+        for (int x = 0; x < width; ++x)
+        {
+          const double* prev = row + x*nb_bins;
+          double* cur = prev + nb_bins;
+          std::copy(prev, prev + nb_bins, cur);
+
+          // gradients, as bob::math::gradient()
+          double gy, gx;
+          if (y == 0) gy = (double)image(1,x) - (double)image(0,x);
+          else if (y == height-1)
+            gy = (double)image(y,x) - (double)image(y-1,x);
+          else gy = ((double)image(y+1,x) - (double)image(y-1,x)) / 2.;
+          if (x == 0) gx = (double)image(y,1) - (double)image(y,0);
+          else if (x == width-1)
+            gx = (double)image(y,x) - (double)image(y,x-1);
+          else gx = ((double)image(y,x+1) - (double)image(y,x-1)) / 2.;
+
+          // magnitude and orientation, as GradientMaps::forward_()
+          double energy = gy*gy + gx*gx;
+          switch (mag_type)
+          {
+            case MagnitudeSquare:
+              break;
+            case SqrtMagnitude:
+              energy = sqrt(sqrt(energy));
+              break;
+            case Magnitude:
+            default:
+              energy = sqrt(energy);
+          }
+          const double orientation = atan2(gy, gx);
+
+          // bilinear binning, as hogComputeHistogram_()
+          const double bin = orientation / range_orientation * nb_bins;
+          int bin_index1 = floor(bin);
+          const double weight = 1.-(bin-bin_index1);
+          bin_index1 = bin_index1 % nb_bins;
+          if (bin_index1 < 0) bin_index1 += nb_bins;
+          const int bin_index2 = (bin_index1+1) % nb_bins;
+          cur[bin_index1] += weight * energy;
+          cur[bin_index2] += (1. - weight) * energy;
+        }
+      }
+    }
+
+    template <typename T>
+    void DenseHOG<T>::integrateColumns(const size_t thread,
+      const size_t n_threads)
+    {
+      const int nb_bins = m_hog.getCellDim();
+      const int row_size = (m_width+1) * nb_bins;
+      double* data = m_integral.data();
+      // the thread processes the (consecutive) columns of its share
+      const int begin = thread * row_size / n_threads;
+      const int end = (thread+1) * row_size / n_threads;
+      for (size_t y = 1; y <= m_height; ++y)
+      {
+        const double* prev = data + (y-1)*row_size;
+        double* cur = data + y*row_size;
+        for (int i = begin; i < end; ++i) cur[i] += prev[i];
+      }
+    }
+
+    template <typename T>
+    void DenseHOG<T>::cellHistogram(const int y, const int x,
+      const size_t height, const size_t width,
+      blitz::Array<double,1>& hist) const
+    {
+      bob::core::array::assertSameDimensionLength(hist.extent(0),
+        m_hog.getCellDim());
+      if (y < 0 || y + height > m_height)
+        throw bob::core::InvalidArgumentException("y", y, 0,
+          (int)m_height - (int)height);
+      if (x < 0 || x + width > m_width)
+        throw bob::core::InvalidArgumentException("x", x, 0,
+          (int)m_width - (int)width);
+
+      const int y1 = y + height, x1 = x + width;
+      for (int b = 0; b < hist.extent(0); ++b)
+        hist(b) = m_integral(y1,x1,b) - m_integral(y,x1,b)
+          - m_integral(y1,x,b) + m_integral(y,x,b);
+    }
+
+    template <typename T>
+    void DenseHOG<T>::checkWindow(const int y, const int x) const
+    {
+      const int max_y = (int)m_height - (int)m_hog.getHeight();
+      const int max_x = (int)m_width - (int)m_hog.getWidth();
+      if (y < 0 || y > max_y)
+        throw bob::core::InvalidArgumentException("y", y, 0, max_y);
+      if (x < 0 || x > max_x)
+        throw bob::core::InvalidArgumentException("x", x, 0, max_x);
+    }
+
+    template <typename T>
+    void DenseHOG<T>::computeCells(const int y, const int x,
+      blitz::Array<double,3>& cells) const
+    {
+      // same decomposition into cells as bob::ip::block()
+      const int step_y = m_hog.getCellHeight() - m_hog.getCellOverlapHeight();
+      const int step_x = m_hog.getCellWidth() - m_hog.getCellOverlapWidth();
+      for (int cy = 0; cy < cells.extent(0); ++cy)
+      {
+        const int y0 = y + cy*step_y, y1 = y0 + m_hog.getCellHeight();
+        for (int cx = 0; cx < cells.extent(1); ++cx)
+        {
+          const int x0 = x + cx*step_x, x1 = x0 + m_hog.getCellWidth();
+          for (int b = 0; b < cells.extent(2); ++b)
+            cells(cy,cx,b) = m_integral(y1,x1,b) - m_integral(y0,x1,b)
+              - m_integral(y1,x0,b) + m_integral(y0,x0,b);
+        }
+      }
+    }
+
+    template <typename T>
+    void DenseHOG<T>::forwardWindow(const int y, const int x,
+      blitz::Array<double,3>& output) const
+    {
+      bob::core::array::assertZeroBase(output);
+      bob::core::array::assertSameShape(output, m_hog.getOutputShape());
+      checkWindow(y, x);
+
+      const blitz::TinyVector<int,4> nb_cells = getBlock4DOutputShape(
+        m_hog.getHeight(), m_hog.getWidth(), m_hog.getCellHeight(),
+        m_hog.getCellWidth(), m_hog.getCellOverlapHeight(),
+        m_hog.getCellOverlapWidth());
+      blitz::Array<double,3> cells(nb_cells(0), nb_cells(1),
+        m_hog.getCellDim());
+      computeCells(y, x, cells);
+
+      // same block normalization as BlockCellDescriptors::normalizeBlocks()
+      const blitz::Range rall = blitz::Range::all();
+      for (int by = 0; by < output.extent(0); ++by)
+        for (int bx = 0; bx < output.extent(1); ++bx)
+        {
+          blitz::Range ry(by, by + m_hog.getBlockHeight() - 1);
+          blitz::Range rx(bx, bx + m_hog.getBlockWidth() - 1);
+          blitz::Array<double,3> cells_block = cells(ry,rx,rall);
+          blitz::Array<double,1> block = output(by,bx,rall);
+          normalizeBlock_(cells_block, block, m_hog.getBlockNorm(),
+            m_hog.getBlockNormEps(), m_hog.getBlockNormThreshold());
+        }
+    }
+
+    template <typename T>
+    const blitz::TinyVector<int,3> DenseHOG<T>::getOutputShape(
+      const size_t step_y, const size_t step_x) const
+    {
+      if (step_y == 0)
+        throw bob::core::InvalidArgumentException("step_y", step_y,
+          (size_t)1, m_height);
+      if (step_x == 0)
+        throw bob::core::InvalidArgumentException("step_x", step_x,
+          (size_t)1, m_width);
+
+      const blitz::TinyVector<int,3> shape = m_hog.getOutputShape();
+      blitz::TinyVector<int,3> res;
+      res(0) = m_height < m_hog.getHeight() ? 0 :
+        (m_height - m_hog.getHeight()) / step_y + 1;
+      res(1) = m_width < m_hog.getWidth() ? 0 :
+        (m_width - m_hog.getWidth()) / step_x + 1;
+      res(2) = shape(0) * shape(1) * shape(2);
+      return res;
+    }
+
+    template <typename T>
+    void DenseHOG<T>::forwardRows(const size_t step_y, const size_t step_x,
+      blitz::Array<double,3>& output, const size_t thread,
+      const size_t n_threads) const
+    {
+      // scratch memory of this thread: the views created below are views
+      // of these arrays only, as the reference counting of blitz arrays is
+      // not thread-safe
+      const blitz::TinyVector<int,4> nb_cells = getBlock4DOutputShape(
+        m_hog.getHeight(), m_hog.getWidth(), m_hog.getCellHeight(),
+        m_hog.getCellWidth(), m_hog.getCellOverlapHeight(),
+        m_hog.getCellOverlapWidth());
+      blitz::Array<double,3> cells(nb_cells(0), nb_cells(1),
+        m_hog.getCellDim());
+      const blitz::TinyVector<int,3> shape = m_hog.getOutputShape();
+      blitz::Array<double,1> block(shape(2));
+
+      const blitz::Range rall = blitz::Range::all();
+      for (int wy = thread; wy < output.extent(0); wy += n_threads)
+        for (int wx = 0; wx < output.extent(1); ++wx)
+        {
+          computeCells(wy*step_y, wx*step_x, cells);
+          int i = 0;
+          for (int by = 0; by < shape(0); ++by)
+            for (int bx = 0; bx < shape(1); ++bx)
+            {
+              blitz::Range ry(by, by + m_hog.getBlockHeight() - 1);
+              blitz::Range rx(bx, bx + m_hog.getBlockWidth() - 1);
+              blitz::Array<double,3> cells_block = cells(ry,rx,rall);
+              normalizeBlock_(cells_block, block, m_hog.getBlockNorm(),
+                m_hog.getBlockNormEps(), m_hog.getBlockNormThreshold());
+              for (int k = 0; k < shape(2); ++k) output(wy,wx,i++) = block(k);
+            }
+        }
+    }
+
+    template <typename T>
+    void DenseHOG<T>::forwardDense(const size_t step_y, const size_t step_x,
+      blitz::Array<double,3>& output) const
+    {
+      bob::core::array::assertZeroBase(output);
+      bob::core::array::assertSameShape(output, getOutputShape(step_y, step_x));
+
+      const size_t n_threads = std::min(m_n_threads, (size_t)output.extent(0));
+      if (n_threads <= 1) {
+        forwardRows(step_y, step_x, output, 0, 1);
+        return;
+      }
+
+      boost::thread_group threads;
+      for (size_t t = 1; t < n_threads; ++t)
+        threads.create_thread(boost::bind(&DenseHOG<T>::forwardRows, this,
+          step_y, step_x, boost::ref(output), t, n_threads));
+      forwardRows(step_y, step_x, output, 0, n_threads);
+      threads.join_all();
+    }
+
+  }
+
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_IP_DENSE_HOG_H */
@@ -127,6 +127,16 @@ namespace bob {
          */
         const boost::shared_ptr<GeomNorm> getGeomNorm(){return m_geom_norm;}
 
+        /**
+         * @brief Configures the internal GeomNorm object for the given eye
+         * positions, as operator() does, and returns it.
+         * @param center_y, center_x  The rotation center in the source image
+         *   (the middle of the eye centers), to be passed to the GeomNorm
+         */
+        const GeomNorm& setupGeomNorm(const double e1_y, const double e1_x,
+          const double e2_y, const double e2_x, double& center_y,
+          double& center_x) const;
+
       private:
         template <typename T, bool mask> 
         void processNoCheck(const blitz::Array<T,2>& src, 
@@ -196,17 +206,8 @@ namespace bob {
       blitz::Array<bool,2>& dst_mask, const double e1_y, const double e1_x,
       const double e2_y, const double e2_x) const
     { 
-      // Get angle to horizontal
-      m_cache_angle = getAngleToHorizontal(e1_y, e1_x, e2_y, e2_x) - m_eyes_angle;
-      m_geom_norm->setRotationAngle(m_cache_angle);
-
-      // Get scaling factor
-      m_cache_scale = m_eyes_distance / sqrt( (e1_y-e2_y)*(e1_y-e2_y) + (e1_x-e2_x)*(e1_x-e2_x) );
-      m_geom_norm->setScalingFactor(m_cache_scale);
-
-      // Get the center (of the eye centers segment)
-      double center_y = (e1_y + e2_y) / 2.;
-      double center_x = (e1_x + e2_x) / 2.;
+      double center_y, center_x;
+      setupGeomNorm(e1_y, e1_x, e2_y, e2_x, center_y, center_x);
 
       // Perform the normalization
       if(mask)
@@ -0,0 +1,418 @@
+/**
+ * @file bob/ip/FaceNormPipeline.h
+ * @date Sun Oct 18 14:05:31 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief A face preprocessing pipeline, which chains the geometric
+ * normalization of the face, the Tan and Triggs preprocessing and
+ * (optionally) the extraction of LBP codes or DCT features.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IP_FACE_NORM_PIPELINE_H
+#define BOB_IP_FACE_NORM_PIPELINE_H
+
+#include <vector>
+#include <stdint.h>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include "bob/core/assert.h"
+#include "bob/ip/FaceEyesNorm.h"
+#include "bob/ip/GeomNorm.h"
+#include "bob/ip/warp.h"
+#include "bob/ip/TanTriggs.h"
+#include "bob/ip/LBP.h"
+#include "bob/ip/DCTFeatures.h"
+
+namespace bob {
+/**
+ * \ingroup libip_api
+ * @{
+ */
+  namespace ip {
+
+  /**
+   * @brief This class chains the usual face preprocessing stages:
+   *   1/ geometric normalization of the face based on the eye positions
+   *     (FaceEyesNorm)
+   *   2/ Tan and Triggs preprocessing (TanTriggs)
+   *   3/ optionally, the extraction of LBP codes (LBP) or of block DCT
+   *     features (DCTFeatures) from the preprocessed face
+   *
+   * The geometric normalization, the gamma correction and the DoG filtering
+   * are fused and run on tiles of rows: only a band of (tile height + 2R)
+   * gamma corrected rows (R being the radius of the DoG kernel) is kept in
+   * memory, instead of the full intermediate images of the single stages.
+   * The contrast equalization requires statistics of the whole filtered
+   * face, and is hence run on the filtered face once all tiles are done.
+   * All scratch memory is kept between calls.
+   *
+   * The results are identical to the ones of the single stages applied one
+   * after the other.
+   */
+  class FaceNormPipeline
+  {
+    public:
+
+      /**
+       * @brief The optional feature extraction stage
+       */
+      typedef enum { None, LBPCodes, DCTBlocks } Features;
+
+      /**
+       * @brief Constructs a pipeline that outputs the preprocessed face
+       * @param face_eyes_norm The geometric normalization of the face
+       * @param tan_triggs The Tan and Triggs preprocessor
+       * @param tile_height The number of rows that are processed at once
+       */
+      FaceNormPipeline(const FaceEyesNorm& face_eyes_norm,
+        const TanTriggs& tan_triggs, const size_t tile_height=16);
+
+      /**
+       * @brief Constructs a pipeline that outputs the LBP codes of the
+       * preprocessed face (the LBP operator is copied)
+       */
+      FaceNormPipeline(const FaceEyesNorm& face_eyes_norm,
+        const TanTriggs& tan_triggs, const LBP& lbp,
+        const size_t tile_height=16);
+
+      /**
+       * @brief Constructs a pipeline that outputs the block DCT features of
+       * the preprocessed face, as a 2D array (see
+       * DCTFeatures::get2DOutputShape())
+       */
+      FaceNormPipeline(const FaceEyesNorm& face_eyes_norm,
+        const TanTriggs& tan_triggs, const DCTFeatures& dct_features,
+        const size_t tile_height=16);
+
+      /**
+       * @brief Copy constructor (the stages are copied)
+       */
+      FaceNormPipeline(const FaceNormPipeline& other);
+
+      /**
+        * @brief Destructor
+        */
+      virtual ~FaceNormPipeline();
+
+      /**
+       * @brief Assignment operator
+       */
+      FaceNormPipeline& operator=(const FaceNormPipeline& other);
+
+      /**
+       * @brief Getters
+       */
+      const FaceEyesNorm& getFaceEyesNorm() const { return m_face_eyes_norm; }
+      const TanTriggs& getTanTriggs() const { return m_tan_triggs; }
+      Features getFeatures() const { return m_features; }
+      boost::shared_ptr<const LBP> getLBP() const { return m_lbp; }
+      boost::shared_ptr<const DCTFeatures> getDCTFeatures() const
+      { return m_dct_features; }
+      size_t getTileHeight() const { return m_tile_height; }
+      size_t getNThreads() const { return m_n_threads; }
+
+      /**
+       * @brief Setters
+       */
+      void setTileHeight(const size_t tile_height);
+      void setNThreads(const size_t n_threads);
+
+      /**
+       * @brief The shape of the output of a single face: the cropped face,
+       * the LBP codes or the 2D DCT features
+       */
+      const blitz::TinyVector<int,2> getOutputShape() const;
+
+      /**
+       * @brief Processes a single face, given the positions of its eyes
+       * (as FaceEyesNorm::operator()). The output is the preprocessed face,
+       * or its DCT features.
+       */
+      template <typename T> void operator()(const blitz::Array<T,2>& src,
+        blitz::Array<double,2>& dst, const double e1_y, const double e1_x,
+        const double e2_y, const double e2_x);
+
+      /**
+       * @brief Processes a single face, given the positions of its eyes
+       * (as FaceEyesNorm::operator()). The output are the LBP codes of the
+       * preprocessed face.
+       */
+      template <typename T> void operator()(const blitz::Array<T,2>& src,
+        blitz::Array<uint16_t,2>& dst, const double e1_y, const double e1_x,
+        const double e2_y, const double e2_x);
+
+      /**
+       * @brief Processes a batch of faces src(i,:,:), with the eye positions
+       * eyes(i,:) = (e1_y, e1_x, e2_y, e2_x), into dst(i,:,:). The faces
+       * are distributed over getNThreads() threads.
+       */
+      template <typename T> void operator()(const blitz::Array<T,3>& src,
+        blitz::Array<double,3>& dst, const blitz::Array<double,2>& eyes);
+      template <typename T> void operator()(const blitz::Array<T,3>& src,
+        blitz::Array<uint16_t,3>& dst, const blitz::Array<double,2>& eyes);
+
+    private:
+
+      /**
+       * @brief Allocates the scratch memory
+       */
+      void init();
+
+      /**
+       * @brief Checks that the output type fits the feature stage
+       */
+      void checkOutput(const bool lbp_codes) const;
+
+      /**
+       * @brief Runs the geometric normalization, the Tan and Triggs
+       * preprocessing into the given image of the size of the cropped face
+       */
+      template <typename T> void preprocess(const blitz::Array<T,2>& src,
+        blitz::Array<double,2>& image, const double e1_y, const double e1_x,
+        const double e2_y, const double e2_x);
+
+      /**
+       * @brief Computes the geometrically normalized and gamma corrected
+       * row r (in [-R, crop_height+R), extrapolated at the borders) into the
+       * band row b
+       */
+      template <typename T> void fillRow(const blitz::Array<T,2>& src,
+        const int r, const int b);
+
+      /**
+       * @brief Computes the position of the first pixel of each row of the
+       * cropped face in the source image
+       */
+      void setupRows(const double e1_y, const double e1_x, const double e2_y,
+        const double e2_x);
+
+      /**
+       * @brief Maps the (extrapolated) index i to [0,size), -1 for zeros
+       */
+      int borderIndex(int i, const int size) const;
+
+      /**
+       * @brief Applies the gamma correction to the band row b and
+       * extrapolates its border columns
+       */
+      void correctRow(const int b);
+
+      /**
+       * @brief DoG filters the rows [y0,y1) into the image, whose first
+       * extrapolated row is the band row 0; accumulates the sum of
+       * |I|^alpha (first step of the contrast equalization)
+       */
+      void filterTile(const int y0, const int y1, blitz::Array<double,2>& image,
+        double& sum);
+
+      /**
+       * @brief Contrast equalization of the filtered image, given the sum of
+       * |I|^alpha
+       */
+      void equalize(blitz::Array<double,2>& image, const double sum) const;
+
+      /**
+       * @brief Processes the faces (thread, thread+n_threads, ...)
+       */
+      template <typename T, typename U> void processBatch(
+        const std::vector<blitz::Array<T,2> >& src,
+        std::vector<blitz::Array<U,2> >& dst,
+        const blitz::Array<double,2>& eyes, const size_t thread,
+        const size_t n_threads);
+
+      /**
+       * @brief Runs processBatch() on all threads
+       */
+      template <typename T, typename U> void runBatch(
+        const blitz::Array<T,3>& src, blitz::Array<U,3>& dst,
+        const blitz::Array<double,2>& eyes);
+
+      // Stages
+      FaceEyesNorm m_face_eyes_norm;
+      TanTriggs m_tan_triggs;
+      Features m_features;
+      boost::shared_ptr<LBP> m_lbp;
+      boost::shared_ptr<DCTFeatures> m_dct_features;
+      size_t m_tile_height;
+      size_t m_n_threads;
+
+      // Geometry of the current face
+      std::vector<double> m_origin_y;
+      std::vector<double> m_origin_x;
+      double m_dy;
+      double m_dx;
+
+      // Scratch memory
+      blitz::Array<double,2> m_band; ///< tile_height+2R extrapolated rows
+      blitz::Array<double,2> m_band_inner; ///< the non-extrapolated columns
+      blitz::Array<double,2> m_image; ///< preprocessed face, if features
+  };
+
+  template <typename T>
+  void FaceNormPipeline::fillRow(const blitz::Array<T,2>& src, const int r,
+    const int b)
+  {
+    const int y = borderIndex(r, m_origin_y.size());
+    if (y < 0) {
+      m_band(b, blitz::Range::all()) = 0.;
+      return;
+    }
+    blitz::Array<bool,2> src_mask, dst_mask;
+    detail::bilinearWarpRow<T,false>(src, src_mask, m_band_inner, dst_mask, b,
+      m_origin_y[y], m_origin_x[y], m_dy, m_dx);
+    correctRow(b);
+  }
+
+  template <typename T>
+  void FaceNormPipeline::preprocess(const blitz::Array<T,2>& src,
+    blitz::Array<double,2>& image, const double e1_y, const double e1_x,
+    const double e2_y, const double e2_x)
+  {
+    setupRows(e1_y, e1_x, e2_y, e2_x);
+
+    const int R = m_tan_triggs.getRadius();
+    const int height = m_origin_y.size();
+    const int tile = m_tile_height;
+    // the band row 0 holds the extrapolated row 'first', the rows until
+    // 'last' (excluded) have already been computed
+    int first = -R, last = -R;
+    double sum = 0.;
+    for (int y0 = 0; y0 < height; y0 += tile) {
+      const int y1 = std::min(y0 + tile, height);
+      // keeps the rows that the previous tile shares with this one
+      const int shift = y0 - R - first;
+      for (int r = y0 - R; r < last; ++r)
+        m_band(r - y0 + R, blitz::Range::all()) =
+          m_band(r - y0 + R + shift, blitz::Range::all());
+      first = y0 - R;
+      for (int r = std::max(last, first); r < y1 + R; ++r)
+        fillRow(src, r, r - first);
+      last = y1 + R;
+      filterTile(y0, y1, image, sum);
+    }
+    equalize(image, sum);
+  }
+
+  template <typename T>
+  void FaceNormPipeline::operator()(const blitz::Array<T,2>& src,
+    blitz::Array<double,2>& dst, const double e1_y, const double e1_x,
+    const double e2_y, const double e2_x)
+  {
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    checkOutput(false);
+    bob::core::array::assertSameShape(dst, getOutputShape());
+
+    if (m_features == None)
+      preprocess(src, dst, e1_y, e1_x, e2_y, e2_x);
+    else {
+      preprocess(src, m_image, e1_y, e1_x, e2_y, e2_x);
+      m_dct_features->operator()(m_image, dst);
+    }
+  }
+
+  template <typename T>
+  void FaceNormPipeline::operator()(const blitz::Array<T,2>& src,
+    blitz::Array<uint16_t,2>& dst, const double e1_y, const double e1_x,
+    const double e2_y, const double e2_x)
+  {
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    checkOutput(true);
+    bob::core::array::assertSameShape(dst, getOutputShape());
+
+    preprocess(src, m_image, e1_y, e1_x, e2_y, e2_x);
+    m_lbp->operator()(m_image, dst);
+  }
+
+  template <typename T, typename U>
+  void FaceNormPipeline::processBatch(
+    const std::vector<blitz::Array<T,2> >& src,
+    std::vector<blitz::Array<U,2> >& dst, const blitz::Array<double,2>& eyes,
+    const size_t thread, const size_t n_threads)
+  {
+    // the stages might slice their output, which is not thread-safe for
+    // views of the same array: they write into private memory instead
+    blitz::Array<U,2> output(getOutputShape());
+    for (size_t i = thread; i < src.size(); i += n_threads) {
+      operator()(src[i], output, eyes(i,0), eyes(i,1), eyes(i,2), eyes(i,3));
+      dst[i] = output;
+    }
+  }
+
+  template <typename T, typename U>
+  void FaceNormPipeline::runBatch(const blitz::Array<T,3>& src,
+    blitz::Array<U,3>& dst, const blitz::Array<double,2>& eyes)
+  {
+    bob::core::array::assertZeroBase(src);
+    bob::core::array::assertZeroBase(dst);
+    bob::core::array::assertZeroBase(eyes);
+    checkOutput(boost::is_same<U,uint16_t>::value);
+    const blitz::TinyVector<int,2> shape = getOutputShape();
+    bob::core::array::assertSameShape(dst,
+      blitz::TinyVector<int,3>(src.extent(0), shape(0), shape(1)));
+    bob::core::array::assertSameShape(eyes,
+      blitz::TinyVector<int,2>(src.extent(0), 4));
+
+    // the views are created here, as the reference counting of blitz
+    // arrays is not thread-safe
+    const blitz::Range all = blitz::Range::all();
+    std::vector<blitz::Array<T,2> > faces;
+    std::vector<blitz::Array<U,2> > outputs;
+    for (int i = 0; i < src.extent(0); ++i) {
+      faces.push_back(src(i, all, all));
+      outputs.push_back(dst(i, all, all));
+    }
+
+    const size_t n_threads = std::min(m_n_threads, faces.size());
+    if (n_threads <= 1) {
+      processBatch(faces, outputs, eyes, 0, 1);
+      return;
+    }
+
+    // each thread gets its own copy of the pipeline (and scratch memory)
+    std::vector<FaceNormPipeline> pipelines(n_threads - 1, *this);
+    boost::thread_group threads;
+    for (size_t t = 1; t < n_threads; ++t)
+      threads.create_thread(boost::bind(
+        &FaceNormPipeline::processBatch<T,U>, &pipelines[t-1],
+        boost::cref(faces), boost::ref(outputs), boost::cref(eyes), t,
+        n_threads));
+    processBatch(faces, outputs, eyes, 0, n_threads);
+    threads.join_all();
+  }
+
+  template <typename T>
+  void FaceNormPipeline::operator()(const blitz::Array<T,3>& src,
+    blitz::Array<double,3>& dst, const blitz::Array<double,2>& eyes)
+  {
+    runBatch(src, dst, eyes);
+  }
+
+  template <typename T>
+  void FaceNormPipeline::operator()(const blitz::Array<T,3>& src,
+    blitz::Array<uint16_t,3>& dst, const blitz::Array<double,2>& eyes)
+  {
+    runBatch(src, dst, eyes);
+  }
+
+}}
+
+#endif /* BOB_IP_FACE_NORM_PIPELINE_H */
@@ -30,6 +30,7 @@
 #include "bob/sp/FFT2D.h"
 #include <vector>
 #include <utility>
+#include <boost/function.hpp>
 
 namespace bob {
 
@@ -69,6 +70,27 @@ namespace bob {
           blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
         ) const;
 
+        //! \brief Gabor transforms the given image, writing only the pixels in the support of the kernel.
+        //! All other pixels of the output are left untouched (i.e., they should be zero already).
+        void transformSupport(
+          const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+          blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
+        ) const;
+
+        //! Sets the pixels in the support of the kernel to zero (undoes transformSupport)
+        void clearSupport(
+          blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
+        ) const;
+
+        //! \brief Computes the Gabor transformed image in spatial domain at a single position (y,x) only,
+        //! i.e., the inverse DFT restricted to the support of the kernel.
+        //! The phase factors of the position are row_phases(u) = exp(2 pi i u y / height) and column_phases(v) = exp(2 pi i v x / width).
+        std::complex<double> transformAt(
+          const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+          const blitz::Array<std::complex<double>,1>& row_phases,
+          const blitz::Array<std::complex<double>,1>& column_phases
+        ) const;
+
       private:
         // the Gabor wavelet, stored as pairs of indices and values
         std::vector<std::pair<blitz::TinyVector<unsigned,2>, double> > m_kernel_pixel;
@@ -133,12 +155,24 @@ namespace bob {
         double pow_of_k() const {return m_pow_of_k;}
         bool dc_free() const {return m_dc_free;}
 
+        //! \brief The number of threads the kernels are distributed over (default: 1).
+        //! Each thread uses its own buffers of the size of the image.
+        unsigned numberOfThreads() const {return m_number_of_threads;}
+        void setNumberOfThreads(unsigned number_of_threads);
+
         //! performs Gabor wavelet transform and returns vector of complex images
         void performGWT(
           const blitz::Array<std::complex<double>,2>& gray_image,
           blitz::Array<std::complex<double>,3>& trafo_image
         );
 
+        //! \brief performs Gabor wavelet transform of a real-valued image,
+        //! using a real-to-complex FFT
+        void performGWT(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<std::complex<double>,3>& trafo_image
+        );
+
         //! \brief performs Gabor wavelet transform and creates 4D image
         //! (absolute part and phase part)
         void computeJetImage(
@@ -146,6 +180,11 @@ namespace bob {
           blitz::Array<double,4>& jet_image,
           bool do_normalize = true
         );
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<double,4>& jet_image,
+          bool do_normalize = true
+        );
 
         //! \brief performs Gabor wavelet transform and creates 3D image
         //! (absolute parts of the responses only)
@@ -154,6 +193,65 @@ namespace bob {
           blitz::Array<double,3>& jet_image,
           bool do_normalize = true
         );
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<double,3>& jet_image,
+          bool do_normalize = true
+        );
+
+        //! \brief computes the Gabor jets (absolute values and phases) at the given positions only.
+        //! Each row of positions holds one (y,x) position; the jets have shape (#positions, 2, #kernels).
+        //! Only the Fourier transform of the image is computed, the inverse transforms are evaluated at the given positions.
+        void computeJets(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,3>& jets,
+          bool do_normalize = true
+        );
+        void computeJets(
+          const blitz::Array<double,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,3>& jets,
+          bool do_normalize = true
+        );
+
+        //! \brief computes the Gabor jets (absolute values only) at the given positions only.
+        //! The jets have shape (#positions, #kernels).
+        void computeJets(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,2>& jets,
+          bool do_normalize = true
+        );
+        void computeJets(
+          const blitz::Array<double,2>& gray_image,
+          const blitz::Array<int,2>& positions,
+          blitz::Array<double,2>& jets,
+          bool do_normalize = true
+        );
+
+        //! \brief performs Gabor wavelet transform and creates single precision jet images
+        //! (the transform itself is computed in double precision)
+        void computeJetImage(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          blitz::Array<float,4>& jet_image,
+          bool do_normalize = true
+        );
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<float,4>& jet_image,
+          bool do_normalize = true
+        );
+        void computeJetImage(
+          const blitz::Array<std::complex<double>,2>& gray_image,
+          blitz::Array<float,3>& jet_image,
+          bool do_normalize = true
+        );
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<float,3>& jet_image,
+          bool do_normalize = true
+        );
 
         //! \brief saves the parameters of this Gabor wavelet family to file
         void save(bob::io::HDF5File& file) const;
@@ -165,6 +263,40 @@ namespace bob {
 
         void computeKernelFrequencies();
 
+        //! computes the spectrum of the image into m_frequency_image
+        template <typename I>
+          void forwardTransform(const blitz::Array<I,2>& gray_image);
+
+        //! allocates the buffers of each thread
+        void initThreadBuffers();
+
+        //! calls job(kernel, thread) for each kernel, distributed over the threads
+        void forEachKernel(const boost::function<void (unsigned, unsigned)>& job) const;
+
+        //! computes the spatial response of the given kernel, using the buffers of the given thread
+        void kernelResponse(unsigned kernel, unsigned thread, blitz::Array<std::complex<double>,2>& response) const;
+
+        //! computes one layer of the trafo image, given the views of all layers
+        void trafoLayer(unsigned kernel, unsigned thread, std::vector<blitz::Array<std::complex<double>,2> >& layers) const;
+
+        //! computes one layer of the jet image, given the views of the absolute values and phases (if any) of all layers
+        template <typename J>
+          void jetLayer(unsigned kernel, unsigned thread, std::vector<blitz::Array<J,2> >& abs_parts, std::vector<blitz::Array<J,2> >& phase_parts) const;
+
+        //! the implementation of computeJetImage
+        template <typename I, typename J, int N>
+          void jetImage(const blitz::Array<I,2>& gray_image, blitz::Array<J,N>& jet_image, bool do_normalize);
+
+        //! computes the responses of one kernel at the positions (absolute values and phases)
+        void positionLayer(unsigned kernel, unsigned thread, blitz::Array<double,3>& jets) const;
+
+        //! computes the responses of one kernel at the positions (absolute values only)
+        void positionLayer(unsigned kernel, unsigned thread, blitz::Array<double,2>& jets) const;
+
+        //! the implementation of computeJets
+        template <typename I, int N>
+          void positionJets(const blitz::Array<I,2>& gray_image, const blitz::Array<int,2>& positions, blitz::Array<double,N>& jets, bool do_normalize);
+
         double m_sigma;
         double m_pow_of_k;
         double m_k_max;
@@ -179,6 +311,13 @@ namespace bob {
 
         blitz::Array<std::complex<double>,2> m_temp_array, m_frequency_image;
 
+        //! the number of threads used to process the kernels
+        unsigned m_number_of_threads;
+        //! per thread buffers: kernel times spectrum (zero outside the kernel support) and its inverse FFT
+        std::vector<blitz::Array<std::complex<double>,2> > m_frequency_buffers, m_spatial_buffers;
+        //! the phase factors of the positions given to computeJets (one array per position, so that the threads need no views)
+        std::vector<blitz::Array<std::complex<double>,1> > m_row_phases, m_column_phases;
+
         //! The number of scales (levels, frequencies) of this family
         unsigned m_number_of_scales;
         //! The number of directions (orientations) of this family
@@ -191,6 +330,12 @@ namespace bob {
     //! Normalizes a Gabor jet (vector of absolute and phase values) to unit length
     void normalizeGaborJet(blitz::Array<double,2>& gabor_jet);
 
+    //! Normalizes a single precision Gabor jet (vector of absolute values) to unit length
+    void normalizeGaborJet(blitz::Array<float,1>& gabor_jet);
+
+    //! Normalizes a single precision Gabor jet (vector of absolute and phase values) to unit length
+    void normalizeGaborJet(blitz::Array<float,2>& gabor_jet);
+
   } // namespace ip
 
 } // namespace bob
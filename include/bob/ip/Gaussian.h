@@ -163,10 +163,33 @@ namespace bob {
         blitz::Array<double, 1> m_kernel_x;
 
         blitz::Array<double, 2> m_tmp_int;
-        blitz::Array<double, 2> m_tmp_int1;
-        blitz::Array<double, 2> m_tmp_int2;
     };
 
+    namespace detail {
+      /**
+       * @brief Convolves the rows [y_begin,y_end) of dst with the 1D kernel
+       * along the y-axis, the input being extrapolated as specified. The
+       * results are the ones of bob::sp::convSep() applied to the
+       * extrapolated input, without building the extrapolated input.
+       * @warning src and dst should have the same shape, and should not
+       * overlap. Only the elements of the arrays are accessed, such that
+       * distinct rows of dst can be computed by distinct threads.
+       */
+      void gaussianConvY(const blitz::Array<double,2>& src,
+        const blitz::Array<double,1>& kernel, blitz::Array<double,2>& dst,
+        const bob::sp::Extrapolation::BorderType border_type,
+        const int y_begin, const int y_end);
+
+      /**
+       * @brief Convolves the rows [y_begin,y_end) of dst with the 1D kernel
+       * along the x-axis, as gaussianConvY().
+       */
+      void gaussianConvX(const blitz::Array<double,2>& src,
+        const blitz::Array<double,1>& kernel, blitz::Array<double,2>& dst,
+        const bob::sp::Extrapolation::BorderType border_type,
+        const int y_begin, const int y_end);
+    }
+
     // Declare template method full specialization
     template <> 
     void bob::ip::Gaussian::operator()<double>(const blitz::Array<double,2>& src, 
@@ -27,6 +27,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <vector>
+#include <algorithm>
 
 namespace bob {
 /**
@@ -165,6 +166,7 @@ class GaussianScaleSpace
     { return m_conv_border; }
     boost::shared_ptr<bob::ip::Gaussian> getGaussian(const size_t i) const 
     { return m_gaussians[i]; }
+    size_t getNThreads() const { return m_n_threads; }
 
     /**
      * @brief Setters
@@ -187,6 +189,12 @@ class GaussianScaleSpace
     { m_kernel_radius_factor = kernel_radius_factor; resetGaussians(); }
     void setConvBorder(const bob::sp::Extrapolation::BorderType border_type)
     { m_conv_border = border_type; resetGaussians(); }
+    /**
+     * Sets the number of threads smoothing the rows of each image of the 
+     * pyramid. The results do not depend on the number of threads.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = std::max(n_threads, (size_t)1); }
 
     /**
      * Automatically sets sigma0 to a value such that there is no smoothing
@@ -240,11 +248,13 @@ class GaussianScaleSpace
 
     std::vector<boost::shared_ptr<bob::ip::Gaussian> > m_gaussians;
     bool m_smooth_at_init;
+    size_t m_n_threads;
 
     /**
      * Working arrays/variables in cache
      */
     mutable blitz::Array<double,2> m_cache_array0;
+    mutable blitz::Array<double,2> m_cache_blur;
     void resetCache() const;
     void resetGaussians();
 
@@ -253,6 +263,13 @@ class GaussianScaleSpace
      * throws an exception otherwise.
      */
     void checkOctaveMin() const;
+
+    /**
+     * Smoothes src into dst with the given Gaussian, splitting the rows
+     * of the image between m_n_threads threads.
+     */
+    void smooth(const bob::ip::Gaussian& gaussian,
+      const blitz::Array<double,2>& src, blitz::Array<double,2>& dst) const;
 };
 
 
@@ -345,7 +362,7 @@ void bob::ip::GaussianScaleSpace::operator()(const blitz::Array<T,2>& src,
     blitz::Array<double,2> dst_m1 = dst[o](0, rall, rall);
     if (o==0) {
       if (m_smooth_at_init)
-        m_gaussians[0]->operator()(m_cache_array0, dst_m1);
+        smooth(*m_gaussians[0], m_cache_array0, dst_m1);
       else
         dst_m1 = m_cache_array0;
     }
@@ -359,7 +376,7 @@ void bob::ip::GaussianScaleSpace::operator()(const blitz::Array<T,2>& src,
     {
       blitz::Array<double,2> dst_prev = dst[o](s-1, rall, rall);
       blitz::Array<double,2> dst_cur = dst[o](s, rall, rall);
-      m_gaussians[s]->operator()(dst_prev, dst_cur);
+      smooth(*m_gaussians[s], dst_prev, dst_cur);
     }
   }
 }
@@ -32,6 +32,7 @@
 #include "bob/core/assert.h"
 #include "bob/core/check.h"
 #include "bob/ip/Exception.h"
+#include "bob/ip/warp.h"
 
 
 namespace bob {
@@ -142,6 +143,15 @@ namespace bob {
         blitz::TinyVector<double,2> operator()(const blitz::TinyVector<double,2>& position,
           const double rot_c_y, const double rot_c_x) const;
 
+        /**
+         * @brief Computes the position (origin_y, origin_x) of the target
+         * pixel (0,0) in the source image, and the displacement (dy,dx) in
+         * the source image when moving one pixel to the right in the target
+         * image. Moving one pixel down in the target image moves (dx,-dy).
+         */
+        void getSourceGrid(const double rot_c_y, const double rot_c_x,
+          double& origin_y, double& origin_x, double& dy, double& dx) const;
+
       private:
         /**
           * @brief Process a 2D blitz Array/Image
@@ -207,99 +217,12 @@ namespace bob {
     { 
       // This is the fastest version of the function that I can imagine...
       // It handles two different coordinate systems: original image and new image
-
-      // transformation center in original image
-      const double original_center_x = rot_c_x, 
-                   original_center_y = rot_c_y;
-      // transformation center in new image:
-      const double new_center_x = m_crop_offset_w, 
-                   new_center_y = m_crop_offset_h;
-
-      // With these positions, we can define a mapping from the new image to the original image
-      const double sin_angle = -sin(m_rotation_angle * M_PI / 180.), 
-                   cos_angle = cos(m_rotation_angle * M_PI / 180.);
-      // we compute the distance in the source image, when going 1 pixel in the new image
-      const double dx = cos_angle / m_scaling_factor, 
-                   dy = -sin_angle / m_scaling_factor;
-
-      // Now, we iterate through the target image, and compute pixel positions in the source.
-      // For this purpose, get the (0,0) position of the target image in source image coordinates:
-      double origin_x = original_center_x - (cos_angle * new_center_x + sin_angle * new_center_y) / m_scaling_factor;
-      double origin_y = original_center_y - (cos_angle * new_center_y - sin_angle * new_center_x) / m_scaling_factor;
-
-      // some helpers for the interpolation
-      int ox, oy;
-      double mx, my;
-      int h = source.shape()[0]-1;
-      int w = source.shape()[1]-1;
+      double origin_y, origin_x, dy, dx;
+      getSourceGrid(rot_c_y, rot_c_x, origin_y, origin_x, dy, dx);
 
       // Ok, so let's do it.
-      for (int y = 0; y < (int)m_crop_height; ++y){
-        // set the source image point to first point in row
-        double source_x = origin_x, source_y = origin_y;
-        // iterate over the row
-        for (int x = 0; x < (int)m_crop_width; ++x){
-
-          // We are at the desired pixel in the new image. Interpolate the old image's pixels:
-          double& res = target(y,x) = 0.;
-
-          // split each source x and y in integral and decimal digits
-          ox = std::floor(source_x);
-          oy = std::floor(source_y);
-          mx = source_x - ox;
-          my = source_y - oy;
-
-          // add the four values bi-linearly interpolated
-          if (mask){
-            bool& new_mask = target_mask(y,x) = false;
-            // upper left
-            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
-              res += (1.-mx) * (1.-my) * source(oy,ox);
-              new_mask = true;
-            }
-            // upper right
-            if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
-              res += mx * (1.-my) * source(oy,ox+1);
-              new_mask = true;
-            }
-            // lower left
-            if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
-              res += (1.-mx) * my * source(oy+1,ox);
-              new_mask = true;
-            }
-            // lower right
-            if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
-              res += mx * my * source(oy+1,ox+1);
-              new_mask = true;
-            }
-          } else {
-            // upper left
-            if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
-              res += (1.-mx) * (1.-my) * source(oy,ox);
-
-            // upper right
-            if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
-              res += mx * (1.-my) * source(oy,ox+1);
-
-            // lower left
-            if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
-              res += (1.-mx) * my * source(oy+1,ox);
-
-            // lower right
-            if (ox >= -1 && oy >= -1 && ox < w && oy < h)
-              res += mx * my * source(oy+1,ox+1);
-          }
-
-          // done with this pixel...
-          // go to the next source pixel in the row
-          source_x += dx;
-          source_y += dy;
-        }
-        // at the end of the row, we shift the origin to the next line
-        origin_x -= dy;
-        origin_y += dx;
-      }
-      // done!
+      detail::bilinearWarp<T,mask>(source, source_mask, target, target_mask,
+        origin_y, origin_x, dy, dx);
     }
 
     template <typename T> 
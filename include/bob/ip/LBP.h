@@ -25,7 +25,11 @@
 
 #include <blitz/array.h>
 #include <stdint.h>
+#include <cmath>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include "bob/core/check.h"
+#include "bob/core/array_copy.h"
 
 namespace bob { namespace ip {
 
@@ -132,6 +136,26 @@ namespace bob { namespace ip {
         operator()(const blitz::Array<double,2>& src, 
             blitz::Array<uint16_t,2>& dst) const = 0;
 
+      /**
+       * Extract LBP features for all the pixels of a 2D blitz::Array that
+       *   are at least border pixels away from its edges, and save the
+       *   resulting LBP codes in the dst 2D blitz::Array, which should be of
+       *   size (height-2*border, width-2*border). The neighbourhood of each
+       *   pixel is sampled as if it was located at (border,border), which
+       *   makes the codes identical to calling operator()(src, y, x) on the
+       *   (2*border+1)x(2*border+1) block centered on each pixel. This is
+       *   how LBPTop processes its planes.
+       */
+      virtual void 
+        operator()(const blitz::Array<uint8_t,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const = 0;
+      virtual void 
+        operator()(const blitz::Array<uint16_t,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const = 0;
+      virtual void 
+        operator()(const blitz::Array<double,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const = 0;
+
       /**
        * Extract the LBP code of a 2D blitz::Array at the given 
        *   location, and return it.
@@ -188,6 +212,31 @@ namespace bob { namespace ip {
       inline void updateR2() { m_R2_rect = static_cast<int>(floor(m_R2+0.5)); }
 
 
+      /**
+       * Computes the LBP codes of a whole block of pixels at once, the first
+       *   one being located at (y0,x0) in src. dy and dx hold the position
+       *   of the m_P neighbours relative to the central pixel, in the order
+       *   of the code bits (most significant first); they should be
+       *   integers for non-circular variants. Interpolation weights are
+       *   computed once per neighbour (and column) and samples are
+       *   processed one image row at a time, in flat loops that the
+       *   compiler can vectorize. The results are bit-exact with respect to
+       *   the pixel-wise processNoCheck() implementations.
+       *
+       * @param fixed If set, neighbours are sampled as if all pixels were
+       *   located at (y0,x0) (see operator()(src, dst, border))
+       * @param avg_factor The weight of the sum of the neighbours and of
+       *   the central pixel, when averaging
+       * @param avg_center_first If the central pixel comes first in that
+       *   sum (the summation order of the pixel-wise implementations
+       *   varies)
+       */
+      template <typename T>
+        void bulk_(const blitz::Array<T,2>& src,
+            blitz::Array<uint16_t,2>& dst, const double* dy,
+            const double* dx, const int y0, const int x0, const bool fixed,
+            const double avg_factor, const bool avg_center_first) const;
+
       /**
        * Circular shift to the right of the input integer for L positions, if N is the total number of bits
        */ 
@@ -217,6 +266,156 @@ namespace bob { namespace ip {
       blitz::Array<uint16_t,1> m_lut_current;
   };
 
+  template <typename T>
+    void bob::ip::LBP::bulk_(const blitz::Array<T,2>& src,
+        blitz::Array<uint16_t,2>& dst, const double* dy, const double* dx,
+        const int y0, const int x0, const bool fixed, const double avg_factor,
+        const bool avg_center_first) const
+    {
+      const int H = dst.extent(0);
+      const int W = dst.extent(1);
+      if (H == 0 || W == 0) return;
+      const int P = m_P;
+
+      // rows are walked with plain pointers
+      const blitz::Array<T,2> csrc = bob::core::array::isCContiguous(src) ?
+        src : bob::core::array::ccopy(src);
+      const T* data = csrc.data();
+      const int stride = csrc.extent(1);
+
+      // column sampling pattern of each neighbour: columns xl and xh, the
+      // former weighted by wx, as in bilinearInterpolationNoCheck(). When
+      // the pattern is the same for all the pixels of a row (always the
+      // case for non-circular or fixed sampling), it is only kept as
+      // offsets relative to the pixel and samples are read contiguously.
+      std::vector<int> xl(P*W), xh(P*W);
+      std::vector<double> wx(P*W);
+      std::vector<bool> contiguous(P, true);
+      std::vector<int> oxl(P), oxh(P);
+      for (int n=0; n<P; ++n) {
+        if (!m_circular) {
+          oxl[n] = oxh[n] = static_cast<int>(dx[n]);
+          continue;
+        }
+        for (int x=0; x<W; ++x) {
+          const int xc = fixed ? x0 : x0+x;
+          const double xd = xc + dx[n];
+          xl[n*W+x] = static_cast<int>(floor(xd)) - xc + x0 + x;
+          xh[n*W+x] = static_cast<int>(ceil(xd)) - xc + x0 + x;
+          wx[n*W+x] = static_cast<int>(ceil(xd)) - xd;
+          if (xl[n*W+x]-x != xl[n*W] || xh[n*W+x]-x != xh[n*W] ||
+              wx[n*W+x] != wx[n*W]) contiguous[n] = false;
+        }
+        oxl[n] = xl[n*W] - x0;
+        oxh[n] = xh[n*W] - x0;
+      }
+
+      std::vector<double> tab(P*W); ///< neighbour samples of a row
+      std::vector<double> center(W);
+      std::vector<double> cmp(W);
+      std::vector<unsigned> code(W);
+
+      for (int y=0; y<H; ++y) {
+        const int yc = y0 + y;
+
+        // samples all neighbours of this row
+        for (int n=0; n<P; ++n) {
+          double* t = &tab[n*W];
+          if (!m_circular) {
+            const T* r = data + (yc+static_cast<int>(dy[n]))*stride + x0 + oxl[n];
+            for (int x=0; x<W; ++x) t[x] = static_cast<double>(r[x]);
+            continue;
+          }
+          const int ycc = fixed ? y0 : yc;
+          const double yd = ycc + dy[n];
+          const int yl = static_cast<int>(floor(yd)) - ycc + yc;
+          const int yh = static_cast<int>(ceil(yd)) - ycc + yc;
+          const double wy = static_cast<int>(ceil(yd)) - yd;
+          const T* rl = data + yl*stride;
+          const T* rh = data + yh*stride;
+          if (contiguous[n]) {
+            const T* ll = rl + x0 + oxl[n];
+            const T* lh = rl + x0 + oxh[n];
+            const T* hl = rh + x0 + oxl[n];
+            const T* hh = rh + x0 + oxh[n];
+            const double w = wx[n*W];
+            for (int x=0; x<W; ++x)
+              t[x] = wy*(w*ll[x] + (1-w)*lh[x]) + (1-wy)*(w*hl[x] + (1-w)*hh[x]);
+          }
+          else {
+            const int* cl = &xl[n*W];
+            const int* ch = &xh[n*W];
+            const double* w = &wx[n*W];
+            for (int x=0; x<W; ++x)
+              t[x] = wy*(w[x]*rl[cl[x]] + (1-w[x])*rl[ch[x]]) +
+                (1-wy)*(w[x]*rh[cl[x]] + (1-w[x])*rh[ch[x]]);
+          }
+        }
+
+        // comparison points, summing in the order of processNoCheck()
+        const T* rc = data + yc*stride + x0;
+        for (int x=0; x<W; ++x) center[x] = static_cast<double>(rc[x]);
+        if (!m_to_average) {
+          for (int x=0; x<W; ++x) cmp[x] = center[x];
+        }
+        else if (avg_center_first) {
+          for (int x=0; x<W; ++x) cmp[x] = center[x];
+          for (int n=0; n<P; ++n) {
+            const double* t = &tab[n*W];
+            for (int x=0; x<W; ++x) cmp[x] += t[x];
+          }
+          for (int x=0; x<W; ++x) cmp[x] *= avg_factor;
+        }
+        else {
+          for (int x=0; x<W; ++x) cmp[x] = tab[x];
+          for (int n=1; n<P; ++n) {
+            const double* t = &tab[n*W];
+            for (int x=0; x<W; ++x) cmp[x] += t[x];
+          }
+          for (int x=0; x<W; ++x) cmp[x] = avg_factor * (cmp[x] + center[x]);
+        }
+
+        // codes
+        for (int x=0; x<W; ++x) code[x] = 0;
+        if (m_eLBP_type == 0) { // regular LBP
+          for (int n=0; n<P; ++n) {
+            const double* t = &tab[n*W];
+            for (int x=0; x<W; ++x)
+              code[x] = (code[x] << 1) | (t[x] >= cmp[x] ? 1u : 0u);
+          }
+          if (m_add_average_bit && !m_rotation_invariant && !m_uniform)
+            for (int x=0; x<W; ++x)
+              code[x] = (code[x] << 1) | (center[x] > cmp[x] ? 1u : 0u);
+        }
+        else if (m_eLBP_type == 1) { // transitional LBP
+          for (int n=0; n<P; ++n) {
+            const double* t = &tab[n*W];
+            const double* u = &tab[((n+1)%P)*W];
+            for (int x=0; x<W; ++x)
+              code[x] = (code[x] << 1) | (t[x] >= u[x] ? 1u : 0u);
+          }
+        }
+        else if (m_eLBP_type == 2) { // directional coded LBP
+          for (int n=0; n<P/2; ++n) {
+            const double* t = &tab[n*W];
+            const double* u = &tab[(n+P/2)*W];
+            for (int x=0; x<W; ++x) {
+              const bool same = (t[x] >= cmp[x] && u[x] >= cmp[x]) ||
+                (t[x] < cmp[x] && u[x] < cmp[x]);
+              const bool larger = fabs(t[x]-cmp[x]) > fabs(u[x]-cmp[x]);
+              code[x] = (code[x] << 2) +
+                (same ? (larger ? 3u : 2u) : (larger ? 0u : 1u));
+            }
+          }
+        }
+
+        // the codes are uint16_t in processNoCheck() (bits shifted out are
+        // lost, e.g. with 16 neighbours and the average bit)
+        for (int x=0; x<W; ++x)
+          dst(y,x) = m_lut_current(static_cast<uint16_t>(code[x]));
+      }
+    }
+
 } }
 
 #endif /* BOB_IP_LBP_H */
@@ -116,6 +116,27 @@ namespace bob { namespace ip {
             blitz::Array<uint16_t,2>& dst) const 
         { operator()<double>(src, dst); }
 
+      /**
+       * Extract LBP features for all the pixels of a 2D blitz::Array that
+       *   are at least border pixels away from its edges, sampling them as
+       *   if they were located at (border,border) (see LBP).
+       */
+      template <typename T> 
+        void operator()(const blitz::Array<T,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const;
+      void 
+        operator()(const blitz::Array<uint8_t,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const 
+        { operator()<uint8_t>(src, dst, border); }
+      void 
+        operator()(const blitz::Array<uint16_t,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const 
+        { operator()<uint16_t>(src, dst, border); }
+      void 
+        operator()(const blitz::Array<double,2>& src, 
+            blitz::Array<uint16_t,2>& dst, int border) const 
+        { operator()<double>(src, dst, border); }
+
       /**
        * Extract the LBP code of a 2D blitz::Array at the given 
        *   location, and return it.
@@ -150,6 +171,12 @@ namespace bob { namespace ip {
         { return getLBPShape<double>(src); }
 
     private:
+      /**
+       * Fills dy and dx with the position of the neighbours relative to the
+       *   central pixel, in the order used by processNoCheck().
+       */
+      void neighbours(double* dy, double* dx) const;
+
       /**
        * Extract the LBP code of a 2D blitz::Array at the given 
        *   location, and return it, without performing any check.
@@ -176,22 +203,31 @@ namespace bob { namespace ip {
       bob::core::array::assertZeroBase(src);
       bob::core::array::assertZeroBase(dst);
       bob::core::array::assertSameShape(dst, getLBPShape(src) );
+      double dy[4], dx[4];
+      neighbours(dy, dx);
       if( m_circular)
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP4R::processNoCheck<T,true>(src, 
-                  static_cast<int>(ceil(m_R))+y, static_cast<int>(ceil(m_R2))+x);
-      }
+        bulk_(src, dst, dy, dx, static_cast<int>(ceil(m_R)),
+            static_cast<int>(ceil(m_R2)), false, 0.2, false);
       else
-      {
-        for(int y=0; y<dst.extent(0); ++y)
-          for(int x=0; x<dst.extent(1); ++x)
-            dst(y,x) = 
-              bob::ip::LBP4R::processNoCheck<T,false>(src, 
-                  static_cast<int>(m_R_rect)+y, static_cast<int>(m_R2_rect)+x);
-      }
+        bulk_(src, dst, dy, dx, m_R_rect, m_R2_rect, false, 0.2, false);
+    }
+
+  template <typename T>
+    void bob::ip::LBP4R::operator()(const blitz::Array<T,2>& src,  
+        blitz::Array<uint16_t,2>& dst, int border) const
+    {
+      bob::core::array::assertZeroBase(src);
+      bob::core::array::assertZeroBase(dst);
+      const int min_border = m_circular ?
+        static_cast<int>(ceil(std::max(m_R, m_R2))) : std::max(m_R_rect, m_R2_rect);
+      if( border < min_border || 2*border > std::min(src.extent(0), src.extent(1)) )
+        throw bob::core::InvalidArgumentException("border", border, min_border,
+            std::min(src.extent(0), src.extent(1))/2);
+      bob::core::array::assertSameShape(dst, 
+          blitz::TinyVector<int,2>(src.extent(0)-2*border, src.extent(1)-2*border));
+      double dy[4], dx[4];
+      neighbours(dy, dx);
+      bulk_(src, dst, dy, dx, border, border, true, 0.2, false);
     }
 
   template <typename T> 
@@ -231,26 +231,29 @@ namespace bob { namespace ip {
         throw bob::core::InvalidArgumentException("Width parameter in  YT ", yt.extent(2), limitWidth, limitWidth);
 
 
-      //for each element in time domain (the simplest way to see what is happening)
-      for(int i=max_radius;i<(Tlength-max_radius);i++){
-        for (int j=max_radius; j < (height-max_radius); j++) {
-          for (int k=max_radius; k < (width-max_radius); k++) {
-            /*Getting the "micro-plane" for XY calculus*/
-            const blitz::Array<T,2> kxy = 
-               src( i, blitz::Range(j-max_radius,j+max_radius), blitz::Range(k-max_radius,k+max_radius));
-            xy(i-max_radius,j-max_radius,k-max_radius) = m_lbp_xy->operator()(kxy, max_radius, max_radius);
-
-            /*Getting the "micro-plane" for XT calculus*/
-            const blitz::Array<T,2> kxt = 
-               src(blitz::Range(i-max_radius,i+max_radius),j,blitz::Range(k-max_radius,k+max_radius));
-            xt(i-max_radius,j-max_radius,k-max_radius) = m_lbp_xt->operator()(kxt, max_radius, max_radius);
-
-            /*Getting the "micro-plane" for YT calculus*/
-            const blitz::Array<T,2> kyt = 
-               src(blitz::Range(i-max_radius,i+max_radius),blitz::Range(j-max_radius,j+max_radius),k);
-            yt(i-max_radius,j-max_radius,k-max_radius) = m_lbp_yt->operator()(kyt, max_radius, max_radius);
-          }
-        }
+      // each plane of the volume is processed in one go, sampling every
+      // voxel as if it was the center of its (2*max_radius+1)^2 block
+      const blitz::Range all = blitz::Range::all();
+
+      /*XY planes: one per frame*/
+      for (int i=max_radius; i < (Tlength-max_radius); i++) {
+        const blitz::Array<T,2> pxy = src(i, all, all);
+        blitz::Array<uint16_t,2> cxy = xy(i-max_radius, all, all);
+        m_lbp_xy->operator()(pxy, cxy, max_radius);
+      }
+
+      /*XT planes: one per row*/
+      for (int j=max_radius; j < (height-max_radius); j++) {
+        const blitz::Array<T,2> pxt = src(all, j, all);
+        blitz::Array<uint16_t,2> cxt = xt(all, j-max_radius, all);
+        m_lbp_xt->operator()(pxt, cxt, max_radius);
+      }
+
+      /*YT planes: one per column*/
+      for (int k=max_radius; k < (width-max_radius); k++) {
+        const blitz::Array<T,2> pyt = src(all, all, k);
+        blitz::Array<uint16_t,2> cyt = yt(all, all, k-max_radius);
+        m_lbp_yt->operator()(pyt, cyt, max_radius);
       }
     }
 } }
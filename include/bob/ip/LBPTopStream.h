@@ -0,0 +1,202 @@
+/**
+ * @file bob/ip/LBPTopStream.h
+ * @date Sun Oct 18 11:02:17 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Computes LBP-Top histograms over a sliding temporal window of a
+ * stream of frames.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IP_LBPTOPSTREAM_H
+#define BOB_IP_LBPTOPSTREAM_H
+
+#include <stdint.h>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include "bob/core/assert.h"
+#include "bob/ip/LBP.h"
+#include "bob/ip/LBPTop.h"
+
+namespace bob { namespace ip {
+
+  /**
+   * The LBPTopStream class computes LBP-Top histograms over a sliding
+   * temporal window of a stream of <b>grayscale</b> frames (for instance,
+   * decoded one by one with bob::io::VideoReader::const_iterator), at frame
+   * rate.
+   *
+   * Frames are pushed one at a time. The last 2R+1 frames (R being the
+   * largest radius of the three LBP operators, as in LBPTop) are kept in a
+   * ring buffer. Once it is full, every new frame completes the temporal
+   * neighbourhood of the frame R positions behind it (the central frame),
+   * whose XY, XT and YT codes are computed once, exactly as LBPTop would, and
+   * accumulated into one histogram per plane. The window histograms are the
+   * sums of the histograms of the last 'window' central frames. They are
+   * updated incrementally: the histograms of the frame leaving the window
+   * are subtracted.
+   *
+   * After W+2R frames have been pushed, the window histograms are equal to
+   * the histograms of the codes LBPTop produces for the volume made of the
+   * last W+2R frames.
+   */
+  class LBPTopStream {
+
+    public: //api
+
+      /**
+       * Constructor
+       *
+       * @param lbptop The LBP-Top configuration (the three LBP operators are
+       * copied)
+       * @param window The number of central frames the histograms are
+       * accumulated over
+       */
+      LBPTopStream(const bob::ip::LBPTop& lbptop, size_t window);
+
+      /**
+       * Destructor
+       */
+      virtual ~LBPTopStream();
+
+      /**
+       * Forgets all the frames pushed so far. The frame size is reset as
+       * well.
+       */
+      void reset();
+
+      /**
+       * Pushes the next frame of the stream. All frames should have the same
+       * size, which has to be at least 2R+1 in both directions.
+       *
+       * @return true if the window histograms cover a full window
+       */
+      template <typename T> bool push(const blitz::Array<T,2>& frame);
+      bool push(const blitz::Array<uint8_t,2>& frame)
+      { return push<uint8_t>(frame); }
+      bool push(const blitz::Array<uint16_t,2>& frame)
+      { return push<uint16_t>(frame); }
+      bool push(const blitz::Array<double,2>& frame)
+      { return push<double>(frame); }
+
+      /**
+       * If the window histograms cover a full window
+       */
+      inline bool isReady() const { return m_n_central >= m_window; }
+
+      /**
+       * The number of frames pushed since the last reset()
+       */
+      inline size_t getNFrames() const { return m_n_frames; }
+
+      /**
+       * The number of central frames processed since the last reset()
+       */
+      inline size_t getNProcessed() const { return m_n_central; }
+
+      /**
+       * The number of central frames the histograms are accumulated over
+       */
+      inline size_t getWindow() const { return m_window; }
+
+      /**
+       * The temporal (and spatial) border R: the number of frames a central
+       * frame lags behind the last pushed one
+       */
+      inline int getRadius() const { return m_radius; }
+
+      /**
+       * The XY, XT and YT codes of the last processed central frame. Their
+       * size is (height-2R, width-2R).
+       */
+      inline const blitz::Array<uint16_t,2>& getXY() const { return m_xy; }
+      inline const blitz::Array<uint16_t,2>& getXT() const { return m_xt; }
+      inline const blitz::Array<uint16_t,2>& getYT() const { return m_yt; }
+
+      /**
+       * The XY, XT and YT histograms over the current window. They have as
+       * many bins as labels of the respective LBP operator.
+       */
+      inline const blitz::Array<uint64_t,1>& getXYHistogram() const
+      { return m_sum_xy; }
+      inline const blitz::Array<uint64_t,1>& getXTHistogram() const
+      { return m_sum_xt; }
+      inline const blitz::Array<uint64_t,1>& getYTHistogram() const
+      { return m_sum_yt; }
+
+    private: //helpers
+
+      /**
+       * Allocates the buffers for frames of the given size
+       */
+      void resize(int height, int width);
+
+      /**
+       * Processes the central frame, once the ring buffer is full, and
+       * updates the window histograms
+       */
+      void update();
+
+      LBPTopStream(const LBPTopStream&);
+      LBPTopStream& operator= (const LBPTopStream&);
+
+    private: //representation
+
+      boost::shared_ptr<bob::ip::LBP> m_lbp_xy; ///< LBP for the XY plane
+      boost::shared_ptr<bob::ip::LBP> m_lbp_xt; ///< LBP for the XT plane
+      boost::shared_ptr<bob::ip::LBP> m_lbp_yt; ///< LBP for the YT plane
+      int m_radius; ///< the border, in all directions
+      size_t m_window; ///< number of central frames per window
+
+      blitz::Array<double,3> m_frames; ///< ring buffer of the last 2R+1 frames
+      size_t m_n_frames; ///< frames pushed since the last reset
+      size_t m_n_central; ///< central frames processed since the last reset
+
+      blitz::Array<double,2> m_plane_xt; ///< XT plane of the current row
+      blitz::Array<double,2> m_plane_yt; ///< YT plane of the current column
+      blitz::Array<uint16_t,2> m_codes_xt; ///< XT codes of the current row
+      blitz::Array<uint16_t,2> m_codes_yt; ///< YT codes of the current column
+      blitz::Array<uint16_t,2> m_xy; ///< XY codes of the central frame
+      blitz::Array<uint16_t,2> m_xt; ///< XT codes of the central frame
+      blitz::Array<uint16_t,2> m_yt; ///< YT codes of the central frame
+
+      blitz::Array<uint64_t,2> m_hist_xy; ///< XY histograms in the window
+      blitz::Array<uint64_t,2> m_hist_xt; ///< XT histograms in the window
+      blitz::Array<uint64_t,2> m_hist_yt; ///< YT histograms in the window
+      blitz::Array<uint64_t,1> m_sum_xy; ///< XY histogram of the window
+      blitz::Array<uint64_t,1> m_sum_xt; ///< XT histogram of the window
+      blitz::Array<uint64_t,1> m_sum_yt; ///< YT histogram of the window
+  };
+
+  template <typename T>
+    bool bob::ip::LBPTopStream::push(const blitz::Array<T,2>& frame)
+    {
+      bob::core::array::assertZeroBase(frame);
+      if (m_n_frames == 0) resize(frame.extent(0), frame.extent(1));
+      else bob::core::array::assertSameShape(frame,
+          blitz::TinyVector<int,2>(m_frames.extent(1), m_frames.extent(2)));
+
+      const blitz::Range all = blitz::Range::all();
+      m_frames(m_n_frames % m_frames.extent(0), all, all) =
+        blitz::cast<double>(frame);
+      ++m_n_frames;
+      update();
+      return isReady();
+    }
+
+} }
+
+#endif /* BOB_IP_LBPTOPSTREAM_H */
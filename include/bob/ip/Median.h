@@ -23,8 +23,12 @@
 #ifndef BOB_IP_MEDIAN_H
 #define BOB_IP_MEDIAN_H
 
-#include <boost/shared_ptr.hpp>
-#include <list>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 #include "bob/core/assert.h"
 #include "bob/core/cast.h"
 #include "bob/ip/Exception.h"
@@ -39,50 +43,25 @@ namespace bob {
   namespace ip {
 
     namespace detail {
+      /**
+       * @brief Unsigned integer types with at most 16 bits are filtered
+       * using histograms, all other types by selection.
+       */
       template <typename T>
-      struct Pixel {
-        int y;
-        int x;
-        T value;
-        Pixel(): y(0), x(0), value(0) {}
-        Pixel(int b, int a, T v): y(b), x(a), value(v) {}
-      };
-
-      template <typename T>
-      void listInsertPixel(const boost::shared_ptr<Pixel<T> > p, 
-                           std::list<boost::shared_ptr<Pixel<T> > >& l)
-      {
-        typename std::list<boost::shared_ptr<Pixel<T> > >::iterator it=l.begin();
-        for( ; it!=l.end(); ++it)
-          if( p->value > (*it)->value) break;
-        l.insert(it, p);
-      }
-
-      template <typename T>
-      T listGetValueAtPosition(const int pos, 
-        const std::list<boost::shared_ptr<Pixel<T> > >& l)
-      { 
-        typename std::list<boost::shared_ptr<Pixel<T> > >::const_iterator it=l.begin();
-        int c=0;
-        for( ; it!=l.end(); ++it, ++c)
-          if( c==pos) return (*it)->value;
-        throw bob::ip::Exception();
-      }
-    
-      template <typename T>
-      void printList(const std::list<boost::shared_ptr<Pixel<T> > >& l)
-      {
-        typename std::list<boost::shared_ptr<Pixel<T> > >::const_iterator it=l.begin();
-        for( ; it!=l.end(); ++it)
-        {
-          std::cout << "(" << (*it)->y << "," << (*it)->x << "," << (*it)->value << ") - ";
-        }
-        std::cout << std::endl;
-      }
+      struct median_use_histogram: boost::integral_constant<bool,
+        std::numeric_limits<T>::is_integer &&
+        !std::numeric_limits<T>::is_signed && sizeof(T) <= 2> {};
     }
 
     /**
       * @brief This class allows to filter an image with a median filter
+      *
+      * uint8 and uint16 images are filtered with a sliding histogram
+      * (Huang's algorithm): moving the window by one pixel removes one column
+      * and adds another one to the histogram, and the median is tracked
+      * incrementally from the previous one. Other types (e.g. double) are
+      * filtered by a partial selection (std::nth_element) on each window.
+      * Rows of the output can be distributed over several threads.
       */
     template <typename T> 
     class Median
@@ -95,7 +74,8 @@ namespace bob {
          */
         Median(const size_t radius_y=1, const size_t radius_x=1): 
           m_radius_y(radius_y), m_radius_x(radius_x),
-          m_median_pos((2*radius_y+1)*(2*radius_x+1)/2)
+          m_median_pos((2*radius_y+1)*(2*radius_x+1)/2),
+          m_n_threads(1)
         {
         }
 
@@ -113,6 +93,14 @@ namespace bob {
           m_median_pos = (2*(int)radius_y+1)*(2*(int)radius_x+1)/2;
         }
 
+        /**
+         * @brief The number of threads the rows of the output are
+         * distributed over (default: 1)
+         */
+        size_t getNThreads() const { return m_n_threads; }
+        void setNThreads(const size_t n_threads)
+        { m_n_threads = std::max(n_threads, (size_t)1); }
+
         /**
          * @brief Processes a 2D blitz Array/Image
          * @param src The 2D input blitz array
@@ -132,18 +120,22 @@ namespace bob {
 
       private:
         /**
-          * @brief Initializes the ordered lists of values
+          * @brief Filters the output rows [y0,y1[ using a sliding histogram
+          */
+        void filterRows(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+          const int y0, const int y1, boost::true_type) const;
+
+        /**
+          * @brief Filters the output rows [y0,y1[ using partial selection
           */
-        void initLists(const blitz::Array<T,2>& src);
+        void filterRows(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+          const int y0, const int y1, boost::false_type) const;
+
         /**
-          * @brief Efficiently updates the ordered lists
+          * @brief Filters the output rows of the given stripe
           */
-        void listRemoveAddColumn(const int j, const int i, 
-                const blitz::Array<T,2>& src, 
-                std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l);
-        void listRemoveAddRow(const int j, const int i, 
-                const blitz::Array<T,2>& src, 
-                std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l);
+        void filterStripe(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+          const int stripe, const int n_stripes) const;
 
         /**
          * @brief Attributes
@@ -151,71 +143,103 @@ namespace bob {
         int m_radius_y;
         int m_radius_x;
         int m_median_pos;
-
-        std::list<boost::shared_ptr<struct detail::Pixel<T> > > m_list_current;
-        std::list<boost::shared_ptr<struct detail::Pixel<T> > > m_list_first_col;
+        size_t m_n_threads;
     };
 
     template <typename T>
-    void bob::ip::Median<T>::initLists(const blitz::Array<T,2>& src)
+    void bob::ip::Median<T>::filterRows(const blitz::Array<T,2>& src,
+      blitz::Array<T,2>& dst, const int y0, const int y1,
+      boost::true_type) const
     {
-      // Clears content
-      m_list_first_col.clear();
-      m_list_current.clear();
-      typedef struct bob::ip::detail::Pixel<T> Pix;
-      typedef typename std::list<boost::shared_ptr<Pix> >::iterator ListIterator;
-      for(int j=0; j<2*m_radius_y+1; ++j)
-        for(int i=0; i<2*m_radius_x+1; ++i)
+      const int wy = 2*m_radius_y+1;
+      const int wx = 2*m_radius_x+1;
+      const int pos = m_median_pos;
+
+      // histogram of the window, 'median' is the current median and 'below'
+      // the number of values in the window that are smaller than it
+      std::vector<int> hist((size_t)std::numeric_limits<T>::max()+1, 0);
+      int median = 0;
+      int below = 0;
+
+      for (int j=y0; j<y1; ++j)
+      {
+        // initial window of the row, starting from the median of the
+        // previous row
+        below = 0;
+        for (int y=j; y<j+wy; ++y)
+          for (int x=0; x<wx; ++x) {
+            const int v = src(y,x);
+            ++hist[v];
+            if (v < median) ++below;
+          }
+
+        for (int i=0; i<dst.extent(1); ++i)
         {
-          boost::shared_ptr<Pix> pix(new Pix(j,i,src(j,i)));
-          bob::ip::detail::listInsertPixel(pix, m_list_first_col);
+          if (i > 0) {
+            // slides the window: removes column i-1, adds column i+wx-1
+            for (int y=j; y<j+wy; ++y) {
+              const int v_old = src(y,i-1);
+              const int v_new = src(y,i+wx-1);
+              --hist[v_old];
+              if (v_old < median) --below;
+              ++hist[v_new];
+              if (v_new < median) ++below;
+            }
+          }
+
+          // moves the median to the smallest value with more than 'pos'
+          // values smaller than or equal to it
+          while (below > pos) {
+            --median;
+            below -= hist[median];
+          }
+          while (below + hist[median] <= pos) {
+            below += hist[median];
+            ++median;
+          }
+          dst(j,i) = static_cast<T>(median);
         }
-      m_list_current = m_list_first_col;
-    }
 
+        // empties the histogram for the next row
+        const int last = dst.extent(1) - 1;
+        for (int y=j; y<j+wy; ++y)
+          for (int x=last; x<last+wx; ++x)
+            --hist[src(y,x)];
+        median = dst(j,0);
+      }
+    }
 
     template <typename T>
-    void bob::ip::Median<T>::listRemoveAddColumn(const int j, const int i,
-                  const blitz::Array<T,2>& src,
-                  std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l)
+    void bob::ip::Median<T>::filterRows(const blitz::Array<T,2>& src,
+      blitz::Array<T,2>& dst, const int y0, const int y1,
+      boost::false_type) const
     {
-      // Erases elements from column i
-      typename std::list<boost::shared_ptr<struct detail::Pixel<T> > >::iterator it=l.begin();
-      for( ; it!=l.end(); )
-      {
-        if( (*it)->x == i) it = l.erase(it);
-        else ++it;
-      }
-      // Adds elements from new column i+2*m_radius_x+1
-      blitz::Array<T,1> col_new = src(blitz::Range(j,j+2*m_radius_y), i+2*m_radius_x+1);
-      for(int k=0; k<col_new.extent(0); ++k)
-      {
-        boost::shared_ptr<struct detail::Pixel<T> > pix(
-          new struct detail::Pixel<T>(j+k,i+2*m_radius_x+1,src(j+k,i+2*m_radius_x+1)));
-        bob::ip::detail::listInsertPixel(pix, l);
-      }
+      const int wy = 2*m_radius_y+1;
+      const int wx = 2*m_radius_x+1;
+      std::vector<T> window(wy*wx);
+
+      for (int j=y0; j<y1; ++j)
+        for (int i=0; i<dst.extent(1); ++i)
+        {
+          typename std::vector<T>::iterator it = window.begin();
+          for (int y=j; y<j+wy; ++y)
+            for (int x=i; x<i+wx; ++x, ++it)
+              *it = src(y,x);
+          std::nth_element(window.begin(), window.begin() + m_median_pos,
+            window.end());
+          dst(j,i) = window[m_median_pos];
+        }
     }
 
     template <typename T>
-    void bob::ip::Median<T>::listRemoveAddRow(const int j, const int i,
-                  const blitz::Array<T,2>& src,
-                  std::list<boost::shared_ptr<struct detail::Pixel<T> > >& l)
+    void bob::ip::Median<T>::filterStripe(const blitz::Array<T,2>& src,
+      blitz::Array<T,2>& dst, const int stripe, const int n_stripes) const
     {
-      // Erases elements from row j 
-      typename std::list<boost::shared_ptr<struct detail::Pixel<T> > >::iterator it=l.begin();
-      for( ; it!=l.end(); )
-      {
-        if( (*it)->y == j) it = l.erase(it);
-        else ++it;
-      }
-      // Adds elements from new row j+2*m_radius_y+2
-      blitz::Array<T,1> col_new = src(j+2*m_radius_y+1,blitz::Range(i,i+2*m_radius_x));
-      for(int k=0; k<col_new.extent(0); ++k)
-      {
-        boost::shared_ptr<struct detail::Pixel<T> > pix(
-          new struct detail::Pixel<T>(j+2*m_radius_y+1,i+k,src(j+2*m_radius_y+1,i+k)));
-        bob::ip::detail::listInsertPixel(pix, l);
-      }
+      const int height = dst.extent(0);
+      const int y0 = (int)((long)height * stripe / n_stripes);
+      const int y1 = (int)((long)height * (stripe+1) / n_stripes);
+      if (y0 < y1)
+        filterRows(src, dst, y0, y1, detail::median_use_histogram<T>());
     }
 
     template <typename T> 
@@ -229,28 +253,20 @@ namespace bob {
       dst_size(0) = src.extent(0) - 2 * m_radius_y;
       dst_size(1) = src.extent(1) - 2 * m_radius_x;
       bob::core::array::assertSameShape(dst, dst_size);
+      if (dst.extent(0) == 0 || dst.extent(1) == 0) return;
 
-      // Initializes the lists
-      initLists(src);
-
-      // Filters
-      for(int j=0; j<dst.extent(0); ++j)
-      {
-        for(int i=0; i<dst.extent(1); ++i)
-        {
-          dst(j,i) = bob::ip::detail::listGetValueAtPosition( m_median_pos, m_list_current);
-          // Updates current ordered list
-          if( i<dst.extent(1) - 1) {
-            listRemoveAddColumn(j, i, src, m_list_current);
-          }
-        }
-        // Updates current ordered list
-        if(j<dst.extent(0)-1)
-        {
-          listRemoveAddRow(j, 0, src, m_list_first_col);
-          m_list_current = m_list_first_col;
-        }
+      // Filters, distributing stripes of rows over the threads
+      const int n_stripes = (int)std::min(m_n_threads, (size_t)dst.extent(0));
+      if (n_stripes <= 1) {
+        filterStripe(src, dst, 0, 1);
+        return;
       }
+      boost::thread_group threads;
+      for (int t=1; t<n_stripes; ++t)
+        threads.create_thread(boost::bind(&bob::ip::Median<T>::filterStripe,
+              this, boost::cref(src), boost::ref(dst), t, n_stripes));
+      filterStripe(src, dst, 0, n_stripes);
+      threads.join_all();
     }
 
     template <typename T> 
@@ -104,6 +104,7 @@ class SIFT
     { return m_descr_gaussian_window_size; }
     double getMagnif() const { return m_descr_magnif; }
     double getNormEpsilon() const { return m_norm_eps; }
+    size_t getNThreads() const { return m_gss->getNThreads(); }
 
     /**
      * @brief Setters
@@ -142,6 +143,13 @@ class SIFT
     { m_descr_magnif = magnif; }
     void setNormEpsilon(const double norm_eps)
     { m_norm_eps = norm_eps; }
+    /**
+     * @brief Sets the number of threads used to compute the Gaussian
+     * pyramid (rows of each image), as well as the Difference of Gaussians
+     * and the gradients (octaves). The results do not depend on it.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_gss->setNThreads(n_threads); }
 
     /** 
      * @brief  Automatically sets sigma0 to a value such that there is no
@@ -193,15 +201,19 @@ class SIFT
     template <typename T> 
     void computeGaussianPyramid(const blitz::Array<T,2>& src);
     /**
-     * @brief Computes the Difference of Gaussians pyramid
+     * @brief Computes the Difference of Gaussians pyramid and the gradients 
+     * of the Gaussian pyramid, the octaves being split between threads.
      * @warning assumes that the Gaussian pyramid has already been computed
      */
-    void computeDog();
+    void computeDogAndGradient();
 
     /**
-     * @brief Computes gradients from the Gaussian pyramid
+     * @brief Computes the Difference of Gaussians and the gradients (as
+     * bob::ip::GradientMaps) of the octaves o, o+step, o+2*step, ...
+     * @warning Only accesses the elements of the arrays, such that distinct
+     * octaves can be processed by distinct threads.
      */
-    void computeGradient();
+    void computeDogAndGradient(const size_t o, const size_t step);
 
     /**
      * @brief Compute SIFT descriptors for the given keypoints
@@ -249,7 +261,6 @@ class SIFT
     std::vector<blitz::Array<double,3> > m_dog_pyr;
     std::vector<blitz::Array<double,3> > m_gss_pyr_grad_mag;
     std::vector<blitz::Array<double,3> > m_gss_pyr_grad_or;
-    std::vector<boost::shared_ptr<bob::ip::GradientMaps> > m_gradient_maps;
    
 
     /**
@@ -267,10 +278,9 @@ void bob::ip::SIFT::computeDescriptor(const blitz::Array<T,2>& src,
 {
   // Computes the Gaussian pyramid
   computeGaussianPyramid(src);
-  // Computes the Difference of Gaussians pyramid
-  computeDog();
-  // Computes the Gradient of the Gaussians pyramid
-  computeGradient();
+  // Computes the Difference of Gaussians pyramid and the Gradient of the 
+  // Gaussians pyramid
+  computeDogAndGradient();
   // Computes the descriptors for the given keypoints
   computeDescriptor(keypoints, dst);
 }
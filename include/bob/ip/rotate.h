@@ -33,6 +33,7 @@
 #include "bob/ip/Exception.h"
 #include "bob/ip/shear.h"
 #include "bob/ip/crop.h"
+#include "bob/ip/warp.h"
 
 
 namespace bob {
@@ -353,6 +354,47 @@ template<typename T, bool mask>
 }
 
 
+/**
+  * @brief Function which rotates a 2D blitz::array/image around its center
+  *   using bilinear interpolation. The center of the source image is mapped
+  *   to the center of the destination image; pixels outside the source image
+  *   are set to zero.
+  * @warning No check is performed on the dst blitz::array/image.
+  * @param src The input blitz array
+  * @param src_mask The mask for the input image
+  * @param dst The output blitz array
+  * @param dst_mask The mask for the output image (that will be generated)
+  * @param angle The angle of the rotation (in degrees)
+  */
+template<typename T, bool mask>
+  static inline void rotateBilinearNoCheck(
+    const blitz::Array<T,2>& src, 
+    const blitz::Array<bool,2>& src_mask, 
+    blitz::Array<double,2>& dst,
+    blitz::Array<bool,2>& dst_mask, 
+    const double angle
+  )
+{
+  const double rad_angle = angle * M_PI / 180.;
+  const double sin_angle = sin(rad_angle), cos_angle = cos(rad_angle);
+
+  // centers of the source and destination images
+  const double src_c_y = (src.extent(0) - 1) / 2.;
+  const double src_c_x = (src.extent(1) - 1) / 2.;
+  const double dst_c_y = (dst.extent(0) - 1) / 2.;
+  const double dst_c_x = (dst.extent(1) - 1) / 2.;
+
+  // the destination pixel (y,x) is taken from the source position
+  // (src_c_y + cos*(y-dst_c_y) + sin*(x-dst_c_x),
+  //  src_c_x + cos*(x-dst_c_x) - sin*(y-dst_c_y)),
+  // which is consistent with rotateNoCheck_90() for 90 degrees
+  const double origin_y = src_c_y - cos_angle * dst_c_y - sin_angle * dst_c_x;
+  const double origin_x = src_c_x - cos_angle * dst_c_x + sin_angle * dst_c_y;
+  bob::ip::detail::bilinearWarp<T,mask>(src, src_mask, dst, dst_mask,
+    origin_y, origin_x, sin_angle, cos_angle);
+}
+
+
 /**
   * @brief Function which rotates a 2D blitz::array/image 
   * @warning No check is performed on the dst blitz::array/image.
@@ -406,6 +448,9 @@ template<typename T, bool mask>
     case bob::ip::Rotate::Shearing:
       rotateShearingNoCheck<T,mask>(src, src_mask, dst, dst_mask, angle_norm);
       break;
+    case bob::ip::Rotate::BilinearInterp:
+      rotateBilinearNoCheck<T,mask>(src, src_mask, dst, dst_mask, angle_norm);
+      break;
     default:
       throw bob::ip::UnknownRotatingAlgorithm();
   }
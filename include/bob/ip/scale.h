@@ -23,6 +23,7 @@
 #ifndef BOB_IP_SCALE_H
 #define BOB_IP_SCALE_H
 
+#include <vector>
 #include "bob/core/assert.h"
 #include "bob/core/array_index.h"
 #include "bob/core/cast.h"
@@ -59,6 +60,19 @@ namespace bob {
 
         const double x_ratio = (src.extent(1)-1.) / (width-1.);
         const double y_ratio = (src.extent(0)-1.) / (height-1.);
+
+        // the interpolation weights and indices along the x-axis are the
+        // same for all the rows: they are computed only once
+        std::vector<double> dx1(width), dx2(width);
+        std::vector<int> x_ind1(width), x_ind2(width);
+        for( int x=0; x<width; ++x) {
+          double x_src = x_ratio * x;
+          dx2[x] = x_src - floor(x_src);
+          dx1[x] = 1. - dx2[x];
+          x_ind1[x] = bob::core::array::keepInRange( floor(x_src), 0, src.extent(1)-1);
+          x_ind2[x] = bob::core::array::keepInRange( x_ind1[x]+1, 0, src.extent(1)-1);
+        }
+
         for( int y=0; y<height; ++y) {
           double y_src = y_ratio * y;
           double dy2 = y_src - floor(y_src);
@@ -66,18 +80,13 @@ namespace bob {
           int y_ind1 = bob::core::array::keepInRange( floor(y_src), 0, src.extent(0)-1);
           int y_ind2 = bob::core::array::keepInRange( y_ind1+1, 0, src.extent(0)-1);
           for( int x=0; x<width; ++x) {
-            double x_src = x_ratio * x;
-            double dx2 = x_src - floor(x_src);
-            double dx1 = 1. - dx2;
-            int x_ind1 = bob::core::array::keepInRange( floor(x_src), 0, src.extent(1)-1);
-            int x_ind2 = bob::core::array::keepInRange( x_ind1+1, 0, src.extent(1)-1);
-            double val = dx1*dy1*src(y_ind1, x_ind1)+dx1*dy2*src(y_ind2, x_ind1)
-              + dx2*dy1*src(y_ind1, x_ind2 )+dx2*dy2*src(y_ind2, x_ind2 );
+            double val = dx1[x]*dy1*src(y_ind1, x_ind1[x])+dx1[x]*dy2*src(y_ind2, x_ind1[x])
+              + dx2[x]*dy1*src(y_ind1, x_ind2[x])+dx2[x]*dy2*src(y_ind2, x_ind2[x]);
             dst(y,x) = val;
             if( mask) {
               bool all_in_mask = true;
               for( int ym=y_ind1; ym<=y_ind2; ++ym)
-                for( int xm=x_ind1; xm<=x_ind2; ++xm)
+                for( int xm=x_ind1[x]; xm<=x_ind2[x]; ++xm)
                   all_in_mask = all_in_mask && src_mask(ym,xm);
               dst_mask(y,x) = all_in_mask;
             }
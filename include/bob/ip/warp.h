@@ -0,0 +1,192 @@
+/**
+ * @file bob/ip/warp.h
+ * @date Sun Oct 18 14:58:12 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Bilinear interpolation of an image sampled on an affine grid, as
+ * used by the geometric normalization and the rotation of images.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IP_WARP_H
+#define BOB_IP_WARP_H
+
+#include <cmath>
+#include <blitz/array.h>
+
+namespace bob {
+/**
+ * \ingroup libip_api
+ * @{
+ */
+  namespace ip {
+
+    namespace detail {
+      /**
+       * @brief Bi-linearly interpolates the source image at (source_y,
+       * source_x) into res. Source pixels outside the image (or outside the
+       * mask) do not contribute. h and w are the largest row and column
+       * indices of the source image.
+       */
+      template <typename T, bool mask>
+      inline void bilinearPixel(const blitz::Array<T,2>& source,
+        const blitz::Array<bool,2>& source_mask, double& res, bool& new_mask,
+        const double source_y, const double source_x, const int h, const int w)
+      {
+        // split each source x and y in integral and decimal digits
+        const int ox = std::floor(source_x);
+        const int oy = std::floor(source_y);
+        const double mx = source_x - ox;
+        const double my = source_y - oy;
+
+        res = 0.;
+        // add the four values bi-linearly interpolated
+        if (mask){
+          new_mask = false;
+          // upper left
+          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h && source_mask(oy,ox)){
+            res += (1.-mx) * (1.-my) * source(oy,ox);
+            new_mask = true;
+          }
+          // upper right
+          if (ox >= -1 && oy >= 0 && ox < w && oy <= h && source_mask(oy,ox+1)){
+            res += mx * (1.-my) * source(oy,ox+1);
+            new_mask = true;
+          }
+          // lower left
+          if (ox >= 0 && oy >= -1 && ox <= w && oy < h && source_mask(oy+1,ox)){
+            res += (1.-mx) * my * source(oy+1,ox);
+            new_mask = true;
+          }
+          // lower right
+          if (ox >= -1 && oy >= -1 && ox < w && oy < h && source_mask(oy+1,ox+1)){
+            res += mx * my * source(oy+1,ox+1);
+            new_mask = true;
+          }
+        } else {
+          // upper left
+          if (ox >= 0 && oy >= 0 && ox <= w && oy <= h)
+            res += (1.-mx) * (1.-my) * source(oy,ox);
+
+          // upper right
+          if (ox >= -1 && oy >= 0 && ox < w && oy <= h)
+            res += mx * (1.-my) * source(oy,ox+1);
+
+          // lower left
+          if (ox >= 0 && oy >= -1 && ox <= w && oy < h)
+            res += (1.-mx) * my * source(oy+1,ox);
+
+          // lower right
+          if (ox >= -1 && oy >= -1 && ox < w && oy < h)
+            res += mx * my * source(oy+1,ox+1);
+        }
+      }
+
+      /**
+       * @brief Bi-linearly interpolates the row y of the target image, whose
+       * first pixel is located at (source_y, source_x) in the source image.
+       * Moving one pixel to the right in the target image moves (dy,dx) in
+       * the source image. Source pixels outside the image (or outside the
+       * mask) do not contribute.
+       *
+       * The source positions are monotonic along the row, hence the pixels
+       * whose four neighbours are all inside the source image form a single
+       * segment. Without mask, this segment is interpolated without any
+       * bounds check, with the same arithmetic as bilinearPixel().
+       */
+      template <typename T, bool mask>
+      void bilinearWarpRow(const blitz::Array<T,2>& source,
+        const blitz::Array<bool,2>& source_mask, blitz::Array<double,2>& target,
+        blitz::Array<bool,2>& target_mask, const int y, double source_y,
+        double source_x, const double dy, const double dx)
+      {
+        const int h = source.extent(0)-1;
+        const int w = source.extent(1)-1;
+        const int width = target.extent(1);
+
+        if (mask){
+          for (int x = 0; x < width; ++x){
+            bilinearPixel<T,true>(source, source_mask, target(y,x),
+              target_mask(y,x), source_y, source_x, h, w);
+            source_x += dx;
+            source_y += dy;
+          }
+          return;
+        }
+
+        const T* data = source.data();
+        const int s0 = source.stride(0), s1 = source.stride(1);
+        bool unused;
+        int x = 0;
+        while (x < width){
+          // pixels with (some) neighbours outside the source image
+          for (; x < width && !(source_x >= 0. && source_x < w &&
+                source_y >= 0. && source_y < h); ++x){
+            bilinearPixel<T,false>(source, source_mask, target(y,x), unused,
+              source_y, source_x, h, w);
+            source_x += dx;
+            source_y += dy;
+          }
+          // pixels with all four neighbours inside the source image
+          for (; x < width && source_x >= 0. && source_x < w &&
+                source_y >= 0. && source_y < h; ++x){
+            // floor() is a truncation for non-negative positions
+            const int ox = static_cast<int>(source_x);
+            const int oy = static_cast<int>(source_y);
+            const double mx = source_x - ox;
+            const double my = source_y - oy;
+            const T* p = data + oy*s0 + ox*s1;
+            double res = 0.;
+            res += (1.-mx) * (1.-my) * p[0];
+            res += mx * (1.-my) * p[s1];
+            res += (1.-mx) * my * p[s0];
+            res += mx * my * p[s0+s1];
+            target(y,x) = res;
+            source_x += dx;
+            source_y += dy;
+          }
+        }
+      }
+
+      /**
+       * @brief Bi-linearly interpolates the target image, whose pixel (0,0)
+       * is located at (origin_y, origin_x) in the source image. Moving one
+       * pixel to the right in the target image moves (dy,dx) in the source
+       * image, moving one pixel down moves (dx,-dy).
+       */
+      template <typename T, bool mask>
+      void bilinearWarp(const blitz::Array<T,2>& source,
+        const blitz::Array<bool,2>& source_mask, blitz::Array<double,2>& target,
+        blitz::Array<bool,2>& target_mask, double origin_y, double origin_x,
+        const double dy, const double dx)
+      {
+        for (int y = 0; y < target.extent(0); ++y){
+          bilinearWarpRow<T,mask>(source, source_mask, target, target_mask, y,
+            origin_y, origin_x, dy, dx);
+          // at the end of the row, we shift the origin to the next line
+          origin_x -= dy;
+          origin_y += dx;
+        }
+      }
+    }
+
+  }
+/**
+ * @}
+ */
+}
+
+#endif /* BOB_IP_WARP_H */
@@ -0,0 +1,141 @@
+/**
+ * @file bob/machine/GaborGraphGallery.h
+ * @date Sun Oct 18 13:21:08 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief A gallery of Gabor graphs that a probe graph can be compared to at once.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MACHINE_GABOR_GRAPH_GALLERY_H
+#define BOB_MACHINE_GABOR_GRAPH_GALLERY_H
+
+#include <vector>
+#include <blitz/array.h>
+#include <bob/machine/GaborJetSimilarities.h>
+
+namespace bob{ namespace machine {
+  /**
+   * @ingroup MACHINE
+   * @{
+   */
+
+  //! \brief A gallery of Gabor graphs (of the same topology) for 1:N identification.
+  //! The graphs are stored contiguously, with the absolute values and the phases of all Gabor jets in separate blocks,
+  //! optionally in single precision.
+  //! A probe graph is compared to all gallery graphs with the given Gabor jet similarity function,
+  //! giving the same scores as GaborGraphMachine::similarity() does for each single gallery graph.
+  //! The gallery is split into tiles, which are processed by several threads.
+  class GaborGraphGallery {
+    public:
+      //! \brief Creates an empty gallery that compares graphs with the given Gabor jet similarity function.
+      //! If single_precision is enabled, the gallery graphs are stored as floats.
+      GaborGraphGallery(
+        const bob::machine::GaborJetSimilarity& jet_similarity_function,
+        bool single_precision = false
+      );
+
+      //! adds a Gabor graph with absolute values and phases (#nodes x 2 x #kernels) to the gallery
+      void add(const blitz::Array<double,3>& graph_jets);
+
+      //! adds a Gabor graph with absolute values only (#nodes x #kernels) to the gallery
+      void add(const blitz::Array<double,2>& graph_jets);
+
+      //! adds several Gabor graphs with absolute values and phases (#graphs x #nodes x 2 x #kernels) to the gallery
+      void add(const blitz::Array<double,4>& many_graph_jets);
+
+      //! removes all graphs from the gallery
+      void clear();
+
+      //! the number of graphs in the gallery
+      int size() const {return m_size;}
+
+      //! the number of nodes per graph (0 for an empty gallery)
+      int numberOfNodes() const {return m_number_of_nodes;}
+
+      //! the number of Gabor wavelets per jet (0 for an empty gallery)
+      int numberOfKernels() const {return m_number_of_kernels;}
+
+      //! if the gallery graphs are stored in single precision
+      bool singlePrecision() const {return m_single_precision;}
+
+      //! the number of threads the gallery tiles are distributed over (default: 1)
+      unsigned numberOfThreads() const {return m_number_of_threads;}
+      void setNumberOfThreads(unsigned number_of_threads);
+
+      //! \brief computes the similarities of the given probe graph (with phases) to all gallery graphs
+      //! (scores needs to have size() elements)
+      void similarities(
+        const blitz::Array<double,3>& probe_graph_jets,
+        blitz::Array<double,1>& scores
+      ) const;
+
+      //! \brief computes the similarities of the given probe graph (absolute values only) to all gallery graphs
+      void similarities(
+        const blitz::Array<double,2>& probe_graph_jets,
+        blitz::Array<double,1>& scores
+      ) const;
+
+      //! \brief returns the indices and scores of the (at most) k most similar gallery graphs,
+      //! sorted by decreasing similarity (ties are sorted by increasing index)
+      void search(
+        const blitz::Array<double,3>& probe_graph_jets,
+        int k,
+        blitz::Array<int,1>& indices,
+        blitz::Array<double,1>& scores
+      ) const;
+
+      //! \brief the same as above, for probe graphs with absolute values only
+      void search(
+        const blitz::Array<double,2>& probe_graph_jets,
+        int k,
+        blitz::Array<int,1>& indices,
+        blitz::Array<double,1>& scores
+      ) const;
+
+    private:
+      //! checks and stores the graph layout on the first graph
+      void checkLayout(int number_of_nodes, int number_of_kernels);
+
+      //! appends the jets of one graph, given its absolute values and (if required) phases, each of shape #nodes x #kernels
+      void append(const blitz::Array<double,2>& abs, const blitz::Array<double,2>* phases);
+
+      //! computes the scores of the probe (contiguous absolute values and phases of all nodes)
+      void computeScores(const double* abs, const double* phases, blitz::Array<double,1>& scores) const;
+
+      //! selects the best k scores
+      void best(const blitz::Array<double,1>& all_scores, int k, blitz::Array<int,1>& indices, blitz::Array<double,1>& scores) const;
+
+      // the Gabor jet similarity function
+      bob::machine::GaborJetSimilarity m_similarity;
+
+      // the layout of the gallery
+      bool m_single_precision;
+      int m_size, m_number_of_nodes, m_number_of_kernels;
+      unsigned m_number_of_threads;
+
+      // the absolute values and phases of all gallery graphs, each of size #graphs x #nodes x #kernels;
+      // depending on the precision, only one of the two pairs is used
+      std::vector<double> m_abs, m_phases;
+      std::vector<float> m_abs_single, m_phases_single;
+  };
+
+  /**
+   * @}
+   */
+} }
+
+#endif // BOB_MACHINE_GABOR_GRAPH_GALLERY_H
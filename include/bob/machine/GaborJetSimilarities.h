@@ -59,9 +59,40 @@ namespace bob { namespace machine {
       //! The similarity between two Gabor jets, including absolute values only
       double operator()(const blitz::Array<double,1>& jet1, const blitz::Array<double,1>& jet2) const;
 
+      //! \brief The similarity between two Gabor jets given as plain vectors of absolute values and phases.
+      //! The phases are not used (and might be NULL) for the SCALAR_PRODUCT and CANBERRA types.
+      //! This function does not modify this object and can be called from several threads concurrently.
+      //! For the disparity types, confidences and phase_differences need to point to buffers of 'length' elements,
+      //! and the estimated disparity is written to 'disparity'.
+      double similarity(
+        const double* abs1, const double* phase1,
+        const double* abs2, const double* phase2,
+        int length,
+        double* confidences, double* phase_differences,
+        blitz::TinyVector<double,2>& disparity
+      ) const;
+
+      //! \brief The same as above, where the first Gabor jet is stored in single precision
+      double similarity(
+        const float* abs1, const float* phase1,
+        const double* abs2, const double* phase2,
+        int length,
+        double* confidences, double* phase_differences,
+        blitz::TinyVector<double,2>& disparity
+      ) const;
+
       //! returns the disparity vector estimated during the last call of similarity; only valid for disparity types
       blitz::TinyVector<double,2> disparity() const {return m_disparity;}
 
+      //! returns the type of this Gabor jet similarity function
+      SimilarityType type() const {return m_type;}
+
+      //! returns true if this Gabor jet similarity function requires the Gabor phases
+      bool usesPhases() const {return m_type >= DISPARITY;}
+
+      //! returns the length of the Gabor jets that this similarity function expects (only set for the types that use phases)
+      int numberOfKernels() const {return m_confidences.size();}
+
       //! \brief saves the parameters of this Gabor jet similarity to file
       void save(bob::io::HDF5File& file) const;
 
@@ -77,10 +108,6 @@ namespace bob { namespace machine {
 
       // initializes the internal memory to be used for disparity-like Gabor jet similarities
       void init();
-      // computes confidences from the given Gabor jets
-      void compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const;
-      // computes the disparity using the m_confidences and m_phase_differences values
-      void compute_disparity() const;
 
       mutable blitz::TinyVector<double,2> m_disparity;
 
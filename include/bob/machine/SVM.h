@@ -29,6 +29,7 @@
 #include <blitz/array.h>
 #include <fstream>
 #include <bob/io/HDF5File.h>
+#include <bob/machine/LinearMachine.h>
 
 // We need to declare the svm_model type for libsvm < 3.0.0. The next bit of
 // code was cut and pasted from version 2.9.1 of libsvm, file svm.cpp.
@@ -350,6 +351,77 @@ namespace bob { namespace machine {
         (const blitz::Array<double,1>& input,
          blitz::Array<double,1>& probabilities) const;
 
+      /**
+       * Tells if this machine uses a linear kernel. In this case, support
+       * vectors are collapsed into one weight vector per decision value
+       * (w = sum_i alpha_i y_i x_i) when the model is loaded and predictions
+       * cost O(d) per decision value, independently of the number of support
+       * vectors.
+       */
+      inline bool isLinear() const { return m_linear_weight.size() != 0; }
+
+      /**
+       * Returns the collapsed weights of a linear machine, one row per
+       * decision value. The decision values are given by W.x - rho, where x
+       * is the scaled input. The returned array is empty if the machine is
+       * not linear.
+       */
+      inline const blitz::Array<double,2>& getLinearWeights() const
+      { return m_linear_weight; }
+
+      /**
+       * Converts a linear machine into an equivalent LinearMachine, with one
+       * output per decision value (see numberOfDecisionValues()) and the
+       * same input scaling. For binary problems, the output is positive for
+       * class classLabel(0) and negative for classLabel(1). Raises an
+       * exception if the machine is not linear.
+       */
+      bob::machine::LinearMachine toLinearMachine() const;
+
+      /**
+       * Tells the number of decision values produced for each input. This is
+       * 1 for regression, one-class and binary classification problems and
+       * N*(N-1)/2 (one per pair of classes) for N-class problems.
+       */
+      size_t numberOfDecisionValues() const;
+
+      /**
+       * Predicts the classes of all inputs, which are arranged row-wise in
+       * the 'input' matrix. The output 'labels' should have as many entries
+       * as there are rows in 'input'.
+       *
+       * Support vectors are kept in a dense matrix and kernels are evaluated
+       * for blocks of inputs at once, using a matrix product. This is much
+       * faster than calling predictClass() for every row, in particular for
+       * dense, high-dimensional inputs. Results match libsvm up to
+       * floating-point rounding. Models with pre-computed kernels are
+       * evaluated one row at a time through libsvm.
+       */
+      void predictClasses(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels) const;
+
+      /**
+       * Predicts the classes of all inputs. Same as above, but does not check
+       */
+      void predictClasses_(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels) const;
+
+      /**
+       * Predicts the classes and decision values for all inputs, which are
+       * arranged row-wise in the 'input' matrix. The 'scores' matrix should
+       * have as many rows as 'input' and numberOfDecisionValues() columns.
+       * See predictClasses() for details.
+       */
+      void predictClassesAndScores(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>& scores) const;
+
+      /**
+       * Predicts classes and decision values. Same as above, but does not
+       * check
+       */
+      void predictClassesAndScores_(const blitz::Array<double,2>& input,
+          blitz::Array<int,1>& labels, blitz::Array<double,2>& scores) const;
+
       /**
        * Saves the current model state to a file. With this variant, the model
        * is saved on simpler libsvm model file that does not include the
@@ -377,6 +449,21 @@ namespace bob { namespace machine {
        */
       void reset();
 
+      /**
+       * Evaluates the decision values for a block of (already scaled) inputs
+       * arranged row-wise, using the dense support vectors. 'kernel' is a
+       * scratch area with, at least, as many rows as 'input' and one column
+       * per support vector.
+       */
+      void decisionValues_(const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& kernel, blitz::Array<double,2>& dec) const;
+
+      /**
+       * Turns decision values into a class label, like svm_predict() does
+       */
+      int decide_(const blitz::Array<double,1>& dec,
+          blitz::Array<int,1>& votes) const;
+
     private: //representation
 
       boost::shared_ptr<svm_model> m_model; ///< libsvm model pointer
@@ -384,6 +471,11 @@ namespace bob { namespace machine {
       size_t m_input_size; ///< vector size expected as input for the SVM's
       blitz::Array<double,1> m_input_sub; ///< scaling: subtraction
       blitz::Array<double,1> m_input_div; ///< scaling: division
+      blitz::Array<double,2> m_sv; ///< dense support vectors, row-wise
+      blitz::Array<double,1> m_sv_norm2; ///< squared norm of each SV
+      blitz::Array<double,2> m_sv_coef; ///< SV coefficients (libsvm layout)
+      blitz::Array<int,1> m_sv_start; ///< first SV of each class
+      blitz::Array<double,2> m_linear_weight; ///< collapsed linear weights
 
   };
 
@@ -24,6 +24,7 @@
 #ifndef BOB_MATH_INTERIOR_POINT_LP_H
 #define BOB_MATH_INTERIOR_POINT_LP_H
 
+#include <vector>
 #include <blitz/array.h>
 
 namespace bob { namespace math {
@@ -43,10 +44,36 @@ namespace bob { namespace math {
  *     min transpose(c)*x, s.t. A*x=b, x>=0
  *   The dual formulation is:
  *     min transpose(b)*lambda, s.t. transpose(A)*lambda+mu=c
+ *
+ *   Each iteration computes a Newton direction (Dx,Dlambda,Dmu) by solving
+ *   the block system:
+ *     [A 0 0; 0 A^T I; S 0 X]*[Dx Dlambda Dmu] = [0 0 r]
+ *   where X=diag(x), S=diag(mu) and r=-x.*mu+sigma.nu.e. This is done
+ *   either densely, or by eliminating Dx and Dmu, which leads to the
+ *   normal equations (see chapter 11 of the same book):
+ *     A*D*A^T*Dlambda = -A*S^-1*r, with D=X*S^-1
+ *     Dmu = -A^T*Dlambda
+ *     Dx = S^-1*(r-X*Dmu)
+ *   The latter only requires the Cholesky decomposition of an MxM matrix,
+ *   instead of the LU decomposition of an (M+2N)x(M+2N) one.
  */
 class LPInteriorPoint
 {
   public:
+    /**
+     * @brief Methods to solve the Newton system of each iteration
+     *   - dense: solves the (M+2N)x(M+2N) block system with a LU
+     *     decomposition
+     *   - normal_equations: solves the MxM normal equations with a
+     *     Cholesky decomposition. A*D*A^T is assembled from the non-zero
+     *     entries of A only, which are listed once per call to solve().
+     *     This requires the dual variable mu to remain strictly positive.
+     */
+    typedef enum {
+      dense = 0,
+      normal_equations = 1
+    } solver_t;
+
     /**
      * @brief Constructor
      * @param M first dimension of the A matrix
@@ -93,6 +120,7 @@ class LPInteriorPoint
     const double getEpsilon() const { return m_epsilon; }
     const blitz::Array<double,1>& getLambda() const { return m_lambda; }
     const blitz::Array<double,1>& getMu() const { return m_mu; }
+    const solver_t getSolver() const { return m_solver; }
 
     /**
      * @brief Setters
@@ -102,6 +130,8 @@ class LPInteriorPoint
     void setDimN(const size_t N)
     { m_N = N; reset(m_M, m_N); }
     void setEpsilon(const double epsilon) { m_epsilon = epsilon; }
+    void setSolver(const solver_t solver)
+    { m_solver = solver; resetCache(); }
 
     /**
      * @brief Solve the linear program
@@ -222,6 +252,51 @@ class LPInteriorPoint
     virtual void updateLargeSystem(const blitz::Array<double,1>& x, 
       const double sigma, const int m) const;
 
+    /**
+     * @brief Initialize the normal equations system: lists the non-zero
+     *   entries of A, column by column.
+     *
+     * @param A The A matrix of the linear equalities
+     */
+    void initializeNormalSystem(const blitz::Array<double,2>& A) const;
+
+    /**
+     * @brief Compute the Newton direction [Dx Dlambda Dmu] by solving the
+     *   normal equations:
+     *     A*D*A^T*Dlambda = -A*S^-1*r, with D=X*S^-1
+     *
+     * @warning initializeNormalSystem() should have been called before.
+     *   Raises a bob::core::InvalidArgumentException if mu has entries
+     *   which are not strictly positive.
+     *
+     * @param x The current x primal solution of the linear program
+     * @param sigma The coefficient sigma which quantifies how close we 
+     *   want to stay from the central path.
+     * @param m
+     */
+    void solveNormalSystem(const blitz::Array<double,1>& x,
+      const double sigma, const int m) const;
+
+    /**
+     * @brief Initialize the system used to compute the Newton directions,
+     *   according to the selected solver.
+     *
+     * @param A The A matrix of the linear equalities
+     */
+    void initializeSystem(const blitz::Array<double,2>& A) const;
+
+    /**
+     * @brief Compute the Newton direction [Dx Dlambda Dmu] with the 
+     *   selected solver. The result is stored in m_cache_x_large.
+     *
+     * @param x The current x primal solution of the linear program
+     * @param sigma The coefficient sigma which quantifies how close we 
+     *   want to stay from the central path.
+     * @param m
+     */
+    void computeDirection(const blitz::Array<double,1>& x, 
+      const double sigma, const int m) const;
+
 
     /**
      * @brief Compute the value of the logarithmic barrier function for the
@@ -254,6 +329,7 @@ class LPInteriorPoint
     size_t m_M;
     size_t m_N;
     double m_epsilon;
+    solver_t m_solver;
     blitz::Array<double,1> m_lambda;
     blitz::Array<double,1> m_mu;
 
@@ -267,6 +343,14 @@ class LPInteriorPoint
     mutable blitz::Array<double,2> m_cache_A_large;
     mutable blitz::Array<double,1> m_cache_b_large;
     mutable blitz::Array<double,1> m_cache_x_large;
+    // Non-zero entries of A, in compressed column format
+    mutable std::vector<int> m_cache_A_colptr;
+    mutable std::vector<int> m_cache_A_rowind;
+    mutable std::vector<double> m_cache_A_values;
+    mutable blitz::Array<double,2> m_cache_A_normal;
+    mutable blitz::Array<double,1> m_cache_b_normal;
+    mutable blitz::Array<double,1> m_cache_d;
+    mutable blitz::Array<double,1> m_cache_r;
 };
 
 /**
@@ -89,6 +89,37 @@ namespace math {
       prod_(A, B, C);
     }
 
+  /**
+   * @brief Performs the matrix multiplication C=A*B^T, using the BLAS dgemm
+   * function
+   *
+   * @warning No checks are performed on the array sizes and is recommended
+   * only in scenarios where you have previously checked conformity and is
+   * focused only on speed. All matrices should be C-style contiguous.
+   *
+   * @param A The A matrix (left element of the multiplication) (size MxN)
+   * @param B The B matrix, which is transposed (size PxN)
+   * @param C The resulting matrix (size MxP)
+   */
+  void prodTranspose_(const blitz::Array<double,2>& A,
+      const blitz::Array<double,2>& B, blitz::Array<double,2>& C);
+
+  /**
+   * @brief Performs the matrix multiplication C=A*B^T, using the BLAS dgemm
+   * function
+   *
+   * The input and output data have their sizes checked and this method will
+   * raise an appropriate exception if that is not cased. All matrices should
+   * be C-style contiguous. If you know that the input and output matrices
+   * conform, use the prodTranspose_() variant.
+   *
+   * @param A The A matrix (left element of the multiplication) (size MxN)
+   * @param B The B matrix, which is transposed (size PxN)
+   * @param C The resulting matrix (size MxP)
+   */
+  void prodTranspose(const blitz::Array<double,2>& A,
+      const blitz::Array<double,2>& B, blitz::Array<double,2>& C);
+
   /**
    * @brief Performs the matrix-vector multiplication c=A*b
    *
@@ -0,0 +1,144 @@
+/**
+ * @file bob/measure/load.h
+ * @date Sun Oct 18 17:58:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Fast loading of (large) score files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MEASURE_LOAD_H
+#define BOB_MEASURE_LOAD_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <blitz/array.h>
+
+namespace bob { namespace measure {
+
+  /**
+   * A score file in the four or five column formats, loaded in memory.
+   *
+   * Each line of a four column file contains, separated by white spaces:
+   * the claimed identity, the real identity, the test label and the score.
+   * Five column files have an additional model label after the claimed
+   * identity. Empty lines and lines starting with '#' are ignored, as are
+   * fields after the score.
+   *
+   * Identities and labels are interned: each distinct string is stored
+   * once, in the order in which it first appears in the file, and the
+   * columns are given as arrays of indexes into these tables. Claimed and
+   * real identities share the same table, so that comparing their indexes
+   * is the same as comparing the strings. Model and test labels share a
+   * second table.
+   *
+   * The file is mapped in memory and large files are parsed by several
+   * threads at once, each handling a contiguous block of lines.
+   */
+  class ScoreFile {
+
+    public: //api
+
+      /**
+       * Loads a score file
+       *
+       * @param filename The file to load
+       * @param columns The file format: 4 or 5 columns
+       * @param n_threads The number of threads parsing the file. If zero,
+       * uses as many threads as the machine has cores.
+       */
+      ScoreFile(const std::string& filename, size_t columns=4,
+          size_t n_threads=0);
+
+      virtual ~ScoreFile();
+
+      /**
+       * The number of scores in the file
+       */
+      inline size_t size() const { return m_scores.extent(0); }
+
+      /**
+       * The number of columns of the file format (4 or 5)
+       */
+      inline size_t getColumns() const { return m_columns; }
+
+      /**
+       * The distinct claimed and real identities
+       */
+      inline const std::vector<std::string>& getIds() const { return m_ids; }
+
+      /**
+       * The distinct model and test labels
+       */
+      inline const std::vector<std::string>& getLabels() const
+      { return m_labels; }
+
+      /**
+       * The claimed identity of each score, as indexes in getIds()
+       */
+      inline const blitz::Array<int32_t,1>& getClaimedIds() const
+      { return m_claimed; }
+
+      /**
+       * The model label of each score, as indexes in getLabels(). Empty for
+       * four column files.
+       */
+      inline const blitz::Array<int32_t,1>& getModelLabels() const
+      { return m_models; }
+
+      /**
+       * The real identity of each score, as indexes in getIds()
+       */
+      inline const blitz::Array<int32_t,1>& getRealIds() const
+      { return m_real; }
+
+      /**
+       * The test label of each score, as indexes in getLabels()
+       */
+      inline const blitz::Array<int32_t,1>& getTestLabels() const
+      { return m_tests; }
+
+      /**
+       * The scores
+       */
+      inline const blitz::Array<double,1>& getScores() const
+      { return m_scores; }
+
+      /**
+       * Splits the scores between negatives (the claimed identity differs
+       * from the real one) and positives (the claimed identity is the real
+       * one), keeping the order of the file. The output arrays are resized.
+       */
+      void split(blitz::Array<double,1>& negatives,
+          blitz::Array<double,1>& positives) const;
+
+    private: //representation
+
+      size_t m_columns;
+      std::vector<std::string> m_ids;
+      std::vector<std::string> m_labels;
+      blitz::Array<int32_t,1> m_claimed;
+      blitz::Array<int32_t,1> m_models;
+      blitz::Array<int32_t,1> m_real;
+      blitz::Array<int32_t,1> m_tests;
+      blitz::Array<double,1> m_scores;
+
+  };
+
+}}
+
+#endif /* BOB_MEASURE_LOAD_H */
@@ -26,6 +26,7 @@
 
 #include <complex>
 #include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
 
 namespace bob { namespace sp {
 /**
@@ -37,6 +38,10 @@ namespace bob { namespace sp {
  * @brief This class implements a 1D Discrete Fourier Transform based on 
  * the FFTW library. It is used as a base class for FFT1D and
  * IFFT1D classes.
+ *
+ * As for FFT2DAbstract, the FFTW plan is created once for the current
+ * length and shared between copies, and arrays of that length are
+ * transformed with the thread-safe new-array execute interface of FFTW.
  */
 class FFT1DAbstract
 {
@@ -78,7 +83,8 @@ class FFT1DAbstract
       blitz::Array<std::complex<double>,1>& dst) const = 0;
 
     /**
-     * @brief Reset the FFT1D object for the given 1D shape
+     * @brief Reset the FFT1D object for the given 1D shape (and create the
+     * corresponding FFTW plan)
      */
     void reset(const size_t length);
 
@@ -92,10 +98,16 @@ class FFT1DAbstract
     void setLength(const size_t length);
 
   protected:
+    /**
+     * @brief Creates the FFTW plan for the current length
+     */
+    virtual void initPlans() = 0;
+
     /**
      * Private attributes
      */
     size_t m_length;
+    boost::shared_ptr<void> m_plan; ///< out-of-place plan
 };
 
 
@@ -131,6 +143,17 @@ class FFT1D: public FFT1DAbstract
      */
     virtual void operator()(const blitz::Array<std::complex<double>,1>& src, 
       blitz::Array<std::complex<double>,1>& dst) const;
+
+    /**
+     * @brief process each row of a 2D array by applying the direct FFT. The
+     * rows are transformed one by one with the plan of the 1D transform, so
+     * that the results are the same as with the 1D operator.
+     */
+    void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
+
+  protected:
+    virtual void initPlans();
 };
 
 
@@ -166,6 +189,9 @@ class IFFT1D: public FFT1DAbstract
      */
     virtual void operator()(const blitz::Array<std::complex<double>,1>& src, 
       blitz::Array<std::complex<double>,1>& dst) const;
+
+  protected:
+    virtual void initPlans();
 };
 
 /**
@@ -26,6 +26,7 @@
 
 #include <complex>
 #include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
 
 namespace bob { namespace sp {
 /**
@@ -36,6 +37,13 @@ namespace bob { namespace sp {
 /**
  * @brief This class implements a Discrete Fourier Transform based on the
  * FFTW library. It is used as a base class for FFT2D and IFFT2D classes.
+ *
+ * FFTW plans are created once for the current shape (at construction or on
+ * reset()) and are shared between copies. Arrays of that shape are
+ * transformed with the new-array execute interface of FFTW, which is
+ * thread-safe: the same object can be used from several threads at once.
+ * Arrays of other shapes are still accepted, with a plan created on the
+ * fly.
  */
 class FFT2DAbstract
 {
@@ -82,7 +90,8 @@ class FFT2DAbstract
     virtual void operator()(blitz::Array<std::complex<double>,2>& src_dst) const = 0;
 
     /**
-     * @brief Reset the FFT2D object for the given 2D shape
+     * @brief Reset the FFT2D object for the given 2D shape (and create the
+     * corresponding FFTW plans)
      */
     void reset(const size_t height, const size_t width);
 
@@ -99,11 +108,18 @@ class FFT2DAbstract
     void setWidth(const size_t width);
 
   protected:
+    /**
+     * @brief Creates the FFTW plans for the current shape
+     */
+    virtual void initPlans() = 0;
+
     /**
      * Private attributes
      */
     size_t m_height;
     size_t m_width;
+    boost::shared_ptr<void> m_plan; ///< out-of-place plan
+    boost::shared_ptr<void> m_plan_inplace; ///< in-place plan
 };
 
 
@@ -144,6 +160,20 @@ class FFT2D: public FFT2DAbstract
      * @brief process an array by applying the FFT inplace
      */
     virtual void operator()(blitz::Array<std::complex<double>,2>& src_dst) const;
+
+    /**
+     * @brief process a real array by applying the direct FFT. Only half of
+     * the spectrum is computed (real-to-complex transform), the other half
+     * is filled in using its Hermitian symmetry.
+     */
+    void operator()(const blitz::Array<double,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
+
+  protected:
+    virtual void initPlans();
+
+  private:
+    boost::shared_ptr<void> m_plan_real; ///< real-to-complex plan
 };
 
 
@@ -184,6 +214,9 @@ class IFFT2D: public FFT2DAbstract
      * @brief process an array by applying the inverse FFT inplace
      */
     virtual void operator()(blitz::Array<std::complex<double>,2>& src_dst) const;
+
+  protected:
+    virtual void initPlans();
 };
 
 /**
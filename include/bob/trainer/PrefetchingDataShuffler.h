@@ -0,0 +1,205 @@
+/**
+ * @file bob/trainer/PrefetchingDataShuffler.h
+ * @date Sun Oct 18 09:12:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief A data shuffler that reads class data from files on demand and
+ * prepares mini-batches on background threads.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_TRAINER_PREFETCHINGDATASHUFFLER_H
+#define BOB_TRAINER_PREFETCHINGDATASHUFFLER_H
+
+#include <vector>
+#include <string>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/random.hpp>
+#include <bob/core/ordered_ring.h>
+#include <bob/io/File.h>
+
+namespace bob { namespace trainer {
+  /**
+   * @ingroup TRAINER
+   * @{
+   */
+
+  /**
+   * An asynchronous variant of the DataShuffler. Instead of holding all
+   * examples in memory, each class is backed by a bob::io::File in which
+   * every entry (as in File::read(index)) is one example. A pool of
+   * background workers draws examples from these files, applies standard
+   * normalization (if set) and keeps a bounded ring of ready mini-batches,
+   * so that the training thread only has to pick up the next one.
+   *
+   * Batches are drawn in the same fair way as in DataShuffler (round-robin
+   * through the classes). Worker 'w' uses its own random number generator,
+   * seeded with 'seed + w', and produces batches 'w', 'w + W', 'w + 2W', ...
+   * (where W is the number of workers). Batches are delivered in this
+   * order, so the sequence is reproducible for a given seed and number of
+   * workers, no matter how threads are scheduled.
+   *
+   * Files are not thread-safe: the workers read them while holding the
+   * process-wide lock of bob::io::HDF5File (see HDF5File::mutex()), which
+   * also covers all other HDF5 accesses. Do not use the given files
+   * elsewhere while the shuffler is running.
+   */
+  class PrefetchingDataShuffler {
+
+    public: //api
+
+      /**
+       * Initializes the shuffler with some data classes and corresponding
+       * targets. Each file should contain one 1D array of doubles per
+       * example. Background workers are only started on the first call to
+       * operator() or after start().
+       *
+       * @param data One file per class
+       * @param target One target per class
+       * @param batch_size The number of examples in each mini-batch
+       * @param n_workers The number of background threads preparing batches
+       * @param queue_size The maximum number of batches kept ready
+       * @param seed The base seed for the workers' random number generators
+       */
+      PrefetchingDataShuffler(
+          const std::vector<boost::shared_ptr<bob::io::File> >& data,
+          const std::vector<blitz::Array<double,1> >& target,
+          size_t batch_size, size_t n_workers=1, size_t queue_size=4,
+          boost::mt19937::result_type seed=5489u);
+
+      /**
+       * D'tor: stops all workers
+       */
+      virtual ~PrefetchingDataShuffler();
+
+      /**
+       * Calculates and returns mean and standard deviation from the input
+       * data. This requires a full pass over all files.
+       */
+      void getStdNorm(blitz::Array<double,1>& mean,
+          blitz::Array<double,1>& stddev) const;
+
+      /**
+       * Set automatic standard normalization. Normalization is applied by
+       * the workers while preparing batches. Batches already in the ring are
+       * discarded.
+       */
+      void setAutoStdNorm(bool s);
+
+      /**
+       * Gets current automatic standard normalization settings
+       */
+      inline bool getAutoStdNorm() const { return m_do_stdnorm; }
+
+      /**
+       * Re-seeds the workers. Batches already in the ring are discarded and
+       * the batch sequence restarts.
+       */
+      void setSeed(boost::mt19937::result_type seed);
+
+      /**
+       * Gets the current base seed
+       */
+      inline boost::mt19937::result_type getSeed() const { return m_seed; }
+
+      /**
+       * The data shape
+       */
+      inline size_t getDataWidth() const { return m_width; }
+
+      /**
+       * The target shape
+       */
+      inline size_t getTargetWidth() const { return m_target[0].extent(0); }
+
+      /**
+       * The number of examples per mini-batch
+       */
+      inline size_t getBatchSize() const { return m_batch_size; }
+
+      /**
+       * The number of background workers
+       */
+      inline size_t getNumberOfWorkers() const { return m_n_workers; }
+
+      /**
+       * The maximum number of batches kept ready
+       */
+      inline size_t getQueueSize() const { return m_ring.size(); }
+
+      /**
+       * Starts the background workers, if they are not running already
+       */
+      void start();
+
+      /**
+       * Stops the background workers and discards prepared batches. The
+       * next call to operator() or start() restarts the batch sequence.
+       */
+      void stop();
+
+      /**
+       * Fills 'data' and 'target' with the next prepared mini-batch,
+       * waiting for it if necessary. Both matrices should have
+       * getBatchSize() rows and the number of columns matching
+       * getDataWidth() and getTargetWidth() respectively.
+       *
+       * Exceptions raised by the workers (e.g. while reading files) are
+       * re-thrown here.
+       */
+      void operator() (blitz::Array<double,2>& data,
+          blitz::Array<double,2>& target);
+
+    private: //helpers
+
+      /**
+       * A slot in the ring of prepared batches
+       */
+      struct Batch {
+        blitz::Array<double,2> data;
+        blitz::Array<double,2> target;
+      };
+
+      void worker(size_t id);
+      void fill(boost::mt19937& rng, Batch& batch);
+
+      PrefetchingDataShuffler(const PrefetchingDataShuffler&);
+      PrefetchingDataShuffler& operator= (const PrefetchingDataShuffler&);
+
+    private: //representation
+
+      std::vector<boost::shared_ptr<bob::io::File> > m_data;
+      std::vector<blitz::Array<double,1> > m_target;
+      std::vector<boost::uniform_int<size_t> > m_range;
+      size_t m_width; ///< the number of features per example
+      size_t m_batch_size; ///< the number of examples per batch
+      size_t m_n_workers; ///< the number of background threads
+      boost::mt19937::result_type m_seed; ///< base seed for workers
+      bool m_do_stdnorm; ///< should we apply standard normalization
+      blitz::Array<double,1> m_mean; ///< mean to be used for std. norm.
+      blitz::Array<double,1> m_stddev; ///< std.dev for std. norm.
+
+      bob::core::OrderedRing<Batch> m_ring; ///< prepared batches
+
+  };
+
+  /**
+   * @}
+   */
+}}
+
+#endif /* BOB_TRAINER_PREFETCHINGDATASHUFFLER_H */
@@ -463,3 +463,65 @@ class CepsTest(unittest.TestCase):
     self.assertFalse(c0 != c1)
     self.assertFalse(c0 == c2)
     self.assertTrue( c0 != c2)
+
+  def test_streaming(self):
+    import pkg_resources
+    rate, data = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+
+    c = bob.ap.Ceps(rate, 20., 10., 24, 19, 0., 4000., 2, 0.97, True, True)
+    c.with_energy = True
+    c.with_delta = True
+    c.with_delta_delta = True
+    A = c(data)
+
+    s = bob.ap.CepsStream(c)
+    self.assertEqual(s.feature_dim, A.shape[1])
+    self.assertEqual(s.latency, 4)
+
+    # Pushes chunks of irregular sizes, some of them shorter than a frame
+    chunks = []
+    start = 0
+    for size in [7, 160, 1000, 3, 333, 4096]:
+      chunks.append(s.push(data[start:start+size]))
+      self.assertEqual(chunks[-1].shape[1], A.shape[1])
+      start += size
+    while start < data.shape[0]:
+      chunks.append(s.push(data[start:start+1500]))
+      start += 1500
+    self.assertTrue(s.n_frames <= A.shape[0] - s.latency)
+    chunks.append(s.finish())
+    self.assertTrue(s.finished)
+    self.assertEqual(s.n_ready, 0)
+
+    B = numpy.vstack(chunks)
+    self.assertEqual(B.shape, A.shape)
+    self.assertTrue(numpy.allclose(A, B, rtol=0., atol=1e-10))
+
+    # The stream can be restarted, with one chunk per sample
+    s.reset()
+    self.assertEqual(s.n_frames, 0)
+    B = numpy.vstack([s.push(data[k:k+1]) for k in range(2000)] + [s.finish()])
+    self.assertTrue(numpy.allclose(c(data[:2000]), B, rtol=0., atol=1e-10))
+
+  def test_threads(self):
+    import pkg_resources
+    rate, data = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+
+    c = bob.ap.Ceps(rate, 20., 10., 24, 19, 0., 4000., 2, 0.97, True, True)
+    c.with_energy = True
+    c.with_delta = True
+    c.with_delta_delta = True
+    self.assertEqual(c.n_threads, 1)
+    A = c(data)
+
+    # The results do not depend on the number of threads, nor on the way
+    # frames are grouped into blocks
+    for n_threads in (2, 3, 8):
+      c.n_threads = n_threads
+      self.assertEqual(c.n_threads, n_threads)
+      self.assertTrue(numpy.array_equal(A, c(data)))
+
+    # Frame by frame extraction gives the same results
+    s = bob.ap.CepsStream(c)
+    B = numpy.vstack([s.push(data), s.finish()])
+    self.assertTrue(numpy.array_equal(A, B))
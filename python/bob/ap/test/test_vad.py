@@ -0,0 +1,97 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# agent <agent@local>
+# Sun Oct 18 22:17:26 2026 +0200
+#
+# Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+# 
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3 of the License.
+# 
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Tests the voice activity detection and the extraction of speech frames
+"""
+
+import os
+import unittest
+import bob
+import numpy
+
+def _read(filename):
+  import scipy.io.wavfile
+  rate, data = scipy.io.wavfile.read(str(filename))
+  return rate, numpy.cast['float'](data)
+
+def _ceps(rate):
+  c = bob.ap.Ceps(rate, 20., 10., 24, 19, 0., 4000., 2, 0.97, True, True)
+  c.with_energy = True
+  c.with_delta = True
+  c.with_delta_delta = True
+  return c
+
+class VADTest(unittest.TestCase):
+  """Tests the voice activity detection"""
+
+  def test01_frame_activity(self):
+    import pkg_resources
+    rate, data = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+    c = _ceps(rate)
+    energies, zcr = c.frame_activity(data)
+    A = c(data)
+    self.assertEqual(energies.shape, (A.shape[0],))
+    self.assertEqual(zcr.shape, (A.shape[0],))
+    # The energies are the ones of the features
+    self.assertTrue(numpy.array_equal(energies, A[:,c.n_ceps]))
+    self.assertTrue((zcr >= 0.).all() and (zcr <= 1.).all())
+
+  def test02_mask(self):
+    energies = numpy.array([0., 10., 10., 0., 10., 0., 0., 0., 10., 10., 10., 0.])
+    zcr = numpy.zeros(energies.shape)
+
+    # 10 dB = log(10) in natural log-energy
+    vad = bob.ap.VAD(threshold_db=20.)
+    self.assertTrue(numpy.array_equal(vad(energies, zcr), energies > 5.))
+    vad.threshold_db = 50.
+    self.assertTrue(vad(energies, zcr).all())
+
+    vad = bob.ap.VAD(threshold_db=20., min_speech_frames=2)
+    expected = numpy.array([0, 1, 1, 0, 0, 0, 0, 0, 1, 1, 1, 0], 'bool')
+    self.assertTrue(numpy.array_equal(vad(energies, zcr), expected))
+
+    vad.hangover = 1
+    expected = numpy.array([1, 1, 1, 1, 0, 0, 0, 1, 1, 1, 1, 1], 'bool')
+    self.assertTrue(numpy.array_equal(vad(energies, zcr), expected))
+
+    vad = bob.ap.VAD(threshold_db=20., max_zcr=0.3)
+    zcr[1] = 0.5
+    self.assertFalse(vad(energies, zcr)[1])
+
+  def test03_extract_speech(self):
+    import pkg_resources
+    rate, data = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+    c = _ceps(rate)
+    A = c(data)
+
+    vad = bob.ap.VAD(threshold_db=20., min_speech_frames=3, hangover=2)
+    B, mask = c.extract_speech(data, vad)
+    self.assertEqual(mask.shape, (A.shape[0],))
+    self.assertEqual(B.shape, (mask.sum(), A.shape[1]))
+    self.assertTrue(mask.any())
+    # Same features as when extracting all frames, including the derivatives
+    self.assertTrue(numpy.array_equal(A[mask], B))
+
+    # With any mask, and several threads
+    c.n_threads = 3
+    mask = numpy.zeros((A.shape[0],), 'bool')
+    mask[0] = mask[7] = mask[-1] = True
+    mask[20:30] = True
+    self.assertTrue(numpy.array_equal(A[mask], c(data, mask)))
+    self.assertEqual(c(data, numpy.zeros((A.shape[0],), 'bool')).shape, (0, A.shape[1]))
@@ -356,3 +356,115 @@ class FileTest(unittest.TestCase):
     self.arrayset_readwrite(".bin", a2)
     self.arrayset_readwrite('.bin', a3)
     self.arrayset_readwrite(".bin", a4)
+
+  @extension_available('.bindata')
+  @extension_available('.tensor')
+  def test07_view(self):
+
+    for extension in ('.bindata', '.tensor'):
+      tmpname = tempname(extension)
+      try:
+        arrays = [numpy.random.normal(size=(6,)).astype('float32') for k in range(5)]
+        if extension == '.tensor': arrays = [k.reshape(2,3) for k in arrays]
+        f = bob.io.File(tmpname, 'w')
+        for k in arrays: f.append(k)
+        del f
+
+        f = bob.io.File(tmpname, 'r')
+        f.advise(bob.io.FileAccess.sequential)
+        views = [f.view(k) for k in range(len(arrays))]
+        del f # views keep the mapping alive
+        for array, view in zip(arrays, views):
+          self.assertTrue( numpy.array_equal(array, view) )
+          self.assertFalse( view.flags.writeable )
+
+      finally:
+        if os.path.exists(tmpname): os.unlink(tmpname)
+
+    # the whole contents of a .bindata file at once
+    tmpname = tempname('.bindata')
+    try:
+      data = numpy.random.normal(size=(4,5))
+      bob.io.write(data, tmpname)
+      f = bob.io.File(tmpname, 'r')
+      self.assertTrue( numpy.array_equal(data, f.view()) )
+      self.assertRaises(IndexError, f.view, 4)
+    finally:
+      if os.path.exists(tmpname): os.unlink(tmpname)
+
+  @extension_available('.jpg')
+  @extension_available('.png')
+  @extension_available('.ppm')
+  def test08_image_loader(self):
+
+    # a smooth color image, so that scaled versions stay close
+    y, x = numpy.mgrid[0:64,0:96]
+    image = numpy.array([x*2, y*3, (x+y)]).astype('uint8')
+    gray = numpy.round(0.299*image[0] + 0.587*image[1] + 0.114*image[2])
+
+    tmpnames = [tempname(k) for k in ('.png', '.jpg', '.ppm', '.pgm')]
+    try:
+      bob.io.write(image, tmpnames[0])
+      bob.io.write(image, tmpnames[1])
+      bob.io.write(image, tmpnames[2])
+      bob.io.write(image[1], tmpnames[3])
+      originals = [bob.io.load(k) for k in tmpnames]
+      originals[3] = numpy.array([originals[3]]*3)
+
+      # images are delivered in order, in any layout
+      for workers in (1, 3):
+        loader = bob.io.ImageLoader(tmpnames, n_workers=workers, queue_size=2)
+        loaded = [k for k in loader]
+        self.assertEqual(len(loaded), len(tmpnames))
+        for original, k in zip(originals, loaded):
+          self.assertTrue( numpy.array_equal(original, k) )
+
+      loader = bob.io.ImageLoader(tmpnames, bob.io.ImageLayout.interleaved)
+      for original, k in zip(originals, loader):
+        self.assertTrue( numpy.array_equal(original.transpose(1,2,0), k) )
+
+      loader = bob.io.ImageLoader(tmpnames, bob.io.ImageLayout.gray)
+      loaded = [k for k in loader]
+      self.assertTrue( abs(loaded[0] - gray).max() <= 1 ) #fixed point
+      self.assertTrue( numpy.array_equal(loaded[3], originals[3][0]) )
+      for k in loaded: self.assertEqual(k.shape, (64, 96))
+      self.assertTrue( abs(loaded[1] - gray.astype('float64')).mean() < 2. )
+
+      # JPEG images are scaled down in the DCT domain, staying large enough
+      loader = bob.io.ImageLoader(tmpnames, max_height=30, max_width=40)
+      self.assertEqual(loader.load(tmpnames[1]).shape, (3, 32, 48))
+      self.assertEqual(loader.load(tmpnames[0]).shape, (3, 64, 96))
+      loader = bob.io.ImageLoader(tmpnames, max_height=8)
+      self.assertEqual(loader.load(tmpnames[1]).shape, (3, 8, 12))
+
+      # errors are reported by the consumer, once the failed file is reached
+      loader = bob.io.ImageLoader(tmpnames + [tempname('.jpg')], n_workers=3)
+      for original in originals:
+        self.assertTrue( numpy.array_equal(original, loader.next()) )
+      self.assertRaises(RuntimeError, loader.next)
+      self.assertRaises(RuntimeError, loader.next) #until stopped
+      self.assertEqual(loader.position, len(originals))
+
+    finally:
+      for k in tmpnames:
+        if os.path.exists(k): os.unlink(k)
+
+  @extension_available('.jpg')
+  @extension_available('.png')
+  def test09_image_loader_palette_transparency(self):
+
+    # a paletted PNG with a tRNS chunk: transparency is dropped
+    palette = numpy.array([[255,0,0], [0,255,0], [0,0,255], [255,255,255]], 'uint8')
+    y, x = numpy.mgrid[0:4,0:6]
+    image = palette[(x+y)%4].transpose(2,0,1)
+    gray = 0.299*image[0] + 0.587*image[1] + 0.114*image[2]
+
+    filename = F('test_palette_trns.png')
+    loader = bob.io.ImageLoader([filename])
+    self.assertTrue( numpy.array_equal(image, loader.next()) )
+    loader = bob.io.ImageLoader([filename], bob.io.ImageLayout.interleaved)
+    self.assertTrue( numpy.array_equal(image.transpose(1,2,0), loader.next()) )
+    loader = bob.io.ImageLoader([filename], bob.io.ImageLayout.gray)
+    loaded = loader.next()
+    self.assertEqual(loaded.shape, (4, 6))
+    self.assertTrue( abs(loaded - gray).max() <= 1 ) #fixed point
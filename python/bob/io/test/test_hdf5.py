@@ -433,3 +433,75 @@ class HDF5FileTest(unittest.TestCase):
     finally:
 
       os.unlink(tmpname)
+
+  def test17_rows(self):
+
+    try:
+
+      tmpname = get_tempfilename()
+      outfile = bob.io.HDF5File(tmpname, 'w')
+      data = numpy.random.random((50,20))
+
+      # appends rows in blocks, mixed with single appends
+      outfile.append_rows('data', data[:30], chunk_rows=8)
+      outfile.append('data', data[30])
+      outfile.append_rows('data', data[31:])
+      outfile.set_chunk_cache('data', 101, 1024*1024, 1.)
+      self.assertTrue( numpy.array_equal(data, outfile.read('data')) )
+      self.assertTrue( numpy.array_equal(data[12:27], outfile.read_rows('data', 12, 15)) )
+      self.assertEqual( outfile.read_rows('data', 50, 0).shape, (0, 20) )
+      self.assertRaises(IndexError, outfile.read_rows, 'data', 45, 6)
+
+      # replaces a block of rows
+      outfile.replace_rows('data', 5, data[:10] * 2)
+      self.assertTrue( numpy.array_equal(data[:10] * 2, outfile.read_rows('data', 5, 10)) )
+      self.assertTrue( numpy.array_equal(data[15:], outfile.read_rows('data', 15, 35)) )
+
+      # blocks of scalars
+      scores = numpy.arange(100, dtype='int32')
+      outfile.append_rows('scores', scores[:60], compression=3)
+      outfile.append_rows('scores', scores[60:])
+      self.assertTrue( numpy.array_equal(scores, outfile.read('scores')) )
+      self.assertTrue( numpy.array_equal(scores[50:70], outfile.read_rows('scores', 50, 20)) )
+      self.assertEqual( outfile.lread('scores', 42), 42 )
+
+    finally:
+
+      os.unlink(tmpname)
+
+  def test18_feature_loader(self):
+
+    tmpnames = [get_tempfilename() for k in range(6)]
+
+    try:
+
+      features = []
+      for k, tmpname in enumerate(tmpnames):
+        features.append(numpy.random.random((4+3*k, 10)))
+        outfile = bob.io.HDF5File(tmpname, 'w')
+        outfile.set('features', features[-1], compression=9)
+        del outfile
+
+      for workers in (1, 3):
+        loader = bob.io.HDF5FeatureLoader(tmpnames, 'features', workers, 2)
+        self.assertEqual(len(loader), len(tmpnames))
+        loaded = [k for k in loader]
+        self.assertEqual(loader.position, len(tmpnames))
+        self.assertEqual(len(loaded), len(features))
+        for ref, data in zip(features, loaded):
+          self.assertTrue( numpy.array_equal(ref, data) )
+
+      # errors in the workers are raised on the consumer side, once the
+      # file that failed is reached
+      paths = ['features'] * len(tmpnames)
+      paths[2] = 'missing'
+      loader = bob.io.HDF5FeatureLoader(tmpnames, paths, 2)
+      self.assertTrue( numpy.array_equal(features[0], loader.next()) )
+      self.assertTrue( numpy.array_equal(features[1], loader.next()) )
+      self.assertRaises(RuntimeError, loader.next)
+      self.assertRaises(RuntimeError, loader.next) #until stopped
+      self.assertEqual(loader.position, 2)
+
+    finally:
+
+      for tmpname in tmpnames: os.unlink(tmpname)
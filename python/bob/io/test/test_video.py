@@ -65,7 +65,122 @@ class VideoTest(unittest.TestCase):
     
     self.assertEqual(counter, len(video)) #we have gone through all frames
 
-TEST_NUMBER = 3
+  @utils.ffmpeg_found()
+  def test003_canPrefetchFrames(self):
+
+    # Frames decoded in the background are the same as the ones read by
+    # VideoReader, in all layouts
+    from .. import VideoReader, PrefetchingVideoReader, VideoLayout
+    frames = [k for k in VideoReader(INPUT_VIDEO)]
+
+    for n_threads in (1, 2):
+      planar = PrefetchingVideoReader(INPUT_VIDEO, queue_size=3,
+          n_threads=n_threads)
+      interleaved = PrefetchingVideoReader(INPUT_VIDEO, VideoLayout.interleaved,
+          queue_size=3, n_threads=n_threads)
+      counter = 0
+      for frame, p, i in zip(frames, planar, interleaved):
+        self.assertTrue(numpy.array_equal(frame, p))
+        self.assertTrue(numpy.array_equal(frame, i.transpose(2,0,1)))
+        counter += 1
+      self.assertEqual(counter, len(frames))
+      self.assertRaises(StopIteration, planar.next)
+
+    gray = PrefetchingVideoReader(INPUT_VIDEO, VideoLayout.gray)
+    counter = 0
+    for frame in gray:
+      self.assertEqual(frame.shape, frames[0].shape[1:])
+      self.assertEqual(frame.dtype, numpy.uint8)
+      counter += 1
+    self.assertEqual(counter, len(frames))
+
+    # restarts from the first frame
+    gray.stop()
+    self.assertEqual(gray.position, 0)
+    self.assertEqual(gray.read().shape, frames[0].shape[1:])
+
+  @utils.ffmpeg_found()
+  def test004_canSeekFrames(self):
+
+    # Frames read after seeking on keyframes are the same as the ones read
+    # sequentially, in any order
+    from .. import VideoReader
+    frames = [k for k in VideoReader(INPUT_VIDEO)]
+
+    video = VideoReader(INPUT_VIDEO)
+    keyframes = video.keyframes
+    self.assertTrue(len(keyframes) > 0)
+    self.assertEqual(keyframes[0], 0)
+    self.assertEqual(list(keyframes), sorted(keyframes))
+
+    for k in (len(frames)-1, 0, len(frames)//2, 3, len(frames)//2 + 1):
+      self.assertTrue(numpy.array_equal(frames[k], video[k]))
+
+    it = video.__iter__()
+    for k in (5, 2, len(frames)-2):
+      self.assertEqual(it.seek(k).position, k)
+      self.assertTrue(numpy.array_equal(frames[k], it.next()))
+
+    for k, frame in zip(range(0, len(frames), 4), video[::4]):
+      self.assertTrue(numpy.array_equal(frames[k], frame))
+
+    # the index can be saved next to the video and re-used
+    import shutil
+    tmpname = utils.temporary_filename(suffix='.mov')
+    try:
+      shutil.copy(INPUT_VIDEO, tmpname)
+      cached = VideoReader(tmpname, cache_index=True)
+      self.assertTrue(cached.cache_index)
+      self.assertEqual(cached.keyframes, keyframes)
+      self.assertTrue(os.path.exists(tmpname + '.keyframes'))
+      reloaded = VideoReader(tmpname, cache_index=True)
+      self.assertEqual(reloaded.keyframes, keyframes)
+      self.assertTrue(numpy.array_equal(frames[-1], reloaded[len(frames)-1]))
+    finally:
+      for f in (tmpname, tmpname + '.keyframes'):
+        if os.path.exists(f): os.unlink(f)
+
+  @utils.ffmpeg_found()
+  def test005_canEncodeInTheBackground(self):
+
+    # Frames queued for encoding on a background thread end up in the file
+    # as if they were encoded synchronously, in any layout
+    from .. import VideoReader, VideoWriter
+    video = VideoReader(INPUT_VIDEO)
+    orig = video[:10]
+    length, _, height, width = orig.shape
+
+    def encode(frames, **kwargs):
+      fname = utils.temporary_filename(suffix='.avi')
+      try:
+        writer = VideoWriter(fname, height, width, video.frame_rate,
+            **kwargs)
+        for k in frames: writer.append(k)
+        writer.flush()
+        stats = writer.statistics
+        self.assertEqual(stats['frames'], length)
+        self.assertTrue(stats['max_latency'] >= stats['mean_latency'])
+        writer.close()
+        self.assertEqual(len(writer), length)
+        return VideoReader(fname).load()
+      finally:
+        if os.path.exists(fname): os.unlink(fname)
+
+    reference = encode(orig)
+    queued = encode(orig, queue_size=3)
+    self.assertTrue(numpy.array_equal(reference, queued))
+
+    interleaved = encode(orig.transpose(0,2,3,1), queue_size=3, n_threads=2)
+    self.assertEqual(interleaved.shape, reference.shape)
+    dist = abs(reference.astype('float64') - interleaved.astype('float64'))
+    self.assertTrue(dist.mean() <= 1.5)
+
+    gray = encode(orig[:,1,:,:].copy(), queue_size=3)
+    self.assertEqual(gray.shape, reference.shape)
+    dist = abs(gray[:,0,:,:].astype('float64') - gray[:,2,:,:].astype('float64'))
+    self.assertTrue(dist.mean() <= 2.)
+
+TEST_NUMBER = 5
 
 @utils.ffmpeg_found()
 def check_format_codec(function, shape, framerate, format, codec, maxdist):
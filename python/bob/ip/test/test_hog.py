@@ -400,3 +400,45 @@ class HOGTest(unittest.TestCase):
     hog3 = bob.ip.HOG(hog2)
     self.assertTrue(  hog3 == hog2 )
     self.assertFalse( hog3 != hog2 )
+
+  def test05_DenseHOG(self):
+    #"""Test the DenseHOG class, which extracts the HOG descriptors of many
+    #  windows using integral histograms"""
+
+    numpy.random.seed(0)
+    img = numpy.random.randint(0, 256, size=(30,40)).astype('float64')
+
+    # A window covering the whole image gets the descriptors of HOG
+    hog = bob.ip.HOG(30,40,8,False,6,8,2,4,2,2,1,1)
+    for full_orientation in (False, True):
+      hog.full_orientation = full_orientation
+      dense = bob.ip.DenseHOG(hog)
+      dense.set_image(img)
+      self.assertEqual( (dense.height, dense.width), (30,40) )
+      self.assertTrue( numpy.allclose(dense.forward(0,0), hog(img), 1e-10, 1e-10) )
+
+    # Cell histograms are the ones of the gradient maps of the whole image,
+    # binned over the same orientation range
+    (mag, ori) = bob.ip.GradientMaps(30,40)(img)
+    for (y,x,h,w) in ((0,0,30,40), (3,5,7,9), (17,30,13,10), (29,39,1,1)):
+      ref = bob.ip.hog_compute_histogram(mag[y:y+h,x:x+w], ori[y:y+h,x:x+w], 8,
+          dense.hog.full_orientation)
+      self.assertTrue( numpy.allclose(dense.cell_histogram(y,x,h,w), ref, 1e-10, 1e-8) )
+    self.assertRaises(ValueError, dense.cell_histogram, 25, 0, 6, 4)
+
+    # All the windows, sampled on a grid, on one or several threads
+    hog = bob.ip.HOG(16,16,9,False,8,8,0,0,2,2,0,0)
+    hog.block_norm = bob.ip.BlockNorm.L2Hys
+    dense = bob.ip.DenseHOG(hog)
+    dense.set_image(img)
+    self.assertEqual( dense.get_output_shape(3,5), (5,5,36) )
+    ref = dense(3,5)
+    self.assertEqual( ref.shape, (5,5,36) )
+    for i in range(ref.shape[0]):
+      for j in range(ref.shape[1]):
+        self.assertTrue( numpy.allclose(ref[i,j,:], dense.forward(3*i,5*j).flatten(), 1e-10, 1e-10) )
+    self.assertRaises(ValueError, dense.forward, 15, 0)
+
+    dense.n_threads = 3
+    dense.set_image(img)
+    self.assertTrue( numpy.array_equal(dense(3,5), ref) )
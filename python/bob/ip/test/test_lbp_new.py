@@ -644,3 +644,81 @@ class LBPTest(unittest.TestCase):
     self.assertEqual(proc2(values_5x5,plane_index=0,operator_coordinates=(0,0,0)),0xf)
     self.assertEqual(proc2(values_5x5,plane_index=1,operator_coordinates=(0,0,0)),0x7)
     self.assertEqual(proc2(values_5x5,plane_index=2,operator_coordinates=(0,0,0)),0x7)
+
+  def test20_whole_image_vs_pixelwise(self):
+    # whole image extraction must give the same codes as the pixel-wise one
+    numpy.random.seed(42)
+    images = (
+        numpy.random.randint(0, 256, (9,11)).astype('uint8'),
+        numpy.random.randint(0, 4, (9,11)).astype('uint16'),
+        numpy.random.rand(9,11) * 255.,
+        )
+    operators = []
+    for radius in (1., 1.5, 2.):
+      for circular in (False, True):
+        for to_average in (False, True):
+          for flags in ((False,False,False), (True,False,False), (False,True,False), (False,False,True), (False,True,True)):
+            for elbp in (0,1,2):
+              kwargs = dict(radius=radius, circular=circular, to_average=to_average, add_average_bit=flags[0], uniform=flags[1], rotation_invariant=flags[2], elbp_type=elbp)
+              operators.append(bob.ip.LBP4R(**kwargs))
+              operators.append(bob.ip.LBP8R(**kwargs))
+              if circular: operators.append(bob.ip.LBP16R(**kwargs))
+
+    for op in operators:
+      for image in images:
+        codes = op(image)
+        if op.circular: b = (int(math.ceil(op.radius)), int(math.ceil(op.radius2)))
+        else: b = (int(math.floor(op.radius+0.5)), int(math.floor(op.radius2+0.5)))
+        for y in range(codes.shape[0]):
+          for x in range(codes.shape[1]):
+            self.assertEqual(codes[y,x], op(image, y+b[0], x+b[1]))
+
+  def test21_lbptop_vs_pixelwise(self):
+    # LBPTop codes must match the LBP codes of the centered blocks
+    numpy.random.seed(42)
+    volume = numpy.random.randint(0, 256, (5,7,9)).astype('uint8')
+    lbp = bob.ip.LBP8R(radius=1., circular=True, uniform=True)
+    op = bob.ip.LBPTop(lbp, lbp, lbp)
+    xy = numpy.ndarray((3,5,7), 'uint16')
+    xt = numpy.ndarray((3,5,7), 'uint16')
+    yt = numpy.ndarray((3,5,7), 'uint16')
+    op(volume, xy, xt, yt)
+    for i in range(1,4):
+      for j in range(1,6):
+        for k in range(1,8):
+          kxy = volume[i,j-1:j+2,k-1:k+2].copy()
+          kxt = volume[i-1:i+2,j,k-1:k+2].copy()
+          kyt = volume[i-1:i+2,j-1:j+2,k].copy()
+          self.assertEqual(xy[i-1,j-1,k-1], lbp(kxy, 1, 1))
+          self.assertEqual(xt[i-1,j-1,k-1], lbp(kxt, 1, 1))
+          self.assertEqual(yt[i-1,j-1,k-1], lbp(kyt, 1, 1))
+
+  def test22_lbptop_stream(self):
+    # window histograms must match LBPTop on the last window+2R frames
+    numpy.random.seed(42)
+    frames = numpy.random.randint(0, 256, (12,7,9)).astype('uint8')
+    lbp = bob.ip.LBP8R(radius=1., circular=True, uniform=True)
+    op = bob.ip.LBPTop(lbp, lbp, lbp)
+    window = 4
+    stream = bob.ip.LBPTopStream(op, window)
+    self.assertEqual(stream.radius, 1)
+
+    xy = numpy.ndarray((window,5,7), 'uint16')
+    xt = numpy.ndarray((window,5,7), 'uint16')
+    yt = numpy.ndarray((window,5,7), 'uint16')
+    for f in range(frames.shape[0]):
+      ready = stream.push(frames[f])
+      self.assertEqual(ready, f+1 >= window+2)
+      if not ready: continue
+      op(frames[f+1-window-2:f+1], xy, xt, yt)
+      self.assertTrue(numpy.array_equal(stream.xy, xy[-1]))
+      self.assertTrue(numpy.array_equal(stream.xt, xt[-1]))
+      self.assertTrue(numpy.array_equal(stream.yt, yt[-1]))
+      n = lbp.max_label
+      self.assertTrue(numpy.array_equal(stream.xy_histogram, numpy.bincount(xy.flatten(), minlength=n)))
+      self.assertTrue(numpy.array_equal(stream.xt_histogram, numpy.bincount(xt.flatten(), minlength=n)))
+      self.assertTrue(numpy.array_equal(stream.yt_histogram, numpy.bincount(yt.flatten(), minlength=n)))
+
+    stream.reset()
+    self.assertEqual(stream.n_frames, 0)
+    self.assertFalse(stream.push(frames[0]))
@@ -82,6 +82,10 @@ class SIFT(unittest.TestCase):
     #bob.io.save(C, F(os.path.join("sift","vlimg_ref_cmp.hdf5"))) # Generated using initial bob version
     C_ref = bob.io.load(F(os.path.join("sift", "vlimg_ref_cmp.hdf5")))
     self.assertTrue( numpy.allclose(C, C_ref, 1e-5, 1e-5) )
+    # Threads do not change the descriptors
+    op.n_threads = 4
+    self.assertEqual(op.n_threads, 4)
+    self.assertTrue( (op.compute_descriptor(A,kp) == B).all() )
     """
     Descriptor returned by vlfeat 0.9.14. 
       Differences with our implementation are (but not limited to):
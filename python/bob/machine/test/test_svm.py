@@ -279,3 +279,88 @@ class SvmTest(unittest.TestCase):
     self.assertEqual(pred_labels, real_labels)
     self.assertTrue( numpy.all(abs(numpy.vstack(pred_probs) -
       numpy.vstack(real_probs)) < 1e-6) )
+
+  @utils.libsvm_available
+  def test07_batch_prediction(self):
+
+    #the dense batched engine should match libsvm on 2- and 3-class problems
+    for model, datafile, expected in (
+        (HEART_MACHINE, HEART_DATA, expected_heart_predictions),
+        (IRIS_MACHINE, IRIS_DATA, expected_iris_predictions),
+        ):
+      machine = bob.machine.SupportVector(model)
+      labels, data = bob.machine.SVMFile(datafile).read_all()
+      data = numpy.vstack(data)
+
+      pred_labels = machine.batch_predict_classes(data)
+      self.assertEqual( tuple(pred_labels), expected )
+
+      pred_labels2, pred_scores2 = machine.batch_predict_classes_and_scores(data)
+      self.assertEqual( tuple(pred_labels2), expected )
+      self.assertEqual( pred_scores2.shape, (len(data),
+        machine.n_decision_values) )
+      ref_labels, ref_scores = machine.predict_classes_and_scores(data)
+      self.assertTrue( numpy.all(abs(pred_scores2 - numpy.vstack(ref_scores))
+        < 1e-10) )
+
+      #input scaling is applied in the same way
+      machine.input_subtract = 0.1
+      machine.input_divide = 2.
+      pred_labels3 = machine.batch_predict_classes(data)
+      self.assertEqual( tuple(pred_labels3), machine.predict_classes(data) )
+
+  @utils.libsvm_available
+  def test08_linear_collapse(self):
+
+    #trains a linear model, collapsed into a single weight vector on load
+    labels, data = bob.machine.SVMFile(HEART_DATA).read_all()
+    data = numpy.vstack(data)
+    labels = numpy.array(labels)
+    trainer = bob.trainer.SVMTrainer()
+    trainer.kernel_type = bob.machine.svm_kernel_type.LINEAR
+    machine = trainer.train((data[labels == 1], data[labels == -1]))
+    self.assertTrue( machine.is_linear )
+    self.assertEqual( machine.linear_weights.shape, (1, data.shape[1]) )
+
+    #computes the reference decision values from the libsvm model file
+    tmp = tempname('.model')
+    machine.save(tmp)
+    f = open(tmp, 'rt')
+    header = {}
+    for line in f:
+      if line.strip() == 'SV': break
+      s = line.split()
+      header[s[0]] = s[1:]
+    weight = numpy.zeros((data.shape[1],), 'float64')
+    for line in f:
+      s = line.split()
+      sv = numpy.zeros((data.shape[1],), 'float64')
+      for entry in s[1:]:
+        idx, val = entry.split(':')
+        sv[int(idx)-1] = float(val)
+      weight += float(s[0]) * sv
+    f.close()
+    os.unlink(tmp)
+    rho = float(header['rho'][0])
+    expected_scores = numpy.dot(data, weight) - rho
+
+    self.assertTrue( numpy.all(abs(machine.linear_weights[0] - weight) < 1e-10) )
+    pred_labels, pred_scores = machine.batch_predict_classes_and_scores(data)
+    self.assertTrue( numpy.all(abs(pred_scores[:,0] - expected_scores) < 1e-10) )
+    for k, d in enumerate(data):
+      label, score = machine.predict_class_and_scores(d)
+      self.assertEqual( label, pred_labels[k] )
+      self.assertTrue( abs(score[0] - expected_scores[k]) < 1e-10 )
+
+    #the exported LinearMachine produces the same decision values
+    linear = machine.to_linear_machine()
+    tmp = tempname('.hdf5')
+    linear.save(bob.io.HDF5File(tmp, 'w'))
+    linear = bob.machine.LinearMachine(bob.io.HDF5File(tmp))
+    os.unlink(tmp)
+    self.assertTrue( numpy.all(abs(linear(data)[:,0] - expected_scores) < 1e-10) )
+
+    #non-linear machines cannot be converted
+    rbf = bob.machine.SupportVector(HEART_MACHINE)
+    self.assertFalse( rbf.is_linear )
+    self.assertRaises(RuntimeError, rbf.to_linear_machine)
@@ -80,6 +80,24 @@ class InteriorpointLPTest(unittest.TestCase):
       # Compare to reference solution
       self.assertEqual( (abs(x-sol) < eps).all(), True )
 
+  def test01b_normal_equations(self):
+    # Same problems, computing the Newton directions with the normal
+    # equations rather than the large dense system
+
+    eps = 1e-4
+    acc = 1e-7
+    for N in range(1,10):
+      A, b, c, x0, sol = generateProblem(N)
+
+      op1 = bob.math.LPInteriorPointShortstep(A.shape[0], A.shape[1], 0.4, acc)
+      op2 = bob.math.LPInteriorPointPredictorCorrector(A.shape[0], A.shape[1], 0.5, 0.25, acc)
+      op3 = bob.math.LPInteriorPointLongstep(A.shape[0], A.shape[1], 1e-3, 0.1, acc)
+      for op in (op1, op2, op3):
+        op.solver = bob.math.LPInteriorPointSolver.normal_equations
+        x = op.solve(A, b, c, x0)
+        # Compare to reference solution
+        self.assertEqual( (abs(x-sol) < eps).all(), True )
+
   def test02_parameters(self):
     op1 = bob.math.LPInteriorPointShortstep(2, 4, 0.4, 1e-6)
     self.assertEqual( op1.m, 2)
@@ -92,6 +110,11 @@ class InteriorpointLPTest(unittest.TestCase):
     op1b.theta = 0.5
     self.assertFalse( op1 == op1b)
     self.assertTrue( op1 != op1b)
+    op1c = bob.math.LPInteriorPointShortstep(op1)
+    self.assertEqual( op1c.solver, bob.math.LPInteriorPointSolver.dense)
+    op1c.solver = bob.math.LPInteriorPointSolver.normal_equations
+    self.assertEqual( op1c.solver, bob.math.LPInteriorPointSolver.normal_equations)
+    self.assertFalse( op1 == op1c)
     op1b.reset(3, 6)
     op1b.epsilon = 1e-5
     self.assertEqual( op1b.m, 3)
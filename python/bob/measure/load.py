@@ -4,9 +4,75 @@
 # Mon 23 May 2011 16:23:05 CEST
 
 """A set of utilities to load score files with different formats.
+
+Score files are parsed natively by :py:class:`bob.measure.ScoreFile`, which
+maps the file in memory, parses large files on several threads and interns
+identities and labels, so that even very large files are loaded quickly.
 """
 
 import numpy
+import logging
+
+def _load(filename, columns):
+  """Loads a score file with the native parser, reporting format errors as
+  SyntaxError. Files that cannot be read raise IOError."""
+
+  from . import ScoreFile
+  try:
+    return ScoreFile(filename, columns)
+  except IOError:
+    raise
+  except RuntimeError, e:
+    raise SyntaxError, str(e)
+
+def _as_tuples(score_file, columns):
+  """Converts a loaded score file into a list of tuples of strings and
+  floats"""
+
+  ids = score_file.ids
+  labels = score_file.labels
+  fields = [[ids[k] for k in score_file.claimed_ids.tolist()]]
+  if columns == 5:
+    fields.append([labels[k] for k in score_file.model_labels.tolist()])
+  fields.append([ids[k] for k in score_file.real_ids.tolist()])
+  fields.append([labels[k] for k in score_file.test_labels.tolist()])
+  fields.append(score_file.scores.tolist())
+  return zip(*fields)
+
+def _cmc(score_file):
+  """Groups the scores of a loaded score file by test label, as required by
+  the CMC functions"""
+
+  labels = score_file.labels
+  tests = score_file.test_labels
+  scores = score_file.scores
+  positive = score_file.claimed_ids == score_file.real_ids
+
+  # groups the scores of each probe, keeping the order of the file
+  groups = {}
+  if len(tests):
+    order = numpy.argsort(tests, kind='mergesort')
+    bounds = numpy.flatnonzero(numpy.diff(tests[order])) + 1
+    for group in numpy.split(order, bounds):
+      is_pos = positive[group]
+      groups[labels[tests[group[0]]]] = \
+          (scores[group][~is_pos], scores[group][is_pos])
+
+  # convert to lists of tuples of ndarrays
+  retval = []
+  logger = logging.getLogger('bob')
+  for probe_name in sorted(groups.keys()):
+    neg, pos = groups[probe_name]
+    if len(pos) and len(neg):
+      retval.append((neg, pos))
+    elif len(pos):
+      logger.warn('For probe name "%s" there are only positive scores. This probe name is ignored.' % probe_name)
+  # test if there are probes for which only negatives exist
+  for probe_name in sorted(groups.keys()):
+    if not len(groups[probe_name][1]):
+      logger.warn('For probe name "%s" there are only negative scores. This probe name is ignored.' % probe_name)
+
+  return retval
 
 def four_column(filename):
   """Loads a score set from a single file to memory.
@@ -25,22 +91,7 @@ def four_column(filename):
       score (float)
   """
 
-  retval = []
-  for i, l in enumerate(open(filename, 'rt')):
-    s = l.strip()
-    if len(s) == 0 or s[0] == '#': continue #empty or comment
-    field = [k.strip() for k in s.split()]
-    if len(field) < 4:
-      raise SyntaxError, 'Line %d of file "%s" is invalid: %s' % \
-          (i, filename, l)
-    try:
-      score = float(field[3])
-      t = (field[0], field[1], field[2], score)
-      retval.append(t)
-    except:
-      raise SyntaxError, 'Cannot convert score to float at line %d of file "%s": %s' % (i, filename, l)
-
-  return retval
+  return _as_tuples(_load(filename, 4), 4)
 
 def split_four_column(filename):
   """Loads a score set from a single file to memory and splits the scores
@@ -54,23 +105,7 @@ def split_four_column(filename):
   arrays of float64.
   """
 
-  # read four column list
-  scores_list = four_column(filename)
-
-  # split in positives and negatives
-  neg = []
-  pos = []
-  for (client_id, probe_id, _, score_str) in scores_list:
-    try:
-      score = float(score_str)
-      if client_id == probe_id:
-        pos.append(score)
-      else:
-        neg.append(score)
-    except:
-      raise SyntaxError, 'Cannot convert score "%s" to float' % score_str
-
-  return (numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
+  return _load(filename, 4).split()
 
 def cmc_four_column(filename):
   """Loads scores to compute CMC curves from a file in four column format.
@@ -83,42 +118,8 @@ def cmc_four_column(filename):
 
   The result of this function can directly be passed to, e.g., the bob.measure.cmc function.
   """
-  # read four column list
-  all_list = four_column(filename)
-  # extract positives and negatives
-  pos_dict = {}
-  neg_dict = {}
-  for (client_id, probe_id, probe_name, score_str) in all_list:
-    try:
-      score = float(score_str)
-      # check in which dict we have to put the score
-      if client_id == probe_id:
-        correct_dict = pos_dict
-      else:
-        correct_dict = neg_dict
-      # append score
-      if probe_name in correct_dict:
-        correct_dict[probe_name].append(score)
-      else:
-        correct_dict[probe_name] = [score]
-    except:
-      raise SyntaxError, "Cannot convert score '%s' to float" % score_str
-
-  # convert to lists of tuples of ndarrays
-  retval = []
-  import logging
-  logger = logging.getLogger('bob')
-  for probe_name in sorted(pos_dict.keys()):
-    if probe_name in neg_dict:
-      retval.append((numpy.array(neg_dict[probe_name], numpy.float64), numpy.array(pos_dict[probe_name], numpy.float64)))
-    else:
-      logger.warn('For probe name "%s" there are only positive scores. This probe name is ignored.' % probe_name)
-  # test if there are probes for which only negatives exist
-  for probe_name in sorted(neg_dict.keys()):
-    if not probe_name in pos_dict.keys():
-       logger.warn('For probe name "%s" there are only negative scores. This probe name is ignored.' % probe_name)
 
-  return retval
+  return _cmc(_load(filename, 4))
 
 def five_column(filename):
   """Loads a score set from a single file to memory.
@@ -139,22 +140,7 @@ def five_column(filename):
       score (float)
   """
 
-  retval = []
-  for i, l in enumerate(open(filename, 'rt')):
-    s = l.strip()
-    if len(s) == 0 or s[0] == '#': continue #empty or comment
-    field = [k.strip() for k in s.split()]
-    if len(field) < 5:
-      raise SyntaxError, 'Line %d of file "%s" is invalid: %s' % \
-          (i, filename, l)
-    try:
-      score = float(field[4])
-      t = (field[0], field[1], field[2], field[3], score)
-      retval.append(t)
-    except:
-      raise SyntaxError, 'Cannot convert score to float at line %d of file "%s": %s' % (i, filename, l)
-
-  return retval
+  return _as_tuples(_load(filename, 5), 5)
 
 def split_five_column(filename):
   """Loads a score set from a single file to memory and splits the scores
@@ -168,23 +154,7 @@ def split_five_column(filename):
   arrays of float64.
   """
 
-  # read five column list
-  scores_list = five_column(filename)
-
-  # split in positives and negatives
-  neg = []
-  pos = []
-  for (client_id, _, probe_id, _, score_str) in scores_list:
-    try:
-      score = float(score_str)
-      if client_id == probe_id:
-        pos.append(score)
-      else:
-        neg.append(score)
-    except:
-      raise SyntaxError, 'Cannot convert score "%s" to float' % score_str
-
-  return (numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
+  return _load(filename, 5).split()
 
 def cmc_five_column(filename):
   """Loads scores to compute CMC curves from a file in five column format.
@@ -197,38 +167,5 @@ def cmc_five_column(filename):
 
   The result of this function can directly be passed to, e.g., the bob.measure.cmc function.
   """
-  # read four column list
-  all_list = five_column(filename)
-
-  pos_dict = {}
-  neg_dict = {}
-  for (client_id, _, probe_id, probe_name, score_str) in all_list:
-    try:
-      score = float(score_str)
-      # check in which dict we have to put the score
-      if client_id == probe_id:
-        correct_dict = pos_dict
-      else:
-        correct_dict = neg_dict
-      # append score
-      if probe_name in correct_dict:
-        correct_dict[probe_name].append(score)
-      else:
-        correct_dict[probe_name] = [score]
-    except:
-      raise SyntaxError, 'Cannot convert score "%s" to float' % score_str
 
-  # convert to lists of tuples of ndarrays
-  retval = []
-  import logging
-  logger = logging.getLogger('bob')
-  for probe_name in sorted(pos_dict.keys()):
-    if probe_name in neg_dict:
-      retval.append((numpy.array(neg_dict[probe_name], numpy.float64), numpy.array(pos_dict[probe_name], numpy.float64)))
-    else:
-      logger.warn('For probe name "%s" there are only positive scores. This probe name is ignored.' % probe_name)
-  # test if there are probes for which only negatives exist
-  for probe_name in sorted(neg_dict.keys()):
-    if not probe_name in pos_dict.keys():
-       logger.warn('For probe name "%s" there are only negative scores. This probe name is ignored.' % probe_name)
-  return retval
+  return _cmc(_load(filename, 5))
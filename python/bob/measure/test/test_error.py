@@ -247,3 +247,42 @@ class ErrorTest(unittest.TestCase):
     self.assertEqual(rr, desired_rr)
     cmc = bob.measure.cmc(data)
     self.assertTrue((cmc == desired_cmc).all())
+
+  def test07_load(self):
+    # compares the native score file parser with a plain python one
+    def reference(filename, columns):
+      retval = []
+      for l in open(filename, 'rt'):
+        field = l.split()
+        if not field or field[0][0] == '#': continue
+        retval.append(tuple(field[:columns-1]) + (float(field[columns-1]),))
+      return retval
+
+    for filename, columns in (('dev-4col.txt', 4), ('test-5col.txt', 5)):
+      expected = reference(F(filename), columns)
+      f = bob.measure.ScoreFile(F(filename), columns, 4)
+      self.assertEqual(len(f), len(expected))
+      if columns == 4: loaded = bob.measure.load.four_column(F(filename))
+      else: loaded = bob.measure.load.five_column(F(filename))
+      self.assertEqual(loaded, expected)
+
+      # identities are interned in order of appearance
+      self.assertEqual(f.ids[f.claimed_ids[0]], expected[0][0])
+      self.assertEqual(len(set(f.ids)), len(f.ids))
+
+      positive = [k[-1] for k in expected if k[0] == k[columns-3]]
+      negative = [k[-1] for k in expected if k[0] != k[columns-3]]
+      neg, pos = f.split()
+      self.assertTrue((neg == negative).all())
+      self.assertTrue((pos == positive).all())
+
+    # malformed files
+    import tempfile
+    (fd, filename) = tempfile.mkstemp('.txt')
+    os.write(fd, "# a comment\n\nclient client probe 1.5\nclient impostor probe\n")
+    os.close(fd)
+    self.assertRaises(SyntaxError, bob.measure.load.four_column, filename)
+    os.unlink(filename)
+
+    # missing files are I/O errors, not format errors
+    self.assertRaises(IOError, bob.measure.load.four_column, filename)
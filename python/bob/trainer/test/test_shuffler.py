@@ -23,9 +23,16 @@
 import os, sys
 import unittest
 import time
+import tempfile
 import bob
 import numpy
 
+def tempname(suffix, prefix='bobtest_'):
+  (fd, name) = tempfile.mkstemp(suffix, prefix)
+  os.close(fd)
+  os.unlink(name)
+  return name
+
 class DataShufflerTest(unittest.TestCase):
   """Performs various shuffer tests."""
 
@@ -232,3 +239,60 @@ class DataShufflerTest(unittest.TestCase):
     back_mean, back_stddev = shuffle.stdnorm()
     self.assertTrue( abs( (back_mean   - prev_mean  ).sum() ) < 1e-10)
     self.assertTrue( abs( (back_stddev - prev_stddev).sum() ) < 1e-10)
+
+  def test06_Prefetching(self):
+
+    # Tests the asynchronous shuffler reading examples from files
+    filenames = []
+    files = []
+    for s in (self.set1, self.set2, self.set3):
+      filenames.append(tempname('.hdf5'))
+      f = bob.io.File(filenames[-1], 'w')
+      for row in s: f.append(row)
+      del f
+      files.append(bob.io.File(filenames[-1], 'r'))
+
+    try:
+      targets = [self.target1, self.target2, self.target3]
+      shuffle1 = bob.trainer.PrefetchingDataShuffler(files, targets,
+          batch_size=28, n_workers=2, queue_size=3, seed=32)
+      self.assertEqual(shuffle1.data_width, 3)
+      self.assertEqual(shuffle1.target_width, 1)
+
+      [data, target] = shuffle1()
+      self.assertEqual(data.shape, (28, 3))
+      self.assertEqual(target.shape, (28, 1))
+
+      # classes are drawn in a fair way, like in the DataShuffler
+      for data_k, target_k, count in ((self.data1, self.target1, 10),
+          (self.data2, self.target2, 9), (self.data3, self.target3, 9)):
+        rows = [i for i in range(28) if numpy.dot(data[i,:], data_k) != 0]
+        self.assertEqual(len(rows), count)
+        self.assertTrue( (target[rows,0] == target_k[0]).all() )
+
+      # the same seed and number of workers give the same sequence
+      batches1 = [shuffle1()[0] for k in range(5)]
+      shuffle1.stop()
+      shuffle1()
+      batches2 = [shuffle1()[0] for k in range(5)]
+      for b1, b2 in zip(batches1, batches2):
+        self.assertTrue( (b1 == b2).all() )
+
+      # std. normalization matches the in-memory shuffler
+      reference = bob.trainer.DataShuffler([self.set1, self.set2, self.set3],
+          targets)
+      [ref_mean, ref_stddev] = reference.stdnorm()
+      [mean, stddev] = shuffle1.stdnorm()
+      self.assertTrue( numpy.allclose(mean, ref_mean) )
+      self.assertTrue( numpy.allclose(stddev, ref_stddev) )
+      shuffle1.auto_stdnorm = True
+      [data, target] = shuffle1()
+      allowed = (numpy.vstack([self.set1, self.set2, self.set3]) - mean) / stddev
+      for row in data:
+        self.assertTrue( min([abs(row - k).max() for k in allowed]) < 1e-10 )
+
+      del shuffle1
+
+    finally:
+      del files
+      for f in filenames: os.unlink(f)
@@ -25,6 +25,13 @@
 #include <bob/core/check.h>
 #include <bob/core/assert.h>
 #include <bob/core/cast.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+/**
+ * The number of frames processed together by Ceps::extractFrames()
+ */
+static const int s_block_size = 64;
 
 bob::ap::Ceps::Ceps( double sampling_frequency, double win_length_ms, double win_shift_ms,
     size_t n_filters, size_t n_ceps, double f_min, double f_max, 
@@ -35,7 +42,7 @@ bob::ap::Ceps::Ceps( double sampling_frequency, double win_length_ms, double win
   m_delta_win(delta_win), m_pre_emphasis_coeff(pre_emphasis_coeff),
   m_mel_scale(mel_scale), m_dct_norm(dct_norm),
   m_with_energy(false), m_with_delta(false), m_with_delta_delta(false),
-  m_energy_floor(1.), m_fb_out_floor(1.), m_fft(1)
+  m_energy_floor(1.), m_fb_out_floor(1.), m_n_threads(1), m_fft(1)
 {
   // Check pre-emphasis coefficient
   if (pre_emphasis_coeff < 0. || pre_emphasis_coeff > 1.)
@@ -71,6 +78,7 @@ bob::ap::Ceps::Ceps(const Ceps& other):
   m_with_delta_delta(other.m_with_delta_delta),
   m_energy_floor(other.m_energy_floor), 
   m_fb_out_floor(other.m_fb_out_floor), 
+  m_n_threads(other.m_n_threads),
   m_fft(other.m_fft.getLength())
 {
   initWinLength();
@@ -108,6 +116,7 @@ bob::ap::Ceps& bob::ap::Ceps::operator=(const bob::ap::Ceps& other)
     m_with_delta_delta = other.m_with_delta_delta;
     m_energy_floor = other.m_energy_floor;
     m_fb_out_floor = other.m_fb_out_floor; 
+    m_n_threads = other.m_n_threads;
     m_fft.setLength(other.m_fft.getLength());
     
     initWinLength();
@@ -247,9 +256,14 @@ void bob::ap::Ceps::initWinSize()
 {
   m_win_size = (size_t)pow(2.0,ceil(log((double)m_win_length)/log(2)));
   m_cache_frame_d.resize(m_win_size);
-  m_fft.reset(m_win_size);
-  m_cache_frame_c1.resize(m_win_size);
-  m_cache_frame_c2.resize(m_win_size);
+  // The real frames are transformed with a complex FFT of half their length
+  const int half_size = (int)m_win_size/2;
+  m_fft.reset(half_size);
+  m_cache_frame_c1.resize(half_size);
+  m_cache_frame_c2.resize(half_size);
+  m_twiddles.resize(half_size+1);
+  for(int k=0; k<=half_size; ++k)
+    m_twiddles(k) = std::polar(1., -2*M_PI*k/(double)m_win_size);
 }
 
 void bob::ap::Ceps::initCacheHammingKernel()
@@ -369,35 +383,74 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   bob::core::array::assertSameShape(ceps_matrix, feature_shape);
   int n_frames=feature_shape(0);
 
-  //compute the center of the cut-off frequencies
-  const int n_coefs = (m_with_energy ?  m_n_ceps + 1 :  m_n_ceps);
-  blitz::Range r1(0,m_n_ceps-1);
-  blitz::Range rf(0,(int)m_win_length-1); 
-  for(int i=0; i<n_frames; ++i) 
+  std::vector<int> frames(n_frames);
+  for(int i=0; i<n_frames; ++i) frames[i] = i;
+  extractFrames(input, frames, ceps_matrix);
+  addDerivatives(ceps_matrix);
+}
+
+void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input, 
+  const blitz::Array<bool,1>& mask, blitz::Array<double,2>& output)
+{
+  blitz::TinyVector<int,2> feature_shape = bob::ap::Ceps::getCepsShape(input);
+  const int n_frames = feature_shape(0);
+  bob::core::array::assertSameDimensionLength(mask.extent(0), n_frames);
+  feature_shape(0) = blitz::count(mask);
+  bob::core::array::assertSameShape(output, feature_shape);
+
+  // The derivatives of a frame depend on the cepstral coefficients of the
+  // delta_win frames around it, and the second order derivatives on the 
+  // 2*delta_win frames around it
+  int context = 0;
+  if(m_with_delta) context = (m_with_delta_delta ? 2 : 1) * (int)m_delta_win;
+  std::vector<int> frames;
+  int last = -1; // last frame added to the list
+  for(int i=0; i<n_frames; ++i)
+  {
+    if(!mask(i)) continue;
+    for(int j=std::max(i-context, last+1); j<=std::min(i+context, n_frames-1); ++j)
+      frames.push_back(j);
+    last = std::max(last, std::min(i+context, n_frames-1));
+  }
+
+  // The other frames are not used (and are left to zero)
+  blitz::Array<double,2> ceps_matrix(n_frames, feature_shape(1));
+  ceps_matrix = 0.;
+  extractFrames(input, frames, ceps_matrix);
+  addDerivatives(ceps_matrix);
+
+  blitz::Range rall = blitz::Range::all();
+  for(int i=0, k=0; i<n_frames; ++i)
+    if(mask(i)) output(k++,rall) = ceps_matrix(i,rall);
+}
+
+void bob::ap::Ceps::extractFrames(const blitz::Array<double,1>& input,
+  const std::vector<int>& frames, blitz::Array<double,2>& ceps_matrix) const
+{
+  // The frames are split into contiguous ranges, one per thread. The main
+  // thread processes the first range.
+  const int n_frames = frames.size();
+  const int n_threads = std::min((int)m_n_threads, n_frames);
+  if (n_threads <= 1)
+    extractFrames(input, frames, ceps_matrix, 0, n_frames);
+  else
   {
-    // Set padded frame to zero
-    m_cache_frame_d = 0.;
-    // Extract frame input vector
-    blitz::Range ri(i*(int)m_win_shift,i*(int)m_win_shift+(int)m_win_length-1);
-    m_cache_frame_d(rf) = input(ri);
-    // Substract mean value
-    m_cache_frame_d -= blitz::mean(m_cache_frame_d);
-
-    // Update output with energy if required
-    if(m_with_energy)
-      ceps_matrix(i,(int)m_n_ceps) = logEnergy(m_cache_frame_d);
-
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Filter with the triangular filter bank (either in linear or Mel domain)
-    logFilterBank(m_cache_frame_d);
-    // Apply DCT kernel and update the output 
-    blitz::Array<double,1> ceps_matrix_row(ceps_matrix(i,r1));
-    applyDct(ceps_matrix_row);
+    void (bob::ap::Ceps::*extract)(const blitz::Array<double,1>&, 
+        const std::vector<int>&, blitz::Array<double,2>&, int, int) const =
+      &bob::ap::Ceps::extractFrames;
+    boost::thread_group threads;
+    for (int t=1; t<n_threads; ++t)
+      threads.create_thread(boost::bind(extract, this, boost::cref(input),
+        boost::cref(frames), boost::ref(ceps_matrix), 
+        t*n_frames/n_threads, (t+1)*n_frames/n_threads));
+    extractFrames(input, frames, ceps_matrix, 0, n_frames/n_threads);
+    threads.join_all();
   }
+}
 
+void bob::ap::Ceps::addDerivatives(blitz::Array<double,2>& ceps_matrix) const
+{
+  const int n_coefs = (m_with_energy ?  m_n_ceps + 1 :  m_n_ceps);
   blitz::Range rall = blitz::Range::all();
   blitz::Range ro0(0,n_coefs-1);
   blitz::Range ro1(n_coefs,2*n_coefs-1);
@@ -416,6 +469,171 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   }
 }
 
+void bob::ap::Ceps::frameActivity(const blitz::Array<double,1>& input,
+  blitz::Array<double,1>& energies, blitz::Array<double,1>& zcr) const
+{
+  const int n_frames = getCepsShape(input)(0);
+  bob::core::array::assertSameDimensionLength(energies.extent(0), n_frames);
+  bob::core::array::assertSameDimensionLength(zcr.extent(0), n_frames);
+
+  // Same split as for the extraction
+  const int n_threads = std::min((int)m_n_threads, n_frames);
+  if (n_threads <= 1)
+    frameActivity(input, energies, zcr, 0, n_frames);
+  else
+  {
+    void (bob::ap::Ceps::*activity)(const blitz::Array<double,1>&, 
+        blitz::Array<double,1>&, blitz::Array<double,1>&, int, int) const =
+      &bob::ap::Ceps::frameActivity;
+    boost::thread_group threads;
+    for (int t=1; t<n_threads; ++t)
+      threads.create_thread(boost::bind(activity, this, boost::cref(input),
+        boost::ref(energies), boost::ref(zcr), 
+        t*n_frames/n_threads, (t+1)*n_frames/n_threads));
+    frameActivity(input, energies, zcr, 0, n_frames/n_threads);
+    threads.join_all();
+  }
+}
+
+void bob::ap::Ceps::frameActivity(const blitz::Array<double,1>& input,
+  blitz::Array<double,1>& energies, blitz::Array<double,1>& zcr,
+  int first, int last) const
+{
+  // The samples are read through the data pointer, as in extractFrames().
+  // The mean is taken over the zero-padded frame, as prepareFrame() does,
+  // so that the energies are exactly the with_energy features.
+  const double* input_data = input.data();
+  const int input_stride = input.stride(0);
+  const int win_length = (int)m_win_length;
+  for(int i=first; i<last; ++i)
+  {
+    const double* samples = input_data + i*(int)m_win_shift*input_stride;
+    double mean = 0.;
+    for(int j=0; j<win_length; ++j)
+      mean += samples[j*input_stride];
+    mean /= (double)m_win_size;
+
+    double previous = samples[0] - mean;
+    double gain = previous * previous;
+    int crossings = 0;
+    for(int j=1; j<win_length; ++j)
+    {
+      const double sample = samples[j*input_stride] - mean;
+      gain += sample * sample;
+      if((previous < 0. && sample > 0.) || (previous > 0. && sample < 0.))
+        ++crossings;
+      previous = sample;
+    }
+    energies(i) = (gain < m_energy_floor ? m_log_energy_floor : log(gain));
+    zcr(i) = crossings / (double)(win_length-1);
+  }
+}
+
+void bob::ap::Ceps::extractFrame(const blitz::Array<double,1>& frame, 
+  blitz::Array<double,1>& ceps_row)
+{
+  // Set padded frame to zero
+  m_cache_frame_d = 0.;
+  blitz::Range rf(0,(int)m_win_length-1); 
+  m_cache_frame_d(rf) = frame;
+
+  // Update output with energy if required
+  double energy;
+  prepareFrame(m_cache_frame_d, energy);
+  if(m_with_energy)
+    ceps_row((int)m_n_ceps) = energy;
+
+  // Filter with the triangular filter bank (either in linear or Mel domain)
+  logFilterBank(m_cache_frame_d);
+  // Apply DCT kernel and update the output 
+  blitz::Array<double,1> ceps_row_c(ceps_row(blitz::Range(0,(int)m_n_ceps-1)));
+  applyDct(ceps_row_c);
+}
+
+void bob::ap::Ceps::extractFrames(const blitz::Array<double,1>& input,
+  const std::vector<int>& frame_list, blitz::Array<double,2>& ceps_matrix,
+  int first, int last) const
+{
+  // Working arrays for a block of frames
+  const int half_size = (int)m_win_size/2;
+  const int block_size = std::min(s_block_size, last-first);
+  blitz::Array<double,2> frames(block_size, (int)m_win_size);
+  blitz::Array<std::complex<double>,2> packed(block_size, half_size);
+  blitz::Array<std::complex<double>,2> spectra(block_size, half_size);
+  blitz::Array<double,2> log_energies(block_size, (int)m_n_filters);
+
+  // This runs on several threads: the input and the output are shared, and
+  // the reference counts of blitz arrays are not thread-safe. They are hence
+  // only accessed through their data pointers and strides, never sliced.
+  const double* input_data = input.data();
+  const int input_stride = input.stride(0);
+  double* ceps_data = ceps_matrix.data();
+  const blitz::TinyVector<int,1> ceps_stride(ceps_matrix.stride(1));
+
+  blitz::Range rall = blitz::Range::all();
+  for(int b=first; b<last; b+=block_size)
+  {
+    const int n = std::min(block_size, last-b);
+
+    // Frame the signal and prepare each frame for the FFT
+    frames = 0.;
+    for(int k=0; k<n; ++k)
+    {
+      const int i = frame_list[b+k];
+      const double* samples = input_data + i*(int)m_win_shift*input_stride;
+      blitz::Array<double,1> frame(frames(k,rall));
+      for(int j=0; j<(int)m_win_length; ++j)
+        frame(j) = samples[j*input_stride];
+      double energy;
+      prepareFrame(frame, energy);
+      if(m_with_energy)
+        ceps_matrix(i,(int)m_n_ceps) = energy;
+      blitz::Array<std::complex<double>,1> packed_row(packed(k,rall));
+      packFrame(frame, packed_row);
+    }
+
+    // Transform all the frames of the block
+    if(n < block_size)
+    {
+      blitz::Range rn(0,n-1);
+      blitz::Array<std::complex<double>,2> packed_n(packed(rn,rall));
+      blitz::Array<std::complex<double>,2> spectra_n(spectra(rn,rall));
+      m_fft(packed_n, spectra_n);
+    }
+    else
+      m_fft(packed, spectra);
+
+    // Apply the banded filter bank matrix, then the DCT matrix
+    for(int k=0; k<n; ++k)
+    {
+      blitz::Array<double,1> frame(frames(k,rall));
+      combineSpectrum(spectra(k,rall), frame);
+      blitz::Array<double,1> log_energies_row(log_energies(k,rall));
+      logTriangularFilterBank(frame, log_energies_row);
+    }
+    for(int k=0; k<n; ++k)
+    {
+      blitz::Array<double,1> ceps_row(
+        ceps_data + frame_list[b+k]*ceps_matrix.stride(0),
+        blitz::shape((int)m_n_ceps), ceps_stride, blitz::neverDeleteData);
+      applyDct(log_energies(k,rall), ceps_row);
+    }
+  }
+}
+
+void bob::ap::Ceps::prepareFrame(blitz::Array<double,1>& frame, 
+  double& energy) const
+{
+  // Substract mean value
+  frame -= blitz::mean(frame);
+  // Compute the energy
+  energy = logEnergy(frame);
+  // Apply pre-emphasis
+  pre_emphasis(frame);
+  // Apply the Hamming window
+  hammingWindow(frame);
+}
+
 void bob::ap::Ceps::pre_emphasis(blitz::Array<double,1> &data) const
 {
   if(m_pre_emphasis_coeff!=0.)
@@ -437,27 +655,65 @@ void bob::ap::Ceps::hammingWindow(blitz::Array<double,1> &data) const
 
 void bob::ap::Ceps::logFilterBank(blitz::Array<double,1>& x)
 {
-  // Apply the FFT
-  m_cache_frame_c1 = bob::core::array::cast<std::complex<double> >(x);
-  m_fft(m_cache_frame_c1, m_cache_frame_c2);
-
-  // Take the the power spectrum of the first part of the output of the FFT
-  blitz::Range r(0,(int)m_win_size/2);
-  blitz::Array<double,1> x_half(x(r));
-  blitz::Array<std::complex<double>,1> complex_half(m_cache_frame_c2(r));
-  x_half = blitz::abs(complex_half);
+  // Take the magnitude of the first part of the output of the FFT
+  spectrumMagnitude(x);
 
   // Apply the Triangular filter bank to this power spectrum
   logTriangularFilterBank(x);
 }
 
+void bob::ap::Ceps::spectrumMagnitude(blitz::Array<double,1>& x) const
+{
+  packFrame(x, m_cache_frame_c1);
+  m_fft(m_cache_frame_c1, m_cache_frame_c2);
+  combineSpectrum(m_cache_frame_c2, x);
+}
+
+void bob::ap::Ceps::packFrame(const blitz::Array<double,1>& x, 
+  blitz::Array<std::complex<double>,1>& z) const
+{
+  // Packs the even samples into the real parts and the odd samples into the
+  // imaginary parts of a sequence of half the length, z, to apply the FFT
+  const int half_size = (int)m_win_size/2;
+  for(int n=0; n<half_size; ++n)
+    z(n) = std::complex<double>(x(2*n), x(2*n+1));
+}
+
+void bob::ap::Ceps::combineSpectrum(const blitz::Array<std::complex<double>,1>& z,
+  blitz::Array<double,1>& x) const
+{
+  // Separates the spectra of the even and odd samples, using the symmetry
+  // of the spectrum of real signals, and combines them:
+  // \f$X[k] = E[k] + e^{-2i\pi k/N} O[k]\f$, where
+  // \f$E[k] = (Z[k] + Z^*[N/2-k])/2\f$ and \f$O[k] = -i(Z[k] - Z^*[N/2-k])/2\f$
+  const int half_size = (int)m_win_size/2;
+  const std::complex<double> minus_half_i(0.,-0.5);
+  for(int k=0; k<=half_size; ++k)
+  {
+    const std::complex<double> zk = z(k % half_size);
+    const std::complex<double> zc = std::conj(z((half_size-k) % half_size));
+    const std::complex<double> even = 0.5 * (zk + zc);
+    const std::complex<double> odd = minus_half_i * (zk - zc);
+    x(k) = std::abs(even + m_twiddles(k) * odd);
+  }
+}
+
 void bob::ap::Ceps::logTriangularFilterBank(blitz::Array<double,1>& data) const
+{
+  logTriangularFilterBank(data, m_cache_filters);
+}
+
+void bob::ap::Ceps::logTriangularFilterBank(const blitz::Array<double,1>& spectrum,
+  blitz::Array<double,1>& log_energies) const
 {
   for(int i=0; i<(int)m_n_filters; ++i)
   {
-    blitz::Array<double,1> data_slice(data(blitz::Range(m_p_index(i),m_p_index(i+2))));
-    double res = blitz::sum(data_slice * m_filter_bank[i]);
-    m_cache_filters(i)= (res < m_fb_out_floor ? m_log_fb_out_floor : log(res));
+    const blitz::Array<double,1>& filter = m_filter_bank[i];
+    const int offset = m_p_index(i);
+    double res = 0.;
+    for(int k=0; k<filter.extent(0); ++k)
+      res += spectrum(offset+k) * filter(k);
+    log_energies(i) = (res < m_fb_out_floor ? m_log_fb_out_floor : log(res));
   }
 }
 
@@ -470,9 +726,19 @@ double bob::ap::Ceps::logEnergy(blitz::Array<double,1> &data) const
 
 void bob::ap::Ceps::applyDct(blitz::Array<double,1>& ceps_row) const
 {
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  ceps_row = blitz::sum(m_cache_filters(j) * m_dct_kernel(i,j), j);
+  applyDct(m_cache_filters, ceps_row);
+}
+
+void bob::ap::Ceps::applyDct(const blitz::Array<double,1>& log_energies,
+  blitz::Array<double,1>& ceps_row) const
+{
+  for(int i=0; i<(int)m_n_ceps; ++i)
+  {
+    double res = 0.;
+    for(int j=0; j<(int)m_n_filters; ++j)
+      res += log_energies(j) * m_dct_kernel(i,j);
+    ceps_row(i) = res;
+  }
 }
 
 void bob::ap::Ceps::addDerivative(const blitz::Array<double,2>& input, blitz::Array<double,2>& output) const
@@ -0,0 +1,189 @@
+/**
+ * @file ap/cxx/CepsStream.cc
+ * @date Sun Oct 18 21:06:42 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the extraction of cepstral features from audio streams
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <boost/format.hpp>
+#include <bob/ap/CepsStream.h>
+
+bob::ap::CepsStream::CepsStream(const bob::ap::Ceps& ceps):
+  m_ceps(ceps),
+  m_n_coefs(ceps.getWithEnergy() ? ceps.getNCeps() + 1 : ceps.getNCeps()),
+  m_dim(ceps.getCepsShape(ceps.getWinLength())(1))
+{
+  reset();
+}
+
+bob::ap::CepsStream::~CepsStream()
+{
+}
+
+size_t bob::ap::CepsStream::getLatency() const
+{
+  if (m_ceps.getWithDeltaDelta()) return 2*m_ceps.getDeltaWin();
+  if (m_ceps.getWithDelta()) return m_ceps.getDeltaWin();
+  return 0;
+}
+
+size_t bob::ap::CepsStream::getNReady() const
+{
+  if (m_ceps.getWithDeltaDelta()) return m_n_delta_delta - m_n_read;
+  if (m_ceps.getWithDelta()) return m_n_delta - m_n_read;
+  return m_n_static - m_n_read;
+}
+
+void bob::ap::CepsStream::reset()
+{
+  m_samples.clear();
+  m_skip = 0;
+  m_finished = false;
+  m_frames.clear();
+  m_base = 0;
+  m_n_static = 0;
+  m_n_delta = 0;
+  m_n_delta_delta = 0;
+  m_n_read = 0;
+}
+
+void bob::ap::CepsStream::push(const blitz::Array<double,1>& chunk)
+{
+  if (m_finished) 
+    throw std::runtime_error("cannot push samples after the end of the stream: reset() it first");
+
+  m_samples.reserve(m_samples.size() + chunk.extent(0));
+  for (int k=0; k<chunk.extent(0); ++k) m_samples.push_back(chunk(k));
+  // Drops the samples between two frames, if the shift is larger than the
+  // frames
+  const size_t skip = std::min(m_skip, m_samples.size());
+  m_samples.erase(m_samples.begin(), m_samples.begin() + skip);
+  m_skip -= skip;
+
+  // Computes the cepstral coefficients of the frames completed by this chunk
+  const size_t win_length = m_ceps.getWinLength();
+  const size_t win_shift = m_ceps.getWinShift();
+  blitz::Range rc(0, (int)m_n_coefs-1);
+  size_t start = 0;
+  for (; start + win_length <= m_samples.size(); start += win_shift) {
+    blitz::Array<double,1> samples(&m_samples[start], 
+        blitz::shape(win_length), blitz::neverDeleteData);
+    blitz::Array<double,1> features(m_dim);
+    blitz::Array<double,1> coefs(features(rc));
+    m_ceps.extractFrame(samples, coefs);
+    m_frames.push_back(features);
+    ++m_n_static;
+  }
+
+  // Keeps the samples of the next frames only
+  if (start > m_samples.size()) {
+    m_skip = start - m_samples.size();
+    start = m_samples.size();
+  }
+  m_samples.erase(m_samples.begin(), m_samples.begin() + start);
+
+  update();
+}
+
+void bob::ap::CepsStream::finish()
+{
+  m_finished = true;
+  m_samples.clear();
+  m_skip = 0;
+  update();
+}
+
+void bob::ap::CepsStream::update()
+{
+  const size_t delta_win = m_ceps.getDeltaWin();
+  const int n_coefs = m_n_coefs;
+
+  // The derivatives of a frame need the delta_win following frames, except
+  // at the end of the stream, where the last frame is replicated
+  if (m_ceps.getWithDelta()) {
+    for (; m_n_delta < m_n_static && 
+        (m_finished || m_n_delta + delta_win < m_n_static); ++m_n_delta)
+      derivative(m_n_delta, m_n_static, 0, n_coefs);
+  }
+  if (m_ceps.getWithDeltaDelta()) {
+    for (; m_n_delta_delta < m_n_delta && 
+        (m_finished || m_n_delta_delta + delta_win < m_n_delta); ++m_n_delta_delta)
+      derivative(m_n_delta_delta, m_n_delta, n_coefs, 2*n_coefs);
+  }
+
+  // Drops the frames that were read, and are not needed anymore to compute
+  // derivatives
+  size_t keep = m_n_read;
+  if (m_ceps.getWithDelta())
+    keep = std::min(keep, m_n_delta > delta_win ? m_n_delta - delta_win : 0);
+  if (m_ceps.getWithDeltaDelta())
+    keep = std::min(keep, m_n_delta_delta > delta_win ? m_n_delta_delta - delta_win : 0);
+  for (; m_base < keep; ++m_base) m_frames.pop_front();
+}
+
+void bob::ap::CepsStream::derivative(size_t i_, size_t n_, int src, int dst)
+{
+  // Follows the order of the operations of Ceps::addDerivative(), so that
+  // the results are the same
+  const int i = i_;
+  const int n = n_;
+  const int delta_win = m_ceps.getDeltaWin();
+  blitz::Range rs(src, src+(int)m_n_coefs-1);
+  blitz::Array<double,1> output(frame(i)(blitz::Range(dst, dst+(int)m_n_coefs-1)));
+  output = 0.;
+
+  // \f$output[i] += \sum_{l=1}^{DW} l * (input[i+l] - input[i-l])\f$
+  for (int l=1; l<=delta_win; ++l) {
+    if (i >= l && i+l < n) 
+      output += l*(frame(i+l)(rs) - frame(i-l)(rs));
+  }
+
+  const double factor = delta_win*(delta_win+1)/2;
+  // Left boundary: the first frame is replicated
+  if (i < delta_win) {
+    output -= (factor - i*(i+1)/2) * frame(0)(rs);
+    for (int l=1+i; l<=delta_win; ++l)
+      output += l*frame(std::min(i+l, n-1))(rs);
+  }
+  // Right boundary: the last frame is replicated
+  if (i >= n-delta_win) {
+    const int ii = (n-1)-i;
+    output += (factor - ii*(ii+1)/2) * frame(n-1)(rs);
+    for (int l=1+ii; l<=delta_win; ++l)
+      output -= l*frame(std::max(i-l, 0))(rs);
+  }
+  // Sum of the integer squared from 1 to delta_win
+  const double sum = delta_win*(delta_win+1)*(2*delta_win+1)/3;
+  output /= sum;
+}
+
+void bob::ap::CepsStream::read(blitz::Array<double,2>& output)
+{
+  const size_t n_frames = output.extent(0);
+  if (n_frames > getNReady())
+    throw std::runtime_error((boost::format("cannot read %u frames from the stream: only %u are ready") % n_frames % getNReady()).str());
+  if (output.extent(1) != (int)m_dim)
+    throw std::runtime_error((boost::format("the features have %u dimensions, but the output array has %d columns") % m_dim % output.extent(1)).str());
+
+  for (size_t k=0; k<n_frames; ++k)
+    output((int)k, blitz::Range::all()) = frame(m_n_read + k);
+  m_n_read += n_frames;
+  update();
+}
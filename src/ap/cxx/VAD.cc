@@ -0,0 +1,96 @@
+/**
+ * @file ap/cxx/VAD.cc
+ * @date Sun Oct 18 22:17:26 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the energy and zero-crossing rate based voice activity
+ * detection
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <bob/ap/VAD.h>
+#include <bob/core/assert.h>
+
+bob::ap::VAD::VAD(double threshold_db, double max_zcr, 
+    size_t min_speech_frames, size_t hangover):
+  m_threshold_db(threshold_db), m_max_zcr(max_zcr),
+  m_min_speech_frames(min_speech_frames), m_hangover(hangover)
+{
+}
+
+bob::ap::VAD::~VAD()
+{
+}
+
+bool bob::ap::VAD::operator==(const bob::ap::VAD& other) const
+{
+  return m_threshold_db == other.m_threshold_db &&
+    m_max_zcr == other.m_max_zcr &&
+    m_min_speech_frames == other.m_min_speech_frames &&
+    m_hangover == other.m_hangover;
+}
+
+bool bob::ap::VAD::operator!=(const bob::ap::VAD& other) const
+{
+  return !(this->operator==(other));
+}
+
+void bob::ap::VAD::operator()(const blitz::Array<double,1>& energies,
+  const blitz::Array<double,1>& zcr, blitz::Array<bool,1>& mask) const
+{
+  const int n_frames = energies.extent(0);
+  bob::core::array::assertSameDimensionLength(zcr.extent(0), n_frames);
+  bob::core::array::assertSameDimensionLength(mask.extent(0), n_frames);
+  if(n_frames == 0) return;
+
+  // Energies are natural logarithms: converts the threshold from decibels
+  const double threshold = blitz::max(energies) - m_threshold_db * log(10.) / 10.;
+  for(int i=0; i<n_frames; ++i)
+    mask(i) = (energies(i) >= threshold && zcr(i) <= m_max_zcr);
+
+  // Discards the short runs of speech frames
+  if(m_min_speech_frames > 1)
+  {
+    int start = 0;
+    for(int i=0; i<=n_frames; ++i)
+    {
+      if(i < n_frames && mask(i)) continue;
+      if(i - start < (int)m_min_speech_frames)
+        for(int j=start; j<i; ++j) mask(j) = false;
+      start = i+1;
+    }
+  }
+
+  // Extends the remaining runs by the hangover, on both sides
+  if(m_hangover > 0)
+  {
+    const int hangover = m_hangover;
+    int remaining = 0;
+    blitz::Array<bool,1> speech(mask.copy());
+    for(int i=0; i<n_frames; ++i)
+    {
+      if(speech(i)) remaining = hangover;
+      else if(remaining > 0) { mask(i) = true; --remaining; }
+    }
+    remaining = 0;
+    for(int i=n_frames-1; i>=0; --i)
+    {
+      if(speech(i)) remaining = hangover;
+      else if(remaining > 0) { mask(i) = true; --remaining; }
+    }
+  }
+}
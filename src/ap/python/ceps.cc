@@ -23,7 +23,9 @@
 #include <boost/python.hpp>
 
 #include "bob/ap/Ceps.h"
+#include "bob/ap/VAD.h"
 #include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
 
 using namespace boost::python;
 
@@ -40,10 +42,61 @@ static object py_forward(bob::ap::Ceps& ceps, bob::python::const_ndarray input)
   bob::python::ndarray ceps_matrix(bob::core::array::t_float64, s(0), s(1));
   blitz::Array<double,2> ceps_matrix_ = ceps_matrix.bz<double,2>();
   // Extracts the features
-  ceps(input_, ceps_matrix_);
+  {
+    bob::python::no_gil unlock;
+    ceps(input_, ceps_matrix_);
+  }
   return ceps_matrix.self();
 }
 
+static object py_forward_mask(bob::ap::Ceps& ceps, bob::python::const_ndarray input, bob::python::const_ndarray mask)
+{
+  const blitz::Array<double,1> input_ = input.bz<double,1>();
+  const blitz::Array<bool,1> mask_ = mask.bz<bool,1>();
+  blitz::TinyVector<int,2> s = ceps.getCepsShape(input_);
+  // One row per selected frame
+  bob::python::ndarray ceps_matrix(bob::core::array::t_float64, blitz::count(mask_), s(1));
+  blitz::Array<double,2> ceps_matrix_ = ceps_matrix.bz<double,2>();
+  {
+    bob::python::no_gil unlock;
+    ceps(input_, mask_, ceps_matrix_);
+  }
+  return ceps_matrix.self();
+}
+
+static boost::python::tuple py_frame_activity(const bob::ap::Ceps& ceps, bob::python::const_ndarray input)
+{
+  const blitz::Array<double,1> input_ = input.bz<double,1>();
+  const int n_frames = ceps.getCepsShape(input_)(0);
+  bob::python::ndarray energies(bob::core::array::t_float64, n_frames);
+  bob::python::ndarray zcr(bob::core::array::t_float64, n_frames);
+  blitz::Array<double,1> energies_ = energies.bz<double,1>();
+  blitz::Array<double,1> zcr_ = zcr.bz<double,1>();
+  {
+    bob::python::no_gil unlock;
+    ceps.frameActivity(input_, energies_, zcr_);
+  }
+  return boost::python::make_tuple(energies.self(), zcr.self());
+}
+
+static boost::python::tuple py_extract_speech(bob::ap::Ceps& ceps, bob::python::const_ndarray input, const bob::ap::VAD& vad)
+{
+  const blitz::Array<double,1> input_ = input.bz<double,1>();
+  const int n_frames = ceps.getCepsShape(input_)(0);
+  blitz::Array<double,1> energies(n_frames), zcr(n_frames);
+  bob::python::ndarray mask(bob::core::array::t_bool, n_frames);
+  blitz::Array<bool,1> mask_ = mask.bz<bool,1>();
+  {
+    // the mask is needed before the extraction, which then only computes
+    // the speech frames (and their context)
+    bob::python::no_gil unlock;
+    ceps.frameActivity(input_, energies, zcr);
+    vad(energies, zcr, mask_);
+  }
+  object features = py_forward_mask(ceps, input, bob::python::const_ndarray(mask.self()));
+  return boost::python::make_tuple(features, mask.self());
+}
+
 static boost::python::tuple py_get_ceps_shape(bob::ap::Ceps& ceps, object input_object)
 {
   boost::python::tuple res;
@@ -124,7 +177,11 @@ void bind_ap_ceps()
         .add_property("with_energy", &bob::ap::Ceps::getWithEnergy, &bob::ap::Ceps::setWithEnergy, "Tells if we add the energy to the output feature")
         .add_property("with_delta", &bob::ap::Ceps::getWithDelta, &bob::ap::Ceps::setWithDelta, "Tells if we add the first derivatives to the output feature")
         .add_property("with_delta_delta", &bob::ap::Ceps::getWithDeltaDelta, &bob::ap::Ceps::setWithDeltaDelta, "Tells if we add the second derivatives to the output feature")
+        .add_property("n_threads", &bob::ap::Ceps::getNThreads, &bob::ap::Ceps::setNThreads, "The number of threads extracting the features of separate blocks of frames. The results do not depend on the number of threads.")
         .def("__call__", &py_forward, (arg("input")), "Computes the cepstral features")
+        .def("__call__", &py_forward_mask, (arg("input"), arg("mask")), "Computes the cepstral features of the frames selected by the mask (a boolean array with one element per frame of the input). The output has one row per selected frame, with the same features as when all frames are extracted. Only the cepstral coefficients of the selected frames, and of the neighbours their derivatives depend on, are computed.")
+        .def("frame_activity", &py_frame_activity, (arg("input")), "Returns the log-energy (as with_energy) and the zero-crossing rate of each frame of the input, as two 1D arrays. These are the measures bob.ap.VAD uses.")
+        .def("extract_speech", &py_extract_speech, (arg("input"), arg("vad")), "Selects the speech frames of the input with the given bob.ap.VAD, and computes their cepstral features only. Returns a tuple with the features (one row per speech frame) and the mask of the speech frames.")
         .def("get_ceps_shape", &py_get_ceps_shape, (arg("n_size"), arg("input_data")), "Computes the shape of the output features")
         ;
 
@@ -0,0 +1,68 @@
+/**
+ * @file ap/python/ceps_stream.cc
+ * @date Sun Oct 18 21:06:42 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the streaming cepstral feature extractor to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+
+#include "bob/ap/CepsStream.h"
+#include "bob/core/python/ndarray.h"
+
+using namespace boost::python;
+
+static const char* CEPSSTREAM_DOC = "Objects of this class extract Cepstral Features from an audio stream, as the signal arrives. Samples are pushed in chunks of any size, and the features of each frame are returned as soon as they can be computed: the cepstral coefficients (and energy) once all the samples of the frame were pushed, the first order derivatives once the delta_win following frames are available as well and the second order derivatives once the 2*delta_win following frames are. At the end of the stream, finish() returns the last frames. The features are the ones bob.ap.Ceps extracts from the whole signal at once.";
+
+static object py_read(bob::ap::CepsStream& stream)
+{
+  // Allocates a numpy array for all the ready frames
+  bob::python::ndarray output(bob::core::array::t_float64, 
+      stream.getNReady(), stream.getFeatureDim());
+  blitz::Array<double,2> output_ = output.bz<double,2>();
+  stream.read(output_);
+  return output.self();
+}
+
+static object py_push(bob::ap::CepsStream& stream, bob::python::const_ndarray input)
+{
+  stream.push(input.bz<double,1>());
+  return py_read(stream);
+}
+
+static object py_finish(bob::ap::CepsStream& stream)
+{
+  stream.finish();
+  return py_read(stream);
+}
+
+void bind_ap_ceps_stream()
+{
+  class_<bob::ap::CepsStream, boost::shared_ptr<bob::ap::CepsStream>, boost::noncopyable>("CepsStream", CEPSSTREAM_DOC, init<const bob::ap::Ceps&>((arg("ceps")), "Creates a stream extracting features with a copy of the configuration of the given bob.ap.Ceps object."))
+        .add_property("ceps", make_function(&bob::ap::CepsStream::getCeps, return_value_policy<copy_const_reference>()), "A copy of the configuration of the feature extraction")
+        .add_property("feature_dim", &bob::ap::CepsStream::getFeatureDim, "The dimension of the feature vectors")
+        .add_property("latency", &bob::ap::CepsStream::getLatency, "The number of frames the features are delayed by, to compute the derivatives")
+        .add_property("n_frames", &bob::ap::CepsStream::getNFrames, "The number of frames returned so far")
+        .add_property("n_ready", &bob::ap::CepsStream::getNReady, "The number of frames ready to be returned")
+        .add_property("finished", &bob::ap::CepsStream::getFinished, "Tells whether the end of the stream was signaled")
+        .def("push", &py_push, (arg("self"), arg("input")), "Appends samples to the stream, and returns the features of the frames that became ready, as a 2D array (possibly empty)")
+        .def("finish", &py_finish, (arg("self")), "Signals the end of the stream, and returns the features of the remaining frames. Samples that do not fill a complete frame are discarded.")
+        .def("read", &py_read, (arg("self")), "Returns the features of the frames that are ready, as a 2D array (possibly empty)")
+        .def("reset", &bob::ap::CepsStream::reset, (arg("self")), "Discards all samples and features, to start a new stream")
+        ;
+}
@@ -23,10 +23,14 @@
 #include "bob/core/python/ndarray.h"
 
 void bind_ap_ceps();
+void bind_ap_ceps_stream();
+void bind_ap_vad();
 
 BOOST_PYTHON_MODULE(_ap) {
 
   bob::python::setup_python("bob audio processing classes and sub-classes");
 
   bind_ap_ceps();
+  bind_ap_ceps_stream();
+  bind_ap_vad();
 }
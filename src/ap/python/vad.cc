@@ -0,0 +1,53 @@
+/**
+ * @file ap/python/vad.cc
+ * @date Sun Oct 18 22:17:26 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the voice activity detection to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+
+#include "bob/ap/VAD.h"
+#include "bob/core/python/ndarray.h"
+
+using namespace boost::python;
+
+static const char* VAD_DOC = "Objects of this class select the speech frames of an utterance, from the log-energy and zero-crossing rate of its frames, as computed by bob.ap.Ceps.frame_activity(). A frame is marked as speech if its energy is at most threshold_db decibels below the energy of the loudest frame, and if its zero-crossing rate is at most max_zcr (noise-like frames have high rates: about 0.5 for white noise). Runs of less than min_speech_frames speech frames are then discarded, and the hangover frames before and after each remaining run are marked as speech as well.";
+
+static object py_vad(const bob::ap::VAD& vad, bob::python::const_ndarray energies, bob::python::const_ndarray zcr)
+{
+  const blitz::Array<double,1> energies_ = energies.bz<double,1>();
+  bob::python::ndarray mask(bob::core::array::t_bool, energies_.extent(0));
+  blitz::Array<bool,1> mask_ = mask.bz<bool,1>();
+  vad(energies_, zcr.bz<double,1>(), mask_);
+  return mask.self();
+}
+
+void bind_ap_vad()
+{
+  class_<bob::ap::VAD, boost::shared_ptr<bob::ap::VAD> >("VAD", VAD_DOC, init<optional<double, double, size_t, size_t> >((arg("threshold_db")=30., arg("max_zcr")=1., arg("min_speech_frames")=1, arg("hangover")=0)))
+        .def(init<bob::ap::VAD&>(args("other"), "Constructs a new VAD from an existing one, using the copy constructor."))
+        .def(self == self)
+        .def(self != self)
+        .add_property("threshold_db", &bob::ap::VAD::getThresholdDb, &bob::ap::VAD::setThresholdDb, "The maximum energy difference of speech frames with the loudest frame, in decibels")
+        .add_property("max_zcr", &bob::ap::VAD::getMaxZcr, &bob::ap::VAD::setMaxZcr, "The maximum zero-crossing rate of speech frames")
+        .add_property("min_speech_frames", &bob::ap::VAD::getMinSpeechFrames, &bob::ap::VAD::setMinSpeechFrames, "The minimum number of consecutive speech frames")
+        .add_property("hangover", &bob::ap::VAD::getHangover, &bob::ap::VAD::setHangover, "The number of frames marked as speech before and after each run of speech frames")
+        .def("__call__", &py_vad, (arg("self"), arg("energies"), arg("zcr")), "Returns the mask of the speech frames (a boolean array), given the log-energy and zero-crossing rate of each frame")
+        ;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file core/cxx/test/ordered_ring.cc
+ * @date Sun Oct 18 21:05:12 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Tests the ordered ring handing items over between threads
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE core-ordered_ring Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <stdexcept>
+
+#include <bob/core/ordered_ring.h>
+
+/**
+ * Produces items 'id', 'id + W', ... with their own sequence number as
+ * value. Item 'fail_at' fails right away, all other items are produced
+ * slowly, so that the failure is reported before the items preceding it.
+ */
+static void produce(bob::core::OrderedRing<size_t>* ring, size_t W,
+    size_t n, size_t fail_at, size_t id) {
+  for (size_t seq=id; seq<n; seq+=W) {
+    size_t* item = ring->acquire(seq);
+    if (!item) return;
+    if (seq == fail_at) {
+      ring->fail(seq, "failed");
+      return;
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+    *item = seq;
+    ring->publish(seq);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_order )
+{
+  const size_t W = 3;
+  const size_t N = 20;
+  bob::core::OrderedRing<size_t> ring(4);
+  ring.start(W, boost::bind(&produce, &ring, W, N, N, _1));
+  ring.finish(N);
+  for (size_t k=0; k<N; ++k) {
+    size_t* item = ring.wait();
+    BOOST_REQUIRE(item);
+    BOOST_CHECK_EQUAL(*item, k);
+    ring.release();
+  }
+  BOOST_CHECK(!ring.wait());
+  BOOST_CHECK_EQUAL(ring.position(), N);
+  ring.stop();
+  BOOST_CHECK_EQUAL(ring.position(), (size_t)0);
+}
+
+BOOST_AUTO_TEST_CASE( test_failure_is_raised_in_order )
+{
+  const size_t W = 3;
+  const size_t N = 20;
+  const size_t F = 5;
+  bob::core::OrderedRing<size_t> ring(8);
+  ring.start(W, boost::bind(&produce, &ring, W, N, F, _1));
+  for (size_t k=0; k<F; ++k) {
+    size_t* item = ring.wait();
+    BOOST_REQUIRE(item);
+    BOOST_CHECK_EQUAL(*item, k);
+    ring.release();
+  }
+  BOOST_CHECK_THROW(ring.wait(), std::runtime_error);
+  BOOST_CHECK_EQUAL(ring.error(), "failed");
+  BOOST_CHECK_THROW(ring.flush(F+1), std::runtime_error);
+  ring.join(); //producers stop at the failure by themselves
+}
@@ -20,6 +20,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <boost/make_shared.hpp>
 #include <bob/core/logging.h>
 #include <bob/core/array_type.h>
 
@@ -69,6 +71,9 @@ bob::io::BinFile::BinFile(const std::string& filename, bob::io::BinFile::openmod
         bob::core::error << "Cannot append data in read only mode." << std::endl;
         throw bob::core::Exception();
       }
+
+      // arrays are read from a memory mapping from now on
+      m_mapping = boost::make_shared<bob::io::MappedFile>(filename);
     }
   }
   else
@@ -144,7 +149,12 @@ void bob::io::BinFile::read (bob::core::array::interface& a) {
   
   if(!a.type().is_compatible(compat)) a.set(compat);
 
-  m_stream.read((char*)a.ptr(), a.type().buffer_size());
+  if (m_mapping) {
+    endOfFile();
+    std::memcpy(a.ptr(), m_mapping->data(m_header.getArrayIndex(m_current_array),
+          a.type().buffer_size()), a.type().buffer_size());
+  }
+  else m_stream.read((char*)a.ptr(), a.type().buffer_size());
   ++m_current_array;
 }
 
@@ -169,3 +179,21 @@ void bob::io::BinFile::read (size_t index, bob::core::array::interface& a) {
     throw e;
   }
 }
+
+boost::shared_ptr<bob::core::array::interface> bob::io::BinFile::view
+(size_t index) {
+  if(!m_header_init) throw Uninitialized();
+  if(index >= m_header.m_n_samples) throw IndexError(index);
+
+  bob::core::array::typeinfo compat(getElementType(), m_header.getNDim(), m_header.getShape());
+
+  if (m_mapping) {
+    return boost::make_shared<bob::io::MappedArray>(m_mapping,
+        m_header.getArrayIndex(index), compat);
+  }
+
+  boost::shared_ptr<bob::core::array::blitz_array> retval =
+    boost::make_shared<bob::core::array::blitz_array>(compat);
+  read(index, *retval);
+  return retval;
+}
@@ -76,6 +76,30 @@ class BinaryArrayFile: public bob::io::File {
 
     }
 
+    virtual boost::shared_ptr<bob::core::array::interface> view(size_t index) {
+
+      if(!m_file)
+        throw std::runtime_error("uninitialized binary file cannot be read");
+
+      return m_file.view(index);
+
+    }
+
+    virtual boost::shared_ptr<bob::core::array::interface> view_all() {
+
+      if(!m_file)
+        throw std::runtime_error("uninitialized binary file cannot be read");
+
+      return m_file.view(0);
+
+    }
+
+    virtual void advise(bob::io::File::access_t pattern) {
+
+      m_file.advise(pattern);
+
+    }
+
     virtual size_t append (const bob::core::array::interface& buffer) {
 
       m_file.write(buffer);
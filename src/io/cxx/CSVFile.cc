@@ -21,23 +21,50 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <sstream>
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/tokenizer.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
 
 #include <boost/shared_array.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <bob/io/CodecRegistry.h>
 #include <bob/io/Exception.h>
+#include <bob/io/LineIndex.h>
 
 typedef boost::tokenizer<boost::escaped_list_separator<char> > Tokenizer;
 
+/**
+ * Tells if a line uses quotes or escapes, in which case it is split by the
+ * (slower) tokenizer instead of at every comma
+ */
+static inline bool is_escaped(const char* begin, const char* end) {
+  for (; begin != end; ++begin) if (*begin == '"' || *begin == '\\') return true;
+  return false;
+}
+
+/**
+ * Counts the number of entries in a line
+ */
+static size_t count_entries(const char* begin, const char* end) {
+  if (is_escaped(begin, end)) {
+    std::string line(begin, end);
+    Tokenizer tok(line);
+    return std::distance(tok.begin(), tok.end());
+  }
+  return std::count(begin, end, ',') + 1;
+}
+
 class CSVFile: public bob::io::File {
 
   public: //api
@@ -45,37 +72,32 @@ class CSVFile: public bob::io::File {
     /**
      * Peeks the file contents for a type. We assume the element type to be
      * always doubles. This method, effectively, only peaks for the total
-     * number of lines and the number of columns in the file.
+     * number of lines and the number of columns in the file, checking all
+     * lines in parallel.
      */
-    void peek() {
-
-      std::string line;
-      size_t line_number = 0;
-      size_t entries = 0;
-      std::streampos cur_pos = 0;
-
-      m_file.seekg(0); //< returns to the begin of file and start reading...
-
-      while (std::getline(m_file,line)) {
-        ++line_number;
-        m_pos.push_back(cur_pos);
-        cur_pos = m_file.tellg();
-        Tokenizer tok(line);
-        size_t size = std::distance(tok.begin(), tok.end());
-        if (!entries) entries = size;
-        else if (entries != size) {
-          boost::format m("line %d at file '%s' contains %d entries instead of %d (expected)");
-          m % line_number % m_filename % size % entries;
-          throw std::runtime_error(m.str());
-        }
-      }
+    void peek(const bob::io::LineIndex& index) {
 
-      if (!line_number) {
+      if (!index.size()) {
         m_newfile = true;
         m_pos.clear();
         return;
       }
 
+      const size_t entries = count_entries(index.begin(0), index.end(0));
+
+      const size_t n_threads = index.getNThreads();
+      const size_t n = index.size();
+      std::vector<std::string> errors(n_threads);
+      boost::thread_group threads;
+      for (size_t t=1; t<n_threads; ++t) {
+        threads.create_thread(boost::bind(&CSVFile::check_lines, this,
+              boost::cref(index), t*n/n_threads, (t+1)*n/n_threads, entries,
+              boost::ref(errors[t])));
+      }
+      check_lines(index, 0, n/n_threads, entries, errors[0]);
+      threads.join_all();
+      raise_first(errors);
+
       m_arrayset_type.dtype = bob::core::array::t_float64;
       m_arrayset_type.nd = 1;
       m_arrayset_type.shape[0] = entries;
@@ -83,7 +105,7 @@ class CSVFile: public bob::io::File {
 
       m_array_type = m_arrayset_type;
       m_array_type.nd = 2;
-      m_array_type.shape[0] = m_pos.size();
+      m_array_type.shape[0] = n;
       m_array_type.shape[1] = entries;
       m_array_type.update_strides();
     }
@@ -92,19 +114,25 @@ class CSVFile: public bob::io::File {
       m_filename(path),
       m_newfile(false) {
 
-        if (mode == 'r' || (mode == 'a' && boost::filesystem::exists(path))) { //try peeking
+        if (mode == 'r') {
+          // the file is mapped in memory and read from there
+          m_index = boost::make_shared<bob::io::LineIndex>(m_filename);
+          peek(*m_index);
+        }
+        else if (mode == 'a' && boost::filesystem::exists(path)) { //try peeking
           
-          if (mode == 'r') 
-            m_file.open(m_filename.c_str(), std::ios::in);
-          else if (mode == 'a')
-            m_file.open(m_filename.c_str(), std::ios::app|std::ios::in|std::ios::out);
+          m_file.open(m_filename.c_str(), std::ios::app|std::ios::in|std::ios::out);
           if (!m_file.is_open()) {
             boost::format m("cannot open file '%s' for reading or appending");
             m % path;
             throw std::runtime_error(m.str());
           }
 
-          peek(); ///< peek file properties
+          bob::io::LineIndex index(m_filename);
+          peek(index); ///< peek file properties
+          m_pos.reserve(index.size());
+          for (size_t k=0; k<index.size(); ++k)
+            m_pos.push_back(index.begin(k) - index.begin(0));
         }
         else {
           m_file.open(m_filename.c_str(), std::ios::trunc|std::ios::in|std::ios::out);
@@ -139,7 +167,7 @@ class CSVFile: public bob::io::File {
     }
 
     virtual size_t size() const {
-      return m_pos.size();
+      return m_index ? m_index->size() : m_pos.size();
     }
 
     virtual const std::string& name() const {
@@ -152,17 +180,26 @@ class CSVFile: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_array_type)) buffer.set(m_array_type);
 
-      //read contents
-      std::string line;
-      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
-      m_file.seekg(0);
       double* p = static_cast<double*>(buffer.ptr());
-      while (std::getline(m_file, line)) {
-        Tokenizer tok(line);
-        for(Tokenizer::iterator k=tok.begin(); k!=tok.end(); ++k) {
-          std::istringstream(*k) >> *(p++);
-        }
+
+      if (!m_index) { //appending: reads contents through the stream
+        const size_t entries = m_arrayset_type.shape[0];
+        for (size_t k=0; k<m_pos.size(); ++k) read_line(k, p + k*entries);
+        return;
+      }
+
+      //parses blocks of lines in parallel
+      const size_t n_threads = m_index->getNThreads();
+      const size_t n = m_index->size();
+      std::vector<std::string> errors(n_threads);
+      boost::thread_group threads;
+      for (size_t t=1; t<n_threads; ++t) {
+        threads.create_thread(boost::bind(&CSVFile::parse_lines, this,
+              t*n/n_threads, (t+1)*n/n_threads, p, boost::ref(errors[t])));
       }
+      parse_lines(0, n/n_threads, p, errors[0]);
+      threads.join_all();
+      raise_first(errors);
     }
 
     virtual void read(bob::core::array::interface& buffer, size_t index) {
@@ -173,26 +210,15 @@ class CSVFile: public bob::io::File {
       if (!buffer.type().is_compatible(m_arrayset_type)) 
         buffer.set(m_arrayset_type);
 
-      if (index >= m_pos.size()) {
+      if (index >= size()) {
         boost::format m("cannot array at position %d -- there is only %d entries at file '%s'");
-        m % index % m_pos.size() % m_filename;
+        m % index % size() % m_filename;
         throw std::runtime_error(m.str());
       }
 
-      //reads a specific line from the file.
-      std::string line;
-      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
-      m_file.seekg(m_pos[index]);
-      if (!std::getline(m_file, line)) {
-        boost::format m("could not seek to line %u (offset %u) while reading file '%s'");
-        m % index % m_pos[index] % m_filename;
-        throw std::runtime_error(m.str());
-      }
-      Tokenizer tok(line);
       double* p = static_cast<double*>(buffer.ptr());
-      for(Tokenizer::iterator k=tok.begin(); k!=tok.end(); ++k) {
-        std::istringstream(*k) >> *(p++);
-      }
+      if (m_index) parse_line(m_index->begin(index), m_index->end(index), index, p);
+      else read_line(index, p);
 
     }
 
@@ -266,13 +292,125 @@ class CSVFile: public bob::io::File {
 
     }
 
+  private: //helpers
+
+    /**
+     * Parses a single entry of line 'index'
+     */
+    void parse_entry(const char* begin, const char* end, size_t index,
+        double& value) const {
+      while (begin != end && std::isspace((unsigned char)*begin)) ++begin;
+      while (end != begin && std::isspace((unsigned char)*(end-1))) --end;
+      if (!bob::io::parse_double(begin, end, value)) {
+        boost::format m("cannot parse entry '%s' at line %u of file '%s' as a number");
+        m % std::string(begin, end) % (index+1) % m_filename;
+        throw std::runtime_error(m.str());
+      }
+    }
+
+    /**
+     * Parses all entries of line 'index', given as [begin, end), into 'p'
+     */
+    void parse_line(const char* begin, const char* end, size_t index,
+        double* p) const {
+
+      const size_t entries = m_arrayset_type.shape[0];
+      size_t parsed = 0;
+
+      if (is_escaped(begin, end)) {
+        std::string line(begin, end);
+        Tokenizer tok(line);
+        for(Tokenizer::iterator k=tok.begin(); k!=tok.end(); ++k) {
+          if (parsed == entries) { ++parsed; break; } //extra entries
+          parse_entry(k->data(), k->data() + k->size(), index, p[parsed++]);
+        }
+      }
+
+      else {
+        for (bool more=true; more; ) {
+          const char* comma = static_cast<const char*>(std::memchr(begin, ',', end - begin));
+          if (!comma) { comma = end; more = false; }
+          if (parsed == entries) { ++parsed; break; } //extra entries
+          parse_entry(begin, comma, index, p[parsed++]);
+          if (more) begin = comma + 1;
+        }
+      }
+
+      if (parsed != entries) {
+        boost::format m("line %d at file '%s' does not contain %d entries (expected)");
+        m % (index+1) % m_filename % entries;
+        throw std::runtime_error(m.str());
+      }
+    }
+
+    /**
+     * Reads line 'index' from the stream of a file opened for appending
+     */
+    void read_line(size_t index, double* p) {
+      std::string line;
+      if (m_file.eof()) m_file.clear(); ///< clear current "end" state.
+      m_file.seekg(m_pos[index]);
+      if (!std::getline(m_file, line)) {
+        boost::format m("could not seek to line %u (offset %u) while reading file '%s'");
+        m % index % m_pos[index] % m_filename;
+        throw std::runtime_error(m.str());
+      }
+      parse_line(line.data(), line.data() + line.size(), index, p);
+    }
+
+    /**
+     * Checks that lines [begin, end) all contain 'entries' entries. Runs on
+     * worker threads: errors are reported through 'error'.
+     */
+    void check_lines(const bob::io::LineIndex& index, size_t begin,
+        size_t end, size_t entries, std::string& error) const {
+      try {
+        for (size_t k=begin; k<end; ++k) {
+          size_t size = count_entries(index.begin(k), index.end(k));
+          if (entries != size) {
+            boost::format m("line %d at file '%s' contains %d entries instead of %d (expected)");
+            m % (k+1) % m_filename % size % entries;
+            throw std::runtime_error(m.str());
+          }
+        }
+      }
+      catch (std::exception& e) {
+        error = e.what();
+      }
+    }
+
+    /**
+     * Parses lines [begin, end) of the mapped file into the rows of 'p'.
+     * Runs on worker threads: errors are reported through 'error'.
+     */
+    void parse_lines(size_t begin, size_t end, double* p,
+        std::string& error) const {
+      const size_t entries = m_arrayset_type.shape[0];
+      try {
+        for (size_t k=begin; k<end; ++k)
+          parse_line(m_index->begin(k), m_index->end(k), k, p + k*entries);
+      }
+      catch (std::exception& e) {
+        error = e.what();
+      }
+    }
+
+    /**
+     * Raises the error of the first block of lines that failed, if any
+     */
+    static void raise_first(const std::vector<std::string>& errors) {
+      for (size_t t=0; t<errors.size(); ++t)
+        if (!errors[t].empty()) throw std::runtime_error(errors[t]);
+    }
+
   private: //representation
     std::fstream m_file;
     std::string m_filename;
     bool m_newfile;
     bob::core::array::typeinfo m_array_type;
     bob::core::array::typeinfo m_arrayset_type;
-    std::vector<std::streampos> m_pos; ///< dictionary of line starts
+    std::vector<std::streampos> m_pos; ///< line starts, when appending
+    boost::shared_ptr<bob::io::LineIndex> m_index; ///< lines, when reading
 
     static std::string s_codecname;
 
@@ -119,8 +119,10 @@ const char* bob::io::Uninitialized::what() const throw() {
   return message;
 }
 
-bob::io::FileNotReadable::FileNotReadable(const std::string& filename) throw() :
-  m_name(filename)
+bob::io::FileNotReadable::FileNotReadable(const std::string& filename,
+    const std::string& reason) throw() :
+  m_name(filename),
+  m_reason(reason)
 {
 }
 
@@ -131,6 +133,7 @@ const char* bob::io::FileNotReadable::what() const throw() {
     boost::format message("Cannot read file '%s'");
     message % m_name;
     m_message = message.str();
+    if (!m_reason.empty()) m_message += ": " + m_reason;
     return m_message.c_str();
   } catch (...) {
     static const char* emergency = "bob::io::FileNotReadable: cannot format, exception raised";
@@ -18,6 +18,22 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <boost/make_shared.hpp>
 #include <bob/io/File.h>
 
 bob::io::File::~File() { }
+
+boost::shared_ptr<bob::core::array::interface> bob::io::File::view
+(size_t index) {
+  boost::shared_ptr<bob::core::array::blitz_array> retval =
+    boost::make_shared<bob::core::array::blitz_array>(type());
+  read(*retval, index);
+  return retval;
+}
+
+boost::shared_ptr<bob::core::array::interface> bob::io::File::view_all() {
+  boost::shared_ptr<bob::core::array::blitz_array> retval =
+    boost::make_shared<bob::core::array::blitz_array>(type_all());
+  read_all(*retval);
+  return retval;
+}
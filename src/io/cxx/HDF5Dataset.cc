@@ -43,7 +43,8 @@ static void delete_h5dataset (hid_t* p) {
 }
 
 static boost::shared_ptr<hid_t> open_dataset
-(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name) {
+(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name,
+ hid_t dapl=H5P_DEFAULT) {
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot open dataset with illegal name `%s' at `%s:%s'");
     m % name % par->file()->filename() % par->path();
@@ -52,7 +53,7 @@ static boost::shared_ptr<hid_t> open_dataset
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
-  *retval = H5Dopen2(*par->location(), name.c_str(), H5P_DEFAULT);
+  *retval = H5Dopen2(*par->location(), name.c_str(), dapl);
   if (*retval < 0) {
     throw bob::io::HDF5StatusError("H5Dopen2", *retval);
   }
@@ -232,12 +233,25 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
   }
 }
 
+/**
+ * Number of variables per chunk of list datasets, if not set by the user.
+ * Chunks of about 64 KiB keep the number of chunks low for long lists of
+ * feature vectors, while many of them fit in the default (1 MiB) chunk
+ * cache.
+ */
+static size_t default_chunk_rows(const bob::io::HDF5Type& type) {
+  static const size_t CHUNK_BYTES = 65536;
+  const size_t row = H5Tget_size(*type.htype()) * type.shape().product();
+  if (!row || row >= CHUNK_BYTES) return 1;
+  return CHUNK_BYTES / row;
+}
+
 /**
  * Creates and writes an "empty" Dataset in an existing file.
  */
 static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
  const std::string& name, const bob::io::HDF5Type& type, bool list,
- size_t compression) {
+ size_t compression, size_t chunk_rows) {
 
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot create dataset with illegal name `%s' at `%s:%s'");
@@ -270,6 +284,7 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //array shape.
   bob::io::HDF5Shape chunking(xshape);
   chunking[0] = 1;
+  if (list) chunking[0] = chunk_rows ? chunk_rows : default_chunk_rows(type);
   if (list || compression) { ///< note: compression requires chunking
     herr_t status = H5Pset_chunk(*dcpl, chunking.n(), chunking.get());
     if (status < 0) throw bob::io::HDF5StatusError("H5Pset_chunk", status);
@@ -357,7 +372,7 @@ static void create_string_dataset (boost::shared_ptr<bob::io::detail::hdf5::Grou
 
 bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     const std::string& name, const bob::io::HDF5Type& type,
-    bool list, size_t compression):
+    bool list, size_t compression, size_t chunk_rows):
   m_parent(parent),
   m_name(name),
   m_id(),
@@ -375,7 +390,7 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     if (type.type() == bob::io::s) 
       create_string_dataset(parent, m_name, type, compression);
     else 
-      create_dataset(parent, m_name, type, list, compression);
+      create_dataset(parent, m_name, type, list, compression, chunk_rows);
   }
   else H5Dclose(set_id); //close it, will re-open it properly
 
@@ -531,6 +546,136 @@ void bob::io::detail::hdf5::Dataset::extend_buffer (const bob::io::HDF5Type& des
   write_buffer(tmp[0]-1, dest, buffer);
 }
 
+/**
+ * Splits the type of a block of consecutive objects into the number of
+ * objects (first dimension) and the type of each object. A 1D block holds
+ * scalars.
+ */
+static size_t split_rows(const bob::io::HDF5Type& block, bob::io::HDF5Type& row) {
+  const bob::io::HDF5Shape& shape = block.shape();
+  if (!shape.n()) throw std::length_error("empty HDF5 block of objects");
+  if (shape.n() == 1) row = bob::io::HDF5Type(block.type());
+  else {
+    bob::io::HDF5Shape alt(shape);
+    alt <<= 1; ///< contract shape
+    row = bob::io::HDF5Type(block.type(), alt);
+  }
+  return shape[0];
+}
+
+std::vector<bob::io::HDF5Descriptor>::iterator
+bob::io::detail::hdf5::Dataset::select (size_t index, size_t count,
+    const bob::io::HDF5Type& row) {
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, row);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) 
+    throw bob::io::HDF5IncompatibleIO(url(), m_descr[0].type.str(), row.str());
+
+  //checks indexing
+  if (index + count > it->size)
+    throw bob::io::HDF5IndexError(url(), it->size, index + count - 1);
+
+  //the hyperslab of a single object, repeated along the first dimension
+  bob::io::HDF5Shape count_shape(it->hyperslab_count);
+  count_shape[0] = count;
+  set_memspace(m_memspace, count_shape);
+
+  it->hyperslab_start[0] = index;
+
+  herr_t status = H5Sselect_hyperslab(*m_filespace, H5S_SELECT_SET,
+      it->hyperslab_start.get(), 0, count_shape.get(), 0);
+  if (status < 0) throw bob::io::HDF5StatusError("H5Sselect_hyperslab", status);
+
+  return it;
+}
+
+void bob::io::detail::hdf5::Dataset::read_rows_buffer (size_t index,
+    const bob::io::HDF5Type& dest, void* buffer) {
+
+  bob::io::HDF5Type row;
+  const size_t count = split_rows(dest, row);
+  if (!count) return;
+
+  std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, count, row);
+
+  herr_t status = H5Dread(*m_id, *it->type.htype(),
+      *m_memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw bob::io::HDF5StatusError("H5Dread", status);
+}
+
+void bob::io::detail::hdf5::Dataset::write_rows_buffer (size_t index,
+    const bob::io::HDF5Type& dest, const void* buffer) {
+
+  bob::io::HDF5Type row;
+  const size_t count = split_rows(dest, row);
+  if (!count) return;
+
+  std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, count, row);
+
+  herr_t status = H5Dwrite(*m_id, *it->type.htype(),
+      *m_memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw bob::io::HDF5StatusError("H5Dwrite", status);
+}
+
+void bob::io::detail::hdf5::Dataset::extend_rows_buffer
+(const bob::io::HDF5Type& dest, const void* buffer) {
+
+  bob::io::HDF5Type row;
+  const size_t count = split_rows(dest, row);
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, row);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) 
+    throw bob::io::HDF5IncompatibleIO(url(), m_descr[0].type.str(), row.str());
+
+  if (!it->expandable)
+    throw bob::io::HDF5NotExpandible(url());
+
+  if (!count) return;
+
+  //if it is expandible, try expansion (once for all objects)
+  const size_t index = it->size;
+  bob::io::HDF5Shape tmp(it->type.shape());
+  tmp >>= 1;
+  tmp[0] = index + count;
+  herr_t status = H5Dset_extent(*m_id, tmp.get());
+  if (status < 0) throw bob::io::HDF5StatusError("H5Dset_extent", status);
+
+  //if expansion succeeded, update all compatible types
+  for (size_t k=0; k<m_descr.size(); ++k) {
+    if (m_descr[k].expandable) { //updated only the length
+      m_descr[k].size += count;
+    }
+    else { //not expandable, update the shape/count for a straight read/write
+      m_descr[k].type.shape()[0] += count;
+      m_descr[k].hyperslab_count[0] += count;
+    }
+  }
+
+  m_filespace = open_filespace(m_id); //update filespace
+
+  write_rows_buffer(index, dest, buffer);
+}
+
+void bob::io::detail::hdf5::Dataset::setChunkCache(size_t nslots,
+    size_t nbytes, double w0) {
+  boost::shared_ptr<hid_t> dapl = open_plist(H5P_DATASET_ACCESS);
+  herr_t status = H5Pset_chunk_cache(*dapl, nslots, nbytes, w0);
+  if (status < 0) throw bob::io::HDF5StatusError("H5Pset_chunk_cache", status);
+
+  //the cache settings are only taken into account when opening the dataset
+  boost::shared_ptr<Group> par = parent();
+  m_id = open_dataset(par, m_name, *dapl);
+  m_filespace = open_filespace(m_id);
+}
+
 void bob::io::detail::hdf5::Dataset::gettype_attribute(const std::string& name,
           bob::io::HDF5Type& type) const {
   bob::io::detail::hdf5::gettype_attribute(m_id, name, type);
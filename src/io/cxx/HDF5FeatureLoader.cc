@@ -0,0 +1,109 @@
+/**
+ * @file io/cxx/HDF5FeatureLoader.cc
+ * @date Sun Oct 18 16:02:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the background loading of HDF5 feature files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <bob/io/HDF5File.h>
+#include <bob/io/HDF5FeatureLoader.h>
+
+bob::io::HDF5FeatureLoader::HDF5FeatureLoader
+(const std::vector<std::string>& filenames,
+ const std::vector<std::string>& paths, size_t n_workers, size_t queue_size):
+  m_filenames(filenames),
+  m_paths(paths),
+  m_n_workers(n_workers),
+  m_ring(queue_size)
+{
+  if (paths.size() != 1 && paths.size() != filenames.size()) {
+    boost::format m("HDF5FeatureLoader: expected either a single dataset path or one per file (%u), but got %u paths");
+    m % filenames.size() % paths.size();
+    throw std::runtime_error(m.str());
+  }
+  if (n_workers == 0) throw std::runtime_error("HDF5FeatureLoader: the number of workers should be greater than zero");
+}
+
+bob::io::HDF5FeatureLoader::~HDF5FeatureLoader() {
+  stop();
+}
+
+void bob::io::HDF5FeatureLoader::start() {
+  m_ring.start(m_n_workers,
+      boost::bind(&bob::io::HDF5FeatureLoader::worker, this, _1));
+}
+
+void bob::io::HDF5FeatureLoader::stop() {
+  m_ring.stop();
+  for (size_t k=0; k<m_ring.size(); ++k)
+    m_ring[k].reference(blitz::Array<double,2>());
+}
+
+void bob::io::HDF5FeatureLoader::load(size_t i,
+    blitz::Array<double,2>& data) const {
+  bob::io::HDF5File file(m_filenames[i], bob::io::HDF5File::in);
+  data.reference(file.readArray<double,2>(getPath(i)));
+}
+
+void bob::io::HDF5FeatureLoader::worker(size_t id) {
+
+  for (size_t seq=id; seq<m_filenames.size(); seq+=m_n_workers) {
+    // waits until the file 'seq - Q' was picked up
+    blitz::Array<double,2>* slot = m_ring.acquire(seq);
+    if (!slot) return;
+
+    // nobody else touches this slot until it is published
+    try {
+      load(seq, *slot);
+    }
+    catch (std::exception& e) {
+      boost::format m("HDF5FeatureLoader: cannot load '%s' from '%s': %s");
+      m % getPath(seq) % m_filenames[seq] % e.what();
+      m_ring.fail(seq, m.str());
+      return;
+    }
+    catch (...) {
+      m_ring.fail(seq, "HDF5FeatureLoader: unknown exception raised by worker");
+      return;
+    }
+
+    m_ring.publish(seq);
+  }
+}
+
+bool bob::io::HDF5FeatureLoader::next(blitz::Array<double,2>& data) {
+
+  if (m_ring.position() >= m_filenames.size()) return false;
+
+  start();
+
+  // files loaded before a failure are still delivered. The failure is
+  // kept (and raised again) until stop() is called.
+  blitz::Array<double,2>* slot = m_ring.wait();
+  if (!slot) throw std::runtime_error("HDF5FeatureLoader: stopped while waiting for the next file");
+
+  // the slot cannot be refilled before we release it
+  data.reference(*slot);
+  slot->reference(blitz::Array<double,2>());
+
+  m_ring.release();
+  return true;
+}
@@ -34,22 +34,34 @@ static unsigned int getH5Access (bob::io::HDF5File::mode_t v) {
   }
 }
 
-bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode):
-  m_file(new bob::io::detail::hdf5::File(filename, getH5Access(mode))),
-  m_cwd(m_file->root()) ///< we start by looking at the root directory
+boost::recursive_mutex& bob::io::HDF5File::mutex() {
+  static boost::recursive_mutex s_mutex;
+  return s_mutex;
+}
+
+bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode)
 {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  m_file.reset(new bob::io::detail::hdf5::File(filename, getH5Access(mode)));
+  m_cwd = m_file->root(); ///< we start by looking at the root directory
 }
 
-bob::io::HDF5File::HDF5File(const bob::io::HDF5File& other_file):
-  m_file(other_file.m_file),
-  m_cwd(other_file.m_cwd)
+bob::io::HDF5File::HDF5File(const bob::io::HDF5File& other_file)
 {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  m_file = other_file.m_file;
+  m_cwd = other_file.m_cwd;
 }
 
 bob::io::HDF5File::~HDF5File() {
+  //the last copy closes the file
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  m_cwd.reset();
+  m_file.reset();
 }
 
 bob::io::HDF5File& bob::io::HDF5File::operator =(const bob::io::HDF5File& other_file){
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   m_file = other_file.m_file;
   m_cwd = other_file.m_cwd;
   return *this;
@@ -57,14 +69,17 @@ bob::io::HDF5File& bob::io::HDF5File::operator =(const bob::io::HDF5File& other_
 
 
 void bob::io::HDF5File::cd(const std::string& path) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   m_cwd = m_cwd->cd(path);
 }
 
 bool bob::io::HDF5File::hasGroup(const std::string& path) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   return m_cwd->has_group(path);
 }
 
 void bob::io::HDF5File::createGroup(const std::string& path) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot create group '%s' at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
@@ -74,19 +89,23 @@ void bob::io::HDF5File::createGroup(const std::string& path) {
 }
 
 std::string bob::io::HDF5File::cwd() const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   return m_cwd->path();
 }
 
 bool bob::io::HDF5File::contains (const std::string& path) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   return m_cwd->has_dataset(path);
 }
 
 const std::vector<bob::io::HDF5Descriptor>& bob::io::HDF5File::describe
 (const std::string& path) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   return (*m_cwd)[path]->m_descr;
 }
 
 void bob::io::HDF5File::unlink (const std::string& path) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot remove dataset at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
@@ -96,6 +115,7 @@ void bob::io::HDF5File::unlink (const std::string& path) {
 }
 
 void bob::io::HDF5File::rename (const std::string& from, const std::string& to) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot rename dataset '%s' -> '%s' at path '%s' of file '%s' because it is not writeable");
     m % from % to % m_cwd->path() % m_file->filename();
@@ -109,6 +129,7 @@ void bob::io::HDF5File::rename (const std::string& from, const std::string& to)
 }
 
 void bob::io::HDF5File::copy (HDF5File& other) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot copy data of file '%s' to path '%s' of file '%s' because it is not writeable");
     m % other.filename() % m_cwd->path() % m_file->filename();
@@ -133,23 +154,27 @@ void bob::io::HDF5File::copy (HDF5File& other) {
 }
 
 void bob::io::HDF5File::create (const std::string& path, const bob::io::HDF5Type& type,
-    bool list, size_t compression) {
+    bool list, size_t compression, size_t chunk_rows) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot create dataset '%s' at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
     throw std::runtime_error(m.str());
   }
-  if (!contains(path)) m_cwd->create_dataset(path, type, list, compression);
+  if (!contains(path)) 
+    m_cwd->create_dataset(path, type, list, compression, chunk_rows);
   else (*m_cwd)[path]->size(type);
 }
 
 void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
     const bob::io::HDF5Type& type, void* buffer) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   (*m_cwd)[path]->read_buffer(pos, type, buffer);
 }
 
 void bob::io::HDF5File::write_buffer (const std::string& path,
     size_t pos, const bob::io::HDF5Type& type, const void* buffer) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot write to object '%s' at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
@@ -160,6 +185,7 @@ void bob::io::HDF5File::write_buffer (const std::string& path,
 
 void bob::io::HDF5File::extend_buffer(const std::string& path,
     const bob::io::HDF5Type& type, const void* buffer) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (!m_file->writeable()) {
     boost::format m("cannot extend object '%s' at path '%s' of file '%s' because the file is not writeable");
     m % path % m_cwd->path() % m_file->filename();
@@ -168,8 +194,43 @@ void bob::io::HDF5File::extend_buffer(const std::string& path,
   (*m_cwd)[path]->extend_buffer(type, buffer);
 }
 
+void bob::io::HDF5File::read_rows_buffer (const std::string& path, size_t pos,
+    const bob::io::HDF5Type& type, void* buffer) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  (*m_cwd)[path]->read_rows_buffer(pos, type, buffer);
+}
+
+void bob::io::HDF5File::write_rows_buffer (const std::string& path,
+    size_t pos, const bob::io::HDF5Type& type, const void* buffer) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  if (!m_file->writeable()) {
+    boost::format m("cannot write to object '%s' at path '%s' of file '%s' because it is not writeable");
+    m % path % m_cwd->path() % m_file->filename();
+    throw std::runtime_error(m.str());
+  }
+  (*m_cwd)[path]->write_rows_buffer(pos, type, buffer);
+}
+
+void bob::io::HDF5File::extend_rows_buffer(const std::string& path,
+    const bob::io::HDF5Type& type, const void* buffer) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  if (!m_file->writeable()) {
+    boost::format m("cannot extend object '%s' at path '%s' of file '%s' because the file is not writeable");
+    m % path % m_cwd->path() % m_file->filename();
+    throw std::runtime_error(m.str());
+  }
+  (*m_cwd)[path]->extend_rows_buffer(type, buffer);
+}
+
+void bob::io::HDF5File::setChunkCache(const std::string& path, size_t nslots,
+    size_t nbytes, double w0) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
+  (*m_cwd)[path]->setChunkCache(nslots, nbytes, w0);
+}
+
 bool bob::io::HDF5File::hasAttribute(const std::string& path,
     const std::string& name) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     return (*m_cwd)[path]->has_attribute(name);
   }
@@ -181,6 +242,7 @@ bool bob::io::HDF5File::hasAttribute(const std::string& path,
 
 void bob::io::HDF5File::getAttributeType(const std::string& path,
     const std::string& name, HDF5Type& type) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     (*m_cwd)[path]->gettype_attribute(name, type);
   }
@@ -196,6 +258,7 @@ void bob::io::HDF5File::getAttributeType(const std::string& path,
 
 void bob::io::HDF5File::deleteAttribute(const std::string& path,
     const std::string& name) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     (*m_cwd)[path]->delete_attribute(name);
   }
@@ -211,6 +274,7 @@ void bob::io::HDF5File::deleteAttribute(const std::string& path,
 
 void bob::io::HDF5File::listAttributes(const std::string& path,
     std::map<std::string, bob::io::HDF5Type>& attributes) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     (*m_cwd)[path]->list_attributes(attributes);
   }
@@ -226,6 +290,7 @@ void bob::io::HDF5File::listAttributes(const std::string& path,
 
 void bob::io::HDF5File::read_attribute(const std::string& path, 
     const std::string& name, const bob::io::HDF5Type& type, void* buffer) const {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     (*m_cwd)[path]->read_attribute(name, type, buffer);
   }
@@ -241,6 +306,7 @@ void bob::io::HDF5File::read_attribute(const std::string& path,
 
 void bob::io::HDF5File::write_attribute(const std::string& path,
     const std::string& name, const bob::io::HDF5Type& type, const void* buffer) {
+  boost::lock_guard<boost::recursive_mutex> lock(mutex());
   if (m_cwd->has_dataset(path)) {
     (*m_cwd)[path]->write_attribute(name, type, buffer);
   }
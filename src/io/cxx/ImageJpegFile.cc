@@ -65,11 +65,13 @@ static void im_peek(const std::string& path, bob::core::array::typeinfo& info) {
 
   // 4. Set parameters for decompression if any
 
-  // 5. Start decompression and get information
-  jpeg_start_decompress(&cinfo);
+  // 5. Get output information: this only reads the headers, while starting
+  // decompression would decode all scans of progressive files
+  jpeg_calc_output_dimensions(&cinfo);
 
   if( cinfo.output_components != 1 && cinfo.output_components != 3)
   {
+    jpeg_destroy_decompress(&cinfo);
     boost::format m("unsupported number of planes (%d) when reading file. Image depth must be 1 or 3.");
     m % cinfo.output_components;
     throw std::runtime_error(m.str());
@@ -92,6 +94,8 @@ static void im_peek(const std::string& path, bob::core::array::typeinfo& info) {
   info.update_strides();
 
   // TODO: check depth
+
+  jpeg_destroy_decompress(&cinfo);
 }
 
 template <typename T> static
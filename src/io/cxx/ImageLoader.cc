@@ -0,0 +1,522 @@
+/**
+ * @file io/cxx/ImageLoader.cc
+ * @date Sun Oct 18 20:14:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the parallel decoding of image files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <csetjmp>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <boost/filesystem.hpp>
+
+#include <bob/core/blitz_array.h>
+#include <bob/io/Exception.h>
+#include <bob/io/utils.h>
+#include <bob/io/ImageLoader.h>
+
+#include <jpeglib.h>
+
+extern "C" {
+#include <png.h>
+}
+
+#ifndef png_jmpbuf
+#  define png_jmpbuf(png_ptr) ((png_ptr)->png_jmpbuf)
+#endif
+
+typedef bob::io::ImageLoader::layout_t layout_t;
+
+bob::io::ImageLoader::ImageLoader
+(const std::vector<std::string>& filenames, layout_t layout,
+ size_t n_workers, size_t queue_size, size_t max_height, size_t max_width):
+  m_filenames(filenames),
+  m_layout(layout),
+  m_n_workers(n_workers),
+  m_max_height(max_height),
+  m_max_width(max_width),
+  m_ring(queue_size)
+{
+  if (!m_n_workers) m_n_workers = boost::thread::hardware_concurrency();
+  if (!m_n_workers) m_n_workers = 1;
+}
+
+bob::io::ImageLoader::~ImageLoader() {
+  stop();
+}
+
+void bob::io::ImageLoader::start() {
+  m_ring.start(m_n_workers,
+      boost::bind(&bob::io::ImageLoader::worker, this, _1));
+}
+
+void bob::io::ImageLoader::stop() {
+  m_ring.stop();
+  for (size_t k=0; k<m_ring.size(); ++k) {
+    m_ring[k].color.reference(blitz::Array<uint8_t,3>());
+    m_ring[k].gray.reference(blitz::Array<uint8_t,2>());
+  }
+}
+
+/**
+ * Converts RGB to luminance as libjpeg does, so that all formats give the
+ * same gray levels
+ */
+static inline uint8_t luma(uint8_t r, uint8_t g, uint8_t b) {
+  return (19595*r + 38470*g + 7471*b + 32768) >> 16;
+}
+
+static void resize(layout_t layout, int height, int width,
+    blitz::Array<uint8_t,3>& color, blitz::Array<uint8_t,2>& gray) {
+  switch (layout) {
+    case bob::io::ImageLoader::gray: gray.resize(height, width); break;
+    case bob::io::ImageLoader::interleaved: color.resize(height, width, 3); break;
+    default: color.resize(3, height, width); break;
+  }
+}
+
+/**
+ * Stores row 'y' of an image, given as interleaved RGB
+ */
+static void store_rgb_row(const uint8_t* rgb, int y, int width,
+    layout_t layout, blitz::Array<uint8_t,3>& color,
+    blitz::Array<uint8_t,2>& gray) {
+
+  switch (layout) {
+    case bob::io::ImageLoader::gray:
+      {
+        uint8_t* out = gray.data() + y*width;
+        for (int x=0; x<width; ++x, rgb+=3) out[x] = luma(rgb[0], rgb[1], rgb[2]);
+      }
+      break;
+    case bob::io::ImageLoader::interleaved:
+      std::memcpy(color.data() + 3*y*width, rgb, 3*width);
+      break;
+    default: //planar
+      {
+        const size_t plane = color.extent(1) * width;
+        uint8_t* r = color.data() + y*width;
+        uint8_t* g = r + plane;
+        uint8_t* b = g + plane;
+        for (int x=0; x<width; ++x, rgb+=3) {
+          r[x] = rgb[0];
+          g[x] = rgb[1];
+          b[x] = rgb[2];
+        }
+      }
+      break;
+  }
+}
+
+/**
+ * Stores row 'y' of an image, given as gray levels
+ */
+static void store_gray_row(const uint8_t* in, int y, int width,
+    layout_t layout, blitz::Array<uint8_t,3>& color,
+    blitz::Array<uint8_t,2>& gray) {
+
+  switch (layout) {
+    case bob::io::ImageLoader::gray:
+      std::memcpy(gray.data() + y*width, in, width);
+      break;
+    case bob::io::ImageLoader::interleaved:
+      {
+        uint8_t* out = color.data() + 3*y*width;
+        for (int x=0; x<width; ++x, out+=3) out[0] = out[1] = out[2] = in[x];
+      }
+      break;
+    default: //planar
+      {
+        const size_t plane = color.extent(1) * width;
+        for (int c=0; c<3; ++c)
+          std::memcpy(color.data() + c*plane + y*width, in, width);
+      }
+      break;
+  }
+}
+
+static boost::shared_ptr<std::FILE> make_cfile(const char *filename, const char *flags)
+{
+  std::FILE* fp = std::fopen(filename, flags);
+  if(fp == 0) throw bob::io::FileNotReadable(filename);
+  return boost::shared_ptr<std::FILE>(fp, std::fclose);
+}
+
+/**
+ * libjpeg error manager that jumps back to the decoding routine, instead of
+ * terminating the program
+ */
+struct jpeg_error_handler {
+  struct jpeg_error_mgr pub;
+  std::jmp_buf jump;
+  char message[JMSG_LENGTH_MAX];
+};
+
+static void jpeg_error_exit(j_common_ptr cinfo) {
+  jpeg_error_handler* handler =
+    reinterpret_cast<jpeg_error_handler*>(cinfo->err);
+  (*cinfo->err->format_message)(cinfo, handler->message);
+  std::longjmp(handler->jump, 1);
+}
+
+/**
+ * The largest DCT scaling denominator (up to 8) that keeps the image at
+ * least as large as the requested size
+ */
+static unsigned int scale_denominator(size_t height, size_t width,
+    size_t max_height, size_t max_width) {
+  if (!max_height && !max_width) return 1;
+  for (unsigned int denom=8; denom>1; denom/=2) {
+    if ((height+denom-1)/denom >= max_height &&
+        (width+denom-1)/denom >= max_width) return denom;
+  }
+  return 1;
+}
+
+static void load_jpeg(const std::string& filename, layout_t layout,
+    size_t max_height, size_t max_width, blitz::Array<uint8_t,3>& color,
+    blitz::Array<uint8_t,2>& gray) {
+
+  boost::shared_ptr<std::FILE> in_file = make_cfile(filename.c_str(), "rb");
+  std::vector<JSAMPLE> row; //for rows that are re-ordered or converted
+
+  struct jpeg_decompress_struct cinfo;
+  struct jpeg_error_handler jerr;
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpeg_error_exit;
+  if (setjmp(jerr.jump)) {
+    jpeg_destroy_decompress(&cinfo);
+    boost::format m("cannot decode JPEG file `%s': %s");
+    m % filename % jerr.message;
+    throw std::runtime_error(m.str());
+  }
+
+  jpeg_create_decompress(&cinfo);
+  jpeg_stdio_src(&cinfo, in_file.get());
+  jpeg_read_header(&cinfo, TRUE);
+
+  if (cinfo.num_components != 1 && cinfo.num_components != 3) {
+    jpeg_destroy_decompress(&cinfo);
+    boost::format m("unsupported number of planes (%d) when reading file `%s'. Image depth must be 1 or 3.");
+    m % cinfo.num_components % filename;
+    throw std::runtime_error(m.str());
+  }
+
+  // lets the decoder skip the chroma channels of gray outputs
+  if (layout == bob::io::ImageLoader::gray &&
+      (cinfo.jpeg_color_space == JCS_YCbCr ||
+       cinfo.jpeg_color_space == JCS_GRAYSCALE))
+    cinfo.out_color_space = JCS_GRAYSCALE;
+  else if (cinfo.jpeg_color_space != JCS_GRAYSCALE)
+    cinfo.out_color_space = JCS_RGB;
+
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = scale_denominator(cinfo.image_height,
+      cinfo.image_width, max_height, max_width);
+
+  jpeg_start_decompress(&cinfo);
+
+  const int height = cinfo.output_height;
+  const int width = cinfo.output_width;
+  const bool gray_rows = (cinfo.out_color_space == JCS_GRAYSCALE);
+  resize(layout, height, width, color, gray);
+
+  JSAMPROW rows[1];
+  if (layout == bob::io::ImageLoader::gray && gray_rows) {
+    while (cinfo.output_scanline < cinfo.output_height) {
+      rows[0] = gray.data() + cinfo.output_scanline * width;
+      jpeg_read_scanlines(&cinfo, rows, 1);
+    }
+  }
+  else if (layout == bob::io::ImageLoader::interleaved && !gray_rows) {
+    while (cinfo.output_scanline < cinfo.output_height) {
+      rows[0] = color.data() + cinfo.output_scanline * 3 * width;
+      jpeg_read_scanlines(&cinfo, rows, 1);
+    }
+  }
+  else {
+    row.resize(width * cinfo.output_components);
+    rows[0] = &row[0];
+    while (cinfo.output_scanline < cinfo.output_height) {
+      int y = cinfo.output_scanline;
+      jpeg_read_scanlines(&cinfo, rows, 1);
+      if (gray_rows) store_gray_row(&row[0], y, width, layout, color, gray);
+      else store_rgb_row(&row[0], y, width, layout, color, gray);
+    }
+  }
+
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+}
+
+static void load_png(const std::string& filename, layout_t layout,
+    blitz::Array<uint8_t,3>& color, blitz::Array<uint8_t,2>& gray) {
+
+  boost::shared_ptr<std::FILE> in_file = make_cfile(filename.c_str(), "rb");
+  std::vector<png_byte> buffer; //for rows that are re-ordered
+
+  png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+  if(png_ptr == NULL) throw std::runtime_error("PNG: error while creating read png structure (function png_create_read_struct())");
+
+  png_infop info_ptr = png_create_info_struct(png_ptr);
+  if(info_ptr == NULL) {
+    png_destroy_read_struct(&png_ptr, NULL, NULL);
+    throw std::runtime_error("PNG: error while creating info png structure (function png_create_info_struct())");
+  }
+
+  if(setjmp(png_jmpbuf(png_ptr))) {
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    boost::format m("cannot decode PNG file `%s'");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+
+  png_init_io(png_ptr, in_file.get());
+  png_read_info(png_ptr, info_ptr);
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type;
+  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+      &interlace_type, NULL, NULL);
+
+  // lets the decoder deliver 8-bit rows in the requested colorspace
+  if (bit_depth == 16) png_set_strip_16(png_ptr);
+  png_set_packing(png_ptr);
+  if (color_type == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(png_ptr);
+  if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+    png_set_expand_gray_1_2_4_to_8(png_ptr);
+  // palette and gray images may carry transparency (tRNS), which the
+  // expansion above turns into an alpha channel
+  if ((color_type & PNG_COLOR_MASK_ALPHA) ||
+      png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+    png_set_strip_alpha(png_ptr);
+
+  const bool gray_source = !(color_type & PNG_COLOR_MASK_COLOR);
+  if (layout == bob::io::ImageLoader::gray && !gray_source)
+    png_set_rgb_to_gray_fixed(png_ptr, 1, 29900, 58700); //as libjpeg
+  else if (layout != bob::io::ImageLoader::gray && gray_source)
+    png_set_gray_to_rgb(png_ptr);
+
+#ifdef PNG_READ_INTERLACING_SUPPORTED
+  int number_passes = png_set_interlace_handling(png_ptr);
+#else
+  int number_passes = 1;
+#endif // PNG_READ_INTERLACING_SUPPORTED
+
+  png_read_update_info(png_ptr, info_ptr);
+
+  // rows are written straight into buffers sized for 1 or 3 channels
+  const int channels = png_get_channels(png_ptr, info_ptr);
+  const int expected = (layout == bob::io::ImageLoader::gray) ? 1 : 3;
+  if (channels != expected) {
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    boost::format m("ImageLoader: cannot load `%s': the PNG decoder delivers %d channel(s) per pixel instead of %d");
+    m % filename % channels % expected;
+    throw std::runtime_error(m.str());
+  }
+
+  resize(layout, height, width, color, gray);
+
+  if (layout == bob::io::ImageLoader::planar) {
+    // interlaced images need all rows to be kept between passes
+    buffer.resize((number_passes > 1 ? height : 1) * 3 * width);
+    for (int pass=0; pass<number_passes; ++pass) {
+      for (size_t y=0; y<height; ++y) {
+        png_bytep row = &buffer[(number_passes > 1 ? y : 0) * 3 * width];
+        png_read_row(png_ptr, row, NULL);
+        if (number_passes == 1) store_rgb_row(row, y, width, layout, color, gray);
+      }
+    }
+    if (number_passes > 1) {
+      for (size_t y=0; y<height; ++y)
+        store_rgb_row(&buffer[y*3*width], y, width, layout, color, gray);
+    }
+  }
+  else {
+    png_bytep base = (layout == bob::io::ImageLoader::gray) ?
+      gray.data() : color.data();
+    const size_t stride = (layout == bob::io::ImageLoader::gray ? 1 : 3) * width;
+    for (int pass=0; pass<number_passes; ++pass) {
+      for (size_t y=0; y<height; ++y) png_read_row(png_ptr, base + y*stride, NULL);
+    }
+  }
+
+  png_read_end(png_ptr, NULL);
+  png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+}
+
+/**
+ * Reads other formats through their codecs and converts them afterwards.
+ * Some codecs are not re-entrant (netpbm and giflib report errors through
+ * global state), so files are read one at a time.
+ */
+static void load_other(const std::string& filename, layout_t layout,
+    blitz::Array<uint8_t,3>& color, blitz::Array<uint8_t,2>& gray) {
+
+  static boost::mutex s_codec_mutex;
+
+  boost::shared_ptr<bob::core::array::blitz_array> image;
+  {
+    boost::lock_guard<boost::mutex> lock(s_codec_mutex);
+    boost::shared_ptr<bob::io::File> file = bob::io::open(filename, 'r');
+    image = boost::make_shared<bob::core::array::blitz_array>(file->type());
+    file->read(*image, 0);
+  }
+
+  const bob::core::array::typeinfo& info = image->type();
+  if (info.dtype != bob::core::array::t_uint8) {
+    boost::format m("ImageLoader: cannot load `%s': only 8-bit images are supported, but the file contains %s");
+    m % filename % info.str();
+    throw std::runtime_error(m.str());
+  }
+
+  const uint8_t* data = static_cast<const uint8_t*>(image->ptr());
+
+  if (info.nd == 2) {
+    const int height = info.shape[0];
+    const int width = info.shape[1];
+    resize(layout, height, width, color, gray);
+    for (int y=0; y<height; ++y)
+      store_gray_row(data + y*width, y, width, layout, color, gray);
+  }
+
+  else if (info.nd == 3 && info.shape[0] == 3) {
+    const int height = info.shape[1];
+    const int width = info.shape[2];
+    const size_t plane = height * width;
+    resize(layout, height, width, color, gray);
+    if (layout == bob::io::ImageLoader::planar) {
+      std::memcpy(color.data(), data, 3*plane);
+      return;
+    }
+    std::vector<uint8_t> row(3*width);
+    for (int y=0; y<height; ++y) {
+      const uint8_t* r = data + y*width;
+      for (int x=0; x<width; ++x) {
+        row[3*x] = r[x];
+        row[3*x+1] = r[x+plane];
+        row[3*x+2] = r[x+2*plane];
+      }
+      store_rgb_row(&row[0], y, width, layout, color, gray);
+    }
+  }
+
+  else {
+    boost::format m("ImageLoader: cannot load `%s': unsupported image type %s");
+    m % filename % info.str();
+    throw std::runtime_error(m.str());
+  }
+}
+
+void bob::io::ImageLoader::decode(const std::string& filename,
+    blitz::Array<uint8_t,3>& color, blitz::Array<uint8_t,2>& gray) const {
+
+  std::string extension = boost::filesystem::path(filename).extension().c_str();
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+  if (extension == ".jpg" || extension == ".jpeg")
+    load_jpeg(filename, m_layout, m_max_height, m_max_width, color, gray);
+  else if (extension == ".png")
+    load_png(filename, m_layout, color, gray);
+  else
+    load_other(filename, m_layout, color, gray);
+}
+
+void bob::io::ImageLoader::load(const std::string& filename,
+    blitz::Array<uint8_t,3>& data) const {
+  if (m_layout == gray) throw std::runtime_error("ImageLoader: images in the gray layout are 2D arrays");
+  blitz::Array<uint8_t,2> unused;
+  decode(filename, data, unused);
+}
+
+void bob::io::ImageLoader::load(const std::string& filename,
+    blitz::Array<uint8_t,2>& data) const {
+  if (m_layout != gray) throw std::runtime_error("ImageLoader: images in the planar and interleaved layouts are 3D arrays");
+  blitz::Array<uint8_t,3> unused;
+  decode(filename, unused, data);
+}
+
+void bob::io::ImageLoader::worker(size_t id) {
+
+  for (size_t seq=id; seq<m_filenames.size(); seq+=m_n_workers) {
+    // waits until the file 'seq - Q' was picked up
+    Slot* slot = m_ring.acquire(seq);
+    if (!slot) return;
+
+    // nobody else touches this slot until it is published
+    try {
+      decode(m_filenames[seq], slot->color, slot->gray);
+    }
+    catch (std::exception& e) {
+      boost::format m("ImageLoader: cannot load '%s': %s");
+      m % m_filenames[seq] % e.what();
+      m_ring.fail(seq, m.str());
+      return;
+    }
+    catch (...) {
+      m_ring.fail(seq, "ImageLoader: unknown exception raised by worker");
+      return;
+    }
+
+    m_ring.publish(seq);
+  }
+}
+
+bob::io::ImageLoader::Slot* bob::io::ImageLoader::wait() {
+
+  if (m_ring.position() >= m_filenames.size()) return 0;
+
+  start();
+
+  // files decoded before a failure are still delivered. The failure is
+  // kept (and raised again) until stop() is called.
+  Slot* slot = m_ring.wait();
+  if (!slot) throw std::runtime_error("ImageLoader: stopped while waiting for the next image");
+  return slot;
+}
+
+bool bob::io::ImageLoader::next(blitz::Array<uint8_t,3>& data) {
+  if (m_layout == gray) throw std::runtime_error("ImageLoader: images in the gray layout are 2D arrays");
+
+  Slot* slot = wait();
+  if (!slot) return false;
+
+  // the slot cannot be refilled before we release it
+  data.reference(slot->color);
+  slot->color.reference(blitz::Array<uint8_t,3>());
+  m_ring.release();
+  return true;
+}
+
+bool bob::io::ImageLoader::next(blitz::Array<uint8_t,2>& data) {
+  if (m_layout != gray) throw std::runtime_error("ImageLoader: images in the planar and interleaved layouts are 3D arrays");
+
+  Slot* slot = wait();
+  if (!slot) return false;
+
+  // the slot cannot be refilled before we release it
+  data.reference(slot->gray);
+  slot->gray.reference(blitz::Array<uint8_t,2>());
+  m_ring.release();
+  return true;
+}
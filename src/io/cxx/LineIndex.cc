@@ -0,0 +1,158 @@
+/**
+ * @file io/cxx/LineIndex.cc
+ * @date Sun Oct 18 17:35:21 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the parallel line indexing of text files and the fast
+ * number parser.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+
+#include <bob/io/LineIndex.h>
+
+/**
+ * Files smaller than this are scanned and parsed by a single thread: for
+ * them, starting threads costs more than it saves.
+ */
+static const size_t PARALLEL_THRESHOLD = 1 << 20;
+
+bob::io::LineIndex::LineIndex(const std::string& filename, size_t n_threads):
+  m_file(boost::make_shared<bob::io::MappedFile>(filename)),
+  m_n_threads(n_threads)
+{
+  if (!m_n_threads) m_n_threads = boost::thread::hardware_concurrency();
+  if (!m_n_threads || m_file->size() < PARALLEL_THRESHOLD) m_n_threads = 1;
+
+  m_file->advise(bob::io::File::sequential);
+
+  const size_t size = m_file->size();
+  m_start.push_back(0);
+
+  if (m_n_threads == 1) scan(0, size, m_start);
+
+  else {
+    std::vector<std::vector<size_t> > starts(m_n_threads);
+    boost::thread_group threads;
+    for (size_t t=1; t<m_n_threads; ++t) {
+      threads.create_thread(boost::bind(&bob::io::LineIndex::scan, this,
+            t*size/m_n_threads, (t+1)*size/m_n_threads,
+            boost::ref(starts[t])));
+    }
+    scan(0, size/m_n_threads, starts[0]);
+    threads.join_all();
+
+    size_t total = 1;
+    for (size_t t=0; t<m_n_threads; ++t) total += starts[t].size();
+    m_start.reserve(total + 1);
+    for (size_t t=0; t<m_n_threads; ++t)
+      m_start.insert(m_start.end(), starts[t].begin(), starts[t].end());
+  }
+
+  // a terminator at the end of the file already marks the end of the last
+  // line, otherwise mark it as if there was one past the end of the file
+  if (m_start.back() != size) m_start.push_back(size + 1);
+}
+
+bob::io::LineIndex::~LineIndex() { }
+
+void bob::io::LineIndex::scan(size_t begin, size_t end,
+    std::vector<size_t>& start) const {
+  const char* data = static_cast<const char*>(m_file->data());
+  const char* p = data + begin;
+  const char* e = data + end;
+  while (p < e) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', e - p));
+    if (!nl) break;
+    start.push_back(nl - data + 1);
+    p = nl + 1;
+  }
+}
+
+/**
+ * Exact powers of ten as doubles: all of them, up to 10^22, are exactly
+ * representable
+ */
+static const double POW10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+  1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool parse_double_slow(const char* begin, const char* end,
+    double& value) {
+  if (begin == end || std::isspace((unsigned char)*begin)) return false;
+  std::string token(begin, end);
+  char* stop = 0;
+  value = std::strtod(token.c_str(), &stop);
+  return stop == token.c_str() + token.size();
+}
+
+bool bob::io::parse_double(const char* begin, const char* end,
+    double& value) {
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) negative = (*(p++) == '-');
+
+  // mantissa: at most 15 significant digits fit exactly in a double
+  unsigned long long mantissa = 0;
+  int digits = 0; //significant digits
+  int exponent = 0;
+  bool any = false; //any digit at all?
+  bool point = false;
+  for (; p != end; ++p) {
+    if (*p >= '0' && *p <= '9') {
+      any = true;
+      if (mantissa == 0 && *p == '0') { if (point) --exponent; continue; }
+      if (++digits > 15) return parse_double_slow(begin, end, value);
+      mantissa = 10*mantissa + (*p - '0');
+      if (point) --exponent;
+    }
+    else if (*p == '.' && !point) point = true;
+    else break;
+  }
+  if (!any) return parse_double_slow(begin, end, value); //inf, nan, hex...
+
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool eneg = false;
+    if (p != end && (*p == '-' || *p == '+')) eneg = (*(p++) == '-');
+    if (p == end || *p < '0' || *p > '9') return parse_double_slow(begin, end, value);
+    int e = 0;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+      if (e > 10000) return parse_double_slow(begin, end, value);
+      e = 10*e + (*p - '0');
+    }
+    exponent += eneg ? -e : e;
+  }
+  if (p != end) return parse_double_slow(begin, end, value); //hex, errors
+
+  if (mantissa == 0) value = 0.;
+  else if (exponent >= 0 && exponent <= 22)
+    value = static_cast<double>(mantissa) * POW10[exponent];
+  else if (exponent < 0 && exponent >= -22)
+    value = static_cast<double>(mantissa) / POW10[-exponent];
+  else return parse_double_slow(begin, end, value);
+
+  if (negative) value = -value;
+  return true;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file io/cxx/MappedFile.cc
+ * @date Sun Oct 18 16:48:09 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements read-only memory mapping of raw array files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <boost/format.hpp>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <bob/io/Exception.h>
+#include <bob/io/MappedFile.h>
+
+bob::io::MappedFile::MappedFile(const std::string& filename):
+  m_filename(filename),
+  m_size(0),
+  m_data(0)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) throw bob::io::FileNotReadable(filename, std::strerror(errno));
+
+  struct stat filestatus;
+  if (fstat(fd, &filestatus) < 0) {
+    int error = errno;
+    ::close(fd);
+    throw bob::io::FileNotReadable(filename, std::strerror(error));
+  }
+  m_size = filestatus.st_size;
+
+  if (m_size) { //empty files cannot be mapped
+    // copy-on-write: writes through MappedArray::ptr() stay in this process
+    m_data = mmap(0, m_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (m_data == MAP_FAILED) {
+      int error = errno;
+      ::close(fd);
+      m_data = 0;
+      boost::format m("cannot map it in memory: %s");
+      m % std::strerror(error);
+      throw bob::io::FileNotReadable(filename, m.str());
+    }
+  }
+
+  // the mapping stays valid after the descriptor is closed
+  ::close(fd);
+}
+
+bob::io::MappedFile::~MappedFile() {
+  if (m_data) munmap(m_data, m_size);
+}
+
+const void* bob::io::MappedFile::data(size_t offset, size_t length) const {
+  if (offset > m_size || length > m_size - offset) {
+    boost::format m("cannot access %u bytes at offset %u of file '%s', which has only %u bytes - is the file truncated?");
+    m % length % offset % m_filename % m_size;
+    throw std::runtime_error(m.str());
+  }
+  return static_cast<const char*>(m_data) + offset;
+}
+
+void bob::io::MappedFile::advise(bob::io::File::access_t pattern) const {
+  if (!m_data) return;
+  int advice = MADV_NORMAL;
+  switch (pattern) {
+    case bob::io::File::sequential:
+      advice = MADV_SEQUENTIAL;
+      break;
+    case bob::io::File::random:
+      advice = MADV_RANDOM;
+      break;
+    default:
+      break;
+  }
+  // this is just a hint: failures are not fatal
+  madvise(m_data, m_size, advice);
+}
+
+bob::io::MappedArray::MappedArray(boost::shared_ptr<MappedFile> file,
+    size_t offset, const bob::core::array::typeinfo& info):
+  m_file(file),
+  m_type(info),
+  m_ptr(const_cast<void*>(file->data(offset, info.buffer_size())))
+{
+}
+
+bob::io::MappedArray::~MappedArray() { }
+
+void bob::io::MappedArray::set(const bob::core::array::interface&) {
+  throw std::runtime_error("cannot modify an array mapped read-only from a file - copy it first");
+}
+
+void bob::io::MappedArray::set(boost::shared_ptr<bob::core::array::interface>) {
+  throw std::runtime_error("cannot modify an array mapped read-only from a file - copy it first");
+}
+
+void bob::io::MappedArray::set(const bob::core::array::typeinfo&) {
+  throw std::runtime_error("cannot modify an array mapped read-only from a file - copy it first");
+}
@@ -0,0 +1,303 @@
+/**
+ * @file io/cxx/PrefetchingVideoReader.cc
+ * @date Sun Oct 18 18:32:10 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the background decoding of videos
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+
+#include <bob/core/blitz_array.h>
+#include <bob/io/PrefetchingVideoReader.h>
+
+bob::io::PrefetchingVideoReader::PrefetchingVideoReader
+(const std::string& filename, layout_t layout, size_t queue_size,
+ size_t n_threads, scaler_t scaler, bool check):
+  m_video(filename, check),
+  m_layout(layout),
+  m_scaler(scaler),
+  m_n_threads(n_threads),
+  m_ring(queue_size)
+{
+  if (!m_n_threads) m_n_threads = boost::thread::hardware_concurrency();
+  if (!m_n_threads) m_n_threads = 1;
+
+  m_typeinfo_frame.dtype = bob::core::array::t_uint8;
+  switch (m_layout) {
+    case planar:
+      m_typeinfo_frame.nd = 3;
+      m_typeinfo_frame.shape[0] = 3;
+      m_typeinfo_frame.shape[1] = m_video.height();
+      m_typeinfo_frame.shape[2] = m_video.width();
+      break;
+    case interleaved:
+      m_typeinfo_frame.nd = 3;
+      m_typeinfo_frame.shape[0] = m_video.height();
+      m_typeinfo_frame.shape[1] = m_video.width();
+      m_typeinfo_frame.shape[2] = 3;
+      break;
+    case gray:
+      m_typeinfo_frame.nd = 2;
+      m_typeinfo_frame.shape[0] = m_video.height();
+      m_typeinfo_frame.shape[1] = m_video.width();
+      break;
+    default:
+      {
+        boost::format m("PrefetchingVideoReader: unknown frame layout %d");
+        m % (int)layout;
+        throw std::runtime_error(m.str());
+      }
+  }
+  m_typeinfo_frame.update_strides();
+}
+
+bob::io::PrefetchingVideoReader::~PrefetchingVideoReader() {
+  stop();
+}
+
+void bob::io::PrefetchingVideoReader::start() {
+  m_ring.start(1, boost::bind(&bob::io::PrefetchingVideoReader::decoder,
+        this));
+}
+
+void bob::io::PrefetchingVideoReader::stop() {
+  m_ring.stop();
+  for (size_t k=0; k<m_ring.size(); ++k) {
+    m_ring[k].color.reference(blitz::Array<uint8_t,3>());
+    m_ring[k].gray.reference(blitz::Array<uint8_t,2>());
+  }
+}
+
+/**
+ * Tells if the first plane of pictures in this pixel format holds the
+ * luminance of all pixels, with one byte per pixel
+ */
+static bool has_luma_plane(PixelFormat format) {
+  switch (format) {
+    case PIX_FMT_YUV420P:
+    case PIX_FMT_YUV422P:
+    case PIX_FMT_YUV444P:
+    case PIX_FMT_YUV410P:
+    case PIX_FMT_YUV411P:
+    case PIX_FMT_YUV440P:
+    case PIX_FMT_YUVJ420P:
+    case PIX_FMT_YUVJ422P:
+    case PIX_FMT_YUVJ444P:
+    case PIX_FMT_YUVJ440P:
+    case PIX_FMT_NV12:
+    case PIX_FMT_NV21:
+    case PIX_FMT_GRAY8:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int scaler_flags(bob::io::PrefetchingVideoReader::scaler_t scaler) {
+  switch (scaler) {
+    case bob::io::PrefetchingVideoReader::bilinear: return SWS_BILINEAR;
+    case bob::io::PrefetchingVideoReader::fast_bilinear: return SWS_FAST_BILINEAR;
+    case bob::io::PrefetchingVideoReader::area: return SWS_AREA;
+    case bob::io::PrefetchingVideoReader::point: return SWS_POINT;
+    default: return SWS_BICUBIC;
+  }
+}
+
+static void scale(const std::string& filename, size_t frame,
+    boost::shared_ptr<AVCodecContext> codec_context,
+    boost::shared_ptr<SwsContext> scaler,
+    boost::shared_ptr<AVFrame> context_frame, uint8_t* data, int linesize) {
+
+  uint8_t* planes[] = {data, 0};
+  int linesizes[] = {linesize, 0};
+
+  int conv_height = sws_scale(scaler.get(), context_frame->data,
+      context_frame->linesize, 0, codec_context->height, planes, linesizes);
+
+  if (conv_height < 0) {
+    boost::format m("bob::io::detail::ffmpeg::sws_scale() failed: could not scale frame %d of file `%s' - ffmpeg reports error %d");
+    m % frame % filename % conv_height;
+    throw std::runtime_error(m.str());
+  }
+}
+
+void bob::io::PrefetchingVideoReader::decoder() {
+
+  size_t seq = 0; //the frame being decoded
+
+  try {
+    // the ffmpeg infrastructure is local to this thread
+    const std::string& filename = m_video.filename();
+    boost::shared_ptr<AVFormatContext> format_context =
+      bob::io::detail::ffmpeg::make_input_format_context(filename);
+    int stream_index = bob::io::detail::ffmpeg::find_video_stream(filename,
+        format_context);
+    AVCodec* codec = bob::io::detail::ffmpeg::find_decoder(filename,
+        format_context, stream_index);
+    boost::shared_ptr<AVCodecContext> codec_context =
+      bob::io::detail::ffmpeg::make_codec_context(filename,
+          format_context->streams[stream_index], codec, m_n_threads);
+    boost::shared_ptr<AVFrame> context_frame =
+      bob::io::detail::ffmpeg::make_empty_frame(filename);
+
+    // the luminance is copied as decoded, when possible
+    bool copy_luma = (m_layout == gray) &&
+      has_luma_plane(codec_context->pix_fmt);
+    boost::shared_ptr<SwsContext> scaler;
+    if (!copy_luma) {
+      scaler = bob::io::detail::ffmpeg::make_scaler(filename, codec_context,
+          codec_context->pix_fmt,
+          (m_layout == gray) ? PIX_FMT_GRAY8 : PIX_FMT_RGB24,
+          scaler_flags(m_scaler));
+    }
+
+    const int height = m_video.height();
+    const int width = m_video.width();
+    blitz::Array<uint8_t,3> rgb; //for re-ordering planar frames
+    if (m_layout == planar) rgb.resize(height, width, 3);
+
+    for (; seq<m_video.numberOfFrames(); ++seq) {
+      // waits until the frame 'seq - Q' was picked up
+      Slot* acquired = m_ring.acquire(seq);
+      if (!acquired) return;
+      Slot& slot = *acquired;
+
+      // decodes into the context frame, without conversion
+      if (!bob::io::detail::ffmpeg::skip_video_frame(filename, seq,
+            stream_index, format_context, codec_context, context_frame,
+            true)) break;
+
+      // nobody else touches this slot until it is published
+      switch (m_layout) {
+        case gray:
+          if (slot.gray.size() == 0) slot.gray.resize(height, width);
+          if (copy_luma) {
+            for (int y=0; y<height; ++y) {
+              std::memcpy(slot.gray.data() + y*width,
+                  context_frame->data[0] + y*context_frame->linesize[0],
+                  width);
+            }
+          }
+          else scale(filename, seq, codec_context, scaler, context_frame,
+              slot.gray.data(), width);
+          break;
+        case interleaved:
+          if (slot.color.size() == 0) slot.color.resize(height, width, 3);
+          scale(filename, seq, codec_context, scaler, context_frame,
+              slot.color.data(), 3*width);
+          break;
+        default: //planar
+          if (slot.color.size() == 0) slot.color.resize(3, height, width);
+          scale(filename, seq, codec_context, scaler, context_frame,
+              rgb.data(), 3*width);
+          slot.color = rgb.transpose(2,0,1);
+          break;
+      }
+
+      m_ring.publish(seq);
+    }
+  }
+  catch (std::exception& e) {
+    m_ring.fail(seq, e.what());
+    return;
+  }
+  catch (...) {
+    m_ring.fail(seq, "PrefetchingVideoReader: unknown exception raised by decoder");
+    return;
+  }
+
+  // the video ends here, possibly truncated
+  m_ring.finish(seq);
+}
+
+bob::io::PrefetchingVideoReader::Slot* bob::io::PrefetchingVideoReader::wait
+(bool throw_on_error) {
+
+  start();
+
+  // frames decoded before a problem are still delivered
+  try {
+    return m_ring.wait(); //0 at the end of the video, possibly truncated
+  }
+  catch (std::runtime_error&) {
+    if (!throw_on_error) return 0; //the video is truncated at the problem
+    stop();
+    throw;
+  }
+}
+
+bool bob::io::PrefetchingVideoReader::next(blitz::Array<uint8_t,3>& data,
+    bool throw_on_error) {
+  if (m_layout == gray) throw std::runtime_error("PrefetchingVideoReader: frames in the gray layout are 2D arrays");
+
+  Slot* slot = wait(throw_on_error);
+  if (!slot) return false;
+
+  // hands over the frame: the decoder allocates a new one for this slot
+  data.reference(slot->color);
+  slot->color.reference(blitz::Array<uint8_t,3>());
+  m_ring.release();
+  return true;
+}
+
+bool bob::io::PrefetchingVideoReader::next(blitz::Array<uint8_t,2>& data,
+    bool throw_on_error) {
+  if (m_layout != gray) throw std::runtime_error("PrefetchingVideoReader: frames in the planar and interleaved layouts are 3D arrays");
+
+  Slot* slot = wait(throw_on_error);
+  if (!slot) return false;
+
+  data.reference(slot->gray);
+  slot->gray.reference(blitz::Array<uint8_t,2>());
+  m_ring.release();
+  return true;
+}
+
+bool bob::io::PrefetchingVideoReader::read(bob::core::array::interface& data,
+    bool throw_on_error) {
+
+  if (!data.type().is_compatible(m_typeinfo_frame)) data.set(m_typeinfo_frame);
+
+  Slot* slot = wait(throw_on_error);
+  if (!slot) return false;
+
+  // copies honoring the strides of the output buffer
+  const bob::core::array::typeinfo& info = data.type();
+  if (m_layout == gray) {
+    blitz::TinyVector<int,2> shape(info.shape[0], info.shape[1]);
+    blitz::TinyVector<int,2> stride(info.stride[0], info.stride[1]);
+    blitz::Array<uint8_t,2> dst(static_cast<uint8_t*>(data.ptr()), shape,
+        stride, blitz::neverDeleteData);
+    dst = slot->gray;
+  }
+  else {
+    blitz::TinyVector<int,3> shape(info.shape[0], info.shape[1],
+        info.shape[2]);
+    blitz::TinyVector<int,3> stride(info.stride[0], info.stride[1],
+        info.stride[2]);
+    blitz::Array<uint8_t,3> dst(static_cast<uint8_t*>(data.ptr()), shape,
+        stride, blitz::neverDeleteData);
+    dst = slot->color;
+  }
+
+  m_ring.release();
+  return true;
+}
@@ -32,6 +32,7 @@
  */
 
 #include <fstream>
+#include <cstring>
 #include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/format.hpp>
@@ -45,6 +46,7 @@
 #include <bob/core/blitz_array.h>
 #include <bob/io/CodecRegistry.h>
 #include <bob/io/Exception.h>
+#include <bob/io/MappedFile.h>
 
 static inline size_t get_filesize(const std::string& filename) {
   struct stat filestatus;
@@ -96,6 +98,9 @@ class T3File: public bob::io::File {
           m_type_arrayset.set_shape<size_t>(1, &shape[1]);
           m_newfile = false;
 
+          // read-only files are read from a memory mapping
+          if (mode == 'r') m_mapping = boost::make_shared<bob::io::MappedFile>(path);
+
         }
       }
 
@@ -131,6 +136,12 @@ class T3File: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_type_array)) buffer.set(m_type_array);
 
+      if (m_mapping) {
+        std::memcpy(buffer.ptr(), m_mapping->data(8, m_type_array.buffer_size()),
+            m_type_array.buffer_size());
+        return;
+      }
+
       //open the file, now for reading the contents...
       std::ifstream ifile(m_filename.c_str(), std::ios::binary|std::ios::in);
 
@@ -152,6 +163,13 @@ class T3File: public bob::io::File {
 
       if (!buffer.type().is_compatible(m_type_arrayset)) buffer.set(m_type_arrayset);
 
+      if (m_mapping) {
+        if (index >= m_length) throw bob::io::IndexError(index);
+        const size_t size = m_type_arrayset.buffer_size();
+        std::memcpy(buffer.ptr(), m_mapping->data(8 + index*size, size), size);
+        return;
+      }
+
       //open the file, now for reading the contents...
       std::ifstream ifile(m_filename.c_str(), std::ios::binary|std::ios::in);
 
@@ -161,6 +179,31 @@ class T3File: public bob::io::File {
 
     }
 
+    virtual boost::shared_ptr<bob::core::array::interface> view(size_t index) {
+
+      if (!m_mapping) return bob::io::File::view(index);
+
+      if (index >= m_length) throw bob::io::IndexError(index);
+      return boost::make_shared<bob::io::MappedArray>(m_mapping,
+          8 + index*m_type_arrayset.buffer_size(), m_type_arrayset);
+
+    }
+
+    virtual boost::shared_ptr<bob::core::array::interface> view_all() {
+
+      if (!m_mapping) return bob::io::File::view_all();
+
+      return boost::make_shared<bob::io::MappedArray>(m_mapping, 8,
+          m_type_array);
+
+    }
+
+    virtual void advise(bob::io::File::access_t pattern) {
+
+      if (m_mapping) m_mapping->advise(pattern);
+
+    }
+
     virtual size_t append (const bob::core::array::interface& buffer) {
 
       const bob::core::array::typeinfo& info = buffer.type();
@@ -269,6 +312,7 @@ class T3File: public bob::io::File {
     bob::core::array::typeinfo m_type_array;
     bob::core::array::typeinfo m_type_arrayset;
     size_t m_length;
+    boost::shared_ptr<bob::io::MappedFile> m_mapping; ///< set if read-only
 
     static std::string s_codecname;
 
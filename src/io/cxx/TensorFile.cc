@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <boost/make_shared.hpp>
 #include <bob/core/logging.h>
 #include <bob/core/array_type.h>
 
@@ -75,6 +76,9 @@ bob::io::TensorFile::TensorFile(const std::string& filename,
         bob::core::error << "Cannot append data in read only mode." << std::endl;
         throw bob::core::Exception();
       }
+
+      // arrays are read from a memory mapping from now on
+      m_mapping = boost::make_shared<bob::io::MappedFile>(filename);
     }
   }
   else
@@ -143,10 +147,17 @@ void bob::io::TensorFile::read (bob::core::array::interface& buf) {
   if(!m_header_init) throw Uninitialized();
   if(!buf.type().is_compatible(m_header.m_type)) buf.set(m_header.m_type);
 
-  m_stream.read(reinterpret_cast<char*>(m_buffer.get()), 
-      m_header.m_type.buffer_size());
+  if (m_mapping) { //re-orders directly from the mapped file
+    endOfFile();
+    bob::io::col_to_row_order(m_mapping->data(m_header.getArrayIndex(m_current_array),
+          m_header.m_type.buffer_size()), buf.ptr(), m_header.m_type);
+  }
+  else {
+    m_stream.read(reinterpret_cast<char*>(m_buffer.get()), 
+        m_header.m_type.buffer_size());
   
-  bob::io::col_to_row_order(m_buffer.get(), buf.ptr(), m_header.m_type);
+    bob::io::col_to_row_order(m_buffer.get(), buf.ptr(), m_header.m_type);
+  }
 
   ++m_current_array;
 }
@@ -165,3 +176,28 @@ void bob::io::TensorFile::read (size_t index, bob::core::array::interface& buf)
   // Put the content of the stream in the blitz array.
   read(buf);
 }
+
+boost::shared_ptr<bob::core::array::interface> bob::io::TensorFile::view
+(size_t index) {
+
+  if(!m_header_init) throw Uninitialized();
+  if(index >= m_header.m_n_samples) throw IndexError(index);
+
+  const bob::core::array::typeinfo& info = m_header.m_type;
+  size_t offset = m_header.getArrayIndex(index);
+
+  if (m_mapping && (offset % info.item_size()) == 0) {
+    // column-major order: the first index varies the fastest
+    size_t stride[BOB_MAX_DIM+1];
+    stride[0] = 1;
+    for (size_t k=1; k<info.nd; ++k) stride[k] = stride[k-1] * info.shape[k-1];
+    bob::core::array::typeinfo mapped;
+    mapped.set(info.dtype, info.nd, info.shape, stride);
+    return boost::make_shared<bob::io::MappedArray>(m_mapping, offset, mapped);
+  }
+
+  boost::shared_ptr<bob::core::array::blitz_array> retval =
+    boost::make_shared<bob::core::array::blitz_array>(info);
+  read(index, *retval);
+  return retval;
+}
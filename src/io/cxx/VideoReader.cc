@@ -24,7 +24,10 @@
 #include <bob/io/VideoReader.h>
 
 #include <stdexcept>
+#include <fstream>
+#include <algorithm>
 #include <boost/format.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/preprocessor.hpp>
 #include <limits>
 
@@ -36,21 +39,38 @@
 #define AV_PIX_FMT_RGB24 PIX_FMT_RGB24
 #endif
 
-bob::io::VideoReader::VideoReader(const std::string& filename, bool check) {
+bob::io::VideoReader::VideoReader(const std::string& filename, bool check,
+    bool cache_index):
+  m_cache_index(cache_index),
+  m_indexed(false)
+{
   open(filename, check);
 }
 
-bob::io::VideoReader::VideoReader(const bob::io::VideoReader& other) {
+bob::io::VideoReader::VideoReader(const bob::io::VideoReader& other):
+  m_cache_index(other.m_cache_index),
+  m_indexed(false)
+{
   *this = other;
 }
 
 bob::io::VideoReader& bob::io::VideoReader::operator= (const bob::io::VideoReader& other) {
+  if (this == &other) return *this;
+  m_cache_index = other.m_cache_index;
   open(other.filename(), other.m_check);
+  // the index describes the same file: no need to scan it again
+  m_indexed = other.m_indexed;
+  m_keyframes = other.m_keyframes;
+  m_keyframe_ts = other.m_keyframe_ts;
   return *this;
 }
 
 void bob::io::VideoReader::open(const std::string& filename, bool check) {
   m_filepath = filename;
+  m_check = check;
+  m_indexed = false;
+  m_keyframes.clear();
+  m_keyframe_ts.clear();
 
   boost::shared_ptr<AVFormatContext> format_ctxt =
     bob::io::detail::ffmpeg::make_input_format_context(m_filepath);
@@ -141,6 +161,79 @@ void bob::io::VideoReader::open(const std::string& filename, bool check) {
 bob::io::VideoReader::~VideoReader() {
 }
 
+/**
+ * Reads the keyframe index from a cache file. The first line identifies the
+ * file format and the video file state (size and modification time), so
+ * that caches of modified videos are ignored. Returns false if the cache
+ * cannot be used.
+ */
+static bool load_index(const std::string& cache, const std::string& stamp,
+    std::vector<size_t>& frames, std::vector<int64_t>& timestamps) {
+  std::ifstream file(cache.c_str());
+  std::string header;
+  if (!std::getline(file, header) || header != stamp) return false;
+  size_t frame;
+  int64_t timestamp;
+  while (file >> frame >> timestamp) {
+    frames.push_back(frame);
+    timestamps.push_back(timestamp);
+  }
+  if (!file.eof() || frames.empty()) {
+    frames.clear();
+    timestamps.clear();
+    return false;
+  }
+  return true;
+}
+
+static void save_index(const std::string& cache, const std::string& stamp,
+    const std::vector<size_t>& frames, const std::vector<int64_t>& timestamps) {
+  std::ofstream file(cache.c_str());
+  file << stamp << std::endl;
+  for (size_t k=0; k<frames.size(); ++k)
+    file << frames[k] << " " << timestamps[k] << std::endl;
+  if (!file) {
+    bob::core::warn << "cannot save keyframe index to `" << cache << "': the index will be rebuilt the next time the video is opened" << std::endl;
+  }
+}
+
+void bob::io::VideoReader::index() const {
+  if (m_indexed) return;
+
+  std::string cache = m_filepath + ".keyframes";
+  std::string stamp;
+  if (m_cache_index) {
+    boost::format f("bob-keyframes-1 %u %u");
+    f % boost::filesystem::file_size(m_filepath);
+    f % boost::filesystem::last_write_time(m_filepath);
+    stamp = f.str();
+    if (load_index(cache, stamp, m_keyframes, m_keyframe_ts)) {
+      m_indexed = true;
+      return;
+    }
+  }
+
+  boost::shared_ptr<AVFormatContext> format_ctxt =
+    bob::io::detail::ffmpeg::make_input_format_context(m_filepath);
+  int stream_index = bob::io::detail::ffmpeg::find_video_stream(m_filepath,
+      format_ctxt);
+  bob::io::detail::ffmpeg::index_keyframes(m_filepath, format_ctxt,
+      stream_index, m_keyframes, m_keyframe_ts);
+  m_indexed = true;
+
+  if (m_cache_index) save_index(cache, stamp, m_keyframes, m_keyframe_ts);
+}
+
+const std::vector<size_t>& bob::io::VideoReader::keyframes() const {
+  index();
+  return m_keyframes;
+}
+
+const std::vector<int64_t>& bob::io::VideoReader::keyframeTimestamps() const {
+  index();
+  return m_keyframe_ts;
+}
+
 size_t bob::io::VideoReader::load(blitz::Array<uint8_t,4>& data, 
   bool throw_on_error, void (*check)(void)) const {
   bob::core::array::blitz_array tmp(data);
@@ -345,7 +438,58 @@ bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::oper
 }
 
 bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::operator+= (size_t frames) {
-  for (size_t i=0; i<frames; ++i) ++(*this);
+  if (frames == 0) return *this;
+  if (frames == 1) return ++(*this);
+  if (!m_parent) {
+    //we are already past the end of the stream
+    throw std::runtime_error("video iterator for file has already reached its end and was reset");
+  }
+  return seek(m_current_frame + frames);
+}
+
+bob::io::VideoReader::const_iterator& bob::io::VideoReader::const_iterator::seek (size_t frame) {
+  if (!m_parent) {
+    //we are already past the end of the stream
+    throw std::runtime_error("video iterator for file has already reached its end and was reset");
+  }
+
+  if (frame >= m_parent->numberOfFrames()) {
+    reset();
+    return *this;
+  }
+
+  //finds the last keyframe before the target frame
+  const std::vector<size_t>& keyframes = m_parent->keyframes();
+  std::vector<size_t>::const_iterator k =
+    std::upper_bound(keyframes.begin(), keyframes.end(), frame);
+
+  if (k == keyframes.begin()) { //no keyframe before: decode from the start
+    if (frame < m_current_frame) {
+      const VideoReader* parent = m_parent;
+      reset();
+      m_parent = parent;
+      init();
+    }
+  }
+  else {
+    --k;
+    //only seeks if this skips frames or to go backwards
+    if (*k > m_current_frame || frame < m_current_frame) {
+      const std::vector<int64_t>& timestamps = m_parent->keyframeTimestamps();
+      bool ok = bob::io::detail::ffmpeg::seek_keyframe(m_parent->m_filepath,
+          timestamps[k - keyframes.begin()], m_stream_index,
+          m_format_context, m_codec_context, false);
+      if (ok) m_current_frame = *k;
+      else { //restart decoding from the beginning
+        const VideoReader* parent = m_parent;
+        reset();
+        m_parent = parent;
+        init();
+      }
+    }
+  }
+
+  while (m_parent && m_current_frame < frame) ++(*this);
   return *this;
 }
 
@@ -827,7 +827,7 @@ static void deallocate_swscaler(SwsContext* s) {
 
 boost::shared_ptr<SwsContext> bob::io::detail::ffmpeg::make_scaler
 (const std::string& filename, boost::shared_ptr<AVCodecContext> ctxt,
- PixelFormat source_pixel_format, PixelFormat dest_pixel_format) {
+ PixelFormat source_pixel_format, PixelFormat dest_pixel_format, int flags) {
 
   /**
    * Initializes the software scaler (SWScale) so we can convert images to
@@ -839,10 +839,10 @@ boost::shared_ptr<SwsContext> bob::io::detail::ffmpeg::make_scaler
   SwsContext* retval = sws_getContext(
       ctxt->width, ctxt->height, source_pixel_format, 
       ctxt->width, ctxt->height, dest_pixel_format, 
-      SWS_BICUBIC, 0, 0, 0);
+      flags, 0, 0, 0);
 
   if (!retval) {
-    boost::format m("bob::io::detail::ffmpeg::sws_getContext(src_width=%d, src_height=%d, src_pix_format=`%s', dest_width=%d, dest_height=%d, dest_pix_format=`%s', flags=SWS_BICUBIC, 0, 0, 0) failed: cannot get software scaler context to start encoding or decoding video file `%s'");
+    boost::format m("bob::io::detail::ffmpeg::sws_getContext(src_width=%d, src_height=%d, src_pix_format=`%s', dest_width=%d, dest_height=%d, dest_pix_format=`%s', flags=0x%x, 0, 0, 0) failed: cannot get software scaler context to start encoding or decoding video file `%s'");
     m % ctxt->width % ctxt->height % 
 #if LIBAVUTIL_VERSION_INT >= 0x320f01 //50.15.1 @ ffmpeg-0.6
 	av_get_pix_fmt_name(source_pixel_format)
@@ -855,7 +855,7 @@ boost::shared_ptr<SwsContext> bob::io::detail::ffmpeg::make_scaler
 #else
 	avcodec_get_pix_fmt_name(dest_pixel_format)
 #endif
-      % filename;
+      % flags % filename;
     throw std::runtime_error(m.str());
   }
   return boost::shared_ptr<SwsContext>(retval, std::ptr_fun(deallocate_swscaler));
@@ -893,6 +893,27 @@ boost::shared_array<uint8_t> bob::io::detail::ffmpeg::make_buffer
   return boost::shared_array<uint8_t>(retval, std::ptr_fun(deallocate_buffer));
 }
 
+/**
+ * Converts the given image planes, in the source format of the scaler, to
+ * whatever is required by the FFmpeg encoder output context.
+ */
+static void planes_to_context(const uint8_t* const planes[],
+    const int linesize[], int height,
+    boost::shared_ptr<SwsContext> scaler,
+    boost::shared_ptr<AVFrame> output_frame) {
+
+#if LIBSWSCALE_VERSION_INT >= 0x000b00 /* 0.11.0 @ ffmpeg-0.6 */
+  int ok = sws_scale(scaler.get(), planes, linesize, 0, height, output_frame->data, output_frame->linesize);
+#else
+  int ok = sws_scale(scaler.get(), const_cast<uint8_t**>(planes), const_cast<int*>(linesize), 0, height, output_frame->data, output_frame->linesize);
+#endif
+  if (ok < 0) {
+    boost::format m("bob::io::detail::ffmpeg::sws_scale() failed: could not scale frame while encoding - ffmpeg reports error %d");
+    m % ok;
+    throw std::runtime_error(m.str());
+  }
+}
+
 /**
  * Transforms from Bob's planar 8-bit RGB representation to whatever is
  * required by the FFmpeg encoder output context (peeked from the AVStream
@@ -911,16 +932,7 @@ static void image_to_context(const blitz::Array<uint8_t,3>& data,
   const uint8_t* planes[] = {datap+plane_size, datap+2*plane_size, datap, 0};
   int linesize[] = {width, width, width, 0};
 
-#if LIBSWSCALE_VERSION_INT >= 0x000b00 /* 0.11.0 @ ffmpeg-0.6 */
-  int ok = sws_scale(scaler.get(), planes, linesize, 0, height, output_frame->data, output_frame->linesize);
-#else
-  int ok = sws_scale(scaler.get(), const_cast<uint8_t**>(planes), linesize, 0, height, output_frame->data, output_frame->linesize);
-#endif
-  if (ok < 0) {
-    boost::format m("bob::io::detail::ffmpeg::sws_scale() failed: could not scale frame while encoding - ffmpeg reports error %d");
-    m % ok;
-    throw std::runtime_error(m.str());
-  }
+  planes_to_context(planes, linesize, height, scaler, output_frame);
 }
 
 /**
@@ -960,7 +972,8 @@ static void deallocate_codec_context(AVCodecContext* c) {
 }
 
 boost::shared_ptr<AVCodecContext> bob::io::detail::ffmpeg::make_codec_context(
-    const std::string& filename, AVStream* stream, AVCodec* codec) {
+    const std::string& filename, AVStream* stream, AVCodec* codec,
+    size_t n_threads) {
 
   AVCodecContext* retval = stream->codec;
 
@@ -969,6 +982,16 @@ boost::shared_ptr<AVCodecContext> bob::io::detail::ffmpeg::make_codec_context(
     retval->time_base.den = 1000;
   }
 
+  // Threading has to be set up before the codec is opened
+  if (n_threads > 1) {
+# ifdef FF_THREAD_FRAME //ffmpeg >= 0.7
+    retval->thread_count = n_threads;
+    retval->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+# else
+    avcodec_thread_init(retval, n_threads);
+# endif
+  }
+
 # if LIBAVCODEC_VERSION_INT < 0x347a00 //52.122.0 @ ffmpeg-0.7
 
   int ok = avcodec_open(retval, codec);
@@ -1087,8 +1110,13 @@ void bob::io::detail::ffmpeg::flush_encoder (const std::string& filename,
     boost::shared_array<uint8_t> buffer,
     size_t buffer_size) {
 
-  //We only need to flush codecs that have delayed data processing
-  if (!(codec->capabilities & CODEC_CAP_DELAY)) return;
+  //We only need to flush codecs that have delayed data processing. Encoders
+  //working on several frames at once also hold frames back.
+  bool delayed = codec->capabilities & CODEC_CAP_DELAY;
+# ifdef FF_THREAD_FRAME
+  if (stream->codec->active_thread_type & FF_THREAD_FRAME) delayed = true;
+# endif
+  if (!delayed) return;
 
   while (true) {
 
@@ -1178,21 +1206,17 @@ void bob::io::detail::ffmpeg::flush_encoder (const std::string& filename,
 
 }
 
-void bob::io::detail::ffmpeg::write_video_frame (const blitz::Array<uint8_t,3>& data,
-    const std::string& filename,
+/**
+ * Encodes the picture in the context frame and writes the resulting packet,
+ * if any, to the output file
+ */
+static void encode_context_frame (const std::string& filename,
     boost::shared_ptr<AVFormatContext> format_context,
     boost::shared_ptr<AVStream> stream,
     boost::shared_ptr<AVFrame> context_frame,
-    boost::shared_ptr<AVFrame> tmp_frame,
-    boost::shared_ptr<SwsContext> swscaler,
     boost::shared_array<uint8_t> buffer,
     size_t buffer_size) {
 
-  if (tmp_frame) 
-    image_to_context(data, stream, swscaler, context_frame, tmp_frame);
-  else 
-    image_to_context(data, stream, swscaler, context_frame);
-
   if (format_context->oformat->flags & AVFMT_RAWPICTURE) {
     
     /* Raw video case - directly store the picture in the packet */
@@ -1303,6 +1327,42 @@ void bob::io::detail::ffmpeg::write_video_frame (const blitz::Array<uint8_t,3>&
 #endif // FFmpeg version >= 0.11.0
 }
 
+void bob::io::detail::ffmpeg::write_video_frame (const blitz::Array<uint8_t,3>& data,
+    const std::string& filename,
+    boost::shared_ptr<AVFormatContext> format_context,
+    boost::shared_ptr<AVStream> stream,
+    boost::shared_ptr<AVFrame> context_frame,
+    boost::shared_ptr<AVFrame> tmp_frame,
+    boost::shared_ptr<SwsContext> swscaler,
+    boost::shared_array<uint8_t> buffer,
+    size_t buffer_size) {
+
+  if (tmp_frame) 
+    image_to_context(data, stream, swscaler, context_frame, tmp_frame);
+  else 
+    image_to_context(data, stream, swscaler, context_frame);
+
+  encode_context_frame(filename, format_context, stream, context_frame,
+      buffer, buffer_size);
+}
+
+void bob::io::detail::ffmpeg::write_video_frame (const uint8_t* const planes[],
+    const int linesize[],
+    const std::string& filename,
+    boost::shared_ptr<AVFormatContext> format_context,
+    boost::shared_ptr<AVStream> stream,
+    boost::shared_ptr<AVFrame> context_frame,
+    boost::shared_ptr<SwsContext> swscaler,
+    boost::shared_array<uint8_t> buffer,
+    size_t buffer_size) {
+
+  planes_to_context(planes, linesize, stream->codec->height, swscaler,
+      context_frame);
+
+  encode_context_frame(filename, format_context, stream, context_frame,
+      buffer, buffer_size);
+}
+
 static int decode_frame (const std::string& filename, int current_frame,
     boost::shared_ptr<AVCodecContext> codec_context,
     boost::shared_ptr<SwsContext> scaler,
@@ -1516,3 +1576,64 @@ bool bob::io::detail::ffmpeg::skip_video_frame (const std::string& filename,
 
   return true;
 }
+
+#ifndef AV_PKT_FLAG_KEY
+#define AV_PKT_FLAG_KEY PKT_FLAG_KEY
+#endif
+
+size_t bob::io::detail::ffmpeg::index_keyframes(const std::string& filename,
+    boost::shared_ptr<AVFormatContext> format_context, int stream_index,
+    std::vector<size_t>& frames, std::vector<int64_t>& timestamps) {
+
+  frames.clear();
+  timestamps.clear();
+
+  boost::shared_ptr<AVPacket> pkt = make_packet();
+  size_t counter = 0;
+  int ok = 0;
+
+  // reads packets only: nothing is decoded
+  while ((ok = av_read_frame(format_context.get(), pkt.get())) >= 0) {
+    if (pkt->stream_index == stream_index) {
+      if (pkt->flags & AV_PKT_FLAG_KEY) {
+        frames.push_back(counter);
+        timestamps.push_back((pkt->dts != (int64_t)AV_NOPTS_VALUE) ?
+            pkt->dts : pkt->pts);
+      }
+      ++counter;
+    }
+    av_free_packet(pkt.get());
+  }
+
+#if LIBAVCODEC_VERSION_INT >= 0x344802 //52.72.2 @ ffmpeg-0.6
+  if (ok != (int)AVERROR_EOF) {
+    boost::format m("bob::io::detail::ffmpeg::av_read_frame() failed: on file `%s' while indexing keyframes - ffmpeg reports error %d == `%s'");
+    m % filename % ok % ffmpeg_error(ok);
+    throw std::runtime_error(m.str());
+  }
+#endif
+
+  return counter;
+}
+
+bool bob::io::detail::ffmpeg::seek_keyframe(const std::string& filename,
+    int64_t timestamp, int stream_index,
+    boost::shared_ptr<AVFormatContext> format_context,
+    boost::shared_ptr<AVCodecContext> codec_context, bool throw_on_error) {
+
+  int ok = av_seek_frame(format_context.get(), stream_index, timestamp,
+      AVSEEK_FLAG_BACKWARD);
+
+  if (ok < 0) {
+    if (throw_on_error) {
+      boost::format m("bob::io::detail::ffmpeg::av_seek_frame(timestamp=%d) failed: on file `%s' - ffmpeg reports error %d == `%s'");
+      m % timestamp % filename % ok % ffmpeg_error(ok);
+      throw std::runtime_error(m.str());
+    }
+    return false;
+  }
+
+  // pictures decoded before the seek must not come out now
+  avcodec_flush_buffers(codec_context.get());
+  return true;
+}
@@ -21,8 +21,14 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
 #include <boost/format.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <bob/core/logging.h>
+#include <bob/core/check.h>
+#include <bob/core/array_copy.h>
 #include <bob/io/VideoWriter.h>
 
 #if LIBAVFORMAT_VERSION_INT < 0x361764 /* 54.23.100 @ ffmpeg-0.11 */
@@ -35,6 +41,16 @@
 #define AV_PIX_FMT_RGB24 PIX_FMT_RGB24
 #endif
 
+#ifndef AV_PIX_FMT_GRAY8
+#define AV_PIX_FMT_GRAY8 PIX_FMT_GRAY8
+#endif
+
+static size_t codec_threads(size_t n_threads) {
+  if (!n_threads) n_threads = boost::thread::hardware_concurrency();
+  if (!n_threads) n_threads = 1;
+  return n_threads;
+}
+
 bob::io::VideoWriter::VideoWriter(
     const std::string& filename,
     size_t height,
@@ -44,14 +60,16 @@ bob::io::VideoWriter::VideoWriter(
     size_t gop,
     const std::string& codec,
     const std::string& format,
-    bool check) :
+    bool check,
+    size_t queue_size,
+    size_t n_threads) :
   m_filename(filename),
   m_opened(false),
   m_format_context(bob::io::detail::ffmpeg::make_output_format_context(filename, format)),
   m_codec(bob::io::detail::ffmpeg::find_encoder(filename, m_format_context, codec)),
   m_stream(bob::io::detail::ffmpeg::make_stream(filename, m_format_context, codec, height,
         width, framerate, bitrate, gop, m_codec)),
-  m_codec_context(bob::io::detail::ffmpeg::make_codec_context(filename, m_stream.get(), m_codec)),
+  m_codec_context(bob::io::detail::ffmpeg::make_codec_context(filename, m_stream.get(), m_codec, codec_threads(n_threads))),
   m_context_frame(bob::io::detail::ffmpeg::make_frame(filename, m_codec_context, m_stream->codec->pix_fmt)),
 #if LIBAVCODEC_VERSION_INT >= 0x352a00 //53.42.0 @ ffmpeg-0.9
   m_swscaler(bob::io::detail::ffmpeg::make_scaler(filename, m_codec_context, PIX_FMT_GBRP, m_stream->codec->pix_fmt)),
@@ -67,8 +85,18 @@ bob::io::VideoWriter::VideoWriter(
   m_gop(gop),
   m_codecname(codec),
   m_formatname(format),
-  m_current_frame(0)
+  m_current_frame(0),
+  m_n_threads(codec_threads(n_threads)),
+  m_ring(),
+  m_queued(0),
+  m_total_latency(0.)
 {
+  m_stats.frames = 0;
+  m_stats.encoding_time = 0.;
+  m_stats.mean_latency = 0.;
+  m_stats.max_latency = 0.;
+  m_stats.blocked_time = 0.;
+
   //runs a codec/format check if the user asked so
   if (check) {
     if (!bob::io::detail::ffmpeg::oformat_is_supported(formatName())) {
@@ -107,16 +135,34 @@ bob::io::VideoWriter::VideoWriter(
   m_context_frame->pts = 0;
 
   m_opened = true; ///< file is now considered opened for bussiness
+
+  if (queue_size) {
+    m_ring = boost::make_shared<bob::core::OrderedRing<Slot> >(queue_size);
+    m_ring->start(1, boost::bind(&bob::io::VideoWriter::encoder, this));
+  }
 }
 
 bob::io::VideoWriter::~VideoWriter() {
-  close();
+  try {
+    close();
+  }
+  catch (std::exception& e) {
+    bob::core::warn << "error while closing video file `" << m_filename << "': " << e.what() << std::endl;
+  }
 }
 
 void bob::io::VideoWriter::close() {
 
   if (!m_opened) return;
 
+  //encodes the frames still in the queue
+  std::string error;
+  if (m_ring) {
+    m_ring->finish(m_queued);
+    m_ring->join();
+    error = m_ring->error();
+  }
+
   bob::io::detail::ffmpeg::flush_encoder(m_filename, m_format_context, m_stream, m_codec,
       m_buffer, FFMPEG_VIDEO_BUFFER_SIZE);
   bob::io::detail::ffmpeg::close_output_file(m_filename, m_format_context);
@@ -127,10 +173,25 @@ void bob::io::VideoWriter::close() {
   m_rgb24_frame.reset();
   m_buffer.reset();
   m_swscaler.reset();
+  m_interleaved_scaler.reset();
+  m_gray_scaler.reset();
   m_stream.reset();
   m_format_context.reset();
 
   m_opened = false; ///< file is now considered closed
+
+  if (!error.empty()) throw std::runtime_error(error);
+}
+
+void bob::io::VideoWriter::flush() {
+  if (m_ring) m_ring->flush(m_queued);
+}
+
+bob::io::VideoWriter::Statistics bob::io::VideoWriter::statistics() const {
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  Statistics retval = m_stats;
+  if (retval.frames) retval.mean_latency = m_total_latency / retval.frames;
+  return retval;
 }
 
 std::string bob::io::VideoWriter::info() const {
@@ -156,61 +217,202 @@ std::string bob::io::VideoWriter::info() const {
   return info.str();
 }
 
-void bob::io::VideoWriter::append(const blitz::Array<uint8_t,4>& data) {
+void bob::io::VideoWriter::check_opened() const {
   if (!m_opened) {
     boost::format m("video writer for file `%s' is closed and cannot be written to");
     m % m_filename;
     throw std::runtime_error(m.str());
   }
+}
 
-  //checks data specifications
-  if (data.extent(1) != 3 || (size_t)data.extent(2) != m_height || 
-      (size_t)data.extent(3) != m_width) {
-    boost::format m("input data extents for each frame (the last 3 dimensions of your 4D input array = %dx%dx%d) do not conform to expected format (3x%dx%d), while writing data to file `%s'");
-    m % data.extent(1) % data.extent(2) % data.extent(3)
-      % m_height % m_width % m_filename;
-    throw std::runtime_error(m.str());
+bob::io::VideoWriter::layout_t bob::io::VideoWriter::frame_layout
+(size_t nd, const size_t* shape) const {
+
+  //the video height and width are even, so layouts cannot be mistaken
+  if (nd == 2 && shape[0] == m_height && shape[1] == m_width) return gray;
+  if (nd == 3 && shape[0] == 3 && shape[1] == m_height && shape[2] == m_width)
+    return planar;
+  if (nd == 3 && shape[0] == m_height && shape[1] == m_width && shape[2] == 3)
+    return interleaved;
+
+  boost::format m("input data extents (%s) do not conform to expected format (3x%dx%d, %dx%dx3 or %dx%d), while writing data to file `%s'");
+  std::string extents;
+  for (size_t k=0; k<nd; ++k) {
+    if (k) extents += "x";
+    extents += boost::str(boost::format("%d") % shape[k]);
+  }
+  m % extents % m_height % m_width % m_height % m_width % m_height % m_width
+    % m_filename;
+  throw std::runtime_error(m.str());
+}
+
+size_t bob::io::VideoWriter::frame_size(layout_t layout) const {
+  return ((layout == gray) ? 1 : 3) * m_height * m_width;
+}
+
+void bob::io::VideoWriter::write(const uint8_t* data, layout_t layout,
+    const boost::posix_time::ptime& queued) {
+
+  boost::posix_time::ptime start =
+    boost::posix_time::microsec_clock::universal_time();
+
+  switch (layout) {
+    case interleaved:
+      {
+        if (!m_interleaved_scaler) {
+          m_interleaved_scaler = bob::io::detail::ffmpeg::make_scaler(m_filename, m_codec_context, AV_PIX_FMT_RGB24, m_stream->codec->pix_fmt);
+        }
+        const uint8_t* planes[] = {data, 0};
+        int linesize[] = {3 * static_cast<int>(m_width), 0};
+        bob::io::detail::ffmpeg::write_video_frame(planes, linesize,
+            m_filename, m_format_context, m_stream, m_context_frame,
+            m_interleaved_scaler, m_buffer, FFMPEG_VIDEO_BUFFER_SIZE);
+      }
+      break;
+    case gray:
+      {
+        if (!m_gray_scaler) {
+          m_gray_scaler = bob::io::detail::ffmpeg::make_scaler(m_filename, m_codec_context, AV_PIX_FMT_GRAY8, m_stream->codec->pix_fmt);
+        }
+        const uint8_t* planes[] = {data, 0};
+        int linesize[] = {static_cast<int>(m_width), 0};
+        bob::io::detail::ffmpeg::write_video_frame(planes, linesize,
+            m_filename, m_format_context, m_stream, m_context_frame,
+            m_gray_scaler, m_buffer, FFMPEG_VIDEO_BUFFER_SIZE);
+      }
+      break;
+    default: //planar
+      {
+        blitz::Array<uint8_t,3> frame(const_cast<uint8_t*>(data),
+            blitz::shape(3, m_height, m_width), blitz::neverDeleteData);
+        bob::io::detail::ffmpeg::write_video_frame(frame, m_filename,
+            m_format_context, m_stream, m_context_frame, m_rgb24_frame,
+            m_swscaler, m_buffer, FFMPEG_VIDEO_BUFFER_SIZE);
+      }
+      break;
+  }
+
+  boost::posix_time::ptime end =
+    boost::posix_time::microsec_clock::universal_time();
+  double latency = (end - queued).total_microseconds() / 1e6;
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_stats.frames += 1;
+  m_stats.encoding_time += (end - start).total_microseconds() / 1e6;
+  m_total_latency += latency;
+  if (latency > m_stats.max_latency) m_stats.max_latency = latency;
+}
+
+void bob::io::VideoWriter::push(const uint8_t* data, layout_t layout) {
+
+  boost::posix_time::ptime now =
+    boost::posix_time::microsec_clock::universal_time();
+
+  if (!m_ring) { //encodes right away
+    write(data, layout, now);
+  }
+
+  else {
+    // waits until the encoder is done with this slot
+    Slot* slot = m_ring->acquire(m_queued);
+    if (!slot) throw std::runtime_error(m_ring->error());
+
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_stats.blocked_time += (boost::posix_time::microsec_clock::universal_time() - now).total_microseconds() / 1e6;
+    }
+
+    // the encoder does not touch this slot until it is published
+    size_t size = frame_size(layout);
+    slot->data.resize(size);
+    std::memcpy(&slot->data[0], data, size);
+    slot->layout = layout;
+    slot->queued = now;
+
+    m_ring->publish(m_queued);
+    ++m_queued;
   }
 
+  ++m_current_frame;
+  m_typeinfo_video.shape[0] += 1;
+}
+
+void bob::io::VideoWriter::encoder() {
+
+  for (size_t seq=0; ; ++seq) {
+    // waits for the next frame, or stops once the queue is closed and empty
+    Slot* slot = m_ring->wait();
+    if (!slot) return;
+
+    try {
+      write(&slot->data[0], slot->layout, slot->queued);
+    }
+    catch (std::exception& e) {
+      m_ring->fail(seq, e.what());
+      return;
+    }
+    catch (...) {
+      m_ring->fail(seq, "VideoWriter: unknown exception raised by encoder");
+      return;
+    }
+
+    m_ring->release();
+  }
+}
+
+void bob::io::VideoWriter::append(const blitz::Array<uint8_t,4>& data) {
+  check_opened();
+
+  //frames are copied as raw memory, in C order
+  if (!bob::core::array::isCZeroBaseContiguous(data)) {
+    append(bob::core::array::ccopy(data));
+    return;
+  }
+
+  //checks data specifications
+  size_t shape[3];
+  for (int k=0; k<3; ++k) shape[k] = data.extent(k+1);
+  layout_t layout = frame_layout(3, shape);
+
   blitz::Range a = blitz::Range::all();
   for(int i=data.lbound(0); i<(data.extent(0)+data.lbound(0)); ++i) {
-    bob::io::detail::ffmpeg::write_video_frame(data(i, a, a, a), m_filename, m_format_context,
-        m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-        FFMPEG_VIDEO_BUFFER_SIZE);
-    ++m_current_frame;
-    m_typeinfo_video.shape[0] += 1;
+    blitz::Array<uint8_t,3> frame = data(i, a, a, a);
+    push(frame.data(), layout);
   }
 }
 
 void bob::io::VideoWriter::append(const blitz::Array<uint8_t,3>& data) {
-  if (!m_opened) {
-    boost::format m("video writer for file `%s' is closed and cannot be written to");
-    m % m_filename;
-    throw std::runtime_error(m.str());
+  check_opened();
+
+  //frames are copied as raw memory, in C order
+  if (!bob::core::array::isCZeroBaseContiguous(data)) {
+    append(bob::core::array::ccopy(data));
+    return;
   }
 
   //checks data specifications
-  if (data.extent(0) != 3 || (size_t)data.extent(1) != m_height || 
-      (size_t)data.extent(2) != m_width) {
-    boost::format m("input data extents (%dx%dx%d) do not conform to expected format (3x%dx%d), while writing data to file `%s'");
-    m % data.extent(0) % data.extent(1) % data.extent(2)
-      % m_height % m_width % m_filename;
-    throw std::runtime_error(m.str());
+  size_t shape[3];
+  for (int k=0; k<3; ++k) shape[k] = data.extent(k);
+  push(data.data(), frame_layout(3, shape));
+}
+
+void bob::io::VideoWriter::append(const blitz::Array<uint8_t,2>& data) {
+  check_opened();
+
+  //frames are copied as raw memory, in C order
+  if (!bob::core::array::isCZeroBaseContiguous(data)) {
+    append(bob::core::array::ccopy(data));
+    return;
   }
 
-  bob::io::detail::ffmpeg::write_video_frame(data, m_filename, m_format_context,
-      m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-      FFMPEG_VIDEO_BUFFER_SIZE);
-  ++m_current_frame;
-  m_typeinfo_video.shape[0] += 1;
+  //checks data specifications
+  size_t shape[2];
+  for (int k=0; k<2; ++k) shape[k] = data.extent(k);
+  push(data.data(), frame_layout(2, shape));
 }
 
 void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
-  if (!m_opened) {
-    boost::format m("video writer for file `%s' is closed and cannot be written to");
-    m % m_filename;
-    throw std::runtime_error(m.str());
-  }
+  check_opened();
 
   const bob::core::array::typeinfo& type = data.type();
 
@@ -218,52 +420,21 @@ void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
     boost::format m("input data type = `%s' does not conform to the specified input specifications (3D array = `%s' or 4D array = `%s'), while writing data to file `%s'");
     m % type.str() % m_typeinfo_frame.str() % m_typeinfo_video.str()
       % m_filename;
+    throw std::runtime_error(m.str());
   }
 
-  if ( type.nd == 3 ) { //appends single frame
-    if ( (type.shape[0] != 3) || 
-        (type.shape[1] != m_height) || 
-        (type.shape[2] != m_width) ) {
-      boost::format m("input data extents (%dx%dx%d) do not conform to expected format (3x%dx%d), while writing data to file `%s'");
-      m % type.shape[0] % type.shape[1] % type.shape[2]
-        % m_height % m_width % m_filename;
-      throw std::runtime_error(m.str());
-    }
+  const uint8_t* ptr = static_cast<const uint8_t*>(data.ptr());
 
-    blitz::TinyVector<int,3> shape;
-    shape = 3, m_height, m_width;
-    blitz::Array<uint8_t,3> tmp(const_cast<uint8_t*>(static_cast<const uint8_t*>(data.ptr())), shape,
-        blitz::neverDeleteData);
-    bob::io::detail::ffmpeg::write_video_frame(tmp, m_filename, m_format_context,
-        m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-        FFMPEG_VIDEO_BUFFER_SIZE);
-    ++m_current_frame;
-    m_typeinfo_video.shape[0] += 1;
+  if ( type.nd == 2 || type.nd == 3 ) { //appends single frame
+    push(ptr, frame_layout(type.nd, type.shape));
   }
   
   else if ( type.nd == 4 ) { //appends a sequence of frames
-    if ( (type.shape[1] != 3) || 
-         (type.shape[2] != m_height) || 
-         (type.shape[3] != m_width) ) {
-      boost::format m("input data extents for each frame (the last 3 dimensions of your 4D input array = %dx%dx%d) do not conform to expected format (3x%dx%d), while writing data to file `%s'");
-      m % type.shape[1] % type.shape[2] % type.shape[3]
-        % m_height % m_width % m_filename;
-      throw std::runtime_error(m.str());
-    }
-    
-    blitz::TinyVector<int,3> shape;
-    shape = 3, m_height, m_width;
-    unsigned long int frame_size = 3 * m_height * m_width;
-    uint8_t* ptr = const_cast<uint8_t*>(static_cast<const uint8_t*>(data.ptr()));
-
+    layout_t layout = frame_layout(3, type.shape + 1);
+    size_t size = frame_size(layout);
     for(size_t i=0; i<type.shape[0]; ++i) {
-      blitz::Array<uint8_t,3> tmp(ptr, shape, blitz::neverDeleteData);
-      bob::io::detail::ffmpeg::write_video_frame(tmp, m_filename, m_format_context,
-          m_stream, m_context_frame, m_rgb24_frame, m_swscaler, m_buffer,
-          FFMPEG_VIDEO_BUFFER_SIZE);
-      ++m_current_frame;
-      m_typeinfo_video.shape[0] += 1;
-      ptr += frame_size;
+      push(ptr, layout);
+      ptr += size;
     }
   }
 
@@ -271,6 +442,7 @@ void bob::io::VideoWriter::append(const bob::core::array::interface& data) {
     boost::format m("input data type information = `%s' does not conform to the specified input specifications (3D array = `%s' or 4D array = `%s'), while writing data to file `%s'");
     m % type.str() % m_typeinfo_frame.str() % m_typeinfo_video.str()
       % m_filename;
+    throw std::runtime_error(m.str());
   }
 
 }
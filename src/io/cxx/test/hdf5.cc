@@ -146,4 +146,38 @@ BOOST_AUTO_TEST_CASE( hdf5_write_on_readonly )
   boost::filesystem::remove(filename);
 }
 
+BOOST_AUTO_TEST_CASE( hdf5_rows )
+{
+  const std::string filename = bob::core::tmpfile();
+  bob::io::HDF5File config(filename, bob::io::HDF5File::trunc);
+
+  // Appends the rows of a in two blocks and a single row
+  blitz::Range all = blitz::Range::all();
+  config.appendRows("a", a(blitz::Range(0,1), all), 0, 3);
+  config.appendArray("a", blitz::Array<double,1>(a(2, all)));
+  config.appendRows("a", a(blitz::Range(3,3), all));
+  BOOST_CHECK_EQUAL(config.describe("a")[0].size, (size_t)4);
+  check_equal(a, config.readArray<double,2>("a"));
+  check_equal(blitz::Array<double,2>(a(blitz::Range(1,3), all)),
+      config.readRows<double,2>("a", 1, 3));
+  BOOST_CHECK_THROW(config.readRows<double,2>("a", 2, 3), bob::io::HDF5IndexError);
+
+  // Replaces rows
+  blitz::Array<double,2> b(2,2);
+  b = 10, 20, 30, 40;
+  config.replaceRows("a", 1, b);
+  check_equal(b, config.readRows<double,2>("a", 1, 2));
+  check_equal(blitz::Array<double,1>(a(3, all)), config.readArray<double,1>("a", 3));
+
+  // Blocks of scalars, read through a different chunk cache
+  config.appendRows("c", c, 9);
+  config.appendRows("c", c);
+  config.setChunkCache("c", 101, 1 << 20, 1.);
+  check_equal(c, config.readRows<double,1>("c", 5, 5));
+  BOOST_CHECK_EQUAL(config.read<double>("c", 6), c(1));
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
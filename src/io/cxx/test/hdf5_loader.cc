@@ -0,0 +1,116 @@
+/**
+ * @file io/cxx/test/hdf5_loader.cc
+ * @date Sun Oct 18 16:02:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Tests the background loading of HDF5 feature files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE HDF5FeatureLoader Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <blitz/array.h>
+#include <string>
+#include <vector>
+#include "bob/core/logging.h" // for bob::core::tmpfile()
+#include "bob/io/HDF5File.h"
+#include "bob/io/HDF5FeatureLoader.h"
+
+struct T {
+  std::vector<std::string> filenames;
+  std::vector<blitz::Array<double,2> > features;
+
+  T() {
+    // files with a varying number of rows, as for utterances
+    for (int k=0; k<7; ++k) {
+      blitz::Array<double,2> f(3+2*k, 5);
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      f = 100.*k + 10.*i + j;
+      filenames.push_back(bob::core::tmpfile());
+      bob::io::HDF5File file(filenames.back(), bob::io::HDF5File::trunc);
+      file.setArray("features", f, 9);
+      features.push_back(f);
+    }
+  }
+
+  ~T() {
+    for (size_t k=0; k<filenames.size(); ++k)
+      boost::filesystem::remove(filenames[k]);
+  }
+
+};
+
+void check_equal(const blitz::Array<double,2>& a,
+    const blitz::Array<double,2>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.extent(0), b.extent(0));
+  BOOST_REQUIRE_EQUAL(a.extent(1), b.extent(1));
+  for (int i=0; i<a.extent(0); ++i)
+    for (int j=0; j<a.extent(1); ++j)
+      BOOST_CHECK_EQUAL(a(i,j), b(i,j));
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( hdf5_loader_order )
+{
+  std::vector<std::string> paths(1, "features");
+  for (size_t workers=1; workers<=4; workers+=3) {
+    bob::io::HDF5FeatureLoader loader(filenames, paths, workers, 2);
+    blitz::Array<double,2> data;
+    for (size_t k=0; k<filenames.size(); ++k) {
+      BOOST_CHECK_EQUAL(loader.getPosition(), k);
+      BOOST_REQUIRE(loader.next(data));
+      check_equal(features[k], data);
+    }
+    BOOST_CHECK(!loader.next(data));
+
+    // restarts from the first file
+    loader.stop();
+    BOOST_REQUIRE(loader.next(data));
+    check_equal(features[0], data);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( hdf5_loader_error )
+{
+  std::vector<std::string> paths(filenames.size(), "features");
+  paths[3] = "missing";
+  bob::io::HDF5FeatureLoader loader(filenames, paths, 3, 4);
+  blitz::Array<double,2> data;
+  for (size_t k=0; k<3; ++k) {
+    BOOST_REQUIRE(loader.next(data));
+    check_equal(features[k], data);
+  }
+  BOOST_CHECK_THROW(loader.next(data), std::runtime_error);
+
+  // the failure sticks until the loader is stopped
+  BOOST_CHECK_THROW(loader.next(data), std::runtime_error);
+  BOOST_CHECK_EQUAL(loader.getPosition(), (size_t)3);
+  loader.stop();
+  BOOST_REQUIRE(loader.next(data));
+  check_equal(features[0], data);
+
+  std::vector<std::string> wrong(2, "features");
+  BOOST_CHECK_THROW(bob::io::HDF5FeatureLoader(filenames, wrong), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/**
+ * @file io/cxx/test/line_index.cc
+ * @date Sun Oct 18 17:35:21 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Tests the line indexing of text files and the number parser
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE LineIndex Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "bob/core/logging.h" // for bob::core::tmpfile()
+#include "bob/io/LineIndex.h"
+
+static std::string line(const bob::io::LineIndex& index, size_t i) {
+  return std::string(index.begin(i), index.end(i));
+}
+
+static std::string write(const std::string& contents) {
+  std::string filename = bob::core::tmpfile(".txt");
+  std::ofstream f(filename.c_str(), std::ios::binary);
+  f << contents;
+  return filename;
+}
+
+BOOST_AUTO_TEST_CASE( line_index_terminators )
+{
+  std::string filename = write("a,b\r\n\nlast");
+  bob::io::LineIndex index(filename);
+  BOOST_REQUIRE_EQUAL(index.size(), 3U);
+  BOOST_CHECK_EQUAL(line(index, 0), "a,b");
+  BOOST_CHECK_EQUAL(line(index, 1), "");
+  BOOST_CHECK_EQUAL(line(index, 2), "last");
+  boost::filesystem::remove(filename);
+
+  // a final terminator does not start a new line
+  filename = write("1\n2\n");
+  bob::io::LineIndex terminated(filename);
+  BOOST_REQUIRE_EQUAL(terminated.size(), 2U);
+  BOOST_CHECK_EQUAL(line(terminated, 1), "2");
+  boost::filesystem::remove(filename);
+
+  filename = write("");
+  BOOST_CHECK_EQUAL(bob::io::LineIndex(filename).size(), 0U);
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( line_index_parallel )
+{
+  // large enough to be scanned by several threads
+  std::ostringstream contents;
+  const size_t n = 300000;
+  for (size_t k=0; k<n; ++k) contents << k << "\n";
+  std::string filename = write(contents.str());
+
+  bob::io::LineIndex index(filename, 4);
+  BOOST_CHECK_EQUAL(index.getNThreads(), 4U);
+  BOOST_REQUIRE_EQUAL(index.size(), n);
+  for (size_t k=0; k<n; k+=997) {
+    std::ostringstream expected;
+    expected << k;
+    BOOST_CHECK_EQUAL(line(index, k), expected.str());
+  }
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( parse_double_strtod )
+{
+  const char* valid[] = {"0", "-0", "+1", "-2.5", "0.001", "1e-3", "5.",
+    ".5", "3.14159265358979", "0.12345678901234567890", "1E300", "4.9e-324",
+    "123456789012345e-10", "inf", "nan", 0};
+  for (size_t k=0; valid[k]; ++k) {
+    double value;
+    BOOST_CHECK(bob::io::parse_double(valid[k], valid[k] + std::strlen(valid[k]), value));
+    double expected = std::strtod(valid[k], 0);
+    if (expected == expected) BOOST_CHECK_EQUAL(value, expected);
+  }
+
+  const char* invalid[] = {"", "abc", "1e", "1.5x", " 1", "1 ", "-", ".", 0};
+  for (size_t k=0; invalid[k]; ++k) {
+    double value;
+    BOOST_CHECK(!bob::io::parse_double(invalid[k], invalid[k] + std::strlen(invalid[k]), value));
+  }
+}
@@ -30,6 +30,7 @@
 #include <blitz/array.h>
 #include "bob/core/logging.h"
 #include "bob/io/utils.h"
+#include "bob/io/MappedFile.h"
 
 struct T {
   blitz::Array<int8_t,2> a, b;
@@ -84,4 +85,42 @@ BOOST_AUTO_TEST_CASE( tensor_2d_read_T5alpha )
   check_equal( bob::io::load<int8_t,2>(testdata_path.string()), b );
 }
 
+BOOST_AUTO_TEST_CASE( tensor_2d_view )
+{
+  std::string filename = bob::core::tmpfile(".tensor");
+  blitz::Array<float,2> f = bob::core::array::cast<float>(a);
+  blitz::Array<double,2> d = bob::core::array::cast<double>(a);
+  {
+    boost::shared_ptr<bob::io::File> file = bob::io::open(filename, 'w');
+    file->append(f);
+    file->append(blitz::Array<float,2>(f + 1.f));
+  }
+
+  boost::shared_ptr<bob::io::File> file = bob::io::open(filename, 'r');
+  file->advise(bob::io::File::random);
+  boost::shared_ptr<bob::core::array::interface> view = file->view(1);
+  BOOST_CHECK(boost::dynamic_pointer_cast<bob::io::MappedArray>(view));
+  BOOST_CHECK_THROW(view->set(view->type()), std::runtime_error);
+
+  // the mapping outlives the file
+  file.reset();
+  check_equal(bob::core::array::wrap<float,2>(*view), blitz::Array<float,2>(f + 1.f));
+
+  // writes are copied on write and never reach the file
+  blitz::Array<float,2> written = bob::core::array::wrap<float,2>(*view);
+  written = 0.f;
+  check_equal(bob::io::open(filename, 'r')->read<float,2>(1), blitz::Array<float,2>(f + 1.f));
+  boost::filesystem::remove(filename);
+
+  // misaligned doubles are read into a new buffer
+  bob::io::save(filename, d);
+  file = bob::io::open(filename, 'r');
+  view = file->view_all();
+  BOOST_CHECK(!boost::dynamic_pointer_cast<bob::io::MappedArray>(view));
+  check_equal(bob::core::array::wrap<double,2>(*view), d);
+  BOOST_CHECK_THROW(file->view(1), bob::io::IndexError);
+  file.reset();
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
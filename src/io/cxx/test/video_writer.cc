@@ -0,0 +1,114 @@
+/**
+ * @file io/cxx/test/video_writer.cc
+ * @date Mon Oct 19 10:12:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Tests that the video writer encodes non-contiguous frames
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE VideoWriter Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include <blitz/array.h>
+#include <string>
+#include <vector>
+#include "bob/core/logging.h" // for bob::core::tmpfile()
+#include "bob/io/VideoWriter.h"
+#include "bob/io/VideoReader.h"
+
+struct T {
+  blitz::Array<uint8_t,4> video;
+  std::vector<std::string> filenames;
+
+  T(): video(8, 3, 32, 48) {
+    // a smooth, moving pattern
+    blitz::firstIndex f;
+    blitz::secondIndex c;
+    blitz::thirdIndex y;
+    blitz::fourthIndex x;
+    video = blitz::cast<uint8_t>((4*x + 3*y + 60*c + 5*f) % 256);
+  }
+
+  ~T() {
+    for (size_t k=0; k<filenames.size(); ++k)
+      boost::filesystem::remove(filenames[k]);
+  }
+
+  std::string next_file() {
+    filenames.push_back(bob::core::tmpfile(".avi"));
+    return filenames.back();
+  }
+
+};
+
+blitz::Array<uint8_t,4> read(const std::string& filename) {
+  bob::io::VideoReader reader(filename);
+  blitz::Array<uint8_t,4> retval;
+  reader.load(retval, true);
+  return retval;
+}
+
+void check_equal(const blitz::Array<uint8_t,4>& a,
+    const blitz::Array<uint8_t,4>& b)
+{
+  for (int k=0; k<4; ++k) BOOST_REQUIRE_EQUAL(a.extent(k), b.extent(k));
+  BOOST_CHECK(blitz::all(a == b));
+}
+
+BOOST_FIXTURE_TEST_SUITE( test_setup, T )
+
+BOOST_AUTO_TEST_CASE( test_non_contiguous_frames )
+{
+  // reference: C-style contiguous frames
+  const std::string reference = next_file();
+  {
+    bob::io::VideoWriter writer(reference, 32, 48);
+    writer.append(video);
+  }
+  blitz::Array<uint8_t,4> expected = read(reference);
+
+  // the same video, with Fortran-style storage
+  const std::string fortran = next_file();
+  {
+    blitz::Array<uint8_t,4> f(video.shape(), blitz::ColumnMajorArray<4>());
+    f = video;
+    bob::io::VideoWriter writer(fortran, 32, 48);
+    writer.append(f);
+  }
+  check_equal(expected, read(fortran));
+
+  // the same frames, as strided views of a larger array, through the queue
+  const std::string strided = next_file();
+  {
+    blitz::Array<uint8_t,4> large(8, 3, 32, 96);
+    blitz::Range a = blitz::Range::all();
+    large(a, a, a, blitz::Range(0, 94, 2)) = video;
+    bob::io::VideoWriter writer(strided, 32, 48, 25., 1500000., 12, "", "",
+        true, 2);
+    for (int k=0; k<8; ++k) {
+      blitz::Array<uint8_t,3> frame = large(k, a, a, blitz::Range(0, 94, 2));
+      writer.append(frame);
+    }
+  }
+  check_equal(expected, read(strided));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -41,6 +41,16 @@ static object file_read(bob::io::File& f, size_t index) {
   return a.pyobject(); //shallow copy
 }
 
+static object file_view_all(bob::io::File& f) {
+  bob::python::py_array a(f.view_all());
+  return a.pyobject(); //read-only, keeps the data alive
+}
+
+static object file_view(bob::io::File& f, size_t index) {
+  bob::python::py_array a(f.view(index));
+  return a.pyobject(); //read-only, keeps the data alive
+}
+
 static boost::shared_ptr<bob::io::File> string_open1 (const std::string& filename,
     const std::string& mode) {
   return bob::io::open(filename, mode[0]);
@@ -72,6 +82,12 @@ static dict extensions() {
 }
 
 void bind_io_file() {
+
+  enum_<bob::io::File::access_t>("FileAccess")
+    .value("normal", bob::io::File::normal)
+    .value("sequential", bob::io::File::sequential)
+    .value("random", bob::io::File::random)
+    ;
   
   class_<bob::io::File, boost::shared_ptr<bob::io::File>, boost::noncopyable>("File", "Abstract base class for all Array/Arrayset i/o operations", no_init)
     .def("__init__", make_constructor(string_open1, default_call_policies(), (arg("filename"), arg("mode"))), "Opens a (supported) file for reading arrays. The mode is a **single** character which takes one of the following values: 'r' - opens the file for read-only operations; 'w' - truncates the file and open it for reading and writing; 'a' - opens the file for reading and writing w/o truncating it.")
@@ -86,6 +102,9 @@ void bind_io_file() {
     .def("read", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
     .def("__getitem__", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
     .def("append", &file_append, (arg("self"), arg("array")), "Appends an array to a file. Compatibility requirements may be enforced.")
+    .def("view", &file_view_all, (arg("self")), "Returns the whole contents of the file as a read-only NumPy ndarray. Raw array files (.bin, .tensor and .bindata) opened with mode 'r' are memory mapped and the returned array points directly into the mapping, without reading it first. Other files are read into a new array.")
+    .def("view", &file_view, (arg("self"), arg("index")), "Returns a single array from the file, considering it to be an arrayset list, as a read-only NumPy ndarray. Raw array files (.bin, .tensor and .bindata) opened with mode 'r' are memory mapped and the returned array points directly into the mapping. Other files are read into a new array.")
+    .def("advise", &bob::io::File::advise, (arg("self"), arg("pattern")), "Announces how the arrays are going to be read (a bob.io.FileAccess value), so that memory mapped files can tune the read-ahead of the operating system. Other files ignore this hint.")
     ;
 
   def("extensions", &extensions, "Returns a dictionary containing all extensions and descriptions currently stored on the global codec registry");
@@ -375,6 +375,48 @@ static void hdf5file_append(bob::io::HDF5File& f, const std::string& path,
 
 BOOST_PYTHON_FUNCTION_OVERLOADS(hdf5file_append_overloads, hdf5file_append, 3, 4)
 
+/**
+ * Reads, replaces or appends blocks of consecutive objects (rows), the first
+ * dimension of the arrays indexing the objects
+ */
+static object hdf5file_read_rows(bob::io::HDF5File& f, const std::string& p,
+    size_t pos, size_t count) {
+  const bob::io::HDF5Type& type = f.describe(p)[0].type;
+  if (type.type() == bob::io::s) 
+    PYTHON_ERROR(TypeError, "cannot read rows of strings at '%s'", p.c_str());
+
+  bob::io::HDF5Shape block(type.shape());
+  if (block.n() != 1 || block[0] != 1) block >>= 1; ///< rows of arrays
+  block[0] = count;
+
+  bob::core::array::typeinfo atype;
+  bob::io::HDF5Type(type.type(), block).copy_to(atype);
+  bob::python::py_array retval(atype);
+  f.read_rows_buffer(p, pos, atype, retval.ptr());
+  return retval.pyobject();
+}
+
+static void hdf5file_replace_rows(bob::io::HDF5File& f, const std::string& p,
+    size_t pos, object obj) {
+  bob::python::py_array tmp(obj, object());
+  f.write_rows_buffer(p, pos, tmp.type(), tmp.ptr());
+}
+
+static void hdf5file_append_rows(bob::io::HDF5File& f, const std::string& p,
+    object obj, size_t compression=0, size_t chunk_rows=0) {
+  bob::python::py_array tmp(obj, object());
+  if (!f.contains(p)) {
+    const bob::io::HDF5Type block(tmp.type());
+    bob::io::HDF5Shape row(block.shape());
+    row <<= 1;
+    f.create(p, (row.n() == 0) ? bob::io::HDF5Type(block.type()) : 
+        bob::io::HDF5Type(block.type(), row), true, compression, chunk_rows);
+  }
+  f.extend_rows_buffer(p, tmp.type(), tmp.ptr());
+}
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(hdf5file_append_rows_overloads, hdf5file_append_rows, 3, 5)
+
 template <typename T>
 static void inner_set_scalar(bob::io::HDF5File& f, const std::string& path,
     object obj) {
@@ -694,6 +736,19 @@ void bind_io_hdf5() {
   "  This is the data that will be set on the position indicated. It may be a simple python or numpy scalar (such as :py:class:`numpy.uint8`) or a :py:class:`numpy.ndarray` of any of the supported data types. You can also, optionally, set this to a list or tuple of scalars or arrays. This will cause this method to iterate over the elements and add each individually.\n\n" \
   "compresssion\n" \
   "  This parameter is effective when appending arrays. Set this to a number betwen 0 (default) and 9 (maximum) to compress the contents of this dataset. This setting is only effective if the dataset does not yet exist, otherwise, the previous setting is respected."))
+    .def("read_rows", &hdf5file_read_rows, (arg("self"), arg("key"), arg("pos"), arg("count")), "Reads 'count' consecutive objects of a dataset, starting at position 'pos', in a single read operation. Returns a :py:class:`numpy.ndarray` whose first dimension indexes the objects read (scalars are returned as a 1D array).")
+    .def("replace_rows", &hdf5file_replace_rows, (arg("self"), arg("path"), arg("pos"), arg("data")), "Modifies consecutive objects of a dataset, starting at position 'pos', in a single write operation. The first dimension of the :py:class:`numpy.ndarray` 'data' indexes the objects to be replaced.")
+    .def("append_rows", &hdf5file_append_rows, hdf5file_append_rows_overloads((arg("self"), arg("path"), arg("data"), arg("compression")=0, arg("chunk_rows")=0), "Appends all the objects indexed by the first dimension of the :py:class:`numpy.ndarray` 'data' to a dataset, extending it only once. If the dataset does not yet exist, one is created with the type characteristics of a single object (row).\n\n" \
+  "Keyword Parameters:\n\n" \
+  "path\n" \
+  "  This is the path to the HDF5 dataset to append data to\n\n" \
+  "data\n" \
+  "  A :py:class:`numpy.ndarray` of any of the supported data types. A 1D array appends scalars, a 2D array appends 1D arrays, and so on.\n\n" \
+  "compression\n" \
+  "  Set this to a number betwen 0 (default) and 9 (maximum) to compress the contents of this dataset. This setting is only effective if the dataset does not yet exist.\n\n" \
+  "chunk_rows\n" \
+  "  The number of objects (rows) per chunk of the dataset. The default (0) lets the chunks hold about 64 KiB. This setting is only effective if the dataset does not yet exist."))
+    .def("set_chunk_cache", &bob::io::HDF5File::setChunkCache, (arg("self"), arg("path"), arg("nslots"), arg("nbytes"), arg("w0")=0.75), "Sets the chunk cache of an existing dataset: the number of chunk slots 'nslots' (a prime number, about 100 times the number of chunks fitting in the cache), the total size 'nbytes' in bytes and the preemption policy 'w0' (between 0 and 1, use 1 if chunks are accessed only once). This setting is not stored in the file.")
     .def("set", &hdf5file_set, hdf5file_set_overloads((arg("self"), arg("path"), arg("data"), arg("compression")=0), "Sets the scalar or array at position 0 to the given value. This method is equivalent to checking if the scalar or array at position 0 exists and then replacing it. If the path does not exist, we append the new scalar or array.\n\n" \
   "Keyword Parameters:\n\n" \
   "path\n" \
@@ -0,0 +1,78 @@
+/**
+ * @file io/python/hdf5_loader.cc
+ * @date Sun Oct 18 16:02:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the background HDF5 feature loader to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+#include <boost/python/stl_iterator.hpp>
+#include <boost/make_shared.hpp>
+
+#include <bob/core/python/ndarray.h>
+#include <bob/core/python/exception.h>
+#include <bob/core/python/gil.h>
+
+#include <bob/io/HDF5FeatureLoader.h>
+
+using namespace boost::python;
+
+static boost::shared_ptr<bob::io::HDF5FeatureLoader> loader
+(object filenames, object paths, size_t n_workers, size_t queue_size) {
+  stl_input_iterator<std::string> fbegin(filenames), fend;
+  std::vector<std::string> vfilenames(fbegin, fend);
+
+  std::vector<std::string> vpaths;
+  extract<std::string> single(paths);
+  if (single.check()) vpaths.push_back(single());
+  else {
+    stl_input_iterator<std::string> pbegin(paths), pend;
+    vpaths.assign(pbegin, pend);
+  }
+
+  return boost::make_shared<bob::io::HDF5FeatureLoader>(vfilenames, vpaths,
+      n_workers, queue_size);
+}
+
+static object loader_next(bob::io::HDF5FeatureLoader& l) {
+  blitz::Array<double,2> data;
+  bool ok;
+  {
+    bob::python::no_gil unlock;
+    ok = l.next(data);
+  }
+  if (!ok) PYTHON_ERROR(StopIteration, "no more files");
+  return object(data);
+}
+
+static inline object pass_through(object const& o) { return o; }
+
+void bind_io_hdf5_loader() {
+
+  class_<bob::io::HDF5FeatureLoader, boost::shared_ptr<bob::io::HDF5FeatureLoader>, boost::noncopyable>("HDF5FeatureLoader", "Reads one 2D float64 array (e.g. one feature vector per row) from each file of a list of HDF5 files, on a pool of background workers. Loaded arrays are kept in a bounded queue and delivered in file order, so that reading the next files overlaps with the processing of the current one.\n\nAll calls into the HDF5 library are serialized between workers, as the library is not re-entrant. Each worker first reads its file with plain system calls, so that disk accesses do run in parallel. Do not use bob.io.HDF5File on other threads while the loader is running.", no_init)
+    .def("__init__", make_constructor(&loader, default_call_policies(), (arg("filenames"), arg("paths"), arg("n_workers")=1, arg("queue_size")=4)), "Initializes the loader with a list of HDF5 files and the path of the dataset to read in each of them, given either as a single string or as one string per file. Background workers are started on the first read.")
+    .def("__len__", &bob::io::HDF5FeatureLoader::size)
+    .add_property("position", &bob::io::HDF5FeatureLoader::getPosition, "The number of files delivered so far, which is also the index of the next file to be delivered")
+    .add_property("n_workers", &bob::io::HDF5FeatureLoader::getNumberOfWorkers)
+    .add_property("queue_size", &bob::io::HDF5FeatureLoader::getQueueSize)
+    .def("start", &bob::io::HDF5FeatureLoader::start, (arg("self")), "Starts the background workers, if they are not running already.")
+    .def("stop", &bob::io::HDF5FeatureLoader::stop, (arg("self")), "Stops the background workers and discards loaded files. The next read restarts from the first file.")
+    .def("next", &loader_next, (arg("self")), "Returns the contents of the next file, waiting for it if necessary. Raises StopIteration when all files were delivered.")
+    .def("__iter__", pass_through)
+    ;
+}
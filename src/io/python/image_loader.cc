@@ -0,0 +1,107 @@
+/**
+ * @file io/python/image_loader.cc
+ * @date Sun Oct 18 20:14:37 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the parallel image loader to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+#include <boost/python/stl_iterator.hpp>
+#include <boost/make_shared.hpp>
+
+#include <bob/core/python/ndarray.h>
+#include <bob/core/python/exception.h>
+#include <bob/core/python/gil.h>
+
+#include <bob/io/ImageLoader.h>
+
+using namespace boost::python;
+
+static boost::shared_ptr<bob::io::ImageLoader> loader
+(object filenames, bob::io::ImageLoader::layout_t layout, size_t n_workers,
+ size_t queue_size, size_t max_height, size_t max_width) {
+  stl_input_iterator<std::string> fbegin(filenames), fend;
+  std::vector<std::string> vfilenames(fbegin, fend);
+  return boost::make_shared<bob::io::ImageLoader>(vfilenames, layout,
+      n_workers, queue_size, max_height, max_width);
+}
+
+static object loader_next(bob::io::ImageLoader& l) {
+  bool ok;
+  if (l.layout() == bob::io::ImageLoader::gray) {
+    blitz::Array<uint8_t,2> data;
+    {
+      bob::python::no_gil unlock;
+      ok = l.next(data);
+    }
+    if (!ok) PYTHON_ERROR(StopIteration, "no more files");
+    return object(data);
+  }
+  blitz::Array<uint8_t,3> data;
+  {
+    bob::python::no_gil unlock;
+    ok = l.next(data);
+  }
+  if (!ok) PYTHON_ERROR(StopIteration, "no more files");
+  return object(data);
+}
+
+static object loader_load(const bob::io::ImageLoader& l,
+    const std::string& filename) {
+  if (l.layout() == bob::io::ImageLoader::gray) {
+    blitz::Array<uint8_t,2> data;
+    {
+      bob::python::no_gil unlock;
+      l.load(filename, data);
+    }
+    return object(data);
+  }
+  blitz::Array<uint8_t,3> data;
+  {
+    bob::python::no_gil unlock;
+    l.load(filename, data);
+  }
+  return object(data);
+}
+
+static inline object pass_through(object const& o) { return o; }
+
+void bind_io_image_loader() {
+
+  enum_<bob::io::ImageLoader::layout_t>("ImageLayout")
+    .value("planar", bob::io::ImageLoader::planar)
+    .value("interleaved", bob::io::ImageLoader::interleaved)
+    .value("gray", bob::io::ImageLoader::gray)
+    ;
+
+  class_<bob::io::ImageLoader, boost::shared_ptr<bob::io::ImageLoader>, boost::noncopyable>("ImageLoader", "Decodes a list of 8-bit image files on a pool of background workers. Decoded images are kept in a bounded queue and delivered in file order, so that decoding the next files overlaps with the processing of the current one.\n\nAll images are delivered in the same layout: ``planar`` (color-bands, height, width), as bob.io.load() returns color images; ``interleaved`` (height, width, color-bands); ``gray`` (height, width). Gray-scale images are replicated on the three color bands and color images are converted to gray with the weights of libjpeg (0.299 R + 0.587 G + 0.114 B).\n\nJPEG and PNG files are decoded straight into the delivered arrays, letting the decoders do the color conversions. If ``max_height`` or ``max_width`` are set, JPEG images are also scaled down while decoding, by the largest factor (2, 4 or 8) that keeps them at least that large. Other formats are read through their regular codecs, at full size.", no_init)
+    .def("__init__", make_constructor(&loader, default_call_policies(), (arg("filenames"), arg("layout")=bob::io::ImageLoader::planar, arg("n_workers")=0, arg("queue_size")=8, arg("max_height")=0, arg("max_width")=0)), "Initializes the loader with a list of image files. ``n_workers`` is the number of background threads (if 0, as many as the machine has cores). Background workers are started on the first read.")
+    .def("__len__", &bob::io::ImageLoader::size)
+    .add_property("layout", &bob::io::ImageLoader::layout, "The layout of the delivered images")
+    .add_property("max_height", &bob::io::ImageLoader::getMaxHeight, "The height requested at most for JPEG images (0 if not limited)")
+    .add_property("max_width", &bob::io::ImageLoader::getMaxWidth, "The width requested at most for JPEG images (0 if not limited)")
+    .add_property("position", &bob::io::ImageLoader::getPosition, "The number of files delivered so far, which is also the index of the next file to be delivered")
+    .add_property("n_workers", &bob::io::ImageLoader::getNumberOfWorkers)
+    .add_property("queue_size", &bob::io::ImageLoader::getQueueSize)
+    .def("start", &bob::io::ImageLoader::start, (arg("self")), "Starts the background workers, if they are not running already.")
+    .def("stop", &bob::io::ImageLoader::stop, (arg("self")), "Stops the background workers and discards decoded files. The next read restarts from the first file.")
+    .def("load", &loader_load, (arg("self"), arg("filename")), "Decodes a single file on the calling thread, with the layout and maximum size of this loader.")
+    .def("next", &loader_next, (arg("self")), "Returns the next image, waiting for it if necessary. Raises StopIteration when all files were delivered.")
+    .def("__iter__", pass_through)
+    ;
+}
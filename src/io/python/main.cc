@@ -38,8 +38,13 @@ void bind_io_exception();
 void bind_io_file();
 void bind_io_hdf5();
 void bind_io_hdf5_extras();
+void bind_io_hdf5_loader();
 void bind_io_datetime();
 
+#if HAVE_IMAGE_LOADER
+void bind_io_image_loader();
+#endif
+
 #if WITH_FFMPEG
 void bind_io_video();
 #endif
@@ -53,8 +58,13 @@ BOOST_PYTHON_MODULE(_io) {
   bind_io_file();
   bind_io_hdf5();
   bind_io_hdf5_extras();
+  bind_io_hdf5_loader();
   bind_io_datetime();
 
+#if HAVE_IMAGE_LOADER
+  bind_io_image_loader();
+#endif
+
 #if WITH_FFMPEG
   bind_io_video();
 #endif
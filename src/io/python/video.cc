@@ -25,6 +25,7 @@
 
 #include <bob/io/VideoReader.h>
 #include <bob/io/VideoWriter.h>
+#include <bob/io/PrefetchingVideoReader.h>
 
 #include <bob/io/VideoUtilities.h>
 #include <bob/core/python/exception.h>
@@ -79,6 +80,8 @@ struct iterator_wrapper {
     class_<bob::io::VideoReader::const_iterator>("VideoReaderIterator", no_init)
       .def("next", next)
       .def("__iter__", pass_through)
+      .def("seek", &bob::io::VideoReader::const_iterator::seek, return_self<>(), (arg("self"), arg("frame")), "Moves the iterator to the given frame, forwards or backwards. The stream is positioned on the closest keyframe before that frame and only the frames in between are decoded.")
+      .add_property("position", &bob::io::VideoReader::const_iterator::cur, "The number of the next frame to be read")
       ;
   }
 
@@ -154,6 +157,13 @@ static object videoreader_getslice (bob::io::VideoReader& v, slice sobj) {
   return py_retval.pyobject();
 }
 
+static tuple videoreader_keyframes(const bob::io::VideoReader& reader) {
+  const std::vector<size_t>& keyframes = reader.keyframes();
+  list retval;
+  for (size_t k=0; k<keyframes.size(); ++k) retval.append(keyframes[k]);
+  return tuple(retval);
+}
+
 static object videoreader_load(bob::io::VideoReader& reader, 
   bool raise_on_error=false) {
   bob::python::py_array tmp(reader.video_type());
@@ -164,21 +174,62 @@ static object videoreader_load(bob::io::VideoReader& reader,
 
 BOOST_PYTHON_FUNCTION_OVERLOADS(videoreader_load_overloads, videoreader_load, 1, 2)
 
+static object prefetcher_next(bob::io::PrefetchingVideoReader& reader,
+    bool raise_on_error) {
+  bob::python::py_array retval(reader.frame_type());
+  bool ok;
+  {
+    bob::python::no_gil unlock;
+    ok = reader.read(retval, raise_on_error);
+  }
+  if (!ok) PYTHON_ERROR(StopIteration, "iteration finished");
+  return retval.pyobject();
+}
+
+static object prefetcher_iter_next(bob::io::PrefetchingVideoReader& reader) {
+  return prefetcher_next(reader, false);
+}
+
 static void videowriter_append(bob::io::VideoWriter& writer, object a) {
   bob::python::convert_t result = bob::python::convertible_to(a, writer.frame_type(),
       false, true);
   if (result != bob::python::IMPOSSIBLE) {
     bob::python::dtype dtype(writer.frame_type().dtype);
     bob::python::py_array tmp(a, dtype.self());
+    bob::python::no_gil unlock;
     writer.append(tmp);
   }
   else {
     bob::python::dtype dtype(writer.video_type().dtype);
     bob::python::py_array tmp(a, dtype.self());
+    bob::python::no_gil unlock;
     writer.append(tmp);
   }
 }
 
+static void videowriter_flush(bob::io::VideoWriter& writer) {
+  bob::python::no_gil unlock;
+  writer.flush();
+}
+
+static void videowriter_close(bob::io::VideoWriter& writer) {
+  bob::python::no_gil unlock;
+  writer.close();
+}
+
+static dict videowriter_statistics(const bob::io::VideoWriter& writer) {
+  bob::io::VideoWriter::Statistics stats = writer.statistics();
+  dict retval;
+  retval["frames"] = stats.frames;
+  retval["encoding_time"] = stats.encoding_time;
+  retval["throughput"] = stats.encoding_time > 0. ?
+    stats.frames / stats.encoding_time : 0.;
+  retval["mean_latency"] = stats.mean_latency;
+  retval["max_latency"] = stats.max_latency;
+  retval["blocked_time"] = stats.blocked_time;
+  return retval;
+}
+
 /**
  * Describes a given codec or returns an empty dictionary, in case the codec
  * cannot be accessed
@@ -426,7 +477,7 @@ void bind_io_video() {
   iterator_wrapper().wrap(); //wraps bob::io::VideoReader::const_iterator
 
   class_<bob::io::VideoReader, boost::shared_ptr<bob::io::VideoReader> >("VideoReader",
-      "VideoReader objects can read data from video files. The current implementation uses `FFmpeg <http://ffmpeg.org>`_ (or `libav <http://libav.org>`_ if FFmpeg is not available) which is a stable freely available video encoding and decoding library, designed specifically for these tasks. You can read an entire video in memory by using the 'load()' method or use video iterators to read it frame by frame and avoid overloading your machine's memory. The maximum precision data `FFmpeg` will yield is a 24-bit (8-bit per band) representation of each pixel (32-bit depths are also supported by `FFmpeg`, but not by Bob presently). So, the input of data using this class uses ``uint8`` as base element type. Output will be colored using the RGB standard, with each band varying between 0 and 255, with zero meaning pure black and 255, pure white (color).", init<const std::string&, optional<bool> >((arg("self"), arg("filename"), arg("check")=true), "Initializes a new VideoReader object by giving the input file path to read. Format and codec will be extracted from the video metadata, automatically, by ``FFmpeg``. By default, if the format and/or the codec are not supported by this version of Bob, an exception will be raised. You can (at your own risk) set the ``check`` to ``False`` to avoid this check."))
+      "VideoReader objects can read data from video files. The current implementation uses `FFmpeg <http://ffmpeg.org>`_ (or `libav <http://libav.org>`_ if FFmpeg is not available) which is a stable freely available video encoding and decoding library, designed specifically for these tasks. You can read an entire video in memory by using the 'load()' method or use video iterators to read it frame by frame and avoid overloading your machine's memory. The maximum precision data `FFmpeg` will yield is a 24-bit (8-bit per band) representation of each pixel (32-bit depths are also supported by `FFmpeg`, but not by Bob presently). So, the input of data using this class uses ``uint8`` as base element type. Output will be colored using the RGB standard, with each band varying between 0 and 255, with zero meaning pure black and 255, pure white (color).", init<const std::string&, optional<bool, bool> >((arg("self"), arg("filename"), arg("check")=true, arg("cache_index")=false), "Initializes a new VideoReader object by giving the input file path to read. Format and codec will be extracted from the video metadata, automatically, by ``FFmpeg``. By default, if the format and/or the codec are not supported by this version of Bob, an exception will be raised. You can (at your own risk) set the ``check`` to ``False`` to avoid this check. If ``cache_index`` is set, the keyframe index is saved next to the video file (with the extension ``.keyframes`` appended) and re-used the next time the video is opened."))
     .add_property("filename", make_function(&bob::io::VideoReader::filename, return_value_policy<copy_const_reference>()), "The full path to the file that will be decoded by this object")
     .add_property("height", &bob::io::VideoReader::height, "The height of each frame in the video (a multiple of 2)")
     .add_property("width", &bob::io::VideoReader::width, "The width of each frame in the video (a multiple of 2)")
@@ -441,15 +492,50 @@ void bind_io_video() {
     .add_property("info", make_function(&bob::io::VideoReader::info, return_value_policy<copy_const_reference>()), "Informative string containing many details of this video and available ffmpeg bindings that will read it")
     .add_property("video_type", make_function(&bob::io::VideoReader::video_type, return_value_policy<copy_const_reference>()), "Typing information to load all of the file at once")
     .add_property("frame_type", make_function(&bob::io::VideoReader::frame_type, return_value_policy<copy_const_reference>()), "Typing information to load the file frame by frame.")
+    .add_property("cache_index", &bob::io::VideoReader::cacheIndex, "If the keyframe index is saved next to the video file")
+    .add_property("keyframes", &videoreader_keyframes, "The numbers of the keyframes in the video stream, from which decoding can start after a seek. Indexing or slicing the reader seeks to the closest keyframe before each requested frame, so that reading every N-th frame or jumping into long videos only decodes the frames that are needed. The index is built by scanning the whole file (without decoding it) the first time it is needed.")
     .def("__load__", &videoreader_load, videoreader_load_overloads((arg("self"), arg("raise_on_error")=false), "Loads all of the video stream in a numpy ndarray organized in this way: (frames, color-bands, height, width). I'll dynamically allocate the output array and return it to you. The flag ``raise_on_error``, which is set to ``False`` by default influences the error reporting in case problems are found with the video file. If you set it to ``True``, we will report problems raising exceptions. If you either don't set it or set it to ``False``, we will truncate the file at the frame with problems and will not report anything. It is your task to verify if the number of frames returned matches the expected number of frames as reported by the property ``number_of_frames`` in this object."))
     .def("__iter__", &bob::io::VideoReader::begin, with_custodian_and_ward_postcall<0,1>())
     .def("__getitem__", &videoreader_getitem)
     .def("__getitem__", &videoreader_getslice)
     ;
 
+  enum_<bob::io::PrefetchingVideoReader::layout_t>("VideoLayout")
+    .value("planar", bob::io::PrefetchingVideoReader::planar)
+    .value("interleaved", bob::io::PrefetchingVideoReader::interleaved)
+    .value("gray", bob::io::PrefetchingVideoReader::gray)
+    ;
+
+  enum_<bob::io::PrefetchingVideoReader::scaler_t>("VideoScaler")
+    .value("bicubic", bob::io::PrefetchingVideoReader::bicubic)
+    .value("bilinear", bob::io::PrefetchingVideoReader::bilinear)
+    .value("fast_bilinear", bob::io::PrefetchingVideoReader::fast_bilinear)
+    .value("area", bob::io::PrefetchingVideoReader::area)
+    .value("point", bob::io::PrefetchingVideoReader::point)
+    ;
+
+  class_<bob::io::PrefetchingVideoReader, boost::shared_ptr<bob::io::PrefetchingVideoReader>, boost::noncopyable>("PrefetchingVideoReader",
+      "Reads a video sequentially, decoding frames ahead on a background thread and keeping them in a bounded queue, so that decoding overlaps with the processing of the current frame. The codec may also use several threads, if it supports it.\n\nFrames are delivered in one of these layouts: ``planar`` (color-bands, height, width), as VideoReader does; ``interleaved`` (height, width, color-bands), which avoids re-ordering the output of the color conversion; ``gray`` (height, width), holding the luminance plane of the decoded pictures without any color conversion (values are then in the range used by the codec, mostly [16, 235]).\n\nThe color conversion uses bicubic interpolation of the chroma planes by default, as VideoReader does. Cheaper methods (e.g. ``fast_bilinear``) give slightly different colors.",
+      init<const std::string&, optional<bob::io::PrefetchingVideoReader::layout_t, size_t, size_t, bob::io::PrefetchingVideoReader::scaler_t, bool> >((arg("self"), arg("filename"), arg("layout")=bob::io::PrefetchingVideoReader::planar, arg("queue_size")=8, arg("n_threads")=0, arg("scaler")=bob::io::PrefetchingVideoReader::bicubic, arg("check")=true), "Opens a video file for reading. ``n_threads`` is the number of threads the codec may use (if 0, as many as the machine has cores). The ``check`` flag works as for VideoReader. Decoding starts on the first read."))
+    .add_property("video", make_function(&bob::io::PrefetchingVideoReader::video, return_internal_reference<>()), "The VideoReader describing the video being read")
+    .add_property("number_of_frames", &bob::io::PrefetchingVideoReader::numberOfFrames, "The number of frames in this video file")
+    .def("__len__", &bob::io::PrefetchingVideoReader::numberOfFrames)
+    .add_property("layout", &bob::io::PrefetchingVideoReader::layout, "The layout of the delivered frames")
+    .add_property("scaler", &bob::io::PrefetchingVideoReader::scaler, "The interpolation method of the color conversion")
+    .add_property("frame_type", make_function(&bob::io::PrefetchingVideoReader::frame_type, return_value_policy<copy_const_reference>()), "Typing information of the delivered frames")
+    .add_property("n_threads", &bob::io::PrefetchingVideoReader::getNumberOfThreads, "The number of threads the codec may use")
+    .add_property("queue_size", &bob::io::PrefetchingVideoReader::getQueueSize, "The maximum number of decoded frames kept ready")
+    .add_property("position", &bob::io::PrefetchingVideoReader::getPosition, "The number of frames delivered so far")
+    .def("start", &bob::io::PrefetchingVideoReader::start, (arg("self")), "Starts decoding in the background, if not running already.")
+    .def("stop", &bob::io::PrefetchingVideoReader::stop, (arg("self")), "Stops decoding and discards decoded frames. The next read restarts from the first frame.")
+    .def("read", &prefetcher_next, (arg("self"), arg("raise_on_error")=false), "Returns the next frame, waiting for it if necessary. Raises StopIteration at the end of the video. As for VideoReader, decoding errors truncate the video unless ``raise_on_error`` is set to ``True``.")
+    .def("next", &prefetcher_iter_next, (arg("self")), "Returns the next frame, see read().")
+    .def("__iter__", pass_through)
+    ;
+
   class_<bob::io::VideoWriter, boost::shared_ptr<bob::io::VideoWriter>, boost::noncopyable>("VideoWriter",
      "Use objects of this class to create and write video files using `FFmpeg <http://ffmpeg.org>`_ (or `libav <http://libav.org>`_ if FFmpeg is not available).",
-     init<const std::string&, size_t, size_t, optional<float, float, size_t, const std::string&, const std::string&, bool> >((arg("self"), arg("filename"), arg("height"), arg("width"), arg("framerate")=25., arg("bitrate")=1500000., arg("gop")=12, arg("codec")="", arg("format")="", arg("check")=true), "Creates a new output file given the input parameters. The format and codec to be used will be derived from the filename extension unless you define them explicetly (you can set both or just one of these two optional parameters)")
+     init<const std::string&, size_t, size_t, optional<float, float, size_t, const std::string&, const std::string&, bool, size_t, size_t> >((arg("self"), arg("filename"), arg("height"), arg("width"), arg("framerate")=25., arg("bitrate")=1500000., arg("gop")=12, arg("codec")="", arg("format")="", arg("check")=true, arg("queue_size")=0, arg("n_threads")=1), "Creates a new output file given the input parameters. The format and codec to be used will be derived from the filename extension unless you define them explicetly (you can set both or just one of these two optional parameters). If ``queue_size`` is greater than zero, appended frames are copied into a queue of that size and encoded by a dedicated thread, so that ``append()`` only blocks when the queue is full; encoding errors are then raised by the next call to ``append()``, ``flush()`` or ``close()``. ``n_threads`` is the number of threads the codec may use, if it supports it (if 0, as many as the machine has cores).")
      )
     .add_property("filename", make_function(&bob::io::VideoReader::filename, return_value_policy<copy_const_reference>()), "The full path to the file that will be encoded by this object")
     .add_property("height", &bob::io::VideoWriter::height, "The height of the output video file (must be a multiple of 2)")
@@ -466,10 +552,14 @@ void bind_io_video() {
     .add_property("gop", &bob::io::VideoWriter::gop, "Group of pictures setting (see the `Wikipedia entry <http://en.wikipedia.org/wiki/Group_of_pictures>`_ for details on this setting)")
     .add_property("info", &bob::io::VideoWriter::info, "Informative string containing many details of this video and available ffmpeg bindings that will read it")
     .add_property("is_opened", &bob::io::VideoWriter::is_opened, "A boolean flag, indicating if the video is still opened for writing (or has already been closed by the user using ``close()``)")
-    .def("close", &bob::io::VideoWriter::close, (arg("self")), "Closes the current video stream and forces writing the trailer. After this point the video is finalized and cannot be written to anymore.")
+    .def("close", &videowriter_close, (arg("self")), "Closes the current video stream and forces writing the trailer. After this point the video is finalized and cannot be written to anymore. Frames still queued are encoded first.")
+    .def("flush", &videowriter_flush, (arg("self")), "Waits until all queued frames are encoded.")
+    .add_property("queue_size", &bob::io::VideoWriter::getQueueSize, "The maximum number of frames waiting to be encoded in the background (zero if frames are encoded as they are appended)")
+    .add_property("n_threads", &bob::io::VideoWriter::getNumberOfThreads, "The number of threads the codec may use")
+    .add_property("statistics", &videowriter_statistics, "A dictionary with statistics about the frames encoded so far: the number of ``frames``, the ``encoding_time`` spent converting and encoding them and the resulting ``throughput`` (in frames per second), the ``mean_latency`` and ``max_latency`` between the call to ``append()`` and the frame being encoded and the ``blocked_time`` ``append()`` waited for room in the queue (all times in seconds)")
     .add_property("video_type", make_function(&bob::io::VideoWriter::video_type, return_value_policy<copy_const_reference>()), "Typing information to load all of the file at once")
     .add_property("frame_type", make_function(&bob::io::VideoWriter::frame_type, return_value_policy<copy_const_reference>()), "Typing information to load the file frame by frame.")
-    .def("append", &videowriter_append, (arg("self"), arg("frame")), "Writes a new frame or set of frames to the file. The frame should be setup as a array with 3 dimensions organized in this way (RGB color-bands, height, width). Sets of frames should be setup as a 4D array in this way: (frame-number, RGB color-bands, height, width).\n\n.. note::\n\n  At present time we only support arrays that have C-style storages (if you pass reversed arrays or arrays with Fortran-style storage, the result is undefined).")
+    .def("append", &videowriter_append, (arg("self"), arg("frame")), "Writes a new frame or set of frames to the file. The frame should be setup as a array with 3 dimensions organized in this way (RGB color-bands, height, width). Sets of frames should be setup as a 4D array in this way: (frame-number, RGB color-bands, height, width). Interleaved frames (height, width, RGB color-bands), or sets of them, and single gray-scale frames (height, width) are also accepted, and converted to the encoder format without re-ordering. Sets of gray-scale frames are not: 3D arrays are always taken as color frames.\n\n.. note::\n\n  At present time we only support arrays that have C-style storages (if you pass reversed arrays or arrays with Fortran-style storage, the result is undefined).")
     ;
 
   def("available_video_codecs", &available_codec_dictionary, "Returns a dictionary containing a detailed description of the built-in codecs for videos that are available but **not necessarily supported**");
@@ -98,4 +98,22 @@ bob::ip::FaceEyesNorm::operator!=(const bob::ip::FaceEyesNorm& b) const
   return !(this->operator==(b));
 }
 
+const bob::ip::GeomNorm& 
+bob::ip::FaceEyesNorm::setupGeomNorm(const double e1_y, const double e1_x,
+  const double e2_y, const double e2_x, double& center_y, 
+  double& center_x) const
+{
+  // Get angle to horizontal
+  m_cache_angle = getAngleToHorizontal(e1_y, e1_x, e2_y, e2_x) - m_eyes_angle;
+  m_geom_norm->setRotationAngle(m_cache_angle);
+
+  // Get scaling factor
+  m_cache_scale = m_eyes_distance / sqrt( (e1_y-e2_y)*(e1_y-e2_y) + (e1_x-e2_x)*(e1_x-e2_x) );
+  m_geom_norm->setScalingFactor(m_cache_scale);
 
+  // Get the center (of the eye centers segment)
+  center_y = (e1_y + e2_y) / 2.;
+  center_x = (e1_x + e2_x) / 2.;
+
+  return *m_geom_norm;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file ip/cxx/FaceNormPipeline.cc
+ * @date Sun Oct 18 14:05:31 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implementation of the fused face preprocessing pipeline
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <boost/make_shared.hpp>
+#include "bob/core/Exception.h"
+#include "bob/ip/FaceNormPipeline.h"
+
+bob::ip::FaceNormPipeline::FaceNormPipeline(
+    const bob::ip::FaceEyesNorm& face_eyes_norm,
+    const bob::ip::TanTriggs& tan_triggs, const size_t tile_height):
+  m_face_eyes_norm(face_eyes_norm), m_tan_triggs(tan_triggs),
+  m_features(None), m_tile_height(tile_height), m_n_threads(1)
+{
+  setTileHeight(tile_height);
+}
+
+bob::ip::FaceNormPipeline::FaceNormPipeline(
+    const bob::ip::FaceEyesNorm& face_eyes_norm,
+    const bob::ip::TanTriggs& tan_triggs, const bob::ip::LBP& lbp,
+    const size_t tile_height):
+  m_face_eyes_norm(face_eyes_norm), m_tan_triggs(tan_triggs),
+  m_features(LBPCodes), m_lbp(lbp.clone()), m_tile_height(tile_height),
+  m_n_threads(1)
+{
+  setTileHeight(tile_height);
+}
+
+bob::ip::FaceNormPipeline::FaceNormPipeline(
+    const bob::ip::FaceEyesNorm& face_eyes_norm,
+    const bob::ip::TanTriggs& tan_triggs,
+    const bob::ip::DCTFeatures& dct_features, const size_t tile_height):
+  m_face_eyes_norm(face_eyes_norm), m_tan_triggs(tan_triggs),
+  m_features(DCTBlocks),
+  m_dct_features(boost::make_shared<bob::ip::DCTFeatures>(dct_features)),
+  m_tile_height(tile_height), m_n_threads(1)
+{
+  setTileHeight(tile_height);
+}
+
+bob::ip::FaceNormPipeline::FaceNormPipeline(
+    const bob::ip::FaceNormPipeline& other):
+  m_face_eyes_norm(other.m_face_eyes_norm),
+  m_tan_triggs(other.m_tan_triggs),
+  m_features(other.m_features),
+  m_tile_height(other.m_tile_height),
+  m_n_threads(other.m_n_threads)
+{
+  if (other.m_lbp) m_lbp = other.m_lbp->clone();
+  if (other.m_dct_features)
+    m_dct_features = boost::make_shared<bob::ip::DCTFeatures>(
+        *other.m_dct_features);
+  init();
+}
+
+bob::ip::FaceNormPipeline::~FaceNormPipeline() { }
+
+bob::ip::FaceNormPipeline&
+bob::ip::FaceNormPipeline::operator=(const bob::ip::FaceNormPipeline& other)
+{
+  if (this != &other)
+  {
+    m_face_eyes_norm = other.m_face_eyes_norm;
+    m_tan_triggs = other.m_tan_triggs;
+    m_features = other.m_features;
+    m_lbp.reset();
+    if (other.m_lbp) m_lbp = other.m_lbp->clone();
+    m_dct_features.reset();
+    if (other.m_dct_features)
+      m_dct_features = boost::make_shared<bob::ip::DCTFeatures>(
+          *other.m_dct_features);
+    m_tile_height = other.m_tile_height;
+    m_n_threads = other.m_n_threads;
+    init();
+  }
+  return *this;
+}
+
+void bob::ip::FaceNormPipeline::setTileHeight(const size_t tile_height)
+{
+  if (tile_height == 0)
+    throw bob::core::InvalidArgumentException("tile_height", tile_height,
+        (size_t)1, std::numeric_limits<size_t>::max());
+  m_tile_height = tile_height;
+  init();
+}
+
+void bob::ip::FaceNormPipeline::setNThreads(const size_t n_threads)
+{
+  m_n_threads = std::max(n_threads, (size_t)1);
+}
+
+void bob::ip::FaceNormPipeline::init()
+{
+  const int R = m_tan_triggs.getRadius();
+  const int height = m_face_eyes_norm.getCropHeight();
+  const int width = m_face_eyes_norm.getCropWidth();
+
+  m_origin_y.resize(height);
+  m_origin_x.resize(height);
+  m_band.resize(m_tile_height + 2*R, width + 2*R);
+  m_band_inner.reference(m_band(blitz::Range::all(),
+      blitz::Range(R, R + width - 1)));
+  m_image.resize(height, width);
+}
+
+void bob::ip::FaceNormPipeline::checkOutput(const bool lbp_codes) const
+{
+  if (lbp_codes && m_features != LBPCodes)
+    throw bob::core::InvalidArgumentException("LBP codes (uint16) can only be computed by a pipeline with an LBP stage");
+  if (!lbp_codes && m_features == LBPCodes)
+    throw bob::core::InvalidArgumentException("A pipeline with an LBP stage outputs LBP codes (uint16)");
+}
+
+const blitz::TinyVector<int,2>
+bob::ip::FaceNormPipeline::getOutputShape() const
+{
+  switch (m_features) {
+    case LBPCodes:
+      return m_lbp->getLBPShape(m_image);
+    case DCTBlocks:
+      return m_dct_features->get2DOutputShape(m_image);
+    default:
+      return m_image.shape();
+  }
+}
+
+void bob::ip::FaceNormPipeline::setupRows(const double e1_y,
+  const double e1_x, const double e2_y, const double e2_x)
+{
+  double center_y, center_x, origin_y, origin_x;
+  const bob::ip::GeomNorm& geom_norm = m_face_eyes_norm.setupGeomNorm(e1_y,
+      e1_x, e2_y, e2_x, center_y, center_x);
+  geom_norm.getSourceGrid(center_y, center_x, origin_y, origin_x, m_dy, m_dx);
+
+  // same steps as GeomNorm::processNoCheck()
+  for (size_t y = 0; y < m_origin_y.size(); ++y) {
+    m_origin_y[y] = origin_y;
+    m_origin_x[y] = origin_x;
+    origin_x -= m_dy;
+    origin_y += m_dx;
+  }
+}
+
+int bob::ip::FaceNormPipeline::borderIndex(int i, const int size) const
+{
+  if (i >= 0 && i < size) return i;
+
+  // same extrapolation as in bob/sp/extrapolate.h
+  switch (m_tan_triggs.getConvBorder()) {
+    case bob::sp::Extrapolation::Zero:
+      return -1;
+    case bob::sp::Extrapolation::NearestNeighbour:
+      return i < 0 ? 0 : size - 1;
+    case bob::sp::Extrapolation::Circular:
+      return ((i % size) + size) % size;
+    default: // Mirror
+      while (i < 0 || i >= size) i = (i < 0) ? -1 - i : 2 * size - 1 - i;
+      return i;
+  }
+}
+
+void bob::ip::FaceNormPipeline::correctRow(const int b)
+{
+  const int R = m_tan_triggs.getRadius();
+  const int width = m_band_inner.extent(1);
+  const double gamma = m_tan_triggs.getGamma();
+
+  // 1/ gamma correction, as TanTriggs::operator()
+  for (int x = R; x < R + width; ++x) {
+    double& v = m_band(b,x);
+    v = (gamma > 0.) ? pow(v, gamma) : log(1. + v);
+  }
+
+  // extrapolates the border columns of the gamma corrected row
+  for (int x = 0; x < R; ++x) {
+    const int left = borderIndex(x - R, width);
+    const int right = borderIndex(width + x, width);
+    m_band(b,x) = left < 0 ? 0. : m_band(b, R + left);
+    m_band(b, R + width + x) = right < 0 ? 0. : m_band(b, R + right);
+  }
+}
+
+void bob::ip::FaceNormPipeline::filterTile(const int y0, const int y1,
+  blitz::Array<double,2>& image, double& sum)
+{
+  const blitz::Array<double,2>& kernel = m_tan_triggs.getKernel();
+  const int K = kernel.extent(0);
+  const double alpha = m_tan_triggs.getAlpha();
+
+  // 2/ convolution with the DoG filter, summing the products in the same
+  // order as bob::sp::conv() does
+  for (int y = y0; y < y1; ++y) {
+    for (int x = 0; x < image.extent(1); ++x) {
+      double res = 0.;
+      for (int i = 0; i < K; ++i)
+        for (int j = 0; j < K; ++j)
+          res += m_band(y - y0 + i, x + j) * kernel(K-1-i, K-1-j);
+      image(y,x) = res;
+      sum += pow(fabs(res), alpha);
+    }
+  }
+}
+
+void bob::ip::FaceNormPipeline::equalize(blitz::Array<double,2>& image,
+  const double sum) const
+{
+  // 3/ contrast equalization, as TanTriggs::performContrastEqualization()
+  const double alpha = m_tan_triggs.getAlpha();
+  const double threshold = m_tan_triggs.getThreshold();
+  const double inv_alpha = 1./alpha;
+  const double wxh = image.extent(0)*image.extent(1);
+
+  // first step: I:=I/mean(abs(I)^a)^(1/a)
+  // (the sum has been accumulated while filtering)
+  double norm_fact = pow(sum / wxh, inv_alpha);
+
+  // Second step: I:=I/mean(min(threshold,abs(I))^a)^(1/a)
+  const double threshold_alpha = pow(threshold, alpha);
+  double sum2 = 0.;
+  for (int y = 0; y < image.extent(0); ++y)
+    for (int x = 0; x < image.extent(1); ++x) {
+      double& v = image(y,x);
+      v /= norm_fact;
+      const double v_alpha = pow(fabs(v), alpha);
+      sum2 += threshold_alpha < v_alpha ? threshold_alpha : v_alpha;
+    }
+  norm_fact = pow(sum2 / wxh, inv_alpha);
+
+  // Last step: I:= threshold * tanh( I / threshold )
+  for (int y = 0; y < image.extent(0); ++y)
+    for (int x = 0; x < image.extent(1); ++x) {
+      double& v = image(y,x);
+      v /= norm_fact;
+      v = threshold * tanh(v / threshold);
+    }
+}
@@ -22,10 +22,14 @@
 
 #include "bob/core/assert.h"
 #include "bob/core/array_copy.h"
+#include "bob/core/Exception.h"
 #include "bob/ip/GaborWaveletTransform.h"
 #include <numeric>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 static inline double sqr(double x){return x*x;}
 
@@ -179,6 +183,64 @@ void bob::ip::GaborKernel::transform(
   }
 }
 
+/**
+ * Performs the convolution of the given image with this Gabor kernel, only touching the pixels in the support of the kernel.
+ * All other pixels of the output image need to be zero, e.g., by calling clearSupport() after the last transformation.
+ * @param frequency_domain_image
+ * @param transformed_frequency_domain_image
+ */
+void bob::ip::GaborKernel::transformSupport(
+  const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+  blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
+) const
+{
+  // assert same size
+  bob::core::array::assertSameShape(frequency_domain_image, transformed_frequency_domain_image);
+  // iterate through the kernel pixels and do the multiplication
+  std::vector<std::pair<blitz::TinyVector<unsigned,2>, double> >::const_iterator it = m_kernel_pixel.begin(), it_end = m_kernel_pixel.end();
+  for (; it < it_end; ++it){
+    transformed_frequency_domain_image(it->first) = frequency_domain_image(it->first) * it->second;
+  }
+}
+
+/**
+ * Sets the pixels in the support of this Gabor kernel to zero.
+ * @param transformed_frequency_domain_image
+ */
+void bob::ip::GaborKernel::clearSupport(
+  blitz::Array<std::complex<double>,2>& transformed_frequency_domain_image
+) const
+{
+  std::vector<std::pair<blitz::TinyVector<unsigned,2>, double> >::const_iterator it = m_kernel_pixel.begin(), it_end = m_kernel_pixel.end();
+  for (; it < it_end; ++it){
+    transformed_frequency_domain_image(it->first) = std::complex<double>(0);
+  }
+}
+
+/**
+ * Computes the value of the Gabor transformed image in spatial domain at a single position,
+ * i.e., the inverse DFT of the product of image and kernel, which is evaluated in the support of the kernel only.
+ * @param frequency_domain_image  The image in frequency domain
+ * @param row_phases     The phase factors exp(2 pi i u y / height) of the position, for each row u
+ * @param column_phases  The phase factors exp(2 pi i v x / width) of the position, for each column v
+ * @return  The complex-valued response of the kernel at the position
+ */
+std::complex<double> bob::ip::GaborKernel::transformAt(
+  const blitz::Array<std::complex<double>,2>& frequency_domain_image,
+  const blitz::Array<std::complex<double>,1>& row_phases,
+  const blitz::Array<std::complex<double>,1>& column_phases
+) const
+{
+  std::complex<double> response(0.);
+  // iterate through the kernel pixels and accumulate the inverse DFT
+  std::vector<std::pair<blitz::TinyVector<unsigned,2>, double> >::const_iterator it = m_kernel_pixel.begin(), it_end = m_kernel_pixel.end();
+  for (; it < it_end; ++it){
+    response += frequency_domain_image(it->first) * (it->second * row_phases((int)it->first[0]) * column_phases((int)it->first[1]));
+  }
+  // same scaling as in the IFFT
+  return response / (double(m_y_resolution) * double(m_x_resolution));
+}
+
 /**
  * Generates and returns the image for the current kernel.
  * @return The kernel image in frequency domain.
@@ -224,7 +286,8 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_fft(0,0),
   m_ifft(0,0),
   m_number_of_scales(number_of_scales),
-  m_number_of_directions(number_of_directions)
+  m_number_of_directions(number_of_directions),
+  m_number_of_threads(1)
 {
   computeKernelFrequencies();
 }
@@ -241,7 +304,8 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_fft(0,0),
   m_ifft(0,0),
   m_number_of_scales(other.m_number_of_scales),
-  m_number_of_directions(other.m_number_of_directions)
+  m_number_of_directions(other.m_number_of_directions),
+  m_number_of_threads(other.m_number_of_threads)
 {
   computeKernelFrequencies();
 }
@@ -261,6 +325,9 @@ bob::ip::GaborWaveletTransform::operator =
   m_ifft = bob::sp::IFFT2D(0,0);
   m_number_of_scales = other.m_number_of_scales;
   m_number_of_directions = other.m_number_of_directions;
+  m_number_of_threads = other.m_number_of_threads;
+  m_frequency_buffers.clear();
+  m_spatial_buffers.clear();
 
   computeKernelFrequencies();
   
@@ -356,6 +423,247 @@ void bob::ip::GaborWaveletTransform::generateKernels(
     m_ifft.reset(resolution[0], resolution[1]);
     m_temp_array.resize(blitz::shape(resolution[0],resolution[1]));
     m_frequency_image.resize(m_temp_array.shape());
+
+    // the thread buffers are re-allocated on demand
+    m_frequency_buffers.clear();
+    m_spatial_buffers.clear();
+  }
+}
+
+/**
+ * Sets the number of threads that the Gabor kernels are distributed over.
+ * @param number_of_threads  The number of threads; 0 is interpreted as 1
+ */
+void bob::ip::GaborWaveletTransform::setNumberOfThreads(unsigned number_of_threads){
+  m_number_of_threads = std::max(number_of_threads, 1u);
+}
+
+/**
+ * Allocates the buffers that each thread needs for the current resolution.
+ * The frequency buffers are zero everywhere except during the processing of a kernel,
+ * so that only the kernel support needs to be written and cleared afterwards.
+ */
+void bob::ip::GaborWaveletTransform::initThreadBuffers(){
+  unsigned number_of_buffers = std::min<unsigned>(m_number_of_threads, std::max<unsigned>(m_gabor_kernels.size(), 1u));
+  while (m_frequency_buffers.size() < number_of_buffers){
+    blitz::Array<std::complex<double>,2> frequency(m_frequency_image.shape());
+    frequency = std::complex<double>(0);
+    m_frequency_buffers.push_back(frequency);
+    m_spatial_buffers.push_back(blitz::Array<std::complex<double>,2>(m_frequency_image.shape()));
+  }
+}
+
+/**
+ * Processes the kernels (j = t, t+T, t+2T, ...) with thread t of T.
+ * Jobs must not create views of arrays shared between the threads (the
+ * reference counts of blitz arrays are not thread-safe): such views are
+ * created by the calling thread, before the jobs are started.
+ */
+static void processKernels(
+  const boost::function<void (unsigned, unsigned)>& job,
+  unsigned thread,
+  unsigned number_of_threads,
+  unsigned number_of_kernels
+)
+{
+  for (unsigned j = thread; j < number_of_kernels; j += number_of_threads){
+    job(j, thread);
+  }
+}
+
+/**
+ * Calls the given job for all kernels, distributing them over the threads.
+ * The calling thread processes its share of the kernels as well.
+ * @param job  The function to call, with the kernel index and the thread index as parameters
+ */
+void bob::ip::GaborWaveletTransform::forEachKernel(
+  const boost::function<void (unsigned, unsigned)>& job
+) const
+{
+  unsigned number_of_kernels = m_gabor_kernels.size();
+  unsigned number_of_threads = std::min<unsigned>(m_frequency_buffers.size(), number_of_kernels);
+  if (number_of_threads <= 1){
+    processKernels(job, 0, 1, number_of_kernels);
+    return;
+  }
+
+  boost::thread_group threads;
+  for (unsigned t = 1; t < number_of_threads; ++t){
+    threads.create_thread(boost::bind(&processKernels, boost::cref(job), t, number_of_threads, number_of_kernels));
+  }
+  processKernels(job, 0, number_of_threads, number_of_kernels);
+  threads.join_all();
+}
+
+/**
+ * Computes the Fourier transform of the given image into m_frequency_image,
+ * after the kernels and buffers have been prepared for its resolution.
+ */
+template <typename I>
+void bob::ip::GaborWaveletTransform::forwardTransform(
+  const blitz::Array<I,2>& gray_image
+)
+{
+  // first, check if we need to reset the kernels
+  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
+  initThreadBuffers();
+
+  // perform Fourier transformation to image
+  m_fft(gray_image, m_frequency_image);
+}
+
+/**
+ * Computes the response of the given kernel in spatial domain, using the buffer of the given thread.
+ * @param kernel    The index of the Gabor kernel
+ * @param thread    The index of the thread
+ * @param response  The complex-valued kernel response (C-contiguous)
+ */
+void bob::ip::GaborWaveletTransform::kernelResponse(
+  unsigned kernel,
+  unsigned thread,
+  blitz::Array<std::complex<double>,2>& response
+) const
+{
+  // the buffers of a thread are only referenced by that thread
+  blitz::Array<std::complex<double>,2> frequency(m_frequency_buffers[thread]);
+  m_gabor_kernels[kernel].transformSupport(m_frequency_image, frequency);
+  m_ifft(frequency, response);
+  // leave the buffer zero for the next kernel
+  m_gabor_kernels[kernel].clearSupport(frequency);
+}
+
+void bob::ip::GaborWaveletTransform::trafoLayer(
+  unsigned kernel,
+  unsigned thread,
+  std::vector<blitz::Array<std::complex<double>,2> >& layers
+) const
+{
+  // the inverse FFT is computed directly into the current layer of the trafo image
+  kernelResponse(kernel, thread, layers[kernel]);
+}
+
+template <typename J>
+void bob::ip::GaborWaveletTransform::jetLayer(
+  unsigned kernel,
+  unsigned thread,
+  std::vector<blitz::Array<J,2> >& abs_parts,
+  std::vector<blitz::Array<J,2> >& phase_parts
+) const
+{
+  blitz::Array<std::complex<double>,2> response(m_spatial_buffers[thread]);
+  kernelResponse(kernel, thread, response);
+  // convert into absolute and phase part
+  abs_parts[kernel] = blitz::cast<J>(blitz::abs(response));
+  if (!phase_parts.empty()){
+    phase_parts[kernel] = blitz::cast<J>(blitz::arg(response));
+  }
+}
+
+/**
+ * Creates the views of the layers of the given trafo image, one per kernel.
+ */
+static void trafoLayers(
+  blitz::Array<std::complex<double>,3>& trafo_image,
+  std::vector<blitz::Array<std::complex<double>,2> >& layers
+)
+{
+  layers.resize(trafo_image.extent(0));
+  for (int j = 0; j < trafo_image.extent(0); ++j){
+    layers[j].reference(trafo_image(j, blitz::Range::all(), blitz::Range::all()));
+  }
+}
+
+/**
+ * Creates the views of the absolute values and phases of the given jet image, one per kernel.
+ */
+template <typename J>
+static void jetLayers(
+  blitz::Array<J,4>& jet_image,
+  std::vector<blitz::Array<J,2> >& abs_parts,
+  std::vector<blitz::Array<J,2> >& phase_parts
+)
+{
+  blitz::Range all = blitz::Range::all();
+  abs_parts.resize(jet_image.extent(3));
+  phase_parts.resize(jet_image.extent(3));
+  for (int j = 0; j < jet_image.extent(3); ++j){
+    abs_parts[j].reference(jet_image(all, all, 0, j));
+    phase_parts[j].reference(jet_image(all, all, 1, j));
+  }
+}
+
+template <typename J>
+static void jetLayers(
+  blitz::Array<J,3>& jet_image,
+  std::vector<blitz::Array<J,2> >& abs_parts,
+  std::vector<blitz::Array<J,2> >& phase_parts
+)
+{
+  blitz::Range all = blitz::Range::all();
+  abs_parts.resize(jet_image.extent(2));
+  phase_parts.clear();
+  for (int j = 0; j < jet_image.extent(2); ++j){
+    abs_parts[j].reference(jet_image(all, all, j));
+  }
+}
+
+/**
+ * Normalizes all Gabor jets of the given jet image.
+ */
+template <typename J>
+static void normalizeJetImage(blitz::Array<J,4>& jet_image){
+  // iterate the positions
+  for (int y = jet_image.extent(0); y--;){
+    for (int x = jet_image.extent(1); x--;){
+      // normalize jet
+      blitz::Array<J,2> jet(jet_image(y,x,blitz::Range::all(),blitz::Range::all()));
+      bob::ip::normalizeGaborJet(jet);
+    }
+  }
+}
+
+template <typename J>
+static void normalizeJetImage(blitz::Array<J,3>& jet_image){
+  // iterate the positions
+  for (int y = jet_image.extent(0); y--;){
+    for (int x = jet_image.extent(1); x--;){
+      // normalize jet
+      blitz::Array<J,1> jet(jet_image(y,x,blitz::Range::all()));
+      bob::ip::normalizeGaborJet(jet);
+    }
+  }
+}
+
+/**
+ * Computes the Gabor jet image for the given image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param jet_image   The resulting Gabor jet image, either 4D (absolute values and phases) or 3D (absolute values only)
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+template <typename I, typename J, int N>
+void bob::ip::GaborWaveletTransform::jetImage(
+  const blitz::Array<I,2>& gray_image,
+  blitz::Array<J,N>& jet_image,
+  bool do_normalize
+)
+{
+  forwardTransform(gray_image);
+
+  // check that the shape is correct
+  blitz::TinyVector<int,N> shape;
+  shape(0) = gray_image.extent(0);
+  shape(1) = gray_image.extent(1);
+  if (N == 4) shape(2) = 2;
+  shape(N-1) = m_kernel_frequencies.size();
+  bob::core::array::assertSameShape(jet_image, shape);
+
+  // now, let each kernel compute the transformation result
+  std::vector<blitz::Array<J,2> > abs_parts, phase_parts;
+  jetLayers(jet_image, abs_parts, phase_parts);
+  forEachKernel(boost::bind(&bob::ip::GaborWaveletTransform::jetLayer<J>, this, _1, _2, boost::ref(abs_parts), boost::ref(phase_parts)));
+
+  if (do_normalize){
+    normalizeJetImage(jet_image);
   }
 }
 
@@ -373,6 +681,109 @@ blitz::Array<double,3> bob::ip::GaborWaveletTransform::kernelImages() const{
   return res;
 }
 
+/**
+ * Computes the phase factors of the given position for the inverse DFT.
+ */
+static void phaseFactors(int position, int resolution, blitz::Array<std::complex<double>,1>& phases){
+  if (phases.extent(0) != resolution) phases.resize(resolution);
+  for (int u = 0; u < resolution; ++u){
+    // use integer arithmetics to keep the angle in [0, 2 pi)
+    phases(u) = std::polar(1., 2. * M_PI * ((long)u * position % resolution) / resolution);
+  }
+}
+
+void bob::ip::GaborWaveletTransform::positionLayer(
+  unsigned kernel,
+  unsigned,
+  blitz::Array<double,3>& jets
+) const
+{
+  for (int n = 0; n < jets.extent(0); ++n){
+    std::complex<double> response = m_gabor_kernels[kernel].transformAt(m_frequency_image, m_row_phases[n], m_column_phases[n]);
+    jets(n, 0, (int)kernel) = std::abs(response);
+    jets(n, 1, (int)kernel) = std::arg(response);
+  }
+}
+
+void bob::ip::GaborWaveletTransform::positionLayer(
+  unsigned kernel,
+  unsigned,
+  blitz::Array<double,2>& jets
+) const
+{
+  for (int n = 0; n < jets.extent(0); ++n){
+    jets(n, (int)kernel) = std::abs(m_gabor_kernels[kernel].transformAt(m_frequency_image, m_row_phases[n], m_column_phases[n]));
+  }
+}
+
+/**
+ * Normalizes the Gabor jets, one per row.
+ */
+static void normalizeJets(blitz::Array<double,3>& jets){
+  for (int n = jets.extent(0); n--;){
+    blitz::Array<double,2> jet(jets(n, blitz::Range::all(), blitz::Range::all()));
+    bob::ip::normalizeGaborJet(jet);
+  }
+}
+
+static void normalizeJets(blitz::Array<double,2>& jets){
+  for (int n = jets.extent(0); n--;){
+    blitz::Array<double,1> jet(jets(n, blitz::Range::all()));
+    bob::ip::normalizeGaborJet(jet);
+  }
+}
+
+/**
+ * Computes the Gabor jets at the given positions of the given image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param positions   The (y,x) positions to compute the Gabor jets for, one per row
+ * @param jets        The resulting Gabor jets, either with phases (3D) or without (2D)
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+template <typename I, int N>
+void bob::ip::GaborWaveletTransform::positionJets(
+  const blitz::Array<I,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,N>& jets,
+  bool do_normalize
+)
+{
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  const int count = positions.extent(0);
+
+  // check positions and output shape
+  bob::core::array::assertSameDimensionLength(positions.extent(1), 2);
+  blitz::TinyVector<int,N> shape;
+  shape(0) = count;
+  if (N == 3) shape(1) = 2;
+  shape(N-1) = m_kernel_frequencies.size();
+  bob::core::array::assertSameShape(jets, shape);
+  for (int n = 0; n < count; ++n){
+    if (positions(n,0) < 0 || positions(n,0) >= height)
+      throw bob::core::InvalidArgumentException("positions", positions(n,0), 0, height-1);
+    if (positions(n,1) < 0 || positions(n,1) >= width)
+      throw bob::core::InvalidArgumentException("positions", positions(n,1), 0, width-1);
+  }
+
+  forwardTransform(gray_image);
+
+  // phase factors of the inverse DFT at the positions
+  m_row_phases.resize(count);
+  m_column_phases.resize(count);
+  for (int n = 0; n < count; ++n){
+    phaseFactors(positions(n,0), height, m_row_phases[n]);
+    phaseFactors(positions(n,1), width, m_column_phases[n]);
+  }
+
+  // now, let each kernel compute its responses at the positions
+  void (bob::ip::GaborWaveletTransform::*layer)(unsigned, unsigned, blitz::Array<double,N>&) const = &bob::ip::GaborWaveletTransform::positionLayer;
+  forEachKernel(boost::bind(layer, this, _1, _2, boost::ref(jets)));
+
+  if (do_normalize){
+    normalizeJets(jets);
+  }
+}
+
 /**
  * Computes the Gabor wavelet transformation for the given image (in spatial domain)
  * @param gray_image  The source image in spatial domain
@@ -383,23 +794,37 @@ void bob::ip::GaborWaveletTransform::performGWT(
   blitz::Array<std::complex<double>,3>& trafo_image
 )
 {
-  // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
+  forwardTransform(gray_image);
 
-  // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
+  // check that the shape is correct
+  bob::core::array::assertSameShape(trafo_image, blitz::shape(m_kernel_frequencies.size(),gray_image.extent(0),gray_image.extent(1)));
+
+  // now, let each kernel compute the transformation result
+  std::vector<blitz::Array<std::complex<double>,2> > layers;
+  trafoLayers(trafo_image, layers);
+  forEachKernel(boost::bind(&bob::ip::GaborWaveletTransform::trafoLayer, this, _1, _2, boost::ref(layers)));
+}
+
+/**
+ * Computes the Gabor wavelet transformation for the given real-valued image (in spatial domain).
+ * The spectrum of the image is computed with a real-to-complex FFT.
+ * @param gray_image  The source image in spatial domain
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::GaborWaveletTransform::performGWT(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  forwardTransform(gray_image);
 
   // check that the shape is correct
   bob::core::array::assertSameShape(trafo_image, blitz::shape(m_kernel_frequencies.size(),gray_image.extent(0),gray_image.extent(1)));
 
   // now, let each kernel compute the transformation result
-  for (unsigned j = 0; j < m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array);
-    // perform ifft on the trafo image layer
-    blitz::Array<std::complex<double>,2> layer(trafo_image(j, blitz::Range::all(), blitz::Range::all()));
-    m_ifft(m_temp_array, layer);
-  } // for j
+  std::vector<blitz::Array<std::complex<double>,2> > layers;
+  trafoLayers(trafo_image, layers);
+  forEachKernel(boost::bind(&bob::ip::GaborWaveletTransform::trafoLayer, this, _1, _2, boost::ref(layers)));
 }
 
 /**
@@ -414,38 +839,34 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   bool do_normalize
 )
 {
-  // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
-
-  // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  // check that the shape is correct
-  bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), 2, m_kernel_frequencies.size()));
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<double,4>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  // now, let each kernel compute the transformation result
-  for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array);
-    // perform ifft of transformed image
-    m_ifft(m_temp_array);
-    // convert into absolute and phase part
-    blitz::Array<double,2> abs_part(jet_image(blitz::Range::all(), blitz::Range::all(), 0, j));
-    abs_part = blitz::abs(m_temp_array);
-    blitz::Array<double,2> phase_part(jet_image(blitz::Range::all(), blitz::Range::all(), 1, j));
-    phase_part = blitz::arg(m_temp_array);
-  } // for j
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<float,4>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  if (do_normalize){
-    // iterate the positions
-    for (int y = jet_image.extent(0); y--;){
-      for (int x = jet_image.extent(1); x--;){
-        // normalize jet
-        blitz::Array<double,2> jet(jet_image(y,x,blitz::Range::all(),blitz::Range::all()));
-        bob::ip::normalizeGaborJet(jet);
-      }
-    }
-  }
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<float,4>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
 }
 
 /**
@@ -460,36 +881,89 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   bool do_normalize
 )
 {
-  // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<int,2>(gray_image.extent(0),gray_image.extent(1)));
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<double,3>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  // check that the shape is correct
-  bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), m_kernel_frequencies.size()));
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<float,3>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  // now, let each kernel compute the transformation result
-  for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
-    // get a reference to the current layer of the trafo image
-    m_gabor_kernels[j].transform(m_frequency_image, m_temp_array);
-    // perform ifft of transformed image
-    m_ifft(m_temp_array);
-    // convert into absolute part
-    blitz::Array<double,2> abs_part(jet_image(blitz::Range::all(), blitz::Range::all(), j));
-    abs_part = blitz::abs(m_temp_array);
-  } // for j
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<float,3>& jet_image,
+  bool do_normalize
+)
+{
+  jetImage(gray_image, jet_image, do_normalize);
+}
 
-  if (do_normalize){
-    // iterate the positions
-    for (int y = jet_image.extent(0); y--;){
-      for (int x = jet_image.extent(1); x--;){
-        // normalize jet
-        blitz::Array<double,1> jet(jet_image(y,x,blitz::Range::all()));
-        bob::ip::normalizeGaborJet(jet);
-      }
-    }
-  }
+/**
+ * Computes the Gabor jets including absolute values and phases at the given positions of the given image (in spatial domain).
+ * This is much faster than computing the whole jet image when only few positions are required.
+ * @param gray_image  The source image in spatial domain
+ * @param positions   The (y,x) positions to compute the Gabor jets for, one per row
+ * @param jets        The resulting Gabor jets, including absolute values and phases for each position
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,3>& jets,
+  bool do_normalize
+)
+{
+  positionJets(gray_image, positions, jets, do_normalize);
+}
+
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<double,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,3>& jets,
+  bool do_normalize
+)
+{
+  positionJets(gray_image, positions, jets, do_normalize);
+}
+
+/**
+ * Computes the Gabor jets including absolute values only at the given positions of the given image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param positions   The (y,x) positions to compute the Gabor jets for, one per row
+ * @param jets        The resulting Gabor jets, including only absolute values for each position
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,2>& jets,
+  bool do_normalize
+)
+{
+  positionJets(gray_image, positions, jets, do_normalize);
+}
+
+void bob::ip::GaborWaveletTransform::computeJets(
+  const blitz::Array<double,2>& gray_image,
+  const blitz::Array<int,2>& positions,
+  blitz::Array<double,2>& jets,
+  bool do_normalize
+)
+{
+  positionJets(gray_image, positions, jets, do_normalize);
 }
 
 void bob::ip::GaborWaveletTransform::save(bob::io::HDF5File& file) const{
@@ -535,3 +1009,24 @@ void bob::ip::normalizeGaborJet(blitz::Array<double,2>& gabor_jet){
   // normalize the absolute parts of the jets
   abs_jet /= norm;
 }
+
+/**
+ * Normalizes the given single precision Gabor jet (absolute values only) to unit length.
+ * @param gabor_jet The Gabor jet to be normalized.
+ */
+void bob::ip::normalizeGaborJet(blitz::Array<float,1>& gabor_jet){
+  double norm = sqrt(std::inner_product(gabor_jet.begin(), gabor_jet.end(), gabor_jet.begin(), 0.));
+  // normalize the absolute parts of the jets
+  gabor_jet /= (float)norm;
+}
+
+/**
+ * Normalizes the given single precision Gabor jet to unit length.
+ * @param gabor_jet The Gabor jet to be normalized, including the phase values (which will not be altered).
+ */
+void bob::ip::normalizeGaborJet(blitz::Array<float,2>& gabor_jet){
+  blitz::Array<float,1> abs_jet = gabor_jet(0, blitz::Range::all());
+  double norm = sqrt(std::inner_product(abs_jet.begin(), abs_jet.end(), abs_jet.begin(), 0.));
+  // normalize the absolute parts of the jets
+  abs_jet /= (float)norm;
+}
@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <vector>
 #include "bob/ip/Gaussian.h"
 
 void bob::ip::Gaussian::computeKernel()
@@ -83,36 +84,112 @@ bob::ip::Gaussian::operator!=(const bob::ip::Gaussian& b) const
   return !(this->operator==(b));
 }
 
+/**
+ * @brief Index of the element of an array of the given size that is used at
+ * index i, once the array is extrapolated as in bob/sp/extrapolate.h, or -1
+ * for zeros.
+ */
+static int extrapolatedIndex(int i, const int size, 
+  const bob::sp::Extrapolation::BorderType border_type)
+{
+  if (i >= 0 && i < size) return i;
+  switch (border_type)
+  {
+    case bob::sp::Extrapolation::Zero:
+      return -1;
+    case bob::sp::Extrapolation::NearestNeighbour:
+      return i < 0 ? 0 : size - 1;
+    case bob::sp::Extrapolation::Circular:
+      return ((i % size) + size) % size;
+    default: // Mirror
+      while (i < 0 || i >= size) i = (i < 0) ? -1 - i : 2 * size - 1 - i;
+      return i;
+  }
+}
+
+void bob::ip::detail::gaussianConvY(const blitz::Array<double,2>& src,
+  const blitz::Array<double,1>& kernel, blitz::Array<double,2>& dst,
+  const bob::sp::Extrapolation::BorderType border_type,
+  const int y_begin, const int y_end)
+{
+  const int K = kernel.extent(0);
+  const int R = K / 2;
+  const int height = src.extent(0);
+  const int width = src.extent(1);
+  const int src_stride = src.stride(1);
+  const int dst_stride = dst.stride(1);
+
+  for (int y = y_begin; y < y_end; ++y)
+  {
+    // sums the products in the same order as bob::sp::conv(), one
+    // (extrapolated) input row at a time
+    double* d = &dst(y,0);
+    for (int x = 0; x < width; ++x) d[x*dst_stride] = 0.;
+    for (int k = 0; k < K; ++k)
+    {
+      const int j = extrapolatedIndex(y + k - R, height, border_type);
+      if (j < 0) continue;
+      const double w = kernel(K-1-k);
+      const double* s = &src(j,0);
+      for (int x = 0; x < width; ++x) 
+        d[x*dst_stride] += s[x*src_stride] * w;
+    }
+  }
+}
+
+void bob::ip::detail::gaussianConvX(const blitz::Array<double,2>& src,
+  const blitz::Array<double,1>& kernel, blitz::Array<double,2>& dst,
+  const bob::sp::Extrapolation::BorderType border_type,
+  const int y_begin, const int y_end)
+{
+  const int K = kernel.extent(0);
+  const int R = K / 2;
+  const int width = src.extent(1);
+  const int src_stride = src.stride(1);
+  const int dst_stride = dst.stride(1);
+
+  // reversed kernel, and input column of each (extrapolated) column
+  std::vector<double> w(K);
+  for (int k = 0; k < K; ++k) w[k] = kernel(K-1-k);
+  std::vector<int> index(width + K - 1);
+  for (int j = 0; j < width + K - 1; ++j)
+    index[j] = extrapolatedIndex(j - R, width, border_type);
+
+  for (int y = y_begin; y < y_end; ++y)
+  {
+    const double* s = &src(y,0);
+    double* d = &dst(y,0);
+    for (int x = 0; x < width; ++x)
+    {
+      const int* ind = &index[x];
+      double res = 0.;
+      for (int k = 0; k < K; ++k)
+        if (ind[k] >= 0) res += s[ind[k]*src_stride] * w[k];
+      d[x*dst_stride] = res;
+    }
+  }
+}
+
 template <>
 void bob::ip::Gaussian::operator()<double>(const blitz::Array<double,2>& src,
    blitz::Array<double,2>& dst)
 {
-  // Checks are postponed to the convolution function.
-  if(m_conv_border == bob::sp::Extrapolation::Zero)
+  bob::core::array::assertZeroBase(src);
+  bob::core::array::assertZeroBase(dst);
+  bob::core::array::assertSameShape(src, dst);
+  // Without extrapolation, the kernels should fit in the image, as for
+  // bob::sp::convSep()
+  if (m_conv_border == bob::sp::Extrapolation::Zero)
   {
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Same));
-    bob::sp::convSep(src, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Same);
-    bob::sp::convSep(m_tmp_int, m_kernel_x, dst, 1, bob::sp::Conv::Same);
+    if (src.extent(0) < m_kernel_y.extent(0))
+      throw bob::sp::ConvolutionKernelTooLarge(0, src.extent(0), m_kernel_y.extent(0));
+    if (src.extent(1) < m_kernel_x.extent(0))
+      throw bob::sp::ConvolutionKernelTooLarge(1, src.extent(1), m_kernel_x.extent(0));
   }
-  else
-  {
-    m_tmp_int1.resize(bob::sp::getConvSepOutputSize(src, m_kernel_y, 0, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(src, m_tmp_int1);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(src, m_tmp_int1);
-    else
-      bob::sp::extrapolateMirror(src, m_tmp_int1);
-    m_tmp_int.resize(bob::sp::getConvSepOutputSize(m_tmp_int1, m_kernel_y, 0, bob::sp::Conv::Valid));
-    bob::sp::convSep(m_tmp_int1, m_kernel_y, m_tmp_int, 0, bob::sp::Conv::Valid);
 
-    m_tmp_int2.resize(bob::sp::getConvSepOutputSize(m_tmp_int, m_kernel_x, 1, bob::sp::Conv::Full));
-    if(m_conv_border == bob::sp::Extrapolation::NearestNeighbour)
-      bob::sp::extrapolateNearest(m_tmp_int, m_tmp_int2);
-    else if(m_conv_border == bob::sp::Extrapolation::Circular)
-      bob::sp::extrapolateCircular(m_tmp_int, m_tmp_int2);
-    else
-      bob::sp::extrapolateMirror(m_tmp_int, m_tmp_int2);
-    bob::sp::convSep(m_tmp_int2, m_kernel_x, dst, 1, bob::sp::Conv::Valid);
-  }
+  m_tmp_int.resize(src.shape());
+  bob::ip::detail::gaussianConvY(src, m_kernel_y, m_tmp_int, m_conv_border,
+    0, src.extent(0));
+  bob::ip::detail::gaussianConvX(m_tmp_int, m_kernel_x, dst, m_conv_border,
+    0, src.extent(0));
 }
@@ -20,6 +20,8 @@
 
 #include <bob/ip/GaussianScaleSpace.h>
 #include <bob/ip/Exception.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 bob::ip::GaussianScaleSpace::GaussianScaleSpace(const size_t height, 
     const size_t width, const size_t n_octaves, const size_t n_intervals,
@@ -29,7 +31,8 @@ bob::ip::GaussianScaleSpace::GaussianScaleSpace(const size_t height,
   m_height(height), m_width(width), m_n_octaves(n_octaves), 
   m_n_intervals(n_intervals), m_octave_min(octave_min),
   m_sigma_n(sigma_n), m_sigma0(sigma0), 
-  m_kernel_radius_factor(kernel_radius_factor), m_conv_border(border_type)
+  m_kernel_radius_factor(kernel_radius_factor), m_conv_border(border_type),
+  m_n_threads(1)
 {
   checkOctaveMin();
   resetCache();
@@ -42,7 +45,7 @@ bob::ip::GaussianScaleSpace::GaussianScaleSpace(const GaussianScaleSpace& other)
   m_octave_min(other.m_octave_min), m_sigma_n(other.m_sigma_n),
   m_sigma0(other.m_sigma0), 
   m_kernel_radius_factor(other.m_kernel_radius_factor),
-  m_conv_border(other.m_conv_border)
+  m_conv_border(other.m_conv_border), m_n_threads(other.m_n_threads)
 {
   resetCache();
   resetGaussians();
@@ -66,6 +69,7 @@ bob::ip::GaussianScaleSpace::operator=(const bob::ip::GaussianScaleSpace& other)
     m_sigma0 = other.m_sigma0;
     m_kernel_radius_factor = other.m_kernel_radius_factor;
     m_conv_border = other.m_conv_border;
+    m_n_threads = other.m_n_threads;
     resetCache();
     resetGaussians();
   }
@@ -193,3 +197,51 @@ bob::ip::GaussianScaleSpace::getOutputShape(const int octave) const
   return res;
 }
 
+
+void bob::ip::GaussianScaleSpace::smooth(const bob::ip::Gaussian& gaussian,
+  const blitz::Array<double,2>& src, blitz::Array<double,2>& dst) const
+{
+  const blitz::Array<double,1>& kernel_y = gaussian.getKernelY();
+  const blitz::Array<double,1>& kernel_x = gaussian.getKernelX();
+  const bob::sp::Extrapolation::BorderType border = gaussian.getConvBorder();
+  // Same checks as bob::ip::Gaussian
+  if (border == bob::sp::Extrapolation::Zero)
+  {
+    if (src.extent(0) < kernel_y.extent(0))
+      throw bob::sp::ConvolutionKernelTooLarge(0, src.extent(0), kernel_y.extent(0));
+    if (src.extent(1) < kernel_x.extent(0))
+      throw bob::sp::ConvolutionKernelTooLarge(1, src.extent(1), kernel_x.extent(0));
+  }
+  m_cache_blur.resize(src.shape());
+
+  const int height = src.extent(0);
+  const int n_threads = std::min((int)m_n_threads, height);
+  if (n_threads <= 1)
+  {
+    bob::ip::detail::gaussianConvY(src, kernel_y, m_cache_blur, border, 0, height);
+    bob::ip::detail::gaussianConvX(m_cache_blur, kernel_x, dst, border, 0, height);
+    return;
+  }
+
+  // The rows are split into contiguous blocks. The vertical pass should be 
+  // complete before the horizontal one starts. The main thread processes 
+  // the first block.
+  for (int pass=0; pass<2; ++pass)
+  {
+    void (*conv)(const blitz::Array<double,2>&, const blitz::Array<double,1>&,
+        blitz::Array<double,2>&, const bob::sp::Extrapolation::BorderType,
+        const int, const int) =
+      (pass == 0 ? &bob::ip::detail::gaussianConvY : &bob::ip::detail::gaussianConvX);
+    const blitz::Array<double,2>& in = (pass == 0 ? src : m_cache_blur);
+    blitz::Array<double,2>& out = (pass == 0 ? m_cache_blur : dst);
+    const blitz::Array<double,1>& kernel = (pass == 0 ? kernel_y : kernel_x);
+
+    boost::thread_group threads;
+    for (int t=1; t<n_threads; ++t)
+      threads.create_thread(boost::bind(conv, boost::cref(in), 
+        boost::cref(kernel), boost::ref(out), border,
+        t*height/n_threads, (t+1)*height/n_threads));
+    conv(in, kernel, out, border, 0, height/n_threads);
+    threads.join_all();
+  }
+}
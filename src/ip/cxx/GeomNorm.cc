@@ -72,6 +72,29 @@ bob::ip::GeomNorm::operator!=(const bob::ip::GeomNorm& b) const
   return !(this->operator==(b));
 }
 
+void 
+bob::ip::GeomNorm::getSourceGrid(const double rot_c_y, const double rot_c_x,
+  double& origin_y, double& origin_x, double& dy, double& dx) const
+{
+  // transformation center in original image
+  const double original_center_x = rot_c_x, 
+               original_center_y = rot_c_y;
+  // transformation center in new image:
+  const double new_center_x = m_crop_offset_w, 
+               new_center_y = m_crop_offset_h;
+
+  // With these positions, we can define a mapping from the new image to the original image
+  const double sin_angle = -sin(m_rotation_angle * M_PI / 180.), 
+               cos_angle = cos(m_rotation_angle * M_PI / 180.);
+  // we compute the distance in the source image, when going 1 pixel in the new image
+  dx = cos_angle / m_scaling_factor;
+  dy = -sin_angle / m_scaling_factor;
+
+  // get the (0,0) position of the target image in source image coordinates
+  origin_x = original_center_x - (cos_angle * new_center_x + sin_angle * new_center_y) / m_scaling_factor;
+  origin_y = original_center_y - (cos_angle * new_center_y - sin_angle * new_center_x) / m_scaling_factor;
+}
+
 blitz::TinyVector<double,2>
 bob::ip::GeomNorm::operator()(const blitz::TinyVector<double,2>& position,
   const double rot_c_y, const double rot_c_x) const
@@ -66,6 +66,47 @@ boost::shared_ptr<bob::ip::LBP> bob::ip::LBP16R::clone() const {
   return boost::make_shared<bob::ip::LBP16R>(*this);
 }
 
+void bob::ip::LBP16R::neighbours(double* dy, double* dx) const
+{
+  if (!m_circular) // there is no possibility for non-circular LBP16
+    throw bob::ip::Exception();
+
+  const double PI = 4.0*atan(1.0);
+  if (m_R == m_R2) {
+    const double alpha = 2 * PI / 16;
+    const double R_sqrt2 = m_R / sqrt(2);
+    const double long_cath = m_R * cos(alpha);
+    const double short_cath = m_R * sin(alpha);
+    dy[0] = -m_R;        dx[0] = 0.;
+    dy[1] = -long_cath;  dx[1] = short_cath;
+    dy[2] = -R_sqrt2;    dx[2] = R_sqrt2;
+    dy[3] = -short_cath; dx[3] = long_cath;
+    dy[4] = 0.;          dx[4] = m_R;
+    dy[5] = short_cath;  dx[5] = long_cath;
+    dy[6] = R_sqrt2;     dx[6] = R_sqrt2;
+    dy[7] = long_cath;   dx[7] = short_cath;
+    dy[8] = m_R;         dx[8] = 0.;
+    dy[9] = long_cath;   dx[9] = -short_cath;
+    dy[10] = R_sqrt2;    dx[10] = -R_sqrt2;
+    dy[11] = short_cath; dx[11] = -long_cath;
+    dy[12] = 0.;         dx[12] = -m_R;
+    dy[13] = -short_cath; dx[13] = -long_cath;
+    dy[14] = -R_sqrt2;   dx[14] = -R_sqrt2;
+    dy[15] = -long_cath; dx[15] = -short_cath;
+  }
+  else {
+    // an ellipse, see processNoCheck()
+    for (int k=0; k<16; ++k) {
+      dy[k] = -(m_R*cos(2*PI*k/m_P));
+      dx[k] = m_R2*sin(2*PI*k/m_P);
+    }
+    dy[0] = -m_R; dx[0] = 0.;
+    dy[4] = 0.;   dx[4] = m_R2;
+    dy[8] = m_R;  dx[8] = 0.;
+    dy[12] = 0.;  dx[12] = -m_R2;
+  }
+}
+
 int bob::ip::LBP16R::getMaxLabel() const {
   return  (m_rotation_invariant ?
       (m_uniform ? 18 : // Rotation invariant + uniform
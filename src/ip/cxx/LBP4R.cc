@@ -68,6 +68,22 @@ boost::shared_ptr<bob::ip::LBP> bob::ip::LBP4R::clone() const {
   return boost::make_shared<bob::ip::LBP4R>(*this);
 }
 
+void bob::ip::LBP4R::neighbours(double* dy, double* dx) const
+{
+  if (m_circular) {
+    dy[0] = -m_R; dx[0] = 0.;
+    dy[1] = 0.;   dx[1] = m_R2;
+    dy[2] = m_R;  dx[2] = 0.;
+    dy[3] = 0.;   dx[3] = -m_R2;
+  }
+  else {
+    dy[0] = -m_R_rect; dx[0] = 0;
+    dy[1] = 0;         dx[1] = m_R2_rect;
+    dy[2] = m_R_rect;  dx[2] = 0;
+    dy[3] = 0;         dx[3] = -m_R2_rect;
+  }
+}
+
 int bob::ip::LBP4R::getMaxLabel() const
 {
   return  (m_rotation_invariant ? 6 :
@@ -67,6 +67,45 @@ boost::shared_ptr<bob::ip::LBP> bob::ip::LBP8R::clone() const {
   return boost::make_shared<bob::ip::LBP8R>(*this);
 }
 
+void bob::ip::LBP8R::neighbours(double* dy, double* dx) const
+{
+  if (m_circular) {
+    if (m_R == m_R2) {
+      const double R_sqrt2 = m_R / sqrt(2);
+      dy[0] = -R_sqrt2; dx[0] = -R_sqrt2;
+      dy[1] = -m_R;     dx[1] = 0.;
+      dy[2] = -R_sqrt2; dx[2] = R_sqrt2;
+      dy[3] = 0.;       dx[3] = m_R;
+      dy[4] = R_sqrt2;  dx[4] = R_sqrt2;
+      dy[5] = m_R;      dx[5] = 0.;
+      dy[6] = R_sqrt2;  dx[6] = -R_sqrt2;
+      dy[7] = 0.;       dx[7] = -m_R;
+    }
+    else {
+      // an ellipse, see processNoCheck()
+      const double PI = 4.0*atan(1.0);
+      dy[0] = -(m_R*cos(2*PI*7/m_P)); dx[0] = m_R2*sin(2*PI*7/m_P);
+      dy[1] = -m_R;                   dx[1] = 0.;
+      dy[2] = -(m_R*cos(2*PI*1/m_P)); dx[2] = m_R2*sin(2*PI*1/m_P);
+      dy[3] = 0.;                     dx[3] = m_R;
+      dy[4] = -(m_R*cos(2*PI*3/m_P)); dx[4] = m_R2*sin(2*PI*3/m_P);
+      dy[5] = m_R;                    dx[5] = 0.;
+      dy[6] = -(m_R*cos(2*PI*5/m_P)); dx[6] = m_R2*sin(2*PI*5/m_P);
+      dy[7] = 0.;                     dx[7] = -m_R;
+    }
+  }
+  else {
+    dy[0] = -m_R_rect; dx[0] = -m_R2_rect;
+    dy[1] = -m_R_rect; dx[1] = 0;
+    dy[2] = -m_R_rect; dx[2] = m_R2_rect;
+    dy[3] = 0;         dx[3] = m_R2_rect;
+    dy[4] = m_R_rect;  dx[4] = m_R2_rect;
+    dy[5] = m_R_rect;  dx[5] = 0;
+    dy[6] = m_R_rect;  dx[6] = -m_R2_rect;
+    dy[7] = 0;         dx[7] = -m_R2_rect;
+  }
+}
+
 int bob::ip::LBP8R::getMaxLabel() const
 {
 return  (m_rotation_invariant ?
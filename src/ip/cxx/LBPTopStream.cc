@@ -0,0 +1,141 @@
+/**
+ * @file ip/cxx/LBPTopStream.cc
+ * @date Sun Oct 18 11:02:17 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implementation of the streaming LBP-Top histograms
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <bob/core/Exception.h>
+#include <bob/ip/LBPTopStream.h>
+
+bob::ip::LBPTopStream::LBPTopStream(const bob::ip::LBPTop& lbptop,
+    size_t window):
+  m_lbp_xy(lbptop.getXY()->clone()),
+  m_lbp_xt(lbptop.getXT()->clone()),
+  m_lbp_yt(lbptop.getYT()->clone()),
+  m_radius(0),
+  m_window(window),
+  m_n_frames(0),
+  m_n_central(0)
+{
+  if (window == 0)
+    throw bob::core::InvalidArgumentException("window", 0);
+
+  // same border as in LBPTop::process()
+  int radius_x = m_lbp_xy->getRadius();
+  int radius_y = m_lbp_xy->getRadius2();
+  int radius_t = m_lbp_yt->getRadius2();
+  m_radius = std::max(std::max(radius_x, radius_y), radius_t);
+
+  m_hist_xy.resize(m_window, m_lbp_xy->getMaxLabel());
+  m_hist_xt.resize(m_window, m_lbp_xt->getMaxLabel());
+  m_hist_yt.resize(m_window, m_lbp_yt->getMaxLabel());
+  m_sum_xy.resize(m_lbp_xy->getMaxLabel());
+  m_sum_xt.resize(m_lbp_xt->getMaxLabel());
+  m_sum_yt.resize(m_lbp_yt->getMaxLabel());
+  reset();
+}
+
+bob::ip::LBPTopStream::~LBPTopStream() { }
+
+void bob::ip::LBPTopStream::reset() {
+  m_n_frames = 0;
+  m_n_central = 0;
+  m_sum_xy = 0;
+  m_sum_xt = 0;
+  m_sum_yt = 0;
+}
+
+void bob::ip::LBPTopStream::resize(int height, int width) {
+  const int N = 2*m_radius + 1;
+  if (height < N)
+    throw bob::core::InvalidArgumentException("height", height, N,
+        std::numeric_limits<int>::max());
+  if (width < N)
+    throw bob::core::InvalidArgumentException("width", width, N,
+        std::numeric_limits<int>::max());
+
+  m_frames.resize(N, height, width);
+  m_plane_xt.resize(N, width);
+  m_plane_yt.resize(N, height);
+  m_codes_xt.resize(1, width-2*m_radius);
+  m_codes_yt.resize(1, height-2*m_radius);
+  m_xy.resize(height-2*m_radius, width-2*m_radius);
+  m_xt.resize(height-2*m_radius, width-2*m_radius);
+  m_yt.resize(height-2*m_radius, width-2*m_radius);
+}
+
+/**
+ * Adds the histogram of the given codes to the row 'slot' of 'hist' and to
+ * 'sum', after having removed the previous contents of that row from 'sum'
+ */
+static void accumulate(const blitz::Array<uint16_t,2>& codes,
+    blitz::Array<uint64_t,2>& hist, int slot, bool replace,
+    blitz::Array<uint64_t,1>& sum) {
+  blitz::Array<uint64_t,1> h = hist(slot, blitz::Range::all());
+  if (replace) sum -= h;
+  h = 0;
+  for (int y=0; y<codes.extent(0); ++y)
+    for (int x=0; x<codes.extent(1); ++x)
+      ++h(codes(y,x));
+  sum += h;
+}
+
+void bob::ip::LBPTopStream::update() {
+  const int N = m_frames.extent(0);
+  if (m_n_frames < (size_t)N) return;
+
+  const blitz::Range all = blitz::Range::all();
+  const int r = m_radius;
+  const int height = m_frames.extent(1);
+  const int width = m_frames.extent(2);
+
+  // slot of the oldest frame in the ring buffer, then in time order
+  const int oldest = m_n_frames % N;
+  std::vector<int> slot(N);
+  for (int t=0; t<N; ++t) slot[t] = (oldest + t) % N;
+
+  // XY codes of the central frame
+  const blitz::Array<double,2> central = m_frames(slot[r], all, all);
+  m_lbp_xy->operator()(central, m_xy, r);
+
+  // XT codes, one row at a time
+  for (int j=r; j<height-r; ++j) {
+    for (int t=0; t<N; ++t) m_plane_xt(t, all) = m_frames(slot[t], j, all);
+    m_lbp_xt->operator()(m_plane_xt, m_codes_xt, r);
+    m_xt(j-r, all) = m_codes_xt(0, all);
+  }
+
+  // YT codes, one column at a time
+  for (int k=r; k<width-r; ++k) {
+    for (int t=0; t<N; ++t) m_plane_yt(t, all) = m_frames(slot[t], all, k);
+    m_lbp_yt->operator()(m_plane_yt, m_codes_yt, r);
+    m_yt(all, k-r) = m_codes_yt(0, all);
+  }
+
+  // replaces the histograms of the frame leaving the window
+  const int h = m_n_central % m_window;
+  const bool replace = m_n_central >= m_window;
+  accumulate(m_xy, m_hist_xy, h, replace, m_sum_xy);
+  accumulate(m_xt, m_hist_xt, h, replace, m_sum_xt);
+  accumulate(m_yt, m_hist_yt, h, replace, m_sum_yt);
+  ++m_n_central;
+}
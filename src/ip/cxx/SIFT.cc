@@ -20,7 +20,11 @@
 
 #include <bob/ip/SIFT.h>
 #include <bob/core/assert.h>
+#include <bob/math/Exception.h>
 #include <algorithm>
+#include <cmath>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 bob::ip::SIFT::SIFT(const size_t height, const size_t width, 
     const size_t n_octaves, const size_t n_intervals, const int octave_min,
@@ -115,8 +119,7 @@ bob::ip::SIFT::operator==(const bob::ip::SIFT& b) const
  if (this->m_gss_pyr.size() != b.m_gss_pyr.size() ||
      this->m_dog_pyr.size() != b.m_dog_pyr.size() ||
      this->m_gss_pyr_grad_mag.size() != b.m_gss_pyr_grad_mag.size() ||
-     this->m_gss_pyr_grad_or.size() != b.m_gss_pyr_grad_or.size() ||
-     this->m_gradient_maps.size() != b.m_gradient_maps.size())
+     this->m_gss_pyr_grad_or.size() != b.m_gss_pyr_grad_or.size())
     return false;
 
   for (size_t i=0; i<m_gss_pyr.size(); ++i)
@@ -135,10 +138,6 @@ bob::ip::SIFT::operator==(const bob::ip::SIFT& b) const
     if (!bob::core::array::isEqual(this->m_gss_pyr_grad_or[i], b.m_gss_pyr_grad_or[i]))
       return false;
 
-  for (size_t i=0; i<m_gradient_maps.size(); ++i)
-    if (*(this->m_gradient_maps[i]) != *(b.m_gradient_maps[i]))
-      return false;
-
   return true;
 }
 
@@ -169,8 +168,6 @@ void bob::ip::SIFT::resetCache()
       m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2)));
     m_gss_pyr_grad_or.push_back(blitz::Array<double,3>(m_gss_pyr[i].extent(0)-3,
       m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2)));
-    m_gradient_maps.push_back(boost::shared_ptr<bob::ip::GradientMaps>(new 
-      bob::ip::GradientMaps(m_gss_pyr[i].extent(1), m_gss_pyr[i].extent(2))));
     m_gss_pyr[i] = 0.;
     m_dog_pyr[i] = 0.;
     m_gss_pyr_grad_mag[i] = 0.;
@@ -184,36 +181,68 @@ bob::ip::SIFT::getGaussianOutputShape(const int octave) const
   return m_gss->getOutputShape(octave);
 }
 
-void bob::ip::SIFT::computeDog()
+void bob::ip::SIFT::computeDogAndGradient()
 {
-  // Computes the Difference of Gaussians pyramid
-  blitz::Range rall = blitz::Range::all();
+  // Same checks as bob::math::gradient(), as exceptions cannot be thrown
+  // from the threads
   for (size_t o=0; o<m_gss_pyr.size(); ++o)
-    for (size_t s=0; s<(size_t)(m_gss_pyr[o].extent(0)-1); ++s)
-    {
-      blitz::Array<double,2> dst_os = m_dog_pyr[o](s, rall, rall);
-      blitz::Array<double,2> src1 = m_gss_pyr[o](s, rall, rall);
-      blitz::Array<double,2> src2 = m_gss_pyr[o](s+1, rall, rall);
-      dst_os = src2 - src1;
-    }
+  {
+    if (m_gss_pyr_grad_mag[o].extent(0) == 0) continue;
+    if (m_gss_pyr[o].extent(1) < 2) 
+      throw bob::math::GradientDimTooSmall(0, m_gss_pyr[o].extent(1));
+    if (m_gss_pyr[o].extent(2) < 2) 
+      throw bob::math::GradientDimTooSmall(1, m_gss_pyr[o].extent(2));
+  }
+
+  // The octaves are independent from each other, once the Gaussian pyramid
+  // is known. The main thread processes the octaves 0, n_threads, ...
+  const size_t n_threads = std::min(m_gss->getNThreads(), m_gss_pyr.size());
+  boost::thread_group threads;
+  for (size_t t=1; t<n_threads; ++t)
+    threads.create_thread(boost::bind(
+      static_cast<void (bob::ip::SIFT::*)(const size_t, const size_t)>(
+        &bob::ip::SIFT::computeDogAndGradient), this, t, n_threads));
+  computeDogAndGradient(0, std::max(n_threads, (size_t)1));
+  threads.join_all();
 }
 
-void bob::ip::SIFT::computeGradient()
+void bob::ip::SIFT::computeDogAndGradient(const size_t o, const size_t step)
 {
-  blitz::Range rall = blitz::Range::all();
-  for (size_t i=0; i<m_gss_pyr.size(); ++i)
+  for (size_t i=o; i<m_gss_pyr.size(); i+=step)
   {
-    blitz::Array<double,3>& gss = m_gss_pyr[i];
+    const blitz::Array<double,3>& gss = m_gss_pyr[i];
+    blitz::Array<double,3>& dog = m_dog_pyr[i];
     blitz::Array<double,3>& gmag = m_gss_pyr_grad_mag[i];
     blitz::Array<double,3>& gor = m_gss_pyr_grad_or[i];
-    boost::shared_ptr<bob::ip::GradientMaps> gmap = m_gradient_maps[i];
+    const int M = gss.extent(1);
+    const int N = gss.extent(2);
+
+    // Difference of Gaussians: dog(s) = gss(s+1) - gss(s)
+    for (int s=0; s<dog.extent(0); ++s)
+      for (int y=0; y<M; ++y)
+        for (int x=0; x<N; ++x)
+          dog(s,y,x) = gss(s+1,y,x) - gss(s,y,x);
+
+    // Gradients of the scales 1 to S-3: centered differences in the 
+    // interior and first differences at the boundaries, as 
+    // bob::math::gradient()
     for (int s=0; s<gmag.extent(0); ++s)
-    {
-      blitz::Array<double,2> gss_s = gss(s+1, rall, rall);
-      blitz::Array<double,2> gmag_s = gmag(s, rall, rall);
-      blitz::Array<double,2> gor_s = gor(s, rall, rall);
-      gmap->forward(gss_s, gmag_s, gor_s);
-    }
+      for (int y=0; y<M; ++y)
+      {
+        const int yp = (y < M-1 ? y+1 : y);
+        const int ym = (y > 0 ? y-1 : y);
+        for (int x=0; x<N; ++x)
+        {
+          const int xp = (x < N-1 ? x+1 : x);
+          const int xm = (x > 0 ? x-1 : x);
+          double gy = gss(s+1,yp,x) - gss(s+1,ym,x);
+          if (y > 0 && y < M-1) gy /= 2.;
+          double gx = gss(s+1,y,xp) - gss(s+1,y,xm);
+          if (x > 0 && x < N-1) gx /= 2.;
+          gmag(s,y,x) = std::sqrt(gy*gy + gx*gx);
+          gor(s,y,x) = std::atan2(gy, gx);
+        }
+      }
   }
 }
 
@@ -0,0 +1,158 @@
+/**
+ * @file ip/cxx/test/FaceNormPipeline.cc
+ * @date Sun Oct 18 14:05:31 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Tests the fused face preprocessing pipeline against the single
+ * stages
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE IP-FaceNormPipeline Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <blitz/array.h>
+#include <stdint.h>
+#include <boost/random.hpp>
+#include "bob/ip/FaceNormPipeline.h"
+#include "bob/ip/LBP8R.h"
+
+template<typename T, typename U, int d>
+void check_dimensions( blitz::Array<T,d>& t1, blitz::Array<U,d>& t2)
+{
+  BOOST_REQUIRE_EQUAL(t1.dimensions(), t2.dimensions());
+  for( int i=0; i<t1.dimensions(); ++i)
+    BOOST_REQUIRE_EQUAL(t1.extent(i), t2.extent(i));
+}
+
+template<typename T>
+void checkBlitzEqual( blitz::Array<T,2> t1, blitz::Array<T,2> t2)
+{
+  check_dimensions( t1, t2);
+  for( int i=0; i<t1.extent(0); ++i)
+    for( int j=0; j<t1.extent(1); ++j)
+      BOOST_CHECK_EQUAL(t1(i,j), t2(i,j));
+}
+
+static blitz::Array<uint8_t,2> random_image(boost::mt19937& rng)
+{
+  boost::uniform_int<int> range(0, 255);
+  blitz::Array<uint8_t,2> image(60, 50);
+  for (int y=0; y<image.extent(0); ++y)
+    for (int x=0; x<image.extent(1); ++x)
+      image(y,x) = range(rng);
+  return image;
+}
+
+static const double eyes[3][4] = {
+  {20., 15., 22., 34.}, {18., 12., 18., 36.}, {25., 10., 19., 30.}
+};
+
+BOOST_AUTO_TEST_CASE( test_facenormpipeline_preprocessing )
+{
+  boost::mt19937 rng;
+  bob::ip::FaceEyesNorm face_eyes_norm(20., 40, 32, 12., 16.);
+  const bob::sp::Extrapolation::BorderType borders[] = {
+    bob::sp::Extrapolation::Mirror, bob::sp::Extrapolation::Zero,
+    bob::sp::Extrapolation::NearestNeighbour,
+    bob::sp::Extrapolation::Circular };
+  const size_t tiles[] = {1, 3, 16, 100};
+
+  for (int b=0; b<4; ++b) {
+    bob::ip::TanTriggs tan_triggs(0.2, 1., 2., 3, 10., 0.1, borders[b]);
+    for (int i=0; i<3; ++i) {
+      blitz::Array<uint8_t,2> image = random_image(rng);
+
+      // stage by stage
+      blitz::Array<double,2> face(40, 32), ref(40, 32);
+      face_eyes_norm(image, face, eyes[i][0], eyes[i][1], eyes[i][2], eyes[i][3]);
+      tan_triggs(face, ref);
+
+      for (int t=0; t<4; ++t) {
+        bob::ip::FaceNormPipeline pipeline(face_eyes_norm, tan_triggs, tiles[t]);
+        blitz::Array<double,2> dst(pipeline.getOutputShape());
+        pipeline(image, dst, eyes[i][0], eyes[i][1], eyes[i][2], eyes[i][3]);
+        checkBlitzEqual(dst, ref);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_facenormpipeline_features )
+{
+  boost::mt19937 rng;
+  bob::ip::FaceEyesNorm face_eyes_norm(20., 40, 32, 12., 16.);
+  bob::ip::TanTriggs tan_triggs(0.); // log instead of gamma correction
+  bob::ip::LBP8R lbp(1.);
+  bob::ip::DCTFeatures dct(8, 8, 4, 4, 15);
+  bob::ip::FaceNormPipeline lbp_pipeline(face_eyes_norm, tan_triggs, lbp, 7);
+  bob::ip::FaceNormPipeline dct_pipeline(face_eyes_norm, tan_triggs, dct, 7);
+
+  blitz::Array<uint8_t,2> image = random_image(rng);
+  blitz::Array<double,2> face(40, 32), preprocessed(40, 32);
+  face_eyes_norm(image, face, eyes[0][0], eyes[0][1], eyes[0][2], eyes[0][3]);
+  tan_triggs(face, preprocessed);
+
+  blitz::Array<uint16_t,2> codes(lbp.getLBPShape(preprocessed)), lbp_dst(lbp_pipeline.getOutputShape());
+  lbp(preprocessed, codes);
+  lbp_pipeline(image, lbp_dst, eyes[0][0], eyes[0][1], eyes[0][2], eyes[0][3]);
+  checkBlitzEqual(lbp_dst, codes);
+
+  blitz::Array<double,2> features(dct.get2DOutputShape(preprocessed)), dct_dst(dct_pipeline.getOutputShape());
+  dct(preprocessed, features);
+  dct_pipeline(image, dct_dst, eyes[0][0], eyes[0][1], eyes[0][2], eyes[0][3]);
+  checkBlitzEqual(dct_dst, features);
+
+  // the outputs do not fit the feature stages
+  blitz::Array<double,2> wrong(lbp_pipeline.getOutputShape());
+  BOOST_CHECK_THROW(lbp_pipeline(image, wrong, eyes[0][0], eyes[0][1], eyes[0][2], eyes[0][3]), bob::core::InvalidArgumentException);
+  BOOST_CHECK_THROW(dct_pipeline(image, lbp_dst, eyes[0][0], eyes[0][1], eyes[0][2], eyes[0][3]), bob::core::InvalidArgumentException);
+}
+
+BOOST_AUTO_TEST_CASE( test_facenormpipeline_batch )
+{
+  boost::mt19937 rng;
+  bob::ip::FaceEyesNorm face_eyes_norm(20., 40, 32, 12., 16.);
+  bob::ip::TanTriggs tan_triggs;
+  bob::ip::LBP8R lbp(1., true);
+  bob::ip::FaceNormPipeline pipeline(face_eyes_norm, tan_triggs, lbp);
+
+  const int N = 7;
+  blitz::Array<uint8_t,3> images(N, 60, 50);
+  blitz::Array<double,2> eye_positions(N, 4);
+  const blitz::Range all = blitz::Range::all();
+  for (int n=0; n<N; ++n) {
+    images(n, all, all) = random_image(rng);
+    for (int k=0; k<4; ++k) eye_positions(n,k) = eyes[n%3][k];
+  }
+
+  // single faces
+  const blitz::TinyVector<int,2> shape = pipeline.getOutputShape();
+  blitz::Array<uint16_t,3> ref(N, shape(0), shape(1));
+  for (int n=0; n<N; ++n) {
+    blitz::Array<uint16_t,2> ref_n = ref(n, all, all);
+    pipeline(images(n, all, all), ref_n, eyes[n%3][0], eyes[n%3][1], eyes[n%3][2], eyes[n%3][3]);
+  }
+
+  for (size_t threads=1; threads<=4; threads+=3) {
+    pipeline.setNThreads(threads);
+    blitz::Array<uint16_t,3> dst(N, shape(0), shape(1));
+    pipeline(images, dst, eye_positions);
+    for (int n=0; n<N; ++n)
+      checkBlitzEqual<uint16_t>(dst(n, all, all), ref(n, all, all));
+  }
+}
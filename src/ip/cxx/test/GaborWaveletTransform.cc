@@ -232,4 +232,47 @@ BOOST_AUTO_TEST_CASE( test_GWT_output )
 
 }
 
+BOOST_AUTO_TEST_CASE( test_GWT_threads_and_real_input )
+{
+  // a synthetic image of odd width, to test the real-to-complex FFT
+  blitz::Array<double,2> real_image(48, 37);
+  blitz::firstIndex i; blitz::secondIndex j;
+  real_image = 128. + 64. * blitz::sin(0.3 * i) * blitz::cos(0.17 * j) + 3. * ((7 * i + 13 * j) % 11);
+  blitz::Array<std::complex<double>,2> image = bob::core::array::cast<std::complex<double> >(real_image);
+
+  // single threaded reference using complex input
+  bob::ip::GaborWaveletTransform gwt;
+  blitz::Array<std::complex<double>, 3> reference(gwt.numberOfKernels(), image.extent(0), image.extent(1));
+  gwt.performGWT(image, reference);
+  blitz::Array<double,4> reference_jets(image.extent(0), image.extent(1), 2, gwt.numberOfKernels());
+  gwt.computeJetImage(image, reference_jets, true);
+
+  for (unsigned threads = 1; threads <= 4; threads += 3){
+    gwt.setNumberOfThreads(threads);
+    BOOST_CHECK_EQUAL(gwt.numberOfThreads(), threads);
+
+    // complex and real input
+    blitz::Array<std::complex<double>, 3> trafo(reference.shape());
+    gwt.performGWT(image, trafo);
+    test_close(trafo, reference, 1e-8);
+    gwt.performGWT(real_image, trafo);
+    test_close(trafo, reference, 1e-8);
+
+    blitz::Array<double,4> jets(reference_jets.shape());
+    gwt.computeJetImage(real_image, jets, true);
+    test_close(jets, reference_jets, 1e-8);
+
+    // single precision jets
+    blitz::Array<float,4> float_jets(reference_jets.shape());
+    gwt.computeJetImage(real_image, float_jets, true);
+    test_close(bob::core::array::cast<double>(float_jets), reference_jets, epsilon);
+
+    blitz::Array<float,3> float_abs_jets(image.extent(0), image.extent(1), gwt.numberOfKernels());
+    gwt.computeJetImage(image, float_abs_jets, false);
+    blitz::Array<double,3> abs_jets(float_abs_jets.shape());
+    gwt.computeJetImage(image, abs_jets, false);
+    test_close(bob::core::array::cast<double>(float_abs_jets), abs_jets, 1e-2);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
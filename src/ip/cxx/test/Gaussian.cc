@@ -144,4 +144,60 @@ BOOST_AUTO_TEST_CASE( test_gaussianSmoothing_2d )
   checkBlitzClose( img_processed, img_ref, eps);
 }
 
+/**
+ * Reference implementation: the input is extrapolated before being 
+ * convolved with bob::sp::convSep()
+ */
+static void gaussian_ref(const blitz::Array<double,2>& src, 
+  const bob::ip::Gaussian& g, blitz::Array<double,2>& dst)
+{
+  const blitz::Array<double,1>& ky = g.getKernelY();
+  const blitz::Array<double,1>& kx = g.getKernelX();
+  const bob::sp::Extrapolation::BorderType b = g.getConvBorder();
+  if (b == bob::sp::Extrapolation::Zero)
+  {
+    blitz::Array<double,2> tmp(src.shape());
+    bob::sp::convSep(src, ky, tmp, 0, bob::sp::Conv::Same);
+    bob::sp::convSep(tmp, kx, dst, 1, bob::sp::Conv::Same);
+    return;
+  }
+  blitz::Array<double,2> ext1(bob::sp::getConvSepOutputSize(src, ky, 0, bob::sp::Conv::Full));
+  if (b == bob::sp::Extrapolation::NearestNeighbour) bob::sp::extrapolateNearest(src, ext1);
+  else if (b == bob::sp::Extrapolation::Circular) bob::sp::extrapolateCircular(src, ext1);
+  else bob::sp::extrapolateMirror(src, ext1);
+  blitz::Array<double,2> tmp(bob::sp::getConvSepOutputSize(ext1, ky, 0, bob::sp::Conv::Valid));
+  bob::sp::convSep(ext1, ky, tmp, 0, bob::sp::Conv::Valid);
+  blitz::Array<double,2> ext2(bob::sp::getConvSepOutputSize(tmp, kx, 1, bob::sp::Conv::Full));
+  if (b == bob::sp::Extrapolation::NearestNeighbour) bob::sp::extrapolateNearest(tmp, ext2);
+  else if (b == bob::sp::Extrapolation::Circular) bob::sp::extrapolateCircular(tmp, ext2);
+  else bob::sp::extrapolateMirror(tmp, ext2);
+  bob::sp::convSep(ext2, kx, dst, 1, bob::sp::Conv::Valid);
+}
+
+BOOST_AUTO_TEST_CASE( test_gaussianSmoothing_extrapolation )
+{
+  blitz::Array<double,2> src(23, 31);
+  ranlib::Uniform<double> gen;
+  for (int i=0; i<src.extent(0); ++i)
+    for (int j=0; j<src.extent(1); ++j)
+      src(i,j) = gen.random();
+
+  const bob::sp::Extrapolation::BorderType borders[] = {
+    bob::sp::Extrapolation::Zero, bob::sp::Extrapolation::NearestNeighbour,
+    bob::sp::Extrapolation::Circular, bob::sp::Extrapolation::Mirror };
+  for (int b=0; b<4; ++b)
+  {
+    bob::ip::Gaussian g(2, 5, 1.2, 2.3, borders[b]);
+    blitz::Array<double,2> dst(src.shape()), ref(src.shape());
+    g(src, dst);
+    gaussian_ref(src, g, ref);
+    checkBlitzEqual(dst, ref);
+  }
+
+  // Kernel larger than the image
+  bob::ip::Gaussian g(2, 20, 1.2, 2.3, bob::sp::Extrapolation::Zero);
+  blitz::Array<double,2> dst(src.shape());
+  BOOST_CHECK_THROW(g(src, dst), bob::sp::ConvolutionKernelTooLarge);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
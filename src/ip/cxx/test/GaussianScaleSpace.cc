@@ -26,6 +26,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <bob/ip/GaussianScaleSpace.h>
+#include <bob/core/check.h>
 
 struct T {
   blitz::Array<double,2> src;
@@ -81,5 +82,26 @@ BOOST_AUTO_TEST_CASE( test_upsample_downsample )
   bob::ip::detail::downsample(d, dsrc, 1);
   checkBlitzClose( dsrc, src, eps);
 }
+
+BOOST_AUTO_TEST_CASE( test_gss_threads )
+{
+  blitz::Array<double,2> img(37, 45);
+  for (int i=0; i<img.extent(0); ++i)
+    for (int j=0; j<img.extent(1); ++j)
+      img(i,j) = (i*7 + j*13) % 17;
+
+  bob::ip::GaussianScaleSpace gss(37, 45, 3, 3, -1);
+  std::vector<blitz::Array<double,3> > ref, dst;
+  gss.allocateOutputPyramid(ref);
+  gss(img, ref);
+
+  gss.setNThreads(3);
+  BOOST_CHECK_EQUAL(gss.getNThreads(), (size_t)3);
+  gss.allocateOutputPyramid(dst);
+  gss(img, dst);
+  BOOST_REQUIRE_EQUAL(dst.size(), ref.size());
+  for (size_t o=0; o<ref.size(); ++o)
+    BOOST_CHECK(bob::core::array::isEqual(dst[o], ref[o]));
+}
  
 BOOST_AUTO_TEST_SUITE_END()
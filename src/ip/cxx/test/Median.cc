@@ -25,6 +25,9 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include <blitz/array.h>
+#include <algorithm>
+#include <vector>
+#include <boost/random.hpp>
 #include "bob/ip/Median.h"
 
 struct T {
@@ -67,4 +70,60 @@ BOOST_AUTO_TEST_CASE( test_median_2d )
   checkBlitzEqual(dst, ref);
 }
 
+template <typename T>
+void median_reference(const blitz::Array<T,2>& src, blitz::Array<T,2>& dst,
+  const int ry, const int rx)
+{
+  std::vector<T> window;
+  for (int j=0; j<dst.extent(0); ++j)
+    for (int i=0; i<dst.extent(1); ++i) {
+      window.clear();
+      for (int y=j; y<=j+2*ry; ++y)
+        for (int x=i; x<=i+2*rx; ++x)
+          window.push_back(src(y,x));
+      std::sort(window.begin(), window.end());
+      dst(j,i) = window[window.size()/2];
+    }
+}
+
+template <typename T>
+void test_median_random(const double max)
+{
+  boost::mt19937 rng;
+  boost::uniform_int<int> dist(0, (int)max);
+  blitz::Array<T,2> src(23,31);
+  for (int j=0; j<src.extent(0); ++j)
+    for (int i=0; i<src.extent(1); ++i)
+      src(j,i) = static_cast<T>(dist(rng));
+
+  const int radii[][2] = {{0,0}, {1,1}, {1,3}, {5,5}, {3,0}};
+  for (int r=0; r<5; ++r) {
+    const int ry = radii[r][0], rx = radii[r][1];
+    blitz::Array<T,2> ref(src.extent(0)-2*ry, src.extent(1)-2*rx);
+    median_reference(src, ref, ry, rx);
+    for (size_t n_threads=1; n_threads<=4; n_threads+=3) {
+      bob::ip::Median<T> filter(ry, rx);
+      filter.setNThreads(n_threads);
+      blitz::Array<T,2> dst(ref.shape());
+      filter(src, dst);
+      checkBlitzEqual(dst, ref);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_median_random_uint8 )
+{
+  test_median_random<uint8_t>(255);
+}
+
+BOOST_AUTO_TEST_CASE( test_median_random_uint16 )
+{
+  test_median_random<uint16_t>(4095);
+}
+
+BOOST_AUTO_TEST_CASE( test_median_random_float64 )
+{
+  test_median_random<double>(1000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -27,6 +27,7 @@
 #include <boost/test/unit_test.hpp>
 #include <blitz/array.h>
 #include <bob/ip/SIFT.h>
+#include <bob/core/check.h>
 
 #include <algorithm>
 #include <random/uniform.h>
@@ -108,7 +109,7 @@ void bob::ip::SIFTtest::run(const blitz::Array<double,2>& src, blitz::Array<doub
     pyr(i,rall,rall) = src;
   vec.push_back(pyr);
   op.setGaussianPyramid(vec);
-  op.computeGradient();
+  op.computeDogAndGradient();
   op.computeDescriptor(kp, kpi, descr);
 }
 
@@ -413,4 +414,28 @@ BOOST_AUTO_TEST_CASE( test_sift_vlfeat_comparison )
   checkBlitzClose( bob_descr, vl_descr, eps); 
 }
 
+BOOST_AUTO_TEST_CASE( test_sift_threads )
+{
+  blitz::Array<double,2> A(64,80);
+  ranlib::Uniform<double> gen;
+  for (int i=0; i<A.extent(0); ++i)
+    for (int j=0; j<A.extent(1); ++j)
+      A(i,j) = gen.random();
+
+  std::vector<boost::shared_ptr<bob::ip::GSSKeypoint> > keypoints;
+  keypoints.push_back(boost::shared_ptr<bob::ip::GSSKeypoint>(new bob::ip::GSSKeypoint(1.5, 20, 30)));
+  keypoints.push_back(boost::shared_ptr<bob::ip::GSSKeypoint>(new bob::ip::GSSKeypoint(3.2, 40, 45, 0.5)));
+  keypoints.push_back(boost::shared_ptr<bob::ip::GSSKeypoint>(new bob::ip::GSSKeypoint(6.4, 32, 40)));
+
+  bob::ip::SIFT op(64, 80, 3, 3, -1);
+  const blitz::TinyVector<int,3> shape = op.getDescriptorShape();
+  blitz::Array<double,4> ref(keypoints.size(), shape(0), shape(1), shape(2));
+  op.computeDescriptor(A, keypoints, ref);
+
+  op.setNThreads(4);
+  blitz::Array<double,4> dst(keypoints.size(), shape(0), shape(1), shape(2));
+  op.computeDescriptor(A, keypoints, dst);
+  BOOST_CHECK(bob::core::array::isEqual(dst, ref));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
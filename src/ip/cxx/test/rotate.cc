@@ -301,6 +301,57 @@ BOOST_AUTO_TEST_CASE( test_rotate_2d_mask )
   checkBlitzEqual(a8m_45, b8_mask);
 }
 
+static double bilinear_reference(const blitz::Array<uint32_t,2>& src,
+  const double y, const double x)
+{
+  // straightforward bilinear interpolation, with zeros outside the image
+  const int oy = (int)floor(y), ox = (int)floor(x);
+  double res = 0.;
+  for (int i=0; i<2; ++i)
+    for (int j=0; j<2; ++j)
+      if (oy+i >= 0 && oy+i < src.extent(0) && ox+j >= 0 && ox+j < src.extent(1))
+        res += (i ? y-oy : 1.-(y-oy)) * (j ? x-ox : 1.-(x-ox)) * src(oy+i,ox+j);
+  return res;
+}
+
+BOOST_AUTO_TEST_CASE( test_rotate_2d_bilinear )
+{
+  blitz::Array<uint32_t,2> img(9,12);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  img = (7*i + 3*j*j) % 23;
+
+  const double angles[] = {5., 30., -25., 120., 237.};
+  for (int a=0; a<5; ++a) {
+    blitz::Array<double,2> b(bob::ip::getRotatedShape(img, angles[a]));
+    bob::ip::rotate(img, b, angles[a], bob::ip::Rotate::BilinearInterp);
+
+    // every pixel is computed independently from its source position
+    const double rad = angles[a] * M_PI / 180.;
+    const double c = cos(rad), s = sin(rad);
+    const double cs_y = (img.extent(0)-1)/2., cs_x = (img.extent(1)-1)/2.;
+    const double cd_y = (b.extent(0)-1)/2., cd_x = (b.extent(1)-1)/2.;
+    for (int y=0; y<b.extent(0); ++y)
+      for (int x=0; x<b.extent(1); ++x) {
+        const double sy = cs_y + c*(y-cd_y) + s*(x-cd_x);
+        const double sx = cs_x + c*(x-cd_x) - s*(y-cd_y);
+        BOOST_CHECK_SMALL(b(y,x) - bilinear_reference(img, sy, sx), 1e-8);
+      }
+  }
+
+  // the interior of a constant image stays constant, and the mask covers it
+  blitz::Array<double,2> b8(bob::ip::getRotatedShape(a8, 45.));
+  blitz::Array<bool,2> b8_mask(b8.shape());
+  bob::ip::rotate(a8, a8m, b8, b8_mask, 45., bob::ip::Rotate::BilinearInterp);
+  const int cy = b8.extent(0)/2, cx = b8.extent(1)/2;
+  for (int y=cy-2; y<=cy+2; ++y)
+    for (int x=cx-2; x<=cx+2; ++x) {
+      BOOST_CHECK_SMALL(b8(y,x) - 1., 1e-10);
+      BOOST_CHECK(b8_mask(y,x));
+    }
+  BOOST_CHECK(!b8_mask(0,0));
+}
+
 BOOST_AUTO_TEST_CASE( test_get_angle_to_horizontal )
 {
   // check that the getAngleToHorizontal function returns reasonable results
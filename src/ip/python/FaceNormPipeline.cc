@@ -0,0 +1,149 @@
+/**
+ * @file ip/python/FaceNormPipeline.cc
+ * @date Sun Oct 18 14:05:31 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the fused face preprocessing pipeline to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/ip/FaceNormPipeline.h"
+#include "bob/core/python/ndarray.h"
+
+using namespace boost::python;
+
+static const char* facenormpipeline_doc = "Objects of this class chain the geometric normalization of faces (FaceEyesNorm), the preprocessing of Tan and Triggs (TanTriggs) and, optionally, the extraction of LBP codes (LBP) or of DCT features (DCTFeatures). The first stages are fused and run on tiles of rows, reusing the same scratch memory for all faces. The results are identical to the ones of the single stages applied one after the other.";
+
+static bob::core::array::ElementType output_type(const bob::ip::FaceNormPipeline& op)
+{
+  return op.getFeatures() == bob::ip::FaceNormPipeline::LBPCodes ?
+    bob::core::array::t_uint16 : bob::core::array::t_float64;
+}
+
+template <typename T, typename U>
+static void inner_call1(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::ndarray output,
+  double e1y, double e1x, double e2y, double e2x)
+{
+  blitz::Array<U,2> output_ = output.bz<U,2>();
+  op(input.bz<T,2>(), output_, e1y, e1x, e2y, e2x);
+}
+
+template <typename T>
+static void inner_call1(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::ndarray output,
+  double e1y, double e1x, double e2y, double e2x)
+{
+  if (output_type(op) == bob::core::array::t_uint16)
+    inner_call1<T,uint16_t>(op, input, output, e1y, e1x, e2y, e2x);
+  else
+    inner_call1<T,double>(op, input, output, e1y, e1x, e2y, e2x);
+}
+
+static void call1(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::ndarray output,
+  double e1y, double e1x, double e2y, double e2x)
+{
+  const bob::core::array::typeinfo& info = input.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8:
+      return inner_call1<uint8_t>(op, input, output, e1y, e1x, e2y, e2x);
+    case bob::core::array::t_uint16:
+      return inner_call1<uint16_t>(op, input, output, e1y, e1x, e2y, e2x);
+    case bob::core::array::t_float64:
+      return inner_call1<double>(op, input, output, e1y, e1x, e2y, e2x);
+    default: PYTHON_ERROR(TypeError, "FaceNormPipeline __call__ does not support array of type '%s'.", info.str().c_str());
+  }
+}
+
+static object call1b(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, double e1y, double e1x, double e2y,
+  double e2x)
+{
+  const blitz::TinyVector<int,2> shape = op.getOutputShape();
+  bob::python::ndarray output(output_type(op), shape(0), shape(1));
+  call1(op, input, output, e1y, e1x, e2y, e2x);
+  return output.self();
+}
+
+template <typename T, typename U>
+static void inner_call2(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output)
+{
+  blitz::Array<U,3> output_ = output.bz<U,3>();
+  op(input.bz<T,3>(), output_, eyes.bz<double,2>());
+}
+
+template <typename T>
+static void inner_call2(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output)
+{
+  if (output_type(op) == bob::core::array::t_uint16)
+    inner_call2<T,uint16_t>(op, input, eyes, output);
+  else
+    inner_call2<T,double>(op, input, eyes, output);
+}
+
+static void call2(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes,
+  bob::python::ndarray output)
+{
+  const bob::core::array::typeinfo& info = input.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8:
+      return inner_call2<uint8_t>(op, input, eyes, output);
+    case bob::core::array::t_uint16:
+      return inner_call2<uint16_t>(op, input, eyes, output);
+    case bob::core::array::t_float64:
+      return inner_call2<double>(op, input, eyes, output);
+    default: PYTHON_ERROR(TypeError, "FaceNormPipeline process_batch does not support array of type '%s'.", info.str().c_str());
+  }
+}
+
+static object call2b(bob::ip::FaceNormPipeline& op,
+  bob::python::const_ndarray input, bob::python::const_ndarray eyes)
+{
+  const blitz::TinyVector<int,2> shape = op.getOutputShape();
+  bob::python::ndarray output(output_type(op), (int)input.type().shape[0],
+    shape(0), shape(1));
+  call2(op, input, eyes, output);
+  return output.self();
+}
+
+static tuple get_output_shape(const bob::ip::FaceNormPipeline& op)
+{
+  const blitz::TinyVector<int,2> shape = op.getOutputShape();
+  return make_tuple(shape(0), shape(1));
+}
+
+void bind_ip_facenormpipeline() {
+  class_<bob::ip::FaceNormPipeline, boost::shared_ptr<bob::ip::FaceNormPipeline> >("FaceNormPipeline", facenormpipeline_doc, init<const bob::ip::FaceEyesNorm&, const bob::ip::TanTriggs&, optional<const size_t> >((arg("face_eyes_norm"), arg("tan_triggs"), arg("tile_height")=16), "Constructs a pipeline that outputs the preprocessed faces (numpy.float64)."))
+      .def(init<const bob::ip::FaceEyesNorm&, const bob::ip::TanTriggs&, const bob::ip::LBP&, optional<const size_t> >((arg("face_eyes_norm"), arg("tan_triggs"), arg("lbp"), arg("tile_height")=16), "Constructs a pipeline that outputs the LBP codes (numpy.uint16) of the preprocessed faces."))
+      .def(init<const bob::ip::FaceEyesNorm&, const bob::ip::TanTriggs&, const bob::ip::DCTFeatures&, optional<const size_t> >((arg("face_eyes_norm"), arg("tan_triggs"), arg("dct_features"), arg("tile_height")=16), "Constructs a pipeline that outputs the DCT features (numpy.float64, one row per block) of the preprocessed faces."))
+      .def(init<bob::ip::FaceNormPipeline&>(args("other")))
+      .add_property("face_eyes_norm", make_function(&bob::ip::FaceNormPipeline::getFaceEyesNorm, return_value_policy<copy_const_reference>()), "A copy of the geometric normalization stage")
+      .add_property("tan_triggs", make_function(&bob::ip::FaceNormPipeline::getTanTriggs, return_value_policy<copy_const_reference>()), "A copy of the Tan and Triggs stage")
+      .add_property("tile_height", &bob::ip::FaceNormPipeline::getTileHeight, &bob::ip::FaceNormPipeline::setTileHeight, "The number of rows of the cropped face that are processed at once")
+      .add_property("n_threads", &bob::ip::FaceNormPipeline::getNThreads, &bob::ip::FaceNormPipeline::setNThreads, "The number of threads that the faces of a batch are distributed over (default: 1).")
+      .add_property("output_shape", &get_output_shape, "The shape of the output for a single face")
+      .def("__call__", &call1, (arg("self"), arg("input"), arg("output"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Processes a face given the coordinates of the right (re_y, re_x) and left (le_y, le_x) eye centers. The output should have the output_shape, and be of type numpy.uint16 for LBP codes and numpy.float64 otherwise.")
+      .def("__call__", &call1b, (arg("self"), arg("input"), arg("re_y"), arg("re_x"), arg("le_y"), arg("le_x")), "Processes a face given the coordinates of the right (re_y, re_x) and left (le_y, le_x) eye centers. The output is allocated and returned.")
+      .def("process_batch", &call2, (arg("self"), arg("input"), arg("eyes"), arg("output")), "Processes the faces input[i,:,:], given the eye coordinates eyes[i,:] = (re_y, re_x, le_y, le_x), into output[i,:,:]. The faces are distributed over n_threads threads.")
+      .def("process_batch", &call2b, (arg("self"), arg("input"), arg("eyes")), "Processes the faces input[i,:,:], given the eye coordinates eyes[i,:] = (re_y, re_x, le_y, le_x). The output is allocated and returned.")
+    ;
+}
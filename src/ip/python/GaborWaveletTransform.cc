@@ -61,6 +61,37 @@ static inline const blitz::Array<std::complex<double>, 2> convert_image(bob::pyt
   }
 }
 
+template <class T>
+static inline const blitz::Array<double,2> real_cast (bob::python::const_ndarray input){
+  blitz::Array<T,2> gray(input.type().shape[1],input.type().shape[2]);
+  bob::ip::rgb_to_gray(input.bz<T,3>(), gray);
+  return bob::core::array::cast<double>(gray);
+}
+
+//! converts real-valued images to double, so that the real-to-complex FFT can be used
+static inline const blitz::Array<double, 2> convert_real_image(bob::python::const_ndarray input){
+  if (input.type().nd == 3){
+    // perform color type conversion
+    switch (input.type().dtype){
+      case bob::core::array::t_uint8: return real_cast<uint8_t>(input);
+      case bob::core::array::t_uint16: return real_cast<uint16_t>(input);
+      case bob::core::array::t_float64: return real_cast<double>(input);
+      default: throw bob::core::Exception();
+    }
+  } else {
+    switch (input.type().dtype){
+      case bob::core::array::t_uint8: return bob::core::array::cast<double>(input.bz<uint8_t,2>());
+      case bob::core::array::t_uint16: return bob::core::array::cast<double>(input.bz<uint16_t,2>());
+      case bob::core::array::t_float64: return input.bz<double,2>();
+      default: throw bob::core::Exception();
+    }
+  }
+}
+
+static inline bool is_complex(bob::python::const_ndarray input){
+  return input.type().dtype == bob::core::array::t_complex128;
+}
+
 static inline void transform (bob::ip::GaborKernel& kernel, blitz::Array<std::complex<double>,2>& input, blitz::Array<std::complex<double>,2>& output){
  // perform fft on input image
   bob::sp::FFT2D fft(input.extent(0), input.extent(1));
@@ -104,15 +135,19 @@ static blitz::Array<std::complex<double>,3> empty_trafo_image (bob::ip::GaborWav
 }
 
 static void perform_gwt_1 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_trafo_image){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image = output_trafo_image.bz<std::complex<double>,3>();
-  gwt.performGWT(image, trafo_image);
+  if (is_complex(input_image))
+    gwt.performGWT(convert_image(input_image), trafo_image);
+  else
+    gwt.performGWT(convert_real_image(input_image), trafo_image);
 }
 
 static blitz::Array<std::complex<double>,3> perform_gwt_2 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
-  blitz::Array<std::complex<double>,3> trafo_image(gwt.numberOfKernels(), image.shape()[0], image.shape()[1]);
-  gwt.performGWT(image, trafo_image);
+  blitz::Array<std::complex<double>,3> trafo_image = empty_trafo_image(gwt, input_image);
+  if (is_complex(input_image))
+    gwt.performGWT(convert_image(input_image), trafo_image);
+  else
+    gwt.performGWT(convert_real_image(input_image), trafo_image);
   return trafo_image;
 }
 
@@ -124,17 +159,33 @@ static bob::python::ndarray empty_jet_image(bob::ip::GaborWaveletTransform& gwt,
     return bob::python::ndarray (bob::core::array::t_float64, image.extent(0), image.extent(1), (int)gwt.numberOfKernels());
 }
 
-static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
+template <typename J, int N>
+static void compute_jets_(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
+  blitz::Array<J,N> jet_image = output_jet_image.bz<J,N>();
+  if (is_complex(input_image))
+    gwt.computeJetImage(convert_image(input_image), jet_image, normalized);
+  else
+    gwt.computeJetImage(convert_real_image(input_image), jet_image, normalized);
+}
 
-  if (output_jet_image.type().nd == 3){
-    // compute jet image with absolute values only
-    blitz::Array<double,3> jet_image = output_jet_image.bz<double,3>();
-    gwt.computeJetImage(image, jet_image, normalized);
-  } else if (output_jet_image.type().nd == 4){
-    blitz::Array<double,4> jet_image = output_jet_image.bz<double,4>();
-    gwt.computeJetImage(image, jet_image, normalized);
-  } else throw bob::core::array::UnexpectedShapeError();
+static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
+  const bob::core::array::typeinfo& info = output_jet_image.type();
+  if (info.nd != 3 && info.nd != 4) throw bob::core::array::UnexpectedShapeError();
+
+  switch (info.dtype){
+    case bob::core::array::t_float64:
+      // compute jet image with absolute values only, or with phases
+      if (info.nd == 3) compute_jets_<double,3>(gwt, input_image, output_jet_image, normalized);
+      else compute_jets_<double,4>(gwt, input_image, output_jet_image, normalized);
+      break;
+    case bob::core::array::t_float32:
+      // single precision jet images
+      if (info.nd == 3) compute_jets_<float,3>(gwt, input_image, output_jet_image, normalized);
+      else compute_jets_<float,4>(gwt, input_image, output_jet_image, normalized);
+      break;
+    default:
+      PYTHON_ERROR(TypeError, "jet images of type '%s' are not supported (use float64 or float32)", info.str().c_str());
+  }
 }
 
 static bob::python::ndarray compute_jets_2(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bool include_phases, bool normalized){
@@ -144,16 +195,22 @@ static bob::python::ndarray compute_jets_2(bob::ip::GaborWaveletTransform& gwt,
 }
 
 
-static void normalize_gabor_jet(bob::python::ndarray gabor_jet){
+template <typename J>
+static void normalize_gabor_jet_(bob::python::ndarray gabor_jet){
   if (gabor_jet.type().nd == 1){
-    blitz::Array<double,1> jet(gabor_jet.bz<double,1>());
+    blitz::Array<J,1> jet(gabor_jet.bz<J,1>());
     bob::ip::normalizeGaborJet(jet);
   } else if (gabor_jet.type().nd == 2){
-    blitz::Array<double,2> jet(gabor_jet.bz<double,2>());
+    blitz::Array<J,2> jet(gabor_jet.bz<J,2>());
     bob::ip::normalizeGaborJet(jet);
   } else throw bob::core::array::UnexpectedShapeError();
 }
 
+static void normalize_gabor_jet(bob::python::ndarray gabor_jet){
+  if (gabor_jet.type().dtype == bob::core::array::t_float32) normalize_gabor_jet_<float>(gabor_jet);
+  else normalize_gabor_jet_<double>(gabor_jet);
+}
+
 void bind_ip_gabor_wavelet_transform() {
   // bind Gabor Kernel class
   boost::python::class_<bob::ip::GaborKernel, boost::shared_ptr<bob::ip::GaborKernel> >(
@@ -251,6 +308,13 @@ void bind_ip_gabor_wavelet_transform() {
     "The number of directions that this Gabor wavelet family holds."
   )
 
+  .add_property(
+    "number_of_threads",
+    &bob::ip::GaborWaveletTransform::numberOfThreads,
+    &bob::ip::GaborWaveletTransform::setNumberOfThreads,
+    "The number of threads that the Gabor wavelets are distributed over when transforming an image (default: 1). Each thread uses its own buffers of the size of the image."
+  )
+
   .def(
     "empty_trafo_image",
     &empty_trafo_image,
@@ -297,7 +361,7 @@ void bind_ip_gabor_wavelet_transform() {
     "compute_jets",
     &compute_jets_1,
     (boost::python::arg("self"), boost::python::arg("input_image"), boost::python::arg("output_jet_image"), boost::python::arg("normalized")=true),
-    "Performs a Gabor wavelet transform and fills given image of Gabor jets. If the normalized parameter is set to True (the default), the absolute parts of the Gabor jets are normalized to unit Euclidean length."
+    "Performs a Gabor wavelet transform and fills given image of Gabor jets. If the normalized parameter is set to True (the default), the absolute parts of the Gabor jets are normalized to unit Euclidean length. The jet image can be of type float64 or float32; in the latter case, the transform is still computed in double precision."
   )
 
   .def(
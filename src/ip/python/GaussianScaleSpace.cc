@@ -145,6 +145,7 @@ void bind_ip_gaussian_scale_space()
       .add_property("sigma0", &bob::ip::GaussianScaleSpace::getSigma0, &bob::ip::GaussianScaleSpace::setSigma0, "The value sigma0 of the standard deviation for the image of the first octave and first scale")
       .add_property("kernel_radius_factor", &bob::ip::GaussianScaleSpace::getKernelRadiusFactor, &bob::ip::GaussianScaleSpace::setKernelRadiusFactor, "Factor used to determine the kernel radii (size=2*radius+1). For each Gaussian kernel, the radius is equal to ceil(kernel_radius_factor*sigma_{octave,scale}).")
       .add_property("conv_border", &bob::ip::GaussianScaleSpace::getConvBorder, &bob::ip::GaussianScaleSpace::setConvBorder, "The way to deal with convolutions at the image boundary.")
+      .add_property("n_threads", &bob::ip::GaussianScaleSpace::getNThreads, &bob::ip::GaussianScaleSpace::setNThreads, "The number of threads smoothing the rows of each image of the pyramid. The results do not depend on it.")
       .def("get_gaussian", &bob::ip::GaussianScaleSpace::getGaussian, (arg("self"), arg("index")), "Returns the Gaussian at index/interval i")
       .def("set_sigma0_no_init_smoothing", &bob::ip::GaussianScaleSpace::setSigma0NoInitSmoothing, (arg("self")), "Sets sigma0 such that there is not smoothing at the first scale of octave_min.")
       .def("allocate_output", &allocate_output, (arg("self")), "Allocates a python list of arrays for the Gaussian pyramid.")
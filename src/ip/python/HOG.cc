@@ -24,6 +24,7 @@
 #include "bob/core/python/ndarray.h"
 #include "bob/core/cast.h"
 #include "bob/ip/HOG.h"
+#include "bob/ip/DenseHOG.h"
 
 using namespace boost::python;
 
@@ -569,6 +570,90 @@ static object hog_call2_p(bob::ip::HOG<double>& obj,
 }
 
 
+template <typename T> 
+static void inner_dense_hog_set_image(bob::ip::DenseHOG<double>& obj, 
+  bob::python::const_ndarray input)
+{
+  obj.setImage(bob::core::array::cast<double>(input.bz<T,2>()));
+}
+
+static void dense_hog_set_image(bob::ip::DenseHOG<double>& obj, 
+  bob::python::const_ndarray input) 
+{
+  const bob::core::array::typeinfo& info = input.type();
+  switch (info.dtype) {
+    case bob::core::array::t_uint8: 
+      return inner_dense_hog_set_image<uint8_t>(obj, input);
+    case bob::core::array::t_uint16:
+      return inner_dense_hog_set_image<uint16_t>(obj, input);
+    case bob::core::array::t_float64: 
+      return obj.setImage(input.bz<double,2>());
+    default: 
+      PYTHON_ERROR(TypeError, 
+        "bob.ip.DenseHOG set_image does not support array with type '%s'.", 
+        info.str().c_str());
+  }
+}
+
+static void dense_hog_cell_histogram(bob::ip::DenseHOG<double>& obj, 
+  const int y, const int x, const size_t height, const size_t width,
+  bob::python::ndarray hist)
+{
+  blitz::Array<double,1> hist_ = hist.bz<double,1>();
+  obj.cellHistogram(y, x, height, width, hist_);
+}
+
+static object dense_hog_cell_histogram_p(bob::ip::DenseHOG<double>& obj, 
+  const int y, const int x, const size_t height, const size_t width)
+{
+  bob::python::ndarray hist(bob::core::array::t_float64, 
+    obj.getHOG().getCellDim());
+  dense_hog_cell_histogram(obj, y, x, height, width, hist);
+  return hist.self();
+}
+
+static void dense_hog_forward(bob::ip::DenseHOG<double>& obj, 
+  const int y, const int x, bob::python::ndarray output)
+{
+  blitz::Array<double,3> output_ = output.bz<double,3>();
+  obj.forwardWindow(y, x, output_);
+}
+
+static object dense_hog_forward_p(bob::ip::DenseHOG<double>& obj, 
+  const int y, const int x)
+{
+  const blitz::TinyVector<int,3> shape = obj.getHOG().getOutputShape();
+  bob::python::ndarray output(bob::core::array::t_float64, 
+    shape(0), shape(1), shape(2));
+  dense_hog_forward(obj, y, x, output);
+  return output.self();
+}
+
+static void dense_hog_call(bob::ip::DenseHOG<double>& obj, 
+  const size_t step_y, const size_t step_x, bob::python::ndarray output)
+{
+  blitz::Array<double,3> output_ = output.bz<double,3>();
+  obj.forwardDense(step_y, step_x, output_);
+}
+
+static object dense_hog_call_p(bob::ip::DenseHOG<double>& obj, 
+  const size_t step_y, const size_t step_x)
+{
+  const blitz::TinyVector<int,3> shape = obj.getOutputShape(step_y, step_x);
+  bob::python::ndarray output(bob::core::array::t_float64, 
+    shape(0), shape(1), shape(2));
+  dense_hog_call(obj, step_y, step_x, output);
+  return output.self();
+}
+
+static tuple dense_hog_get_output_shape(bob::ip::DenseHOG<double>& obj, 
+  const size_t step_y, const size_t step_x)
+{
+  const blitz::TinyVector<int,3> shape = obj.getOutputShape(step_y, step_x);
+  return make_tuple(shape(0), shape(1), shape(2));
+}
+
+
 void bind_ip_hog() 
 {
   static const char* gradientmaps_doc = 
@@ -577,6 +662,14 @@ void bind_ip_hog()
   static const char* hog_doc = 
     "Objects of this class, after configuration, can extract \
      Histogram of Gradients (HOG) descriptors.";
+  static const char* dense_hog_doc = 
+    "Objects of this class extract the HOG descriptors of many windows of \
+     the same image. The gradients of the image are computed once, and \
+     accumulated into integral histograms, from which the histogram of any \
+     cell is obtained by lookup. The windows and their descriptors are \
+     configured by a HOG extractor. Since the gradients are the ones of the \
+     whole image, they are centered at the boundaries of the windows which \
+     do not lie on the boundaries of the image.";
 
   boost::python::enum_<bob::ip::GradientMagnitudeType>("GradientMagnitudeType")
     .value("Magnitude", bob::ip::Magnitude)
@@ -764,4 +857,54 @@ void bind_ip_hog()
     .def("forward_", &hog_call2_p, (arg("input")),
       "Extract the HOG descriptors. This variant does not check the inputs.")
   ;
+
+  class_<bob::ip::DenseHOG<double>, boost::shared_ptr<bob::ip::DenseHOG<double> > >(
+      "DenseHOG", 
+      dense_hog_doc, 
+      init<const bob::ip::HOG<double>&>((arg("hog")),
+        "Constructs a new dense HOG extractor, whose windows and descriptors \
+         are the ones of the given HOG extractor."))
+    .def(init<bob::ip::DenseHOG<double>&>(args("other")))
+    .add_property("hog", make_function(&bob::ip::DenseHOG<double>::getHOG,
+      return_value_policy<copy_const_reference>()),
+      "A copy of the HOG extractor that configures the windows.")
+    .add_property("height", &bob::ip::DenseHOG<double>::getHeight,
+      "Height of the current image.")
+    .add_property("width", &bob::ip::DenseHOG<double>::getWidth,
+      "Width of the current image.")
+    .add_property("n_threads", &bob::ip::DenseHOG<double>::getNThreads,
+      &bob::ip::DenseHOG<double>::setNThreads,
+      "The number of threads that the rows of the image (and of windows) \
+       are distributed over (default: 1).")
+    .def("set_image", &dense_hog_set_image, (arg("input")),
+      "Computes the gradients and the integral histograms of the image.")
+    .def("cell_histogram", &dense_hog_cell_histogram, 
+      (arg("y"), arg("x"), arg("height"), arg("width"), arg("hist")),
+      "Computes the histogram of the gradients of the given cell of the \
+       current image.")
+    .def("cell_histogram", &dense_hog_cell_histogram_p, 
+      (arg("y"), arg("x"), arg("height"), arg("width")),
+      "Computes the histogram of the gradients of the given cell of the \
+       current image.")
+    .def("forward", &dense_hog_forward, (arg("y"), arg("x"), arg("output")),
+      "Extracts the HOG descriptors of the window of the current image \
+       whose top left corner is (y,x).")
+    .def("forward", &dense_hog_forward_p, (arg("y"), arg("x")),
+      "Extracts the HOG descriptors of the window of the current image \
+       whose top left corner is (y,x).")
+    .def("get_output_shape", &dense_hog_get_output_shape, 
+      (arg("step_y"), arg("step_x")),
+      "Gets the shape of the output of __call__().")
+    .def("__call__", &dense_hog_call, 
+      (arg("step_y"), arg("step_x"), arg("output")),
+      "Extracts the HOG descriptors of all the windows of the current \
+       image, sampled every step_y rows and step_x columns. output[i,j,:] \
+       contains the flattened descriptors of the window whose top left \
+       corner is (i*step_y,j*step_x).")
+    .def("__call__", &dense_hog_call_p, (arg("step_y"), arg("step_x")),
+      "Extracts the HOG descriptors of all the windows of the current \
+       image, sampled every step_y rows and step_x columns. output[i,j,:] \
+       contains the flattened descriptors of the window whose top left \
+       corner is (i*step_y,j*step_x).")
+  ;
 }
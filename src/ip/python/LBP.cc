@@ -28,6 +28,7 @@
 #include <bob/ip/LBP8R.h>
 #include <bob/ip/LBP16R.h>
 #include <bob/ip/LBPTop.h>
+#include <bob/ip/LBPTopStream.h>
 #include <bob/ip/LBPHSFeatures.h>
 
 using namespace boost::python;
@@ -131,6 +132,20 @@ static void call_lbptop (const bob::ip::LBPTop& op, bob::python::const_ndarray i
   }
 }
 
+template <typename T>
+static bool inner_lbptop_push (bob::ip::LBPTopStream& op, bob::python::const_ndarray frame) {
+  return op.push(frame.bz<T,2>());
+}
+
+static bool lbptop_push (bob::ip::LBPTopStream& op, bob::python::const_ndarray frame) {
+  switch(frame.type().dtype) {
+    case bob::core::array::t_uint8: return inner_lbptop_push<uint8_t>(op, frame);
+    case bob::core::array::t_uint16: return inner_lbptop_push<uint16_t>(op, frame);
+    case bob::core::array::t_float64: return inner_lbptop_push<double>(op, frame);
+    default:
+      PYTHON_ERROR(TypeError, "LBPTopStream cannot process frame of type '%s'", frame.type().str().c_str());
+  }
+}
 
 template <typename T> 
 static object inner_lbp_apply (bob::ip::LBPHSFeatures& op, bob::python::const_ndarray input) {
@@ -197,6 +212,23 @@ void bind_ip_lbp_new() {
     .def("__call__", &call_lbptop, (arg("self"),arg("input"), arg("xy"), arg("xt"), arg("yt")), "Processes a 3D array representing a set of <b>grayscale</b> images and returns (by argument) the three LBP planes calculated. The 3D array has to be arranged in this way:\n\n1st dimension => time\n2nd dimension => frame height\n3rd dimension => frame width\n\nThe central pixel is the point where the LBP planes interesect/have to be calculated from.")
     ;
 
+  class_<bob::ip::LBPTopStream, boost::shared_ptr<bob::ip::LBPTopStream>, boost::noncopyable>("LBPTopStream",
+ "Computes LBP-Top histograms over a sliding temporal window of a stream of <b>grayscale</b> frames. Frames are pushed one at a time; the last 2R+1 frames are kept in a ring buffer and, for each new frame, the XY, XT and YT codes of the frame R positions behind it are computed once and accumulated into the histograms of the last 'window' such frames.", init<const bob::ip::LBPTop&, size_t>((arg("lbptop"), arg("window")), "Constructs a new LBPTopStream from an LBPTop configuration and the number of (central) frames the histograms are accumulated over"))
+    .add_property("window", &bob::ip::LBPTopStream::getWindow, "The number of central frames the histograms are accumulated over")
+    .add_property("radius", &bob::ip::LBPTopStream::getRadius, "The number of frames a central frame lags behind the last pushed one (also the spatial border)")
+    .add_property("n_frames", &bob::ip::LBPTopStream::getNFrames, "The number of frames pushed since the last reset")
+    .add_property("n_processed", &bob::ip::LBPTopStream::getNProcessed, "The number of central frames processed since the last reset")
+    .add_property("ready", &bob::ip::LBPTopStream::isReady, "If the histograms cover a full window")
+    .add_property("xy", make_function(&bob::ip::LBPTopStream::getXY, return_value_policy<copy_const_reference>()), "The XY codes of the last processed central frame")
+    .add_property("xt", make_function(&bob::ip::LBPTopStream::getXT, return_value_policy<copy_const_reference>()), "The XT codes of the last processed central frame")
+    .add_property("yt", make_function(&bob::ip::LBPTopStream::getYT, return_value_policy<copy_const_reference>()), "The YT codes of the last processed central frame")
+    .add_property("xy_histogram", make_function(&bob::ip::LBPTopStream::getXYHistogram, return_value_policy<copy_const_reference>()), "The XY histogram over the current window")
+    .add_property("xt_histogram", make_function(&bob::ip::LBPTopStream::getXTHistogram, return_value_policy<copy_const_reference>()), "The XT histogram over the current window")
+    .add_property("yt_histogram", make_function(&bob::ip::LBPTopStream::getYTHistogram, return_value_policy<copy_const_reference>()), "The YT histogram over the current window")
+    .def("push", &lbptop_push, (arg("self"), arg("frame")), "Pushes the next frame of the stream (all frames should have the same size). Returns True if the histograms cover a full window.")
+    .def("reset", &bob::ip::LBPTopStream::reset, (arg("self")), "Forgets all the frames pushed so far")
+    ;
+
 
   class_<bob::ip::LBPHSFeatures, boost::shared_ptr<bob::ip::LBPHSFeatures> >("LBPHSFeatures", "Constructs a new LBPHSFeatures object to extract histogram of LBP over 2D blitz arrays/images.", init<const int, const int, const int, const int, optional<const double, const int, const bool, const bool, const bool, const bool, const bool> >((arg("block_h"), arg("block_w"), arg("overlap_h"), arg("overlap_w"), arg("lbp_radius")=1., arg("lbp_neighbours")=8, arg("circular")=false,arg("to_average")=false,arg("add_average_bit")=false,arg("uniform")=false, arg("rotation_invariant")=false), "Constructs a new DCT features extractor."))
     .add_property("n_bins", &bob::ip::LBPHSFeatures::getNBins)
@@ -89,6 +89,7 @@ void bind_ip_sift()
       .add_property("gaussian_window_size", &bob::ip::SIFT::getGaussianWindowSize, &bob::ip::SIFT::setGaussianWindowSize, "The Gaussian window size for the descriptor")
       .add_property("magnif", &bob::ip::SIFT::getMagnif, &bob::ip::SIFT::setMagnif, "The magnification factor for the descriptor")
       .add_property("norm_epsilon", &bob::ip::SIFT::getNormEpsilon, &bob::ip::SIFT::setNormEpsilon, "The epsilon value added during the descriptor normalization")
+      .add_property("n_threads", &bob::ip::SIFT::getNThreads, &bob::ip::SIFT::setNThreads, "The number of threads used to compute the Gaussian pyramid, the Difference of Gaussians and the gradients. The descriptors do not depend on it.")
       .def("set_sigma0_no_init_smoothing", &bob::ip::SIFT::setSigma0NoInitSmoothing, (arg("self")), "Sets sigma0 such that there is not smoothing at the first scale of octave_min.")
       .def("compute_descriptor", &compute_descr_p, (arg("self"), arg("src"), arg("keypoints")), "Computes SIFT descriptor for a 2D/grayscale image, at the given keypoints. The dst array will be allocated and returned.")
       .def("get_descriptor_shape", &bob::ip::SIFT::getDescriptorShape, (arg("self")), "Returns the shape of a descriptor for a given keypoint")
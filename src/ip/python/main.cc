@@ -57,6 +57,7 @@ void bind_ip_glcm_uint8();
 void bind_ip_glcm_uint16();
 void bind_ip_glcmprop();
 void bind_ip_sift();
+void bind_ip_facenormpipeline();
 
 #if WITH_VLFEAT
 void bind_ip_vlsift();
@@ -101,6 +102,7 @@ BOOST_PYTHON_MODULE(_ip) {
   bind_ip_glcm_uint16();
   bind_ip_glcmprop();
   bind_ip_sift();
+  bind_ip_facenormpipeline();
 
 #if WITH_VLFEAT
   bind_ip_vlsift();
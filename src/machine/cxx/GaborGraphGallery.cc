@@ -0,0 +1,303 @@
+/**
+ * @file machine/cxx/GaborGraphGallery.cc
+ * @date Sun Oct 18 13:21:08 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the comparison of a probe graph with a gallery of Gabor graphs
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/machine/GaborGraphGallery.h>
+#include <bob/core/assert.h>
+#include <bob/core/Exception.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+
+//! the number of gallery graphs that are processed as one block
+static const int TILE_SIZE = 256;
+
+bob::machine::GaborGraphGallery::GaborGraphGallery(
+  const bob::machine::GaborJetSimilarity& jet_similarity_function,
+  bool single_precision
+)
+: m_similarity(jet_similarity_function),
+  m_single_precision(single_precision),
+  m_size(0),
+  m_number_of_nodes(0),
+  m_number_of_kernels(0),
+  m_number_of_threads(1)
+{
+}
+
+void bob::machine::GaborGraphGallery::setNumberOfThreads(unsigned number_of_threads){
+  m_number_of_threads = std::max(number_of_threads, 1u);
+}
+
+void bob::machine::GaborGraphGallery::clear(){
+  m_size = m_number_of_nodes = m_number_of_kernels = 0;
+  m_abs.clear(); m_phases.clear();
+  m_abs_single.clear(); m_phases_single.clear();
+}
+
+void bob::machine::GaborGraphGallery::checkLayout(int number_of_nodes, int number_of_kernels){
+  if (m_size == 0){
+    if (m_similarity.usesPhases())
+      bob::core::array::assertSameDimensionLength(number_of_kernels, m_similarity.numberOfKernels());
+    m_number_of_nodes = number_of_nodes;
+    m_number_of_kernels = number_of_kernels;
+  } else {
+    bob::core::array::assertSameDimensionLength(number_of_nodes, m_number_of_nodes);
+    bob::core::array::assertSameDimensionLength(number_of_kernels, m_number_of_kernels);
+  }
+}
+
+template <typename T>
+static void push_back(std::vector<T>& data, const blitz::Array<double,2>& values){
+  for (int n = 0; n < values.extent(0); ++n)
+    for (int j = 0; j < values.extent(1); ++j)
+      data.push_back(static_cast<T>(values(n,j)));
+}
+
+void bob::machine::GaborGraphGallery::append(
+  const blitz::Array<double,2>& abs,
+  const blitz::Array<double,2>* phases
+)
+{
+  if (m_similarity.usesPhases() && !phases)
+    throw bob::core::InvalidArgumentException("The Gabor jet similarity function requires Gabor graphs including phases");
+  checkLayout(abs.extent(0), abs.extent(1));
+
+  if (m_single_precision){
+    push_back(m_abs_single, abs);
+    if (m_similarity.usesPhases()) push_back(m_phases_single, *phases);
+  } else {
+    push_back(m_abs, abs);
+    if (m_similarity.usesPhases()) push_back(m_phases, *phases);
+  }
+  ++m_size;
+}
+
+/**
+ * Adds the given Gabor graph (including phases) to the gallery.
+ * @param graph_jets  The Gabor graph, with shape (#nodes, 2, #kernels)
+ */
+void bob::machine::GaborGraphGallery::add(const blitz::Array<double,3>& graph_jets){
+  bob::core::array::assertSameDimensionLength(graph_jets.extent(1), 2);
+  blitz::Range all = blitz::Range::all();
+  blitz::Array<double,2> abs(graph_jets(all, 0, all)), phases(graph_jets(all, 1, all));
+  append(abs, &phases);
+}
+
+/**
+ * Adds the given Gabor graph (without phases) to the gallery.
+ * @param graph_jets  The Gabor graph, with shape (#nodes, #kernels)
+ */
+void bob::machine::GaborGraphGallery::add(const blitz::Array<double,2>& graph_jets){
+  append(graph_jets, 0);
+}
+
+/**
+ * Adds the given Gabor graphs (including phases) to the gallery.
+ * @param many_graph_jets  The Gabor graphs, with shape (#graphs, #nodes, 2, #kernels)
+ */
+void bob::machine::GaborGraphGallery::add(const blitz::Array<double,4>& many_graph_jets){
+  blitz::Range all = blitz::Range::all();
+  for (int p = 0; p < many_graph_jets.extent(0); ++p){
+    add(many_graph_jets(p, all, all, all));
+  }
+}
+
+/**
+ * The data that the threads share while comparing a probe with the gallery.
+ */
+template <typename T>
+struct ScoreJob {
+  const bob::machine::GaborJetSimilarity* similarity;
+  const T* abs; //!< the absolute values of the gallery
+  const T* phases; //!< the phases of the gallery (might be NULL)
+  const double* probe_abs;
+  const double* probe_phases;
+  int size, nodes, kernels;
+  double* scores;
+};
+
+/**
+ * Computes the scores of the tiles (t, t+T, t+2T, ...) with thread t of T.
+ */
+template <typename T>
+static void score_tiles(const ScoreJob<T>& job, unsigned thread, unsigned number_of_threads){
+  // private buffers of this thread
+  std::vector<double> confidences(job.kernels), phase_differences(job.kernels);
+  blitz::TinyVector<double,2> disparity;
+  const int graph_size = job.nodes * job.kernels;
+
+  for (int begin = thread * TILE_SIZE; begin < job.size; begin += number_of_threads * TILE_SIZE){
+    int end = std::min(begin + TILE_SIZE, job.size);
+    for (int p = begin; p < end; ++p){
+      // same as GaborGraphMachine::similarity
+      double similarity = 0.;
+      for (int i = 0; i < job.nodes; ++i){
+        const size_t offset = (size_t)p * graph_size + i * job.kernels;
+        similarity += job.similarity->similarity(
+          job.abs + offset, job.phases ? job.phases + offset : 0,
+          job.probe_abs + i * job.kernels, job.probe_phases ? job.probe_phases + i * job.kernels : 0,
+          job.kernels, &confidences[0], &phase_differences[0], disparity
+        );
+      }
+      job.scores[p] = similarity / job.nodes;
+    }
+  }
+}
+
+template <typename T>
+static void score_gallery(const ScoreJob<T>& job, unsigned number_of_threads){
+  unsigned number_of_tiles = (job.size + TILE_SIZE - 1) / TILE_SIZE;
+  number_of_threads = std::min(number_of_threads, number_of_tiles);
+  if (number_of_threads <= 1){
+    score_tiles(job, 0, 1);
+    return;
+  }
+
+  boost::thread_group threads;
+  for (unsigned t = 1; t < number_of_threads; ++t){
+    threads.create_thread(boost::bind(&score_tiles<T>, boost::cref(job), t, number_of_threads));
+  }
+  score_tiles(job, 0, number_of_threads);
+  threads.join_all();
+}
+
+void bob::machine::GaborGraphGallery::computeScores(
+  const double* abs,
+  const double* phases,
+  blitz::Array<double,1>& scores
+) const
+{
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameDimensionLength(scores.extent(0), m_size);
+  if (m_size == 0) return;
+
+  if (m_single_precision){
+    ScoreJob<float> job = {
+      &m_similarity, &m_abs_single[0], m_phases_single.empty() ? 0 : &m_phases_single[0],
+      abs, phases, m_size, m_number_of_nodes, m_number_of_kernels, scores.data()
+    };
+    score_gallery(job, m_number_of_threads);
+  } else {
+    ScoreJob<double> job = {
+      &m_similarity, &m_abs[0], m_phases.empty() ? 0 : &m_phases[0],
+      abs, phases, m_size, m_number_of_nodes, m_number_of_kernels, scores.data()
+    };
+    score_gallery(job, m_number_of_threads);
+  }
+}
+
+/**
+ * Computes the similarities of the given probe graph to all graphs in the gallery.
+ * @param probe_graph_jets  The probe graph, with shape (#nodes, 2, #kernels)
+ * @param scores            The similarities, one per gallery graph
+ */
+void bob::machine::GaborGraphGallery::similarities(
+  const blitz::Array<double,3>& probe_graph_jets,
+  blitz::Array<double,1>& scores
+) const
+{
+  if (m_size) bob::core::array::assertSameShape(probe_graph_jets, blitz::shape(m_number_of_nodes, 2, m_number_of_kernels));
+  // make contiguous copies of the absolute values and phases
+  blitz::Range all = blitz::Range::all();
+  blitz::Array<double,2> abs(probe_graph_jets.extent(0), probe_graph_jets.extent(2)), phases(abs.shape());
+  abs = probe_graph_jets(all, 0, all);
+  phases = probe_graph_jets(all, 1, all);
+  computeScores(abs.data(), phases.data(), scores);
+}
+
+/**
+ * Computes the similarities of the given probe graph to all graphs in the gallery.
+ * @param probe_graph_jets  The probe graph, with shape (#nodes, #kernels)
+ * @param scores            The similarities, one per gallery graph
+ */
+void bob::machine::GaborGraphGallery::similarities(
+  const blitz::Array<double,2>& probe_graph_jets,
+  blitz::Array<double,1>& scores
+) const
+{
+  if (m_similarity.usesPhases())
+    throw bob::core::InvalidArgumentException("The Gabor jet similarity function requires Gabor graphs including phases");
+  if (m_size) bob::core::array::assertSameShape(probe_graph_jets, blitz::shape(m_number_of_nodes, m_number_of_kernels));
+  blitz::Array<double,2> abs(probe_graph_jets.shape());
+  abs = probe_graph_jets;
+  computeScores(abs.data(), 0, scores);
+}
+
+//! sorts by decreasing score and increasing index
+struct BetterScore {
+  const double* scores;
+  bool operator()(int a, int b) const {
+    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+  }
+};
+
+void bob::machine::GaborGraphGallery::best(
+  const blitz::Array<double,1>& all_scores,
+  int k,
+  blitz::Array<int,1>& indices,
+  blitz::Array<double,1>& scores
+) const
+{
+  k = std::max(0, std::min(k, m_size));
+  std::vector<int> order(m_size);
+  for (int p = 0; p < m_size; ++p) order[p] = p;
+  BetterScore better = {all_scores.data()};
+  std::partial_sort(order.begin(), order.begin() + k, order.end(), better);
+
+  indices.resize(k);
+  scores.resize(k);
+  for (int i = 0; i < k; ++i){
+    indices(i) = order[i];
+    scores(i) = all_scores(order[i]);
+  }
+}
+
+/**
+ * Searches the k most similar graphs of the gallery.
+ * @param probe_graph_jets  The probe graph, with shape (#nodes, 2, #kernels)
+ * @param k        The number of graphs to return
+ * @param indices  The indices of the most similar gallery graphs (resized to min(k, size()))
+ * @param scores   Their similarities to the probe, in decreasing order (resized to min(k, size()))
+ */
+void bob::machine::GaborGraphGallery::search(
+  const blitz::Array<double,3>& probe_graph_jets,
+  int k,
+  blitz::Array<int,1>& indices,
+  blitz::Array<double,1>& scores
+) const
+{
+  blitz::Array<double,1> all_scores(m_size);
+  similarities(probe_graph_jets, all_scores);
+  best(all_scores, k, indices, scores);
+}
+
+void bob::machine::GaborGraphGallery::search(
+  const blitz::Array<double,2>& probe_graph_jets,
+  int k,
+  blitz::Array<int,1>& indices,
+  blitz::Array<double,1>& scores
+) const
+{
+  blitz::Array<double,1> all_scores(m_size);
+  similarities(probe_graph_jets, all_scores);
+  best(all_scores, k, indices, scores);
+}
@@ -52,78 +52,133 @@ void bob::machine::GaborJetSimilarity::init(){
 }
 
 
-double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,1>& jet1, const blitz::Array<double,1>& jet2) const{
-  bob::core::array::assertCZeroBaseContiguous(jet1);
-  bob::core::array::assertCZeroBaseContiguous(jet2);
-  bob::core::array::assertSameShape(jet1,jet2);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+static double adjustPhase(double phase){
+  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+}
+
+template <typename T>
+static void compute_confidences(const T* abs1, const T* phase1, const double* abs2, const double* phase2, int length, double* confidences, double* phase_differences){
+  // first, fill confidence and phase difference vectors
+  for (int j = length; j--;){
+    confidences[j] = abs1[j] * abs2[j];
+    phase_differences[j] = adjustPhase(phase1[j] - phase2[j]);
+  }
+}
 
-  switch (m_type){
-    case SCALAR_PRODUCT:
+static void compute_disparity(const bob::ip::GaborWaveletTransform& gwt, const double* confidences, const double* phase_differences, int length, blitz::TinyVector<double,2>& disparity){
+  // approximate the disparity from the phase differences
+  double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
+  // initialize the disparity with 0
+  disparity = 0.;
+
+  const std::vector<blitz::TinyVector<double,2> >& kernels = gwt.kernelFrequencies();
+  // iterate backwards through the vector to start with the lowest frequency wavelets
+  for (int j = length-1, level = gwt.numberOfScales()-1; level >= 0; --level){
+    for (int direction = gwt.numberOfDirections()-1; direction >= 0; --direction, --j){
+      double
+          kjx = kernels[j][1],
+          kjy = kernels[j][0],
+          conf = confidences[j],
+          diff = phase_differences[j];
+
+      // totalize gamma matrix
+      gamma_x_x += kjx * kjx * conf;
+      gamma_x_y += kjx * kjy * conf;
+      gamma_y_y += kjy * kjy * conf;
+
+      // totalize phi vector
+      // estimate the number of cycles that we are off
+      double nL = round((diff - disparity[1] * kjx - disparity[0] * kjy) / (2.*M_PI));
+      // totalize corrected phi vector elements
+      phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
+      phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
+    } // for direction
+
+    // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
+    double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
+    disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+    disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+
+  } // for level
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Similarity functions  /////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+static double jet_similarity(
+  bob::machine::GaborJetSimilarity::SimilarityType type,
+  const bob::ip::GaborWaveletTransform& gwt,
+  const T* abs1, const T* phase1,
+  const double* abs2, const double* phase2,
+  int length,
+  double* confidences, double* phase_differences,
+  blitz::TinyVector<double,2>& disparity
+)
+{
+  switch (type){
+    case bob::machine::GaborJetSimilarity::SCALAR_PRODUCT:{
       // normalized scalar product
-      return std::inner_product(jet1.begin(), jet1.end(), jet2.begin(), 0.);
-    case CANBERRA:{
+      double sim = 0.;
+      for (int j = 0; j < length; ++j){
+        sim += abs1[j] * abs2[j];
+      }
+      return sim;
+    }
+    case bob::machine::GaborJetSimilarity::CANBERRA:{
       // Canberra similarity
       double sim = 0.;
-      unsigned size = jet1.shape()[0];
-      for (unsigned j = size; j--;){
-        sim += 1. - std::abs(jet1(j) - jet2(j)) / (jet1(j) + jet2(j));
+      for (int j = length; j--;){
+        sim += 1. - std::abs(abs1[j] - abs2[j]) / (abs1[j] + abs2[j]);
       }
-      return sim / size;
+      return sim / length;
     }
     default:
-      throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
-  }
-}
-
-
-double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
-  if (m_type == SCALAR_PRODUCT || m_type == CANBERRA){
-    // call the function without phases
-    return operator()(jet1(0,blitz::Range::all()), jet2(0,blitz::Range::all()));
+      break;
   }
 
   // Here, only the disparity based similarity functions are executed
-  bob::core::array::assertCZeroBaseContiguous(jet1);
-  bob::core::array::assertCZeroBaseContiguous(jet2);
-  bob::core::array::assertSameShape(jet1,jet2);
 
   // compute confidence vectors
-  compute_confidences(jet1, jet2);
+  compute_confidences(abs1, phase1, abs2, phase2, length, confidences, phase_differences);
 
   // now, compute the disparity
-  compute_disparity();
+  compute_disparity(gwt, confidences, phase_differences, length, disparity);
 
-  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
+  const std::vector<blitz::TinyVector<double,2> >& kernels = gwt.kernelFrequencies();
 
-  switch (m_type){
-    case DISPARITY:{
+  switch (type){
+    case bob::machine::GaborJetSimilarity::DISPARITY:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_confidences.size(); j--;){
-        sum += m_confidences[j] * cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = length; j--;){
+        sum += confidences[j] * cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
       }
       return sum;
     } // DISPARITY
 
-    case PHASE_DIFF:{
+    case bob::machine::GaborJetSimilarity::PHASE_DIFF:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      for (int j = length; j--;){
+        sum += cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
       }
-      return sum / jet1.shape()[1];
+      return sum / length;
     } // PHASE_DIFF
 
-    case PHASE_DIFF_PLUS_CANBERRA:{
+    case bob::machine::GaborJetSimilarity::PHASE_DIFF_PLUS_CANBERRA:{
       // compute the similarity using the estimated disparity
       double sum = 0.;
-      for (int j = m_phase_differences.size(); j--;){
+      for (int j = length; j--;){
         // add disparity term
-        sum += cos(m_phase_differences[j] - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+        sum += cos(phase_differences[j] - disparity[0] * kernels[j][0] - disparity[1] * kernels[j][1]);
         // add Canberra term
-        sum += 1. - std::abs(jet1(0,j) - jet2(0,j)) / (jet1(0,j) + jet2(0,j));
+        sum += 1. - std::abs(abs1[j] - abs2[j]) / (abs1[j] + abs2[j]);
       }
-      return sum / (2. * jet1.shape()[1]);
+      return sum / (2. * length);
     }
 
     default:
@@ -132,57 +187,55 @@ double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>
   }
 }
 
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-static double adjustPhase(double phase){
-  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+double bob::machine::GaborJetSimilarity::similarity(
+  const double* abs1, const double* phase1,
+  const double* abs2, const double* phase2,
+  int length,
+  double* confidences, double* phase_differences,
+  blitz::TinyVector<double,2>& disparity
+) const
+{
+  return jet_similarity(m_type, m_gwt, abs1, phase1, abs2, phase2, length, confidences, phase_differences, disparity);
 }
 
-void bob::machine::GaborJetSimilarity::compute_confidences(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
-  // first, fill confidence and phase difference vectors
-  for (int j = m_confidences.size(); j--;){
-    m_confidences[j] = jet1(0,j) * jet2(0,j);
-    m_phase_differences[j] = adjustPhase(jet1(1,j) - jet2(1,j));
-  }
+double bob::machine::GaborJetSimilarity::similarity(
+  const float* abs1, const float* phase1,
+  const double* abs2, const double* phase2,
+  int length,
+  double* confidences, double* phase_differences,
+  blitz::TinyVector<double,2>& disparity
+) const
+{
+  return jet_similarity(m_type, m_gwt, abs1, phase1, abs2, phase2, length, confidences, phase_differences, disparity);
 }
 
-void bob::machine::GaborJetSimilarity::compute_disparity() const{
-  // approximate the disparity from the phase differences
-  double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
-  // initialize the disparity with 0
-  m_disparity = 0.;
 
-  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt.kernelFrequencies();
-  // iterate backwards through the vector to start with the lowest frequency wavelets
-  for (int j = m_confidences.size()-1, level = m_gwt.numberOfScales()-1; level >= 0; --level){
-    for (int direction = m_gwt.numberOfDirections()-1; direction >= 0; --direction, --j){
-      double
-          kjx = kernels[j][1],
-          kjy = kernels[j][0],
-          conf = m_confidences[j],
-          diff = m_phase_differences[j];
+double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,1>& jet1, const blitz::Array<double,1>& jet2) const{
+  bob::core::array::assertCZeroBaseContiguous(jet1);
+  bob::core::array::assertCZeroBaseContiguous(jet2);
+  bob::core::array::assertSameShape(jet1,jet2);
 
-      // totalize gamma matrix
-      gamma_x_x += kjx * kjx * conf;
-      gamma_x_y += kjx * kjy * conf;
-      gamma_y_y += kjy * kjy * conf;
+  if (m_type != SCALAR_PRODUCT && m_type != CANBERRA)
+    throw bob::core::NotImplementedError("Disparity similarity (and its derivatives) need Gabor jets including phases");
 
-      // totalize phi vector
-      // estimate the number of cycles that we are off
-      double nL = round((diff - m_disparity[1] * kjx - m_disparity[0] * kjy) / (2.*M_PI));
-      // totalize corrected phi vector elements
-      phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
-      phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
-    } // for direction
+  return similarity(jet1.data(), 0, jet2.data(), 0, jet1.extent(0), 0, 0, m_disparity);
+}
 
-    // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
-    double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
-    m_disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
-    m_disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
 
-  } // for level
+double bob::machine::GaborJetSimilarity::operator()(const blitz::Array<double,2>& jet1, const blitz::Array<double,2>& jet2) const{
+  if (m_type == SCALAR_PRODUCT || m_type == CANBERRA){
+    // call the function without phases
+    return operator()(jet1(0,blitz::Range::all()), jet2(0,blitz::Range::all()));
+  }
+
+  // Here, only the disparity based similarity functions are executed
+  bob::core::array::assertCZeroBaseContiguous(jet1);
+  bob::core::array::assertCZeroBaseContiguous(jet2);
+  bob::core::array::assertSameShape(jet1,jet2);
+  bob::core::array::assertSameDimensionLength(jet1.extent(1), m_confidences.size());
+
+  const int length = jet1.extent(1);
+  return similarity(jet1.data(), jet1.data() + length, jet2.data(), jet2.data() + length, length, &m_confidences[0], &m_phase_differences[0], m_disparity);
 }
 
 
@@ -28,7 +28,9 @@
 #include <bob/machine/SVM.h>
 #include <bob/machine/MLPException.h>
 #include <bob/core/check.h>
+#include <bob/core/array_copy.h>
 #include <bob/core/logging.h>
+#include <bob/math/linear.h>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -36,6 +38,13 @@
 #include <sys/stat.h>
 #include <algorithm>
 
+/**
+ * Number of inputs for which kernels are evaluated at once in the batched
+ * prediction methods. Keeps the kernel scratch area within cache for typical
+ * numbers of support vectors.
+ */
+static const int SVM_BATCH_BLOCK = 128;
+
 static bool is_colon(char i) { return i == ':'; }
 
 bob::machine::SVMFile::SVMFile (const std::string& filename):
@@ -228,6 +237,64 @@ void bob::machine::SupportVector::reset() {
   //create and reset cache
   m_input_cache.reset(new svm_node[1 + m_input_size]);
 
+  //keeps a dense copy of the support vectors and coefficients for batched
+  //prediction - note: pre-computed kernels store the sample serial number
+  //at index 0 and cannot be densified this way.
+  const int l = m_model->l;
+  const int n_class = m_model->nr_class;
+  if (kernelType() != PRECOMPUTED) {
+    m_sv.resize(l, m_input_size);
+    m_sv = 0.;
+    m_sv_norm2.resize(l);
+    for (int k=0; k<l; ++k) {
+      for (svm_node* it = m_model->SV[k]; it->index != -1; ++it)
+        m_sv(k, it->index-1) = it->value;
+      m_sv_norm2(k) = blitz::sum(blitz::pow2(m_sv(k, blitz::Range::all())));
+    }
+  }
+  else {
+    m_sv.resize(0, 0);
+    m_sv_norm2.resize(0);
+  }
+
+  m_sv_coef.resize(n_class-1, l);
+  for (int k=0; k<n_class-1; ++k)
+    for (int i=0; i<l; ++i) m_sv_coef(k,i) = m_model->sv_coef[k][i];
+
+  m_sv_start.resize(n_class);
+  m_sv_start = 0;
+  if (m_model->nSV) { //only set for classification problems
+    for (int k=1; k<n_class; ++k)
+      m_sv_start(k) = m_sv_start(k-1) + m_model->nSV[k-1];
+  }
+
+  //collapses linear models into one weight vector per decision value
+  m_linear_weight.resize(0, 0);
+  if (kernelType() == LINEAR) {
+    blitz::Range all = blitz::Range::all();
+    m_linear_weight.resize(numberOfDecisionValues(), m_input_size);
+    m_linear_weight = 0.;
+    if (m_model->nSV) { //classification, one vector per pair of classes
+      int p = 0;
+      for (int i=0; i<n_class; ++i) {
+        for (int j=i+1; j<n_class; ++j) {
+          for (int n=m_sv_start(i); n<m_sv_start(i)+m_model->nSV[i]; ++n)
+            m_linear_weight(p,all) += m_sv_coef(j-1,n) * m_sv(n,all);
+          for (int n=m_sv_start(j); n<m_sv_start(j)+m_model->nSV[j]; ++n)
+            m_linear_weight(p,all) += m_sv_coef(i,n) * m_sv(n,all);
+          ++p;
+        }
+      }
+    }
+    else { //regression or one-class, a single vector
+      for (int n=0; n<l; ++n)
+        m_linear_weight(0,all) += m_sv_coef(0,n) * m_sv(n,all);
+    }
+    //the dense support vectors are not needed anymore
+    m_sv.resize(0, 0);
+    m_sv_norm2.resize(0);
+  }
+
   m_input_sub.resize(inputSize());
   m_input_sub = 0.0;
   m_input_div.resize(inputSize());
@@ -356,8 +423,31 @@ static inline void copy(const blitz::Array<double,1>& input,
   cache[cur].index = -1; //libsvm detects end of input if index==-1
 }
 
+/**
+ * Evaluates the decision values of a collapsed linear machine
+ */
+static inline void linear_decision(const blitz::Array<double,1>& input,
+    const blitz::Array<double,1>& sub, const blitz::Array<double,1>& div,
+    const blitz::Array<double,2>& weight, const double* rho,
+    blitz::Array<double,1>& dec) {
+  const int n_dim = input.extent(0);
+  for (int p=0; p<weight.extent(0); ++p) {
+    double sum = 0.;
+    for (int k=0; k<n_dim; ++k)
+      sum += weight(p,k) * ((input(k) - sub(k))/div(k));
+    dec(p) = sum - rho[p];
+  }
+}
+
 int bob::machine::SupportVector::predictClass_
 (const blitz::Array<double,1>& input) const {
+  if (isLinear()) {
+    blitz::Array<double,1> dec(m_linear_weight.extent(0));
+    blitz::Array<int,1> votes(numberOfClasses());
+    linear_decision(input, m_input_sub, m_input_div, m_linear_weight,
+        m_model->rho, dec);
+    return decide_(dec, votes);
+  }
   copy(input, m_input_cache, m_input_sub, m_input_div);
   int retval = round(svm_predict(m_model.get(), m_input_cache.get()));
   return retval;
@@ -378,6 +468,15 @@ int bob::machine::SupportVector::predictClass
 int bob::machine::SupportVector::predictClassAndScores_
 (const blitz::Array<double,1>& input,
  blitz::Array<double,1>& scores) const {
+  if (isLinear()) {
+    blitz::Array<double,1> dec(m_linear_weight.extent(0));
+    blitz::Array<int,1> votes(numberOfClasses());
+    linear_decision(input, m_input_sub, m_input_div, m_linear_weight,
+        m_model->rho, dec);
+    const int n = std::min(dec.extent(0), scores.extent(0));
+    scores(blitz::Range(0,n-1)) = dec(blitz::Range(0,n-1));
+    return decide_(dec, votes);
+  }
   copy(input, m_input_cache, m_input_sub, m_input_div);
 #if LIBSVM_VERSION > 290
   int retval = round(svm_predict_values(m_model.get(), m_input_cache.get(), scores.data()));
@@ -461,3 +560,229 @@ void bob::machine::SupportVector::save(bob::io::HDF5File& config) const {
   uint64_t version = LIBSVM_VERSION;
   config.setAttribute(".", "version", version);
 }
+
+size_t bob::machine::SupportVector::numberOfDecisionValues() const {
+  switch (machineType()) {
+    case ONE_CLASS:
+    case EPSILON_SVR:
+    case NU_SVR:
+      return 1;
+    default:
+      {
+        size_t n_class = numberOfClasses();
+        return (n_class*(n_class-1))/2;
+      }
+  }
+}
+
+void bob::machine::SupportVector::decisionValues_
+(const blitz::Array<double,2>& input, blitz::Array<double,2>& kernel,
+ blitz::Array<double,2>& dec) const {
+
+  const int n_input = input.extent(0);
+  const int n_sv = m_sv.extent(0);
+  if (n_input == 0) return;
+
+  if (isLinear()) { //dec = x W^T - rho, no kernel evaluation
+    const int n_dec = m_linear_weight.extent(0);
+    bob::math::prodTranspose_(input, m_linear_weight, dec);
+    for (int r=0; r<n_input; ++r)
+      for (int p=0; p<n_dec; ++p) dec(r,p) -= m_model->rho[p];
+    return;
+  }
+
+  //kernel(r,i) = <input(r,:), SV(i,:)> for all inputs and SVs at once
+  blitz::Array<double,2> kernel_ = kernel(blitz::Range(0,n_input-1), blitz::Range::all());
+  bob::math::prodTranspose_(input, m_sv, kernel_);
+
+  const double gamma = m_model->param.gamma;
+  const double coef0 = m_model->param.coef0;
+  const int degree = m_model->param.degree;
+  const kernel_t type = kernelType();
+
+  for (int r=0; r<n_input; ++r) {
+    double* k = &kernel(r,0);
+    switch (type) {
+      case POLY:
+        for (int i=0; i<n_sv; ++i) k[i] = std::pow(gamma*k[i] + coef0, degree);
+        break;
+      case RBF:
+        {
+          const double norm2 = blitz::sum(blitz::pow2(input(r, blitz::Range::all())));
+          const double* sv_norm2 = m_sv_norm2.data();
+          for (int i=0; i<n_sv; ++i) {
+            double d2 = norm2 + sv_norm2[i] - 2.*k[i];
+            k[i] = std::exp(-gamma * (d2 > 0. ? d2 : 0.));
+          }
+        }
+        break;
+      case SIGMOID:
+        for (int i=0; i<n_sv; ++i) k[i] = std::tanh(gamma*k[i] + coef0);
+        break;
+      default: //LINEAR
+        break;
+    }
+
+    //combines kernel values as in svm_predict_values()
+    switch (machineType()) {
+      case ONE_CLASS:
+      case EPSILON_SVR:
+      case NU_SVR:
+        {
+          const double* coef = &m_sv_coef(0,0);
+          double sum = 0.;
+          for (int i=0; i<n_sv; ++i) sum += coef[i] * k[i];
+          dec(r,0) = sum - m_model->rho[0];
+        }
+        break;
+      default:
+        {
+          const int n_class = m_model->nr_class;
+          int p = 0;
+          for (int i=0; i<n_class; ++i) {
+            for (int j=i+1; j<n_class; ++j) {
+              const int si = m_sv_start(i), ci = m_model->nSV[i];
+              const int sj = m_sv_start(j), cj = m_model->nSV[j];
+              const double* coef1 = &m_sv_coef(j-1,0);
+              const double* coef2 = &m_sv_coef(i,0);
+              double sum = 0.;
+              for (int n=si; n<si+ci; ++n) sum += coef1[n] * k[n];
+              for (int n=sj; n<sj+cj; ++n) sum += coef2[n] * k[n];
+              dec(r,p) = sum - m_model->rho[p];
+              ++p;
+            }
+          }
+        }
+        break;
+    }
+  }
+}
+
+int bob::machine::SupportVector::decide_(const blitz::Array<double,1>& dec,
+    blitz::Array<int,1>& votes) const {
+
+  switch (machineType()) {
+    case ONE_CLASS:
+      return (dec(0) > 0) ? 1 : -1;
+    case EPSILON_SVR:
+    case NU_SVR:
+      return round(dec(0));
+    default:
+      break;
+  }
+
+  const int n_class = m_model->nr_class;
+  votes = 0;
+  int p = 0;
+  for (int i=0; i<n_class; ++i) {
+    for (int j=i+1; j<n_class; ++j) {
+      if (dec(p) > 0) ++votes(i);
+      else ++votes(j);
+      ++p;
+    }
+  }
+
+  int vote_max = 0;
+  for (int i=1; i<n_class; ++i) if (votes(i) > votes(vote_max)) vote_max = i;
+  return m_model->label[vote_max];
+}
+
+void bob::machine::SupportVector::predictClassesAndScores_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores) const {
+
+  const int n_input = input.extent(0);
+  const int n_dec = numberOfDecisionValues();
+  blitz::Range all = blitz::Range::all();
+
+  if (kernelType() == PRECOMPUTED) { //cannot be densified, use libsvm
+    blitz::Array<double,1> tmp(std::max((size_t)n_dec, outputSize()));
+    for (int r=0; r<n_input; ++r) {
+      labels(r) = predictClassAndScores_(input(r,all), tmp);
+      scores(r,all) = tmp(blitz::Range(0,n_dec-1));
+    }
+    return;
+  }
+
+  const int block = std::min(n_input, SVM_BATCH_BLOCK);
+  blitz::Array<double,2> x(block, inputSize());
+  blitz::Array<double,2> kernel(block, isLinear() ? 0 : m_sv.extent(0));
+  blitz::Array<double,2> dec(block, n_dec);
+  blitz::Array<int,1> votes(numberOfClasses());
+
+  for (int start=0; start<n_input; start+=block) {
+    const int n = std::min(block, n_input-start);
+    blitz::Array<double,2> x_ = x(blitz::Range(0,n-1), all);
+    blitz::Array<double,2> dec_ = dec(blitz::Range(0,n-1), all);
+    for (int r=0; r<n; ++r)
+      x_(r,all) = (input(start+r,all) - m_input_sub) / m_input_div;
+    decisionValues_(x_, kernel, dec_);
+    for (int r=0; r<n; ++r) {
+      labels(start+r) = decide_(dec_(r,all), votes);
+      scores(start+r,all) = dec_(r,all);
+    }
+  }
+}
+
+void bob::machine::SupportVector::predictClassesAndScores
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels,
+ blitz::Array<double,2>& scores) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (labels.extent(0) != input.extent(0)) {
+    boost::format s("output labels for this SVM should have %d entries (one per input row), but you provided an array with %d elements instead");
+    s % input.extent(0) % labels.extent(0);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (scores.extent(0) != input.extent(0) || 
+      (size_t)scores.extent(1) != numberOfDecisionValues()) {
+    boost::format s("output scores for this SVM should have shape (%d, %d), but you provided an array with shape (%d, %d) instead");
+    s % input.extent(0) % numberOfDecisionValues() % scores.extent(0) % scores.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  predictClassesAndScores_(input, labels, scores);
+}
+
+void bob::machine::SupportVector::predictClasses_
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels) const {
+  blitz::Array<double,2> scores(input.extent(0), numberOfDecisionValues());
+  predictClassesAndScores_(input, labels, scores);
+}
+
+void bob::machine::SupportVector::predictClasses
+(const blitz::Array<double,2>& input, blitz::Array<int,1>& labels) const {
+
+  if ((size_t)input.extent(1) != inputSize()) {
+    boost::format s("input for this SVM should have %d columns, but you provided an array with %d columns instead");
+    s % inputSize() % input.extent(1);
+    throw std::invalid_argument(s.str());
+  }
+
+  if (labels.extent(0) != input.extent(0)) {
+    boost::format s("output labels for this SVM should have %d entries (one per input row), but you provided an array with %d elements instead");
+    s % input.extent(0) % labels.extent(0);
+    throw std::invalid_argument(s.str());
+  }
+
+  predictClasses_(input, labels);
+}
+
+bob::machine::LinearMachine bob::machine::SupportVector::toLinearMachine() const {
+  if (!isLinear()) {
+    throw std::runtime_error("only SVMs with a linear kernel can be converted into a LinearMachine");
+  }
+  bob::machine::LinearMachine retval(bob::core::array::ccopy(m_linear_weight.transpose(1,0)));
+  blitz::Array<double,1> bias(m_linear_weight.extent(0));
+  for (int p=0; p<bias.extent(0); ++p) bias(p) = -m_model->rho[p];
+  retval.setBiases(bias);
+  retval.setInputSubtraction(m_input_sub);
+  retval.setInputDivision(m_input_div);
+  return retval;
+}
@@ -26,10 +26,12 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/random.hpp>
 #include <blitz/array.h>
 
 #include "bob/machine/GaborGraphMachine.h"
 #include "bob/machine/GaborJetSimilarities.h"
+#include "bob/machine/GaborGraphGallery.h"
 #include "bob/machine/Exception.h"
 
 #include "bob/core/Exception.h"
@@ -101,6 +103,11 @@ BOOST_AUTO_TEST_CASE( test_gabor_graph_machine )
   blitz::Array<double,3> graph(machine.numberOfNodes(), 2, gwt.numberOfKernels());
   machine.extract(jet_image, graph);
 
+  // extract the graph directly from the image, evaluating the Gabor wavelet transform at the nodes only
+  blitz::Array<double,3> sparse_graph(graph.shape());
+  machine.extract(gwt, bob::core::array::cast<double>(uint8_image), sparse_graph, true);
+  test_close(sparse_graph, graph);
+
   // check if the jets are still the same
   boost::filesystem::path graph_jets_file = boost::filesystem::path(data_dir) / "graph_jets.hdf5";
 #ifdef GENERATE_NEW_REFERENCE_FILES
@@ -125,3 +132,64 @@ BOOST_AUTO_TEST_CASE( test_gabor_graph_machine )
     BOOST_CHECK_CLOSE(similarity, 1., epsilon);
   }
 }
+
+BOOST_AUTO_TEST_CASE( test_gabor_graph_gallery )
+{
+  bob::ip::GaborWaveletTransform gwt;
+  const int graphs = 600, nodes = 7, kernels = gwt.numberOfKernels();
+
+  // generate some random Gabor graphs with normalized absolute values and phases in [-pi, pi)
+  boost::mt19937 rng;
+  boost::uniform_real<double> abs_dist(0.1, 1.), phase_dist(-M_PI, M_PI);
+  blitz::Array<double,4> gallery(graphs, nodes, 2, kernels);
+  for (int p = 0; p < graphs; ++p)
+    for (int i = 0; i < nodes; ++i)
+      for (int j = 0; j < kernels; ++j){
+        gallery(p,i,0,j) = abs_dist(rng);
+        gallery(p,i,1,j) = phase_dist(rng);
+      }
+  blitz::Range all = blitz::Range::all();
+  for (int p = 0; p < graphs; ++p)
+    for (int i = 0; i < nodes; ++i){
+      blitz::Array<double,2> jet(gallery(p,i,all,all));
+      bob::ip::normalizeGaborJet(jet);
+    }
+  blitz::Array<double,3> probe(gallery(123,all,all,all).copy());
+
+  bob::machine::GaborGraphMachine machine;
+  bob::machine::GaborJetSimilarity::SimilarityType types[] = {
+    bob::machine::GaborJetSimilarity::SCALAR_PRODUCT,
+    bob::machine::GaborJetSimilarity::CANBERRA,
+    bob::machine::GaborJetSimilarity::DISPARITY,
+    bob::machine::GaborJetSimilarity::PHASE_DIFF,
+    bob::machine::GaborJetSimilarity::PHASE_DIFF_PLUS_CANBERRA
+  };
+
+  for (int t = 0; t < 5; ++t){
+    bob::machine::GaborJetSimilarity sim(types[t], gwt);
+    for (int single_precision = 0; single_precision < 2; ++single_precision){
+      bob::machine::GaborGraphGallery batch(sim, single_precision);
+      batch.setNumberOfThreads(3);
+      batch.add(gallery);
+      BOOST_CHECK_EQUAL(batch.size(), graphs);
+
+      blitz::Array<double,1> scores(graphs);
+      batch.similarities(probe, scores);
+      for (int p = 0; p < graphs; ++p){
+        double reference = machine.similarity(gallery(p,all,all,all), probe, sim);
+        BOOST_CHECK_SMALL(scores(p) - reference, single_precision ? 1e-5 : epsilon);
+      }
+
+      // the probe itself is the best match
+      blitz::Array<int,1> indices;
+      blitz::Array<double,1> best;
+      batch.search(probe, 5, indices, best);
+      BOOST_CHECK_EQUAL(indices.extent(0), 5);
+      BOOST_CHECK_EQUAL(indices(0), 123);
+      for (int i = 1; i < 5; ++i){
+        BOOST_CHECK(best(i) <= best(i-1));
+        BOOST_CHECK_EQUAL(best(i), scores(indices(i)));
+      }
+    }
+  }
+}
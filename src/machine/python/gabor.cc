@@ -27,7 +27,9 @@
 #include <bob/ip/GaborWaveletTransform.h>
 #include <bob/machine/GaborGraphMachine.h>
 #include <bob/machine/GaborJetSimilarities.h>
+#include <bob/machine/GaborGraphGallery.h>
 #include <bob/core/array_exception.h>
+#include <bob/core/cast.h>
 
 
 static void bob_extract(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray input_jet_image, bob::python::ndarray output_graph){
@@ -58,6 +60,34 @@ static bob::python::ndarray bob_extract2(bob::machine::GaborGraphMachine& self,
   } else throw bob::core::array::UnexpectedShapeError();
 }
 
+static blitz::Array<double,2> gray_image(bob::python::const_ndarray input_image){
+  switch (input_image.type().dtype){
+    case bob::core::array::t_uint8: return bob::core::array::cast<double>(input_image.bz<uint8_t,2>());
+    case bob::core::array::t_uint16: return bob::core::array::cast<double>(input_image.bz<uint16_t,2>());
+    case bob::core::array::t_float64: return input_image.bz<double,2>();
+    default: PYTHON_ERROR(TypeError, "images of type '%s' are not supported (use uint8, uint16 or float64)", input_image.type().str().c_str());
+  }
+}
+
+static void bob_extract_from_image(bob::machine::GaborGraphMachine& self, bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_graph, bool normalized){
+  const blitz::Array<double,2> image = gray_image(input_image);
+  if (output_graph.type().nd == 2){
+    blitz::Array<double,2> graph = output_graph.bz<double,2>();
+    self.extract(gwt, image, graph, normalized);
+  } else if (output_graph.type().nd == 3){
+    blitz::Array<double,3> graph = output_graph.bz<double,3>();
+    self.extract(gwt, image, graph, normalized);
+  } else throw bob::core::array::UnexpectedShapeError();
+}
+
+static bob::python::ndarray bob_extract_from_image2(bob::machine::GaborGraphMachine& self, bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bool include_phases, bool normalized){
+  bob::python::ndarray output_graph = include_phases ?
+    bob::python::ndarray(bob::core::array::t_float64, self.numberOfNodes(), 2, (int)gwt.numberOfKernels()) :
+    bob::python::ndarray(bob::core::array::t_float64, self.numberOfNodes(), (int)gwt.numberOfKernels());
+  bob_extract_from_image(self, gwt, input_image, output_graph, normalized);
+  return output_graph;
+}
+
 static void bob_average(bob::machine::GaborGraphMachine& self, bob::python::const_ndarray many_graph_jets, bob::python::ndarray averaged_graph_jets){
   const blitz::Array<double,4> graph_set = many_graph_jets.bz<double,4>();
   blitz::Array<double,3> graph = averaged_graph_jets.bz<double,3>();
@@ -118,6 +148,37 @@ static double bob_jet_sim(const bob::machine::GaborJetSimilarity& self, bob::pyt
   }
 }
 
+static void bob_gallery_add(bob::machine::GaborGraphGallery& self, bob::python::const_ndarray graph_jets){
+  switch (graph_jets.type().nd){
+    case 2: self.add(graph_jets.bz<double,2>()); break;
+    case 3: self.add(graph_jets.bz<double,3>()); break;
+    case 4: self.add(graph_jets.bz<double,4>()); break;
+    default: throw bob::core::array::UnexpectedShapeError();
+  }
+}
+
+static bob::python::ndarray bob_gallery_similarities(const bob::machine::GaborGraphGallery& self, bob::python::const_ndarray probe_graph){
+  bob::python::ndarray output(bob::core::array::t_float64, self.size());
+  blitz::Array<double,1> scores = output.bz<double,1>();
+  switch (probe_graph.type().nd){
+    case 2: self.similarities(probe_graph.bz<double,2>(), scores); break;
+    case 3: self.similarities(probe_graph.bz<double,3>(), scores); break;
+    default: throw bob::core::array::UnexpectedShapeError();
+  }
+  return output;
+}
+
+static boost::python::tuple bob_gallery_search(const bob::machine::GaborGraphGallery& self, bob::python::const_ndarray probe_graph, int k){
+  blitz::Array<int,1> indices;
+  blitz::Array<double,1> scores;
+  switch (probe_graph.type().nd){
+    case 2: self.search(probe_graph.bz<double,2>(), k, indices, scores); break;
+    case 3: self.search(probe_graph.bz<double,3>(), k, indices, scores); break;
+    default: throw bob::core::array::UnexpectedShapeError();
+  }
+  return boost::python::make_tuple(indices, scores);
+}
+
 void bind_machine_gabor(){
   /////////////////////////////////////////////////////////////////////////////////////////
   //////////////// Gabor jet similarities
@@ -247,6 +308,20 @@ void bind_machine_gabor(){
       "Extracts and returns the Gabor jets at the desired locations from the given Gabor jet image"
     )
 
+    .def(
+      "extract",
+      &bob_extract_from_image,
+      (boost::python::arg("self"), boost::python::arg("gwt"), boost::python::arg("image"), boost::python::arg("graph_jets"), boost::python::arg("normalized")=true),
+      "Extracts the Gabor jets at the desired locations directly from the given gray image, by evaluating the given Gabor wavelet transform at the node positions only. This is much faster than computing the Gabor jet image first."
+    )
+
+    .def(
+      "extract",
+      &bob_extract_from_image2,
+      (boost::python::arg("self"), boost::python::arg("gwt"), boost::python::arg("image"), boost::python::arg("include_phases")=true, boost::python::arg("normalized")=true),
+      "Extracts and returns the Gabor jets (with or without phases) at the desired locations directly from the given gray image, by evaluating the given Gabor wavelet transform at the node positions only."
+    )
+
     .def(
       "average",
       &bob_average,
@@ -261,4 +336,67 @@ void bind_machine_gabor(){
       "Computes the similarity between the given probe graph and the gallery, which might be a single graph or a collection of graphs"
   );
 
+  /////////////////////////////////////////////////////////////////////////////////////////
+  //////////////// Gabor graph gallery
+  boost::python::class_<bob::machine::GaborGraphGallery, boost::shared_ptr<bob::machine::GaborGraphGallery> >(
+      "GaborGraphGallery",
+      "A gallery of Gabor graphs (of the same topology) that a probe graph is compared to at once, e.g., for 1:N identification. The gallery graphs are stored contiguously, optionally in single precision, and the comparison can be distributed over several threads.",
+      boost::python::no_init
+    )
+
+    .def(
+      boost::python::init<const bob::machine::GaborJetSimilarity&, boost::python::optional<bool> >(
+        (
+          boost::python::arg("jet_similarity_function"),
+          boost::python::arg("single_precision") = false
+        ),
+        "Creates an empty gallery, where graphs are compared using the given Gabor jet similarity function. If single_precision is enabled, the gallery graphs are stored as float32."
+      )
+    )
+
+    .def(
+      "add",
+      &bob_gallery_add,
+      (boost::python::arg("self"), boost::python::arg("graph_jets")),
+      "Adds a Gabor graph (with or without phases), or a list of Gabor graphs with phases (4D), to the gallery."
+    )
+
+    .def(
+      "clear",
+      &bob::machine::GaborGraphGallery::clear,
+      "Removes all graphs from the gallery."
+    )
+
+    .def(
+      "__len__",
+      &bob::machine::GaborGraphGallery::size,
+      "The number of graphs in the gallery."
+    )
+
+    .add_property(
+      "single_precision",
+      &bob::machine::GaborGraphGallery::singlePrecision,
+      "Are the gallery graphs stored in single precision?"
+    )
+
+    .add_property(
+      "number_of_threads",
+      &bob::machine::GaborGraphGallery::numberOfThreads,
+      &bob::machine::GaborGraphGallery::setNumberOfThreads,
+      "The number of threads that the gallery is distributed over when comparing a probe graph (default: 1)."
+    )
+
+    .def(
+      "similarities",
+      &bob_gallery_similarities,
+      (boost::python::arg("self"), boost::python::arg("probe_graph_jets")),
+      "Computes the similarities of the given probe graph to all graphs in the gallery, which are identical to GaborGraphMachine.similarity() for each single gallery graph."
+    )
+
+    .def(
+      "search",
+      &bob_gallery_search,
+      (boost::python::arg("self"), boost::python::arg("probe_graph_jets"), boost::python::arg("k")),
+      "Returns the indices and similarities of the k most similar gallery graphs as a tuple, sorted by decreasing similarity."
+  );
 }
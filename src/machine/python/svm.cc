@@ -104,6 +104,27 @@ static object predict_class_and_scores_n(const bob::machine::SupportVector& m,
   return make_tuple(tuple(classes), tuple(scores));
 }
 
+static object batch_predict_classes(const bob::machine::SupportVector& m,
+    bob::python::const_ndarray input) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  bob::python::ndarray labels(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> labels_ = labels.bz<int32_t,1>();
+  m.predictClasses(i_, labels_);
+  return labels.self();
+}
+
+static tuple batch_predict_classes_and_scores
+(const bob::machine::SupportVector& m, bob::python::const_ndarray input) {
+  blitz::Array<double,2> i_ = input.bz<double,2>();
+  bob::python::ndarray labels(bob::core::array::t_int32, i_.extent(0));
+  blitz::Array<int32_t,1> labels_ = labels.bz<int32_t,1>();
+  bob::python::ndarray scores(bob::core::array::t_float64, i_.extent(0),
+      m.numberOfDecisionValues());
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  m.predictClassesAndScores(i_, labels_, scores_);
+  return make_tuple(labels.self(), scores.self());
+}
+
 static int predict_class_and_probs(const bob::machine::SupportVector& m, 
     bob::python::const_ndarray input, bob::python::ndarray probs) {
   blitz::Array<double,1> probs_ = probs.bz<double,1>();
@@ -278,6 +299,12 @@ void bind_machine_svm() {
     .def("predict_class_and_scores", &predict_class_and_scores, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_scores_", &predict_class_and_scores_, (arg("self"), arg("input"), arg("scores")), "Returns the predicted class given a certain input. Returns the scores for each class in the second argument. Checks the input and output arrays for size conformity. Does not check the input data and is, therefore, a little bit faster.")
     .def("predict_classes_and_scores", &predict_class_and_scores_n, (arg("self"), arg("input")), "Returns the predicted class and output scores as a tuple, in this order. Checks the input array for size conformity. If the size is wrong, an exception is raised. This variant takes a single 2D double array as input. The samples should be organized row-wise.")
+    .add_property("is_linear", &bob::machine::SupportVector::isLinear, "true if this machine uses a linear kernel. In this case, support vectors are collapsed into one weight vector per decision value when the model is loaded and prediction costs O(d) per decision value, independently of the number of support vectors.")
+    .add_property("linear_weights", make_function(&bob::machine::SupportVector::getLinearWeights, return_value_policy<copy_const_reference>()), "The collapsed weights of a linear machine, one row per decision value (empty if the machine is not linear). Decision values are given by dot(W, x) - rho, where x is the scaled input.")
+    .def("to_linear_machine", &bob::machine::SupportVector::toLinearMachine, (arg("self")), "Converts a linear machine into an equivalent bob.machine.LinearMachine, with one output per decision value and the same input scaling, that you can save to an HDF5 file for deployment. For binary problems, the output is positive for the first label in 'labels' and negative for the second. Raises an exception if the machine is not linear.")
+    .add_property("n_decision_values", &bob::machine::SupportVector::numberOfDecisionValues, "The number of decision values (scores) produced for each input: 1 for regression, one-class and 2-class problems or N*(N-1)/2 (one per pair of classes) for N-class problems")
+    .def("batch_predict_classes", &batch_predict_classes, (arg("self"), arg("input")), "Returns the predicted classes for a 2D array of inputs, with samples arranged row-wise, as a 1D int32 numpy array. Support vectors are kept in a dense matrix and kernels are evaluated for blocks of inputs at once, which is much faster than predict_classes() for dense, high-dimensional data. Decision values match libsvm's up to floating-point rounding.")
+    .def("batch_predict_classes_and_scores", &batch_predict_classes_and_scores, (arg("self"), arg("input")), "Returns the predicted classes and decision values for a 2D array of inputs, with samples arranged row-wise, as a tuple with a 1D int32 numpy array and a 2D float64 numpy array with 'n_decision_values' columns. See batch_predict_classes() for details.")
     .def("predict_class_and_probabilities", &predict_class_and_probs2, (arg("self"), arg("input")), "Returns the predicted class and probabilities in a tuple (on that order) given a certain input. The current machine has to support probabilities, otherwise an exception is raised. Checks the input array for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities", &predict_class_and_probs, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. If the model supports it, returns the probabilities for each class in the second argument, otherwise raises an exception. Checks the input and output arrays for size conformity. If the size is wrong, an exception is raised.")
     .def("predict_class_and_probabilities_", &predict_class_and_probs_, (arg("self"), arg("input"), arg("probabilities")), "Returns the predicted class given a certain input. This version will not run any checks, so you must be sure to pass the correct input to the classifier.")
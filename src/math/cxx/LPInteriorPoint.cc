@@ -25,6 +25,7 @@
 #include <bob/math/linear.h>
 #include <bob/math/linsolve.h>
 #include <bob/math/Exception.h>
+#include <bob/core/Exception.h>
 #include <bob/core/array_copy.h>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
@@ -33,7 +34,7 @@
 
 bob::math::LPInteriorPoint::LPInteriorPoint(const size_t M, const size_t N, 
     const double epsilon):
-  m_M(M), m_N(N), m_epsilon(epsilon), m_lambda(M), m_mu(N)
+  m_M(M), m_N(N), m_epsilon(epsilon), m_solver(dense), m_lambda(M), m_mu(N)
 {
   m_lambda = 0.;
   m_mu = 0.;
@@ -43,6 +44,7 @@ bob::math::LPInteriorPoint::LPInteriorPoint(const size_t M, const size_t N,
 bob::math::LPInteriorPoint::LPInteriorPoint(
   const bob::math::LPInteriorPoint &other):
   m_M(other.m_M), m_N(other.m_N), m_epsilon(other.m_epsilon), 
+  m_solver(other.m_solver),
   m_lambda(bob::core::array::ccopy(other.m_lambda)),
   m_mu(bob::core::array::ccopy(other.m_mu))
 {
@@ -59,9 +61,23 @@ void bob::math::LPInteriorPoint::resetCache()
   m_cache_lambda.resize(m_M);
   m_cache_mu.resize(m_N);
 
-  m_cache_A_large.resize(m_M+2*m_N, m_M+2*m_N);
+  // Only allocates the matrix of the selected solver, as the large one
+  // quickly gets huge
+  if (m_solver == dense)
+  {
+    m_cache_A_large.resize(m_M+2*m_N, m_M+2*m_N);
+    m_cache_A_normal.resize(0, 0);
+  }
+  else
+  {
+    m_cache_A_large.resize(0, 0);
+    m_cache_A_normal.resize(m_M, m_M);
+  }
   m_cache_b_large.resize(m_M+2*m_N);
   m_cache_x_large.resize(m_M+2*m_N);
+  m_cache_b_normal.resize(m_M);
+  m_cache_d.resize(m_N);
+  m_cache_r.resize(m_N);
 }
 
 bob::math::LPInteriorPoint& bob::math::LPInteriorPoint::operator=(
@@ -72,6 +88,7 @@ bob::math::LPInteriorPoint& bob::math::LPInteriorPoint::operator=(
     m_M = other.m_M;
     m_N = other.m_N;
     m_epsilon = other.m_epsilon;
+    m_solver = other.m_solver;
     m_lambda = bob::core::array::ccopy(other.m_lambda);
     m_mu = bob::core::array::ccopy(other.m_mu);
     resetCache();
@@ -83,7 +100,7 @@ bool bob::math::LPInteriorPoint::operator==(
   const bob::math::LPInteriorPoint& other) const
 {
   return (m_M == other.m_M && m_N == other.m_N && 
-          m_epsilon == other.m_epsilon &&
+          m_epsilon == other.m_epsilon && m_solver == other.m_solver &&
           bob::core::array::isEqual(m_lambda, other.m_lambda) &&
           bob::core::array::isEqual(m_mu, other.m_mu));
 }
@@ -252,7 +269,7 @@ void bob::math::LPInteriorPoint::centeringV(const blitz::Array<double,2>& A,
   blitz::Range r_m(0,m-1);
   blitz::Range r_n(0,n-1);
 
-  initializeLargeSystem(A);
+  initializeSystem(A);
 
   int k=0;  
   while (true)
@@ -261,9 +278,8 @@ void bob::math::LPInteriorPoint::centeringV(const blitz::Array<double,2>& A,
     if (isInV(x, m_mu, theta) )
       break;
 
-    // 2) Update the big system and solve it
-    updateLargeSystem( x, 1., m);
-    bob::math::linsolve( m_cache_A_large, m_cache_x_large, m_cache_b_large);
+    // 2) Compute the Newton direction
+    computeDirection(x, 1., m);
 
     // 4) Find alpha and update x, lamda and mu
     double alpha=1.;
@@ -335,6 +351,108 @@ void bob::math::LPInteriorPoint::updateLargeSystem(const blitz::Array<double,1>&
   m_cache_b_large(r_n+m+n) = -x*m_mu + nu_sigma;
 }
 
+void bob::math::LPInteriorPoint::initializeNormalSystem(
+  const blitz::Array<double,2>& A) const
+{
+  // Get dimensions from the A matrix
+  const int m = A.extent(0);
+  const int n = A.extent(1);
+
+  // List the non-zero entries of A, column by column. The structure of
+  // A*D*A^T only depends on them, and is hence the same at each iteration.
+  m_cache_A_colptr.resize(n+1);
+  m_cache_A_rowind.clear();
+  m_cache_A_values.clear();
+  for (int j=0; j<n; ++j)
+  {
+    m_cache_A_colptr[j] = m_cache_A_rowind.size();
+    for (int i=0; i<m; ++i)
+      if (A(i,j) != 0.)
+      {
+        m_cache_A_rowind.push_back(i);
+        m_cache_A_values.push_back(A(i,j));
+      }
+  }
+  m_cache_A_colptr[n] = m_cache_A_rowind.size();
+}
+
+void bob::math::LPInteriorPoint::solveNormalSystem(
+  const blitz::Array<double,1>& x, const double sigma, const int m) const
+{
+  // Get dimensions from the x vector
+  const int n = x.extent(0);
+
+  // D = X S^-1 requires mu > 0
+  if (blitz::any(m_mu <= 0.))
+    throw bob::core::InvalidArgumentException("mu", blitz::min(m_mu));
+
+  // Compute nu*sigma
+  double nu_sigma = sigma * bob::math::dot(x, m_mu) / n;
+
+  // r = -X S e + nu sigma e and D = X S^-1
+  m_cache_r = -x*m_mu + nu_sigma;
+  m_cache_d = x / m_mu;
+
+  // Compute A*D*A^T (upper triangular part) and -A*S^-1*r, using the
+  // non-zero entries of A only
+  m_cache_A_normal = 0.;
+  m_cache_b_normal = 0.;
+  for (int j=0; j<n; ++j)
+  {
+    const int end = m_cache_A_colptr[j+1];
+    const double s_r_j = m_cache_r(j) / m_mu(j);
+    for (int p=m_cache_A_colptr[j]; p<end; ++p)
+    {
+      const int i = m_cache_A_rowind[p];
+      const double d_a_ij = m_cache_d(j) * m_cache_A_values[p];
+      for (int q=p; q<end; ++q)
+        m_cache_A_normal(i, m_cache_A_rowind[q]) +=
+          d_a_ij * m_cache_A_values[q];
+      m_cache_b_normal(i) -= m_cache_A_values[p] * s_r_j;
+    }
+  }
+  // Row indices are increasing within each column: copy the upper
+  // triangular part to the lower one
+  for (int i=0; i<m; ++i)
+    for (int k=0; k<i; ++k)
+      m_cache_A_normal(i,k) = m_cache_A_normal(k,i);
+
+  // Solve for Dlambda using a Cholesky decomposition
+  blitz::Range r_m(0,m-1);
+  blitz::Array<double,1> d_lambda = m_cache_x_large(r_m+n);
+  bob::math::linsolveSympos_(m_cache_A_normal, d_lambda, m_cache_b_normal);
+
+  // Dmu = -A^T Dlambda and Dx = S^-1 (r - X Dmu)
+  for (int j=0; j<n; ++j)
+  {
+    double d_mu_j = 0.;
+    for (int p=m_cache_A_colptr[j]; p<m_cache_A_colptr[j+1]; ++p)
+      d_mu_j -= m_cache_A_values[p] * d_lambda(m_cache_A_rowind[p]);
+    m_cache_x_large(m+n+j) = d_mu_j;
+    m_cache_x_large(j) = (m_cache_r(j) - x(j) * d_mu_j) / m_mu(j);
+  }
+}
+
+void bob::math::LPInteriorPoint::initializeSystem(
+  const blitz::Array<double,2>& A) const
+{
+  if (m_solver == normal_equations)
+    initializeNormalSystem(A);
+  else
+    initializeLargeSystem(A);
+}
+
+void bob::math::LPInteriorPoint::computeDirection(
+  const blitz::Array<double,1>& x, const double sigma, const int m) const
+{
+  if (m_solver == normal_equations)
+    solveNormalSystem(x, sigma, m);
+  else
+  {
+    updateLargeSystem(x, sigma, m);
+    bob::math::linsolve(m_cache_A_large, m_cache_x_large, m_cache_b_large);
+  }
+}
 
 
 bob::math::LPInteriorPointShortstep::LPInteriorPointShortstep(
@@ -401,8 +519,8 @@ void bob::math::LPInteriorPointShortstep::solve(const blitz::Array<double,2>& A,
   const double sigma = 1. - m_theta / sqrt(n);
   double nu;
 
-  // Declare and initialize arrays for the large linear system
-  initializeLargeSystem(A);
+  // Initialize the system giving the Newton directions
+  initializeSystem(A);
   m_lambda = lambda;
   m_mu = mu;
 
@@ -415,9 +533,8 @@ void bob::math::LPInteriorPointShortstep::solve(const blitz::Array<double,2>& A,
     if( nu < m_epsilon )
       break;
 
-    // 2) Update the big system and solve it
-    updateLargeSystem( x, sigma, m);
-    bob::math::linsolve( m_cache_A_large, m_cache_x_large, m_cache_b_large);
+    // 2) Compute the Newton direction
+    computeDirection(x, sigma, m);
 
     // 3) Update x, lamda and mu
     m_lambda += m_cache_x_large( r_m+n);
@@ -520,8 +637,8 @@ void bob::math::LPInteriorPointPredictorCorrector::solve(const blitz::Array<doub
   // Declare variable
   double nu;
 
-  // Declare and initialize arrays for the large linear system
-  initializeLargeSystem(A);
+  // Initialize the system giving the Newton directions
+  initializeSystem(A);
   m_lambda = lambda;
   m_mu = mu;
 
@@ -536,9 +653,8 @@ void bob::math::LPInteriorPointPredictorCorrector::solve(const blitz::Array<doub
     if (nu < m_epsilon)
       break;
 
-    // 2) Update the big system and solve it
-    updateLargeSystem( x, 0., m);
-    bob::math::linsolve( m_cache_A_large, m_cache_x_large, m_cache_b_large);
+    // 2) Compute the Newton direction
+    computeDirection(x, 0., m);
 
     // 3) alpha=1
     double alpha = 1.;
@@ -569,9 +685,8 @@ void bob::math::LPInteriorPointPredictorCorrector::solve(const blitz::Array<doub
     if( nu < m_epsilon )
       break;
 
-    // 7) Update the big system and solve it
-    updateLargeSystem( x, 1., m);
-    bob::math::linsolve( m_cache_A_large, m_cache_x_large, m_cache_b_large);
+    // 7) Compute the Newton direction
+    computeDirection(x, 1., m);
 
     // 8) Update x
     m_lambda += m_cache_x_large(r_m+n);
@@ -686,7 +801,7 @@ void bob::math::LPInteriorPointLongstep::solve(const blitz::Array<double,2>& A,
   // Declare and initialize variables
   double nu;
 
-  initializeLargeSystem(A);
+  initializeSystem(A);
   m_lambda = lambda;
   m_mu = mu;
 
@@ -699,9 +814,8 @@ void bob::math::LPInteriorPointLongstep::solve(const blitz::Array<double,2>& A,
     if (nu < m_epsilon)
       break;
 
-    // 2) Update the big system and solve it
-    updateLargeSystem(x, m_sigma, m);
-    bob::math::linsolve(m_cache_A_large, m_cache_x_large, m_cache_b_large);
+    // 2) Compute the Newton direction
+    computeDirection(x, m_sigma, m);
 
     // 3) alpha=1
     double alpha = 1.;
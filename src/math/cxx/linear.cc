@@ -0,0 +1,68 @@
+/**
+ * @file math/cxx/linear.cc
+ * @date Sun Oct 18 22:41:07 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Matrix products relying on BLAS
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/math/linear.h>
+#include <bob/core/assert.h>
+#include <algorithm>
+
+// Declaration of the external BLAS function (Matrix product)
+extern "C" void dgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const double *alpha, const double *A,
+  const int *lda, const double *B, const int *ldb, const double *beta,
+  double *C, const int *ldc);
+
+void bob::math::prodTranspose(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C)
+{
+  // Check inputs
+  bob::core::array::assertCZeroBaseContiguous(A);
+  bob::core::array::assertCZeroBaseContiguous(B);
+  bob::core::array::assertSameDimensionLength(A.extent(1), B.extent(1));
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(C);
+  bob::core::array::assertSameDimensionLength(A.extent(0), C.extent(0));
+  bob::core::array::assertSameDimensionLength(B.extent(0), C.extent(1));
+
+  bob::math::prodTranspose_(A, B, C);
+}
+
+void bob::math::prodTranspose_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C)
+{
+  // Defines dimensionality variables
+  const int M = C.extent(1);
+  const int N = C.extent(0);
+  const int K = A.extent(1);
+  if (M == 0 || N == 0) return;
+
+  // C: row major order, Fortran: column major. C=A*B^T in row major order
+  // is C^T=B*A^T in column major order, where A and B are seen as A^T and
+  // B^T already: only B has to be transposed by dgemm.
+  const char transa = 'T';
+  const char transb = 'N';
+  const double alpha = 1.;
+  const double beta = 0.;
+  const int ld = std::max(1, K);
+  dgemm_( &transa, &transb, &M, &N, &K, &alpha, B.data(), &ld, A.data(), &ld,
+    &beta, C.data(), &M);
+}
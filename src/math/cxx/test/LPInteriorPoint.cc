@@ -156,6 +156,64 @@ BOOST_AUTO_TEST_CASE( test_solve )
 }
  
 
+BOOST_AUTO_TEST_CASE( test_solve_normal_equations )
+{
+  blitz::Array<double,2> A;
+  blitz::Array<double,1> b;
+  blitz::Array<double,1> c;
+  blitz::Array<double,1> x0;
+  blitz::Array<double,1> sol;
+
+  // Check problem 1 for dimension 1 to 10, computing the Newton directions
+  // with the normal equations
+  for (int n=1; n<=10; ++n)
+  {
+    generateProblem(n, A, b, c, x0);
+    sol.resize(n);
+    sol = 0.;
+    sol(n-1) = pow(5., n); // Solution to problem 1 is [0 ... 0 5^n] 
+
+    // Short step
+    blitz::Array<double,1> x2(bob::core::array::ccopy(x0));
+    bob::math::LPInteriorPointShortstep solver2(n, 2*n, 0.4, 1e-6);
+    solver2.setSolver(bob::math::LPInteriorPoint::normal_equations);
+    solver2.solve(A, b, c, x2);
+    for( int i=0; i<n; ++i)
+      BOOST_CHECK_SMALL( fabs(x2(i)-sol(i)), eps);
+
+    // Predictor corrector
+    blitz::Array<double,1> x3(bob::core::array::ccopy(x0));
+    bob::math::LPInteriorPointPredictorCorrector solver3(n, 2*n, 0.5, 0.25, 1e-6);
+    solver3.setSolver(bob::math::LPInteriorPoint::normal_equations);
+    solver3.solve(A, b, c, x3);
+    for( int i=0; i<n; ++i)
+      BOOST_CHECK_SMALL( fabs( x3(i)-sol(i)), eps);
+
+    // Long step
+    blitz::Array<double,1> x4(bob::core::array::ccopy(x0));
+    bob::math::LPInteriorPointLongstep solver4(n, 2*n, 1e-3, 0.1, 1e-6);
+    solver4.setSolver(bob::math::LPInteriorPoint::normal_equations);
+    solver4.solve(A, b, c, x4);
+    for( int i=0; i<n; ++i)
+      BOOST_CHECK_SMALL( fabs( x4(i)-sol(i)), eps);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_solver_selection )
+{
+  bob::math::LPInteriorPointShortstep op1(2, 4, 0.4, 1e-6);
+  BOOST_CHECK_EQUAL( bob::math::LPInteriorPoint::dense, op1.getSolver() );
+  bob::math::LPInteriorPointShortstep op2(op1);
+  op2.setSolver(bob::math::LPInteriorPoint::normal_equations);
+  BOOST_CHECK_EQUAL( bob::math::LPInteriorPoint::normal_equations, 
+    op2.getSolver() );
+  BOOST_CHECK( op1 != op2 );
+  op1 = op2;
+  BOOST_CHECK( op1 == op2 );
+  BOOST_CHECK_EQUAL( bob::math::LPInteriorPoint::normal_equations, 
+    op1.getSolver() );
+}
+
 
 BOOST_AUTO_TEST_CASE( test_detail_neighborhood )
 {
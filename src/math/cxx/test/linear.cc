@@ -25,6 +25,7 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include <bob/math/linear.h>
+#include <bob/core/array_copy.h>
 
 
 struct T {
@@ -111,6 +112,15 @@ BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod )
   checkBlitzClose( A_23, sol, eps);
 }
 
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_transpose )
+{
+  blitz::Array<double,2> sol(2,3);
+  blitz::Array<double,2> A_34(bob::core::array::ccopy(A_43.transpose(1,0)));
+
+  bob::math::prodTranspose( A_24, A_34, sol);
+  checkBlitzClose( A_23, sol, eps);
+}
+
 BOOST_AUTO_TEST_CASE( test_matrix_vector_prod )
 {
   blitz::Array<double,1> sol(2);
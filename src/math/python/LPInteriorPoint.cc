@@ -135,6 +135,11 @@ static bool is_in_vinf(bob::math::LPInteriorPointLongstep& op,
 
 void bind_math_lp_interiorpoint()
 {
+  enum_<bob::math::LPInteriorPoint::solver_t>("LPInteriorPointSolver")
+    .value("dense", bob::math::LPInteriorPoint::dense)
+    .value("normal_equations", bob::math::LPInteriorPoint::normal_equations)
+    ;
+
   class_<bob::math::LPInteriorPoint, boost::shared_ptr<bob::math::LPInteriorPoint>, boost::noncopyable>("LPInteriorPoint", "A base class for the Linear Program solver based on interior point methods.\nReference:\n'Primal-Dual Interior-Point Methods',\nStephen J. Wright, ISBN: 978-0898713824, chapter 5: 'Path-Following Algorithms'", no_init)
     .def(self == self)
     .def(self != self)
@@ -143,6 +148,7 @@ void bind_math_lp_interiorpoint()
     .add_property("epsilon", &bob::math::LPInteriorPoint::getEpsilon, &bob::math::LPInteriorPoint::setEpsilon, "The precision to determine whether an equality constraint is fulfilled or not")
     .add_property("lambda_", &get_lambda, "The value of the lambda dual variable (read-only)")
     .add_property("mu", &get_mu, "The value of the mu dual variable (read-only)")
+    .add_property("solver", &bob::math::LPInteriorPoint::getSolver, &bob::math::LPInteriorPoint::setSolver, "The method used to compute the Newton directions: 'dense' solves the (M+2N)x(M+2N) block system with a LU decomposition, 'normal_equations' solves the MxM normal equations A*D*A^T with a Cholesky decomposition, using the non-zero entries of A only. The latter is much faster for large problems, but requires the dual variable mu to remain strictly positive.")
     .def("reset", &bob::math::LPInteriorPoint::reset, (arg("self"), arg("M"), arg("N")), "Reset the size of the problem (M and N correspond to the dimensions of the A matrix")
     .def("solve", &solve1, (arg("self"), arg("A"), arg("b"), arg("c"), arg("x0")), "Solve a LP problem")
     .def("solve", &solve2, (arg("self"), arg("A"), arg("b"), arg("c"), arg("x0"), arg("lambda"), arg("mu")), "Solve a LP problem")
@@ -0,0 +1,234 @@
+/**
+ * @file measure/cxx/load.cc
+ * @date Sun Oct 18 17:58:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implements the parallel loading of score files
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cctype>
+#include <stdexcept>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <bob/io/LineIndex.h>
+#include <bob/measure/load.h>
+
+/**
+ * Interns strings: assigns consecutive indexes to distinct strings, in the
+ * order they are first seen
+ */
+struct StringTable {
+
+  int32_t intern(const char* begin, const char* end) {
+    m_key.assign(begin, end); //reuses the key buffer
+    boost::unordered_map<std::string, int32_t>::const_iterator
+      it = m_index.find(m_key);
+    if (it != m_index.end()) return it->second;
+    int32_t retval = names.size();
+    m_index.insert(std::make_pair(m_key, retval));
+    names.push_back(m_key);
+    return retval;
+  }
+
+  std::vector<std::string> names;
+
+  private:
+    boost::unordered_map<std::string, int32_t> m_index;
+    std::string m_key;
+
+};
+
+/**
+ * The contents of a block of consecutive lines, parsed by one thread, with
+ * strings interned in tables local to the block
+ */
+struct Block {
+  StringTable ids;
+  StringTable labels;
+  std::vector<int32_t> claimed;
+  std::vector<int32_t> models;
+  std::vector<int32_t> real;
+  std::vector<int32_t> tests;
+  std::vector<double> scores;
+  std::vector<int32_t> id_map; ///< local to global id indexes
+  std::vector<int32_t> label_map; ///< local to global label indexes
+  size_t offset; ///< position of the first score of this block
+  std::string error;
+};
+
+static inline bool is_space(char c) {
+  return std::isspace(static_cast<unsigned char>(c));
+}
+
+/**
+ * Parses lines [begin, end) of a score file. Runs on worker threads: errors
+ * are reported through the block.
+ */
+static void parse_block(const bob::io::LineIndex& index, size_t columns,
+    size_t begin, size_t end, Block& block) {
+
+  try {
+    const char* field[5][2];
+
+    for (size_t k=begin; k<end; ++k) {
+      const char* p = index.begin(k);
+      const char* e = index.end(k);
+      while (p != e && is_space(*p)) ++p;
+      if (p == e || *p == '#') continue; //empty or comment
+
+      size_t n = 0;
+      while (n < columns) {
+        while (p != e && is_space(*p)) ++p;
+        if (p == e) break;
+        field[n][0] = p;
+        while (p != e && !is_space(*p)) ++p;
+        field[n++][1] = p;
+      }
+
+      if (n < columns) {
+        boost::format m("line %u of file '%s' is invalid: it has %u fields instead of %u: %s");
+        m % (k+1) % index.filename() % n % columns % std::string(index.begin(k), e);
+        throw std::runtime_error(m.str());
+      }
+
+      double score;
+      const char** s = field[columns-1];
+      if (!bob::io::parse_double(s[0], s[1], score)) {
+        boost::format m("cannot convert score '%s' to float at line %u of file '%s'");
+        m % std::string(s[0], s[1]) % (k+1) % index.filename();
+        throw std::runtime_error(m.str());
+      }
+
+      block.claimed.push_back(block.ids.intern(field[0][0], field[0][1]));
+      if (columns == 5) {
+        block.models.push_back(block.labels.intern(field[1][0], field[1][1]));
+      }
+      block.real.push_back(block.ids.intern(field[columns-3][0], field[columns-3][1]));
+      block.tests.push_back(block.labels.intern(field[columns-2][0], field[columns-2][1]));
+      block.scores.push_back(score);
+    }
+  }
+  catch (std::exception& e) {
+    block.error = e.what();
+  }
+}
+
+static void remap(const std::vector<int32_t>& local,
+    const std::vector<int32_t>& map, int32_t* output) {
+  for (size_t k=0; k<local.size(); ++k) output[k] = map[local[k]];
+}
+
+/**
+ * Copies a block to its position in the output arrays, replacing local
+ * string indexes by global ones
+ */
+static void store_block(const Block& block, int32_t* claimed,
+    int32_t* models, int32_t* real, int32_t* tests, double* scores) {
+  remap(block.claimed, block.id_map, claimed + block.offset);
+  if (models) remap(block.models, block.label_map, models + block.offset);
+  remap(block.real, block.id_map, real + block.offset);
+  remap(block.tests, block.label_map, tests + block.offset);
+  std::copy(block.scores.begin(), block.scores.end(), scores + block.offset);
+}
+
+bob::measure::ScoreFile::ScoreFile(const std::string& filename,
+    size_t columns, size_t n_threads):
+  m_columns(columns)
+{
+  if (columns != 4 && columns != 5) {
+    boost::format m("score files have either 4 or 5 columns, not %u");
+    m % columns;
+    throw std::runtime_error(m.str());
+  }
+
+  bob::io::LineIndex index(filename, n_threads);
+  n_threads = index.getNThreads();
+  const size_t n = index.size();
+
+  // parses blocks of lines in parallel
+  std::vector<Block> blocks(n_threads);
+  {
+    boost::thread_group threads;
+    for (size_t t=1; t<n_threads; ++t) {
+      threads.create_thread(boost::bind(parse_block, boost::cref(index),
+            columns, t*n/n_threads, (t+1)*n/n_threads,
+            boost::ref(blocks[t])));
+    }
+    parse_block(index, columns, 0, n/n_threads, blocks[0]);
+    threads.join_all();
+  }
+  for (size_t t=0; t<n_threads; ++t)
+    if (!blocks[t].error.empty()) throw std::runtime_error(blocks[t].error);
+
+  // merges the string tables, keeping the order of first appearance
+  StringTable ids, labels;
+  size_t size = 0;
+  for (size_t t=0; t<n_threads; ++t) {
+    Block& b = blocks[t];
+    b.offset = size;
+    size += b.scores.size();
+    for (size_t k=0; k<b.ids.names.size(); ++k) {
+      const std::string& s = b.ids.names[k];
+      b.id_map.push_back(ids.intern(s.data(), s.data() + s.size()));
+    }
+    for (size_t k=0; k<b.labels.names.size(); ++k) {
+      const std::string& s = b.labels.names[k];
+      b.label_map.push_back(labels.intern(s.data(), s.data() + s.size()));
+    }
+  }
+  m_ids.swap(ids.names);
+  m_labels.swap(labels.names);
+
+  // stores all blocks in parallel
+  m_claimed.resize(size);
+  if (columns == 5) m_models.resize(size);
+  m_real.resize(size);
+  m_tests.resize(size);
+  m_scores.resize(size);
+  int32_t* models = (columns == 5) ? m_models.data() : 0;
+
+  boost::thread_group threads;
+  for (size_t t=1; t<n_threads; ++t) {
+    threads.create_thread(boost::bind(store_block, boost::cref(blocks[t]),
+          m_claimed.data(), models, m_real.data(), m_tests.data(),
+          m_scores.data()));
+  }
+  store_block(blocks[0], m_claimed.data(), models, m_real.data(),
+      m_tests.data(), m_scores.data());
+  threads.join_all();
+}
+
+bob::measure::ScoreFile::~ScoreFile() { }
+
+void bob::measure::ScoreFile::split(blitz::Array<double,1>& negatives,
+    blitz::Array<double,1>& positives) const {
+  int n_positives = 0;
+  for (int k=0; k<m_scores.extent(0); ++k)
+    if (m_claimed(k) == m_real(k)) ++n_positives;
+
+  negatives.resize(m_scores.extent(0) - n_positives);
+  positives.resize(n_positives);
+  int n = 0, p = 0;
+  for (int k=0; k<m_scores.extent(0); ++k) {
+    if (m_claimed(k) == m_real(k)) positives(p++) = m_scores(k);
+    else negatives(n++) = m_scores(k);
+  }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file measure/python/load.cc
+ * @date Sun Oct 18 17:58:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Binds the score file loader to python
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/make_shared.hpp>
+
+#include "bob/measure/load.h"
+#include "bob/io/Exception.h"
+#include "bob/core/python/ndarray.h"
+#include "bob/core/python/gil.h"
+#include "bob/core/python/exception.h"
+
+using namespace boost::python;
+
+static boost::shared_ptr<bob::measure::ScoreFile> score_file
+(const std::string& filename, size_t columns, size_t n_threads) {
+  bob::python::no_gil unlock;
+  return boost::make_shared<bob::measure::ScoreFile>(filename, columns,
+      n_threads);
+}
+
+static tuple strings(const std::vector<std::string>& v) {
+  list retval;
+  for (size_t k=0; k<v.size(); ++k) retval.append(str(v[k]));
+  return tuple(retval);
+}
+
+static tuple ids(const bob::measure::ScoreFile& f) {
+  return strings(f.getIds());
+}
+
+static tuple labels(const bob::measure::ScoreFile& f) {
+  return strings(f.getLabels());
+}
+
+static tuple split(const bob::measure::ScoreFile& f) {
+  blitz::Array<double,1> negatives, positives;
+  f.split(negatives, positives);
+  return make_tuple(negatives, positives);
+}
+
+void bind_measure_load() {
+
+  // files that cannot be read are I/O errors, even if bob.io is not loaded
+  bob::python::register_exception_translator<bob::io::FileNotReadable>(PyExc_IOError);
+
+  class_<bob::measure::ScoreFile, boost::shared_ptr<bob::measure::ScoreFile>, boost::noncopyable>("ScoreFile", "A score file in the four or five column formats, loaded in memory.\n\nEach line of a four column file contains, separated by white spaces: the claimed identity, the real identity, the test label and the score. Five column files have an additional model label after the claimed identity. Empty lines and lines starting with '#' are ignored.\n\nIdentities and labels are interned: the distinct strings are given by 'ids' (claimed and real identities) and 'labels' (model and test labels), in the order they first appear in the file, and the columns are given as arrays of int32 indexes into these tuples. The file is parsed by several threads at once.", no_init)
+    .def("__init__", make_constructor(&score_file, default_call_policies(), (arg("filename"), arg("columns")=4, arg("n_threads")=0)), "Loads a score file with 4 or 5 columns, using the given number of threads (if 0, uses as many threads as the machine has cores). Raises a RuntimeError if the file is malformed, or an IOError if it cannot be read.")
+    .def("__len__", &bob::measure::ScoreFile::size)
+    .add_property("columns", &bob::measure::ScoreFile::getColumns, "The number of columns of the file format")
+    .add_property("ids", &ids, "The distinct claimed and real identities")
+    .add_property("labels", &labels, "The distinct model and test labels")
+    .add_property("claimed_ids", make_function(&bob::measure::ScoreFile::getClaimedIds, return_value_policy<copy_const_reference>()), "The claimed identity of each score, as indexes in 'ids'")
+    .add_property("model_labels", make_function(&bob::measure::ScoreFile::getModelLabels, return_value_policy<copy_const_reference>()), "The model label of each score, as indexes in 'labels' (empty for four column files)")
+    .add_property("real_ids", make_function(&bob::measure::ScoreFile::getRealIds, return_value_policy<copy_const_reference>()), "The real identity of each score, as indexes in 'ids'")
+    .add_property("test_labels", make_function(&bob::measure::ScoreFile::getTestLabels, return_value_policy<copy_const_reference>()), "The test label of each score, as indexes in 'labels'")
+    .add_property("scores", make_function(&bob::measure::ScoreFile::getScores, return_value_policy<copy_const_reference>()), "The scores")
+    .def("split", &split, (arg("self")), "Returns the scores split in a tuple (negatives, positives): positives are the scores for which the claimed identity is the real one. The order of the file is kept.")
+    ;
+}
@@ -24,7 +24,51 @@
 #include <bob/sp/FFT1D.h>
 #include <bob/core/assert.h>
 #include <fftw3.h>
+#include "fftw_planner.h"
 
+static void destroy_plan(fftw_plan p) {
+  boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+  fftw_destroy_plan(p);
+}
+
+/**
+ * Creates an out-of-place complex 1D plan that can be executed on any
+ * (unaligned) array of the given length with fftw_execute_dft()
+ */
+static boost::shared_ptr<void> make_plan(const size_t length, const int sign)
+{
+  if (length == 0) return boost::shared_ptr<void>();
+  boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+  fftw_complex* in = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex)*length));
+  fftw_complex* out = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex)*length));
+  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
+  // for large arrays
+  fftw_plan p = fftw_plan_dft_1d(length, in, out, sign, FFTW_ESTIMATE | FFTW_UNALIGNED);
+  fftw_free(out);
+  fftw_free(in);
+  return boost::shared_ptr<void>(p, destroy_plan);
+}
+
+/**
+ * Executes the cached plan if the arrays have the planned length and are
+ * distinct, or plans on the fly (as before plans were cached)
+ */
+static void execute(const boost::shared_ptr<void>& plan, const size_t length,
+  const int extent, fftw_complex* src, fftw_complex* dst, const int sign)
+{
+  if (plan && (size_t)extent == length && src != dst) {
+    fftw_execute_dft(static_cast<fftw_plan>(plan.get()), src, dst);
+    return;
+  }
+
+  fftw_plan p;
+  {
+    boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+    p = fftw_plan_dft_1d(extent, src, dst, sign, FFTW_ESTIMATE);
+  }
+  fftw_execute(p);
+  destroy_plan(p);
+}
 
 bob::sp::FFT1DAbstract::FFT1DAbstract(const size_t length):
   m_length(length)
@@ -32,7 +76,7 @@ bob::sp::FFT1DAbstract::FFT1DAbstract(const size_t length):
 }
 
 bob::sp::FFT1DAbstract::FFT1DAbstract(const bob::sp::FFT1DAbstract& other):
-  m_length(other.m_length)
+  m_length(other.m_length), m_plan(other.m_plan)
 {
 }
 
@@ -62,7 +106,9 @@ bool bob::sp::FFT1DAbstract::operator!=(const bob::sp::FFT1DAbstract& b) const
 void bob::sp::FFT1DAbstract::reset(const size_t length)
 {
   // Update the length
+  if (m_length == length && m_plan) return;
   m_length = length;
+  initPlans();
 }
 
 void bob::sp::FFT1DAbstract::setLength(const size_t length)
@@ -79,6 +125,7 @@ bob::sp::FFT1D::FFT1D():
 bob::sp::FFT1D::FFT1D(const size_t length):
   bob::sp::FFT1DAbstract(length)
 {
+  initPlans();
 }
 
 bob::sp::FFT1D::FFT1D(const bob::sp::FFT1D& other):
@@ -90,6 +137,11 @@ bob::sp::FFT1D::~FFT1D()
 {
 }
 
+void bob::sp::FFT1D::initPlans()
+{
+  m_plan = make_plan(m_length, FFTW_FORWARD);
+}
+
 void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,1>& src, 
   blitz::Array<std::complex<double>,1>& dst) const
 {
@@ -104,12 +156,27 @@ void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,1>& src,
   fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
   fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
   
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  execute(m_plan, m_length, src.extent(0), src_, dst_, FFTW_FORWARD);
+}
+
+void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,2>& src, 
+  blitz::Array<std::complex<double>,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  // Reinterpret cast to fftw format
+  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
+  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
+
+  const int length = src.extent(1);
+  for (int i=0; i<src.extent(0); ++i)
+    execute(m_plan, m_length, length, src_ + i*length, dst_ + i*length,
+        FFTW_FORWARD);
 }
 
 
@@ -121,6 +188,7 @@ bob::sp::IFFT1D::IFFT1D():
 bob::sp::IFFT1D::IFFT1D(const size_t length):
   bob::sp::FFT1DAbstract(length)
 {
+  initPlans();
 }
 
 bob::sp::IFFT1D::IFFT1D(const bob::sp::IFFT1D& other):
@@ -132,6 +200,11 @@ bob::sp::IFFT1D::~IFFT1D()
 {
 }
 
+void bob::sp::IFFT1D::initPlans()
+{
+  m_plan = make_plan(m_length, FFTW_BACKWARD);
+}
+
 void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,1>& src, 
   blitz::Array<std::complex<double>,1>& dst) const
 {
@@ -146,14 +219,8 @@ void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,1>& src
   fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
   fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
   
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p); /* repeat as needed */
-  fftw_destroy_plan(p);
+  execute(m_plan, m_length, src.extent(0), src_, dst_, FFTW_BACKWARD);
 
   // Rescale as FFTW is not doing it
   dst /= static_cast<double>(m_length);
 }
-
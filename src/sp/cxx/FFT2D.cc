@@ -24,6 +24,78 @@
 #include <bob/sp/FFT2D.h>
 #include <bob/core/assert.h>
 #include <fftw3.h>
+#include "fftw_planner.h"
+
+boost::mutex& bob::sp::detail::fftw_planner_mutex()
+{
+  static boost::mutex s_planner_mutex;
+  return s_planner_mutex;
+}
+
+static void destroy_plan(fftw_plan p) {
+  boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+  fftw_destroy_plan(p);
+}
+
+/**
+ * Creates a complex 2D plan that can be executed on any (unaligned) array of
+ * the given shape with fftw_execute_dft()
+ */
+static boost::shared_ptr<void> make_plan(const size_t height,
+  const size_t width, const int sign, const bool inplace)
+{
+  if (height == 0 || width == 0) return boost::shared_ptr<void>();
+  boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+  fftw_complex* in = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex)*height*width));
+  fftw_complex* out = inplace ? in : static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex)*height*width));
+  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
+  // for large arrays
+  fftw_plan p = fftw_plan_dft_2d(height, width, in, out, sign, FFTW_ESTIMATE | FFTW_UNALIGNED);
+  if (!inplace) fftw_free(out);
+  fftw_free(in);
+  return boost::shared_ptr<void>(p, destroy_plan);
+}
+
+/**
+ * Creates a real-to-complex 2D plan, which writes the non-redundant half of
+ * the spectrum in an output array of full size (i.e. with rows of 'width'
+ * elements)
+ */
+static boost::shared_ptr<void> make_real_plan(const size_t height,
+  const size_t width)
+{
+  if (height == 0 || width == 0) return boost::shared_ptr<void>();
+  boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+  double* in = static_cast<double*>(fftw_malloc(sizeof(double)*height*width));
+  fftw_complex* out = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex)*height*width));
+  int n[2] = {(int)height, (int)width};
+  fftw_plan p = fftw_plan_many_dft_r2c(2, n, 1, in, 0, 1, 0, out, n, 1, 0, FFTW_ESTIMATE | FFTW_UNALIGNED);
+  fftw_free(out);
+  fftw_free(in);
+  return boost::shared_ptr<void>(p, destroy_plan);
+}
+
+/**
+ * Executes the cached plan if the array has the planned shape, or plans on
+ * the fly (as before plans were cached)
+ */
+static void execute(const boost::shared_ptr<void>& plan, const size_t height,
+  const size_t width, const int extent0, const int extent1, fftw_complex* src,
+  fftw_complex* dst, const int sign)
+{
+  if (plan && (size_t)extent0 == height && (size_t)extent1 == width) {
+    fftw_execute_dft(static_cast<fftw_plan>(plan.get()), src, dst);
+    return;
+  }
+
+  fftw_plan p;
+  {
+    boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+    p = fftw_plan_dft_2d(extent0, extent1, src, dst, sign, FFTW_ESTIMATE);
+  }
+  fftw_execute(p);
+  destroy_plan(p);
+}
 
 bob::sp::FFT2DAbstract::FFT2DAbstract(const size_t height, const size_t width):
   m_height(height), m_width(width)
@@ -31,7 +103,8 @@ bob::sp::FFT2DAbstract::FFT2DAbstract(const size_t height, const size_t width):
 }
 
 bob::sp::FFT2DAbstract::FFT2DAbstract(const bob::sp::FFT2DAbstract& other):
-  m_height(other.m_height), m_width(other.m_width)
+  m_height(other.m_height), m_width(other.m_width),
+  m_plan(other.m_plan), m_plan_inplace(other.m_plan_inplace)
 {
 }
 
@@ -61,8 +134,10 @@ bool bob::sp::FFT2DAbstract::operator!=(const bob::sp::FFT2DAbstract& b) const
 void bob::sp::FFT2DAbstract::reset(const size_t height, const size_t width)
 {
   // Update the height and width
+  if (m_height == height && m_width == width && m_plan) return;
   m_height = height;
   m_width = width;
+  initPlans();
 }
 
 bob::sp::FFT2D::FFT2D():
@@ -73,10 +148,12 @@ bob::sp::FFT2D::FFT2D():
 bob::sp::FFT2D::FFT2D(const size_t height, const size_t width):
   bob::sp::FFT2DAbstract(height, width)
 {
+  initPlans();
 }
 
 bob::sp::FFT2D::FFT2D(const bob::sp::FFT2D& other):
-  bob::sp::FFT2DAbstract(other)
+  bob::sp::FFT2DAbstract(other),
+  m_plan_real(other.m_plan_real)
 {
 }
 
@@ -84,6 +161,13 @@ bob::sp::FFT2D::~FFT2D()
 {
 }
 
+void bob::sp::FFT2D::initPlans()
+{
+  m_plan = make_plan(m_height, m_width, FFTW_FORWARD, false);
+  m_plan_inplace = make_plan(m_height, m_width, FFTW_FORWARD, true);
+  m_plan_real = make_real_plan(m_height, m_width);
+}
+
 void bob::sp::FFT2D::operator()(const blitz::Array<std::complex<double>,2>& src, 
   blitz::Array<std::complex<double>,2>& dst) const
 {
@@ -97,13 +181,9 @@ void bob::sp::FFT2D::operator()(const blitz::Array<std::complex<double>,2>& src,
   // Reinterpret cast to fftw format
   fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
   fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+
+  execute(src_ == dst_ ? m_plan_inplace : m_plan, m_height, m_width,
+      src.extent(0), src.extent(1), src_, dst_, FFTW_FORWARD);
 }
 
 
@@ -115,12 +195,48 @@ void bob::sp::FFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst) c
   // Reinterpret cast to fftw format
   fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
 
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  execute(m_plan_inplace, m_height, m_width, src_dst.extent(0),
+      src_dst.extent(1), src_dst_, src_dst_, FFTW_FORWARD);
+}
+
+void bob::sp::FFT2D::operator()(const blitz::Array<double,2>& src, 
+  blitz::Array<std::complex<double>,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape( dst, src);
+
+  const int height = src.extent(0);
+  const int width = src.extent(1);
+  if (height == 0 || width == 0) return;
+
+  // Reinterpret cast to fftw format
+  double* src_ = const_cast<double*>(src.data());
+  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
+
+  if (m_plan_real && (size_t)height == m_height && (size_t)width == m_width) {
+    fftw_execute_dft_r2c(static_cast<fftw_plan>(m_plan_real.get()), src_, dst_);
+  }
+  else {
+    fftw_plan p;
+    int n[2] = {height, width};
+    {
+      boost::lock_guard<boost::mutex> lock(bob::sp::detail::fftw_planner_mutex());
+      p = fftw_plan_many_dft_r2c(2, n, 1, src_, 0, 1, 0, dst_, n, 1, 0, FFTW_ESTIMATE);
+    }
+    fftw_execute(p);
+    destroy_plan(p);
+  }
+
+  // The spectrum of a real signal is Hermitian: X(y,x) = conj(X(-y,-x))
+  for (int y = 0; y < height; ++y) {
+    const int y_ = (height - y) % height;
+    for (int x = width/2 + 1; x < width; ++x)
+      dst(y,x) = std::conj(dst(y_, width - x));
+  }
 }
 
 
@@ -132,6 +248,7 @@ bob::sp::IFFT2D::IFFT2D():
 bob::sp::IFFT2D::IFFT2D(const size_t height, const size_t width):
   bob::sp::FFT2DAbstract(height, width)
 {
+  initPlans();
 }
 
 bob::sp::IFFT2D::IFFT2D(const bob::sp::IFFT2D& other):
@@ -143,6 +260,12 @@ bob::sp::IFFT2D::~IFFT2D()
 {
 }
 
+void bob::sp::IFFT2D::initPlans()
+{
+  m_plan = make_plan(m_height, m_width, FFTW_BACKWARD, false);
+  m_plan_inplace = make_plan(m_height, m_width, FFTW_BACKWARD, true);
+}
+
 void bob::sp::IFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src, 
   blitz::Array<std::complex<double>,2>& dst) const
 {
@@ -156,13 +279,9 @@ void bob::sp::IFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src
   // Reinterpret cast to fftw format
   fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
   fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+
+  execute(src_ == dst_ ? m_plan_inplace : m_plan, m_height, m_width,
+      src.extent(0), src.extent(1), src_, dst_, FFTW_BACKWARD);
 
   // Rescale the result by the size of the input 
   // (as this is not performed by FFTW)
@@ -177,12 +296,8 @@ void bob::sp::IFFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst)
   // Reinterpret cast to fftw format
   fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
 
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  execute(m_plan_inplace, m_height, m_width, src_dst.extent(0),
+      src_dst.extent(1), src_dst_, src_dst_, FFTW_BACKWARD);
 
   // Rescale the result by the size of the input
   // (as this is not performed by FFTW)
@@ -354,6 +354,28 @@ BOOST_AUTO_TEST_CASE( test_fft1D_range1to2048_random )
   }
 }
 
+BOOST_AUTO_TEST_CASE( test_fft1D_rows_random )
+{
+  // The rows of 2D arrays are transformed as 1D arrays are
+  for (int N=1; N < 65; N+=7) {
+    blitz::Array<std::complex<double>,2> t(5,N), t_fft(5,N);
+    for (int i=0; i < t.extent(0); ++i)
+      for (int j=0; j < N; ++j)
+        t(i,j) = std::complex<double>((rand()/(double)RAND_MAX)*10., 
+          (rand()/(double)RAND_MAX)*10.);
+
+    bob::sp::FFT1D fft(N);
+    fft(t, t_fft);
+    for (int i=0; i < t.extent(0); ++i) {
+      blitz::Array<std::complex<double>,1> row(N), row_fft(N);
+      row = t(i, blitz::Range::all());
+      fft(row, row_fft);
+      for (int j=0; j < N; ++j)
+        BOOST_CHECK_EQUAL( t_fft(i,j), row_fft(j));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( test_fft2D_1x1to8x8_set )
 {
   // size of the data
@@ -0,0 +1,235 @@
+/**
+ * @file trainer/cxx/PrefetchingDataShuffler.cc
+ * @date Sun Oct 18 09:12:44 2026 +0200
+ * @author agent <agent@local>
+ *
+ * @brief Implementation of the PrefetchingDataShuffler.
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <boost/format.hpp>
+#include <boost/bind.hpp>
+#include <bob/core/assert.h>
+#include <bob/core/array_copy.h>
+#include <bob/io/HDF5File.h>
+#include <bob/trainer/Exception.h>
+#include <bob/trainer/PrefetchingDataShuffler.h>
+
+bob::trainer::PrefetchingDataShuffler::PrefetchingDataShuffler
+(const std::vector<boost::shared_ptr<bob::io::File> >& data,
+ const std::vector<blitz::Array<double,1> >& target,
+ size_t batch_size, size_t n_workers, size_t queue_size,
+ boost::mt19937::result_type seed):
+  m_data(data),
+  m_target(target.size()),
+  m_range(),
+  m_width(0),
+  m_batch_size(batch_size),
+  m_n_workers(n_workers),
+  m_seed(seed),
+  m_do_stdnorm(false),
+  m_mean(),
+  m_stddev(),
+  m_ring(queue_size)
+{
+  if (data.size() == 0) throw bob::trainer::WrongNumberOfClasses(0);
+  if (target.size() == 0) throw bob::trainer::WrongNumberOfClasses(0);
+
+  bob::core::array::assertSameDimensionLength(data.size(), target.size());
+
+  if (batch_size == 0) throw std::runtime_error("PrefetchingDataShuffler: the batch size should be greater than zero");
+  if (n_workers == 0) throw std::runtime_error("PrefetchingDataShuffler: the number of workers should be greater than zero");
+
+  // checks shapes, minimum number of examples
+  for (size_t k=0; k<data.size(); ++k) {
+    const bob::core::array::typeinfo& info = data[k]->type();
+    if (info.nd != 1) {
+      boost::format m("PrefetchingDataShuffler: examples in file '%s' (class %u) should be 1D arrays, but they have %u dimensions");
+      m % data[k]->filename() % k % info.nd;
+      throw std::runtime_error(m.str());
+    }
+    if (data[k]->size() == 0) throw WrongNumberOfFeatures(0, 1, k);
+    if (k == 0) m_width = info.shape[0];
+    else if (info.shape[0] != m_width)
+      throw WrongNumberOfFeatures(info.shape[0], m_width, k);
+    bob::core::array::assertSameShape(target[0], target[k]);
+  }
+
+  // set save values for the mean and stddev (even if not used at start)
+  m_mean.resize(m_width);
+  m_mean = 0.;
+  m_stddev.resize(m_width);
+  m_stddev = 1.;
+
+  for (size_t k=0; k<target.size(); ++k) {
+    m_target[k].reference(bob::core::array::ccopy(target[k]));
+    m_range.push_back(boost::uniform_int<size_t>(0, m_data[k]->size()-1));
+  }
+
+  // pre-allocates the ring, so workers never allocate batch memory
+  for (size_t k=0; k<m_ring.size(); ++k) {
+    m_ring[k].data.resize(m_batch_size, m_width);
+    m_ring[k].target.resize(m_batch_size, getTargetWidth());
+  }
+}
+
+bob::trainer::PrefetchingDataShuffler::~PrefetchingDataShuffler() {
+  stop();
+}
+
+void bob::trainer::PrefetchingDataShuffler::getStdNorm
+(blitz::Array<double,1>& mean, blitz::Array<double,1>& stddev) const {
+
+  mean.resize(m_width);
+  stddev.resize(m_width);
+
+  if (m_do_stdnorm) {
+    mean = m_mean;
+    stddev = m_stddev;
+    return;
+  }
+
+  // single pass over the data, see DataShuffler.cc
+  mean = 0.;
+  stddev = 0.; ///< temporarily used to accumulate square sum!
+  double samples = 0;
+
+  for (size_t k=0; k<m_data.size(); ++k) {
+    boost::lock_guard<boost::recursive_mutex>
+      lock(bob::io::HDF5File::mutex());
+    for (size_t i=0; i<m_data[k]->size(); ++i) {
+      blitz::Array<double,1> example = m_data[k]->cast<double,1>(i);
+      mean += example;
+      stddev += blitz::pow2(example);
+      ++samples;
+    }
+  }
+  stddev -= blitz::pow2(mean) / samples;
+  stddev /= (samples-1); ///< note: unbiased sample variance
+  stddev = blitz::sqrt(stddev);
+
+  mean /= (samples);
+}
+
+void bob::trainer::PrefetchingDataShuffler::setAutoStdNorm(bool s) {
+  if (s == m_do_stdnorm) return;
+  bool running = m_ring.running();
+  stop();
+  if (s) getStdNorm(m_mean, m_stddev);
+  else {
+    m_mean = 0.;
+    m_stddev = 1.;
+  }
+  m_do_stdnorm = s;
+  if (running) start();
+}
+
+void bob::trainer::PrefetchingDataShuffler::setSeed
+(boost::mt19937::result_type seed) {
+  bool running = m_ring.running();
+  stop();
+  m_seed = seed;
+  if (running) start();
+}
+
+void bob::trainer::PrefetchingDataShuffler::start() {
+  m_ring.start(m_n_workers,
+      boost::bind(&bob::trainer::PrefetchingDataShuffler::worker, this, _1));
+}
+
+void bob::trainer::PrefetchingDataShuffler::stop() {
+  m_ring.stop();
+}
+
+void bob::trainer::PrefetchingDataShuffler::fill(boost::mt19937& rng,
+    Batch& batch) {
+
+  // same fair selection as in DataShuffler::operator()
+  size_t counter = 0;
+  blitz::Range all = blitz::Range::all();
+  while (counter < m_batch_size) {
+    for (size_t i=0; i<m_data.size() && counter < m_batch_size; ++i) {
+      size_t index = m_range[i](rng); //pick a random position within class
+      blitz::Array<double,1> example;
+      {
+        boost::lock_guard<boost::recursive_mutex>
+          lock(bob::io::HDF5File::mutex());
+        example.reference(m_data[i]->cast<double,1>(index));
+      }
+      if (m_do_stdnorm)
+        batch.data(counter,all) = (example - m_mean) / m_stddev;
+      else
+        batch.data(counter,all) = example;
+      batch.target(counter,all) = m_target[i];
+      ++counter;
+    }
+  }
+}
+
+void bob::trainer::PrefetchingDataShuffler::worker(size_t id) {
+
+  boost::mt19937 rng(m_seed + id);
+
+  for (size_t seq=id; ; seq+=m_n_workers) {
+    // waits until the batch 'seq - Q' was picked up
+    Batch* slot = m_ring.acquire(seq);
+    if (!slot) return;
+
+    // nobody else touches this slot until it is published
+    try {
+      fill(rng, *slot);
+    }
+    catch (std::exception& e) {
+      m_ring.fail(seq, e.what());
+      return;
+    }
+    catch (...) {
+      m_ring.fail(seq, "PrefetchingDataShuffler: unknown exception raised by worker");
+      return;
+    }
+
+    m_ring.publish(seq);
+  }
+}
+
+void bob::trainer::PrefetchingDataShuffler::operator()
+(blitz::Array<double,2>& data, blitz::Array<double,2>& target) {
+
+  bob::core::array::assertSameDimensionLength(data.extent(0), m_batch_size);
+  bob::core::array::assertSameDimensionLength(target.extent(0), m_batch_size);
+  bob::core::array::assertSameDimensionLength(data.extent(1), m_width);
+  bob::core::array::assertSameDimensionLength(target.extent(1),
+      getTargetWidth());
+
+  start();
+
+  Batch* slot = 0;
+  try {
+    slot = m_ring.wait();
+  }
+  catch (...) {
+    stop();
+    throw;
+  }
+  if (!slot) throw std::runtime_error("PrefetchingDataShuffler: stopped while waiting for the next batch");
+
+  // the slot cannot be refilled before we release it
+  data = slot->data;
+  target = slot->target;
+
+  m_ring.release();
+}
@@ -21,9 +21,11 @@
  */
 
 #include <bob/core/python/ndarray.h>
+#include <bob/core/python/gil.h>
 #include <boost/python/stl_iterator.hpp>
 #include <boost/make_shared.hpp>
 #include <bob/trainer/DataShuffler.h>
+#include <bob/trainer/PrefetchingDataShuffler.h>
 #include <bob/trainer/MLPRPropTrainer.h>
 
 using namespace boost::python;
@@ -120,6 +122,49 @@ static boost::shared_ptr<bob::trainer::DataShuffler> shuffler_from_arrays_or_arr
   return shuffler_from_arrays(data, target);
 }
 
+static tuple call_prefetching_shuffler1(bob::trainer::PrefetchingDataShuffler& s) {
+  blitz::Array<double,2> data(s.getBatchSize(), s.getDataWidth());
+  blitz::Array<double,2> target(s.getBatchSize(), s.getTargetWidth());
+  {
+    bob::python::no_gil unlock;
+    s(data, target);
+  }
+  return make_tuple(data, target);
+}
+
+static void call_prefetching_shuffler2(bob::trainer::PrefetchingDataShuffler& s,
+    bob::python::ndarray d, bob::python::ndarray t) {
+  blitz::Array<double,2> data_ = d.bz<double,2>();
+  blitz::Array<double,2> target_ = t.bz<double,2>();
+  bob::python::no_gil unlock;
+  s(data_, target_);
+}
+
+static tuple prefetching_stdnorm(bob::trainer::PrefetchingDataShuffler& s) {
+  blitz::Array<double,1> mean(s.getDataWidth());
+  blitz::Array<double,1> stddev(s.getDataWidth());
+  s.getStdNorm(mean, stddev);
+  return make_tuple(mean, stddev);
+}
+
+static boost::shared_ptr<bob::trainer::PrefetchingDataShuffler> prefetching_shuffler
+(object data, object target, size_t batch_size, size_t n_workers,
+ size_t queue_size, boost::mt19937::result_type seed) {
+  //data
+  stl_input_iterator<boost::shared_ptr<bob::io::File> > dbegin(data), dend;
+  std::vector<boost::shared_ptr<bob::io::File> > vdata(dbegin, dend);
+
+  //target
+  stl_input_iterator<bob::python::const_ndarray> vtarget(target), tend;
+  std::vector<blitz::Array<double,1> > vtarget_ref;
+  vtarget_ref.reserve(len(target));
+  for (; vtarget != tend; ++vtarget) 
+    vtarget_ref.push_back((*vtarget).bz<double,1>());
+
+  return boost::make_shared<bob::trainer::PrefetchingDataShuffler>(vdata,
+      vtarget_ref, batch_size, n_workers, queue_size, seed);
+}
+
 void bind_trainer_rprop() {
   class_<bob::trainer::DataShuffler, boost::shared_ptr<bob::trainer::DataShuffler> >("DataShuffler", "A data shuffler is capable of being populated with data from one or multiple classes and matching target values. Once setup, the shuffer can randomly select a number of vectors and accompaning targets for the different classes, filling up user containers.\n\nData shufflers are particular useful for training neural networks.", no_init)
     .def("__init__", make_constructor(&shuffler_from_arrays_or_arraysets, default_call_policies(), (arg("data"), arg("target"))), "Initializes the shuffler with some data classes and corresponding targets. The data is read by considering examples are lying on different rows of the input data if it is composed of a list of NumPy ndarrays or copied internally if it is composed of a list of io.Arraysets.")
@@ -134,6 +179,23 @@ void bind_trainer_rprop() {
     .def("__call__", call_shuffler3, (arg("self"), arg("data"), arg("target")), "This version is a shortcut to the previous declaration of operator() that actually instantiates its own random number generator and seed it a time-based variable. We guarantee two calls will lead to different results if they are at least 1 microsecond appart (procedure uses the machine clock).")
     ;
 
+  class_<bob::trainer::PrefetchingDataShuffler, boost::shared_ptr<bob::trainer::PrefetchingDataShuffler>, boost::noncopyable>("PrefetchingDataShuffler", "An asynchronous variant of the DataShuffler. Each class is backed by a bob.io.File in which every entry is one example. A pool of background workers draws examples from these files, applies standard normalization (if set) and keeps a bounded ring of ready mini-batches, so that training only has to pick up the next one.\n\nWorker 'w' uses its own random number generator seeded with 'seed + w' and batches are always delivered in the same order, so the sequence is reproducible for a given seed and number of workers.", no_init)
+    .def("__init__", make_constructor(&prefetching_shuffler, default_call_policies(), (arg("data"), arg("target"), arg("batch_size"), arg("n_workers")=1, arg("queue_size")=4, arg("seed")=5489)), "Initializes the shuffler with a list of files (one per class, with one 1D array per example) and corresponding targets. Background workers are started on the first draw.")
+    .def("stdnorm", &bob::trainer::PrefetchingDataShuffler::getStdNorm, (arg("self"), arg("mean"), arg("stddev")), "Calculates and returns mean and standard deviation from the input data. This requires a full pass over all files.")
+    .def("stdnorm", &prefetching_stdnorm, (arg("self")), "Calculates and returns mean and standard deviation from the input data. This requires a full pass over all files.")
+    .add_property("auto_stdnorm", &bob::trainer::PrefetchingDataShuffler::getAutoStdNorm, &bob::trainer::PrefetchingDataShuffler::setAutoStdNorm)
+    .add_property("seed", &bob::trainer::PrefetchingDataShuffler::getSeed, &bob::trainer::PrefetchingDataShuffler::setSeed)
+    .add_property("data_width", &bob::trainer::PrefetchingDataShuffler::getDataWidth)
+    .add_property("target_width", &bob::trainer::PrefetchingDataShuffler::getTargetWidth)
+    .add_property("batch_size", &bob::trainer::PrefetchingDataShuffler::getBatchSize)
+    .add_property("n_workers", &bob::trainer::PrefetchingDataShuffler::getNumberOfWorkers)
+    .add_property("queue_size", &bob::trainer::PrefetchingDataShuffler::getQueueSize)
+    .def("start", &bob::trainer::PrefetchingDataShuffler::start, (arg("self")), "Starts the background workers, if they are not running already.")
+    .def("stop", &bob::trainer::PrefetchingDataShuffler::stop, (arg("self")), "Stops the background workers and discards prepared batches. The next draw restarts the batch sequence.")
+    .def("__call__", &call_prefetching_shuffler1, (arg("self")), "Returns the next prepared mini-batch as a tuple (data, target), waiting for it if necessary.")
+    .def("__call__", &call_prefetching_shuffler2, (arg("self"), arg("data"), arg("target")), "Fills the given 'data' and 'target' matrices with the next prepared mini-batch, waiting for it if necessary. Matrices should have 'batch_size' rows.")
+    ;
+
   class_<bob::trainer::MLPRPropTrainer>("MLPRPropTrainer", "Sets an MLP to perform discrimination based on RProp: A Direct Adaptive Method for Faster Backpropagation Learning: The RPROP Algorithm, by Martin Riedmiller and Heinrich Braun on IEEE International Conference on Neural Networks, pp. 586--591, 1993.", init<const bob::machine::MLP&, size_t>((arg("machine"), arg("batch_size")), "Initializes a new MLPRPropTrainer trainer according to a given machine settings and a training batch size. Good values for batch sizes are tens of samples. RProp is a 'batch' training algorithm. Do not try to set batch_size to a too-low value."))
     .def("reset", &bob::trainer::MLPRPropTrainer::reset, (arg("self")), "Re-initializes the whole training apparatus to start training a new machine. This will effectively reset all Delta matrices to their initial values and set the previous derivatives to zero as described on the section II.C of the RProp paper.")
     .add_property("batch_size", &bob::trainer::MLPRPropTrainer::getBatchSize, &bob::trainer::MLPRPropTrainer::setBatchSize)